@@ -6,17 +6,20 @@
 C_SRCS += \
 ../HAL/buzzer.c \
 ../HAL/external_eeprom.c \
-../HAL/motor.c 
+../HAL/motor.c \
+../HAL/limit_switch.c 
 
 OBJS += \
 ./HAL/buzzer.o \
 ./HAL/external_eeprom.o \
-./HAL/motor.o 
+./HAL/motor.o \
+./HAL/limit_switch.o 
 
 C_DEPS += \
 ./HAL/buzzer.d \
 ./HAL/external_eeprom.d \
-./HAL/motor.d 
+./HAL/motor.d \
+./HAL/limit_switch.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -7,19 +7,25 @@ C_SRCS += \
 ../MCAL/gpio.c \
 ../MCAL/timer.c \
 ../MCAL/twi.c \
-../MCAL/uart.c 
+../MCAL/uart.c \
+../MCAL/ext_interrupt.c \
+../MCAL/adc.c 
 
 OBJS += \
 ./MCAL/gpio.o \
 ./MCAL/timer.o \
 ./MCAL/twi.o \
-./MCAL/uart.o 
+./MCAL/uart.o \
+./MCAL/ext_interrupt.o \
+./MCAL/adc.o 
 
 C_DEPS += \
 ./MCAL/gpio.d \
 ./MCAL/timer.d \
 ./MCAL/twi.d \
-./MCAL/uart.d 
+./MCAL/uart.d \
+./MCAL/ext_interrupt.d \
+./MCAL/adc.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -0,0 +1,42 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+C_SRCS += \
+../UTIL/sha256.c \
+../UTIL/ascon.c \
+../UTIL/secure_link.c \
+../UTIL/sha1.c \
+../UTIL/totp.c \
+../UTIL/stack_monitor.c \
+../UTIL/isr_latency.c 
+
+OBJS += \
+./UTIL/sha256.o \
+./UTIL/ascon.o \
+./UTIL/secure_link.o \
+./UTIL/sha1.o \
+./UTIL/totp.o \
+./UTIL/stack_monitor.o \
+./UTIL/isr_latency.o 
+
+C_DEPS += \
+./UTIL/sha256.d \
+./UTIL/ascon.d \
+./UTIL/secure_link.d \
+./UTIL/sha1.d \
+./UTIL/totp.d \
+./UTIL/stack_monitor.d \
+./UTIL/isr_latency.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+UTIL/%.o: ../UTIL/%.c UTIL/subdir.mk
+	@echo 'Building file: $<'
+	@echo 'Invoking: AVR Compiler'
+	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega32 -DF_CPU=8000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
@@ -4,13 +4,22 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
-../main.c 
+../main.c \
+../attempt_limiter.c \
+../door_config.c \
+../bench.c 
 
 OBJS += \
-./main.o 
+./main.o \
+./attempt_limiter.o \
+./door_config.o \
+./bench.o 
 
 C_DEPS += \
-./main.d 
+./main.d \
+./attempt_limiter.d \
+./door_config.d \
+./bench.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -1,37 +1,144 @@
-/******************************************************************************
- *
- * Module: BUZZER
- *
- * File Name: buzzer.c
- *
- * Description: Source file for the buzzer driver
- *
- * Author: Yousouf Soliman
- *
- *******************************************************************************/
-#include "buzzer.h"
-#include "../UTIL/std_types.h"
-/*******************************************************************************
- *                      Functions Definitions                                  *
- *******************************************************************************/
-/*
- * Description:
- * 1. Initializes the pin connected to the buzzer
- * 2. Turns buzzer OFF as default
- * */
-void Buzzer_init(void) {
-	GPIO_setupPinDirection(BUZZER_PORT_ID, BUZZER_PIN_ID, PIN_OUTPUT);
-	GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_LOW);
-}
-/*
- * Description:
- * Turns Buzzer ON*/
-void Buzzer_on(void) {
-	GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_HIGH);
-}
-/*
- * Description:
- * Turns Buzzer OFF*/
-void Buzzer_off(void) {
-	GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_LOW);
-}
+/******************************************************************************
+ *
+ * Module: BUZZER
+ *
+ * File Name: buzzer.c
+ *
+ * Description: Source file for the buzzer driver
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#include "buzzer.h"
+#include "../UTIL/std_types.h"
+#include "../MCAL/gpio_fast.h" /* Single instruction access to the buzzer pin */
+#include "../MCAL/timer.h" /* For the tone on OC2 */
+#include <avr/pgmspace.h> /* For the pattern steps in flash */
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* Playing pattern state, updated from the tick ISR */
+static volatile boolean g_playing = FALSE;
+static const Buzzer_StepType *g_patternSteps; /* first step of the sequence */
+static const Buzzer_StepType *g_patternStep; /* step playing */
+static uint16 g_stepMsLeft; /* ms left before the next step */
+static uint8 g_repeatsLeft; /* plays left including this one, 0 = forever */
+static uint8 g_repeatForever;
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+/*
+ * Applies the step g_patternStep points at, wrapping around at the end of the sequence.
+ * Returns FALSE when the pattern is over.
+ * */
+static boolean Buzzer_loadStep(void);
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description:
+ * 1. Initializes the pin connected to the buzzer
+ * 2. Turns buzzer OFF as default
+ * */
+void Buzzer_init(void) {
+	GPIO_setupPinDirection(BUZZER_PORT_ID, BUZZER_PIN_ID, PIN_OUTPUT);
+	GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_LOW);
+	g_playing = FALSE;
+}
+/*
+ * Description:
+ * Turns Buzzer ON*/
+void Buzzer_on(void) {
+#ifdef BUZZER_TONE
+	Timer2_setCompareOutput(Timer2_OC2_Toggle);
+#else
+	GPIO_FAST_SET(BUZZER_PIN);
+#endif
+}
+/*
+ * Description:
+ * Turns Buzzer OFF*/
+void Buzzer_off(void) {
+#ifdef BUZZER_TONE
+	Timer2_setCompareOutput(Timer2_OC2_Disconnected);
+	/* The pin goes back to its PORT value, which is kept low */
+#else
+	GPIO_FAST_CLEAR(BUZZER_PIN);
+#endif
+}
+/*
+ * Description:
+ * Starts playing a pattern in the background, replacing the one playing (if any).
+ * Buzzer_tick() must be called every 1ms. The pattern is copied, its steps must stay in flash.
+ * */
+void Buzzer_play(const Buzzer_PatternType *pattern) {
+	g_playing = FALSE;
+	/* Freeze the tick while the pattern is being loaded */
+	g_patternSteps = pattern->steps;
+	g_patternStep = pattern->steps;
+	g_repeatsLeft = pattern->repeat;
+	g_repeatForever = (pattern->repeat == 0);
+	if (Buzzer_loadStep()) {
+		g_playing = TRUE;
+	} else {
+		Buzzer_off();
+		/* Empty pattern */
+	}
+}
+/*
+ * Description:
+ * Stops the pattern playing and turns the buzzer OFF*/
+void Buzzer_stop(void) {
+	g_playing = FALSE;
+	Buzzer_off();
+}
+/*
+ * Description:
+ * Returns TRUE while a pattern is playing*/
+boolean Buzzer_isPlaying(void) {
+	return g_playing;
+}
+/*
+ * Description:
+ * Advances the playing pattern by 1ms, to be called from the system tick ISR*/
+void Buzzer_tick(void) {
+	if (!g_playing) {
+		return;
+	}
+	g_stepMsLeft--;
+	if (g_stepMsLeft == 0) {
+		g_patternStep++;
+		if (!Buzzer_loadStep()) {
+			g_playing = FALSE;
+			Buzzer_off();
+		}
+	}
+}
+/*
+ * Applies the step g_patternStep points at, wrapping around at the end of the sequence.
+ * Returns FALSE when the pattern is over.
+ * */
+static boolean Buzzer_loadStep(void) {
+	uint16 duration = pgm_read_word(&g_patternStep->duration_ms);
+	if (duration == 0) {
+		/* End of the sequence: play it again or stop */
+		if (!g_repeatForever) {
+			g_repeatsLeft--;
+			if (g_repeatsLeft == 0) {
+				return FALSE;
+			}
+		}
+		g_patternStep = g_patternSteps;
+		duration = pgm_read_word(&g_patternStep->duration_ms);
+		if (duration == 0) {
+			return FALSE;
+		}
+	}
+	g_stepMsLeft = duration;
+	if (pgm_read_byte(&g_patternStep->state) == Buzzer_ON) {
+		Buzzer_on();
+	} else {
+		Buzzer_off();
+	}
+	return TRUE;
+}
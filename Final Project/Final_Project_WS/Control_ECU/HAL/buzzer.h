@@ -1,48 +1,89 @@
-/******************************************************************************
- *
- * Module: BUZZER
- *
- * File Name: buzzer.h
- *
- * Description: Header file for the buzzer driver
- *
- * Author: Yousouf Soliman
- *
- *******************************************************************************/
-#ifndef BUZZER_H_
-#define BUZZER_H_
-
-#include "../MCAL/gpio.h"
-
-/*******************************************************************************
- *                            Definitions                                      *
- *******************************************************************************/
-#define BUZZER_PORT_ID PORTA_ID
-#define BUZZER_PIN_ID PIN0_ID
-
-/*******************************************************************************
- *                         Types Declaration                                   *
- *******************************************************************************/
-typedef enum {
-	Buzzer_OFF, Buzzer_ON
-} Buzzer_state;
-
-/*******************************************************************************
- *                      Functions Prototypes                                   *
- *******************************************************************************/
-/*
- * Description:
- * 1. Initializes the pin connected to the buzzer
- * 2. Turns buzzer OFF as default
- * */
-void Buzzer_init(void);
-/*
- * Description:
- * Turns Buzzer ON*/
-void Buzzer_on(void);
-/*
- * Description:
- * Turns Buzzer OFF*/
-void Buzzer_off(void);
-
-#endif /* BUZZER_H_ */
+/******************************************************************************
+ *
+ * Module: BUZZER
+ *
+ * File Name: buzzer.h
+ *
+ * Description: Header file for the buzzer driver
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#ifndef BUZZER_H_
+#define BUZZER_H_
+
+#include "../MCAL/gpio.h"
+#include "../UTIL/std_types.h"
+
+/*******************************************************************************
+ *                            Definitions                                      *
+ *******************************************************************************/
+/*#define BUZZER_TONE*/
+/* Define it for a passive buzzer on OC2/PD7: the tone is generated by the Timer2
+ * system tick toggling OC2 on each compare match (1 / (2 x 1ms) = 500Hz), no CPU
+ * involved. Otherwise an active buzzer on PA0 is switched on and off. */
+#ifdef BUZZER_TONE
+#define BUZZER_PORT_ID PORTD_ID
+#define BUZZER_PIN_ID PIN7_ID
+#else
+#define BUZZER_PORT_ID PORTA_ID
+#define BUZZER_PIN_ID PIN0_ID
+#endif
+#define BUZZER_PIN GPIO_PIN(BUZZER_PORT_ID,BUZZER_PIN_ID)
+/* Compile-time pin descriptor for the GPIO fast path */
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef enum {
+	Buzzer_OFF, Buzzer_ON
+} Buzzer_state;
+
+typedef struct {
+	uint16 duration_ms; /* 0 marks the end of the sequence */
+	uint8 state; /* Buzzer_ON (beep) or Buzzer_OFF (pause) */
+} Buzzer_StepType;
+/* One step of a pattern, the steps are stored in flash (PROGMEM) */
+
+typedef struct {
+	const Buzzer_StepType *steps; /* flash address of the step sequence */
+	uint8 repeat; /* number of times the sequence is played, 0 = until Buzzer_stop() */
+} Buzzer_PatternType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ * Description:
+ * 1. Initializes the pin connected to the buzzer
+ * 2. Turns buzzer OFF as default
+ * */
+void Buzzer_init(void);
+/*
+ * Description:
+ * Turns Buzzer ON*/
+void Buzzer_on(void);
+/*
+ * Description:
+ * Turns Buzzer OFF*/
+void Buzzer_off(void);
+/*
+ * Description:
+ * Starts playing a pattern in the background, replacing the one playing (if any).
+ * Buzzer_tick() must be called every 1ms. The pattern is copied, its steps must stay in flash.
+ * */
+void Buzzer_play(const Buzzer_PatternType *pattern);
+/*
+ * Description:
+ * Stops the pattern playing and turns the buzzer OFF*/
+void Buzzer_stop(void);
+/*
+ * Description:
+ * Returns TRUE while a pattern is playing*/
+boolean Buzzer_isPlaying(void);
+/*
+ * Description:
+ * Advances the playing pattern by 1ms, to be called from the system tick ISR*/
+void Buzzer_tick(void);
+
+#endif /* BUZZER_H_ */
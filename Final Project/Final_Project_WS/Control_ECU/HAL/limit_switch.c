@@ -0,0 +1,59 @@
+/******************************************************************************
+ *
+ * Module: LIMIT SWITCH
+ *
+ * File Name: limit_switch.c
+ *
+ * Description: Source file for the door end-of-travel limit switches driver
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#include "limit_switch.h"
+
+#include "../MCAL/gpio.h"
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description:
+ * 1. Initializes both switch pins with pull-ups
+ * 2. Interrupts on the falling edge (switch pressed)
+ * */
+void LimitSwitch_init(void) {
+	EXT_INT_ConfigType EXT_INT_Config;
+	EXT_INT_Config.sense = EXT_INT_FallingEdge;
+	EXT_INT_Config.pull_up = LOGIC_HIGH;
+
+	EXT_INT_Config.id = LIMIT_SWITCH_OPEN_INT;
+	EXT_INT_init(&EXT_INT_Config);
+	EXT_INT_Config.id = LIMIT_SWITCH_CLOSED_INT;
+	EXT_INT_init(&EXT_INT_Config);
+}
+
+/*
+ * Description:
+ * Sets the function called from the ISR when the required switch gets pressed
+ * */
+void LimitSwitch_setCallBack(LimitSwitch_Id id, void(*a_ptr)(void)) {
+	if (id == LimitSwitch_OPEN) {
+		EXT_INT_setCallBack(LIMIT_SWITCH_OPEN_INT, a_ptr);
+	} else {
+		EXT_INT_setCallBack(LIMIT_SWITCH_CLOSED_INT, a_ptr);
+	}
+}
+
+/*
+ * Description:
+ * Returns TRUE if the required switch is currently pressed
+ * */
+boolean LimitSwitch_isPressed(LimitSwitch_Id id) {
+	uint8 state;
+	if (id == LimitSwitch_OPEN) {
+		state = GPIO_readPin(EXT_INT0_PORT_ID, EXT_INT0_PIN_ID);
+	} else {
+		state = GPIO_readPin(EXT_INT1_PORT_ID, EXT_INT1_PIN_ID);
+	}
+	return (state == LIMIT_SWITCH_PRESSED);
+}
@@ -0,0 +1,55 @@
+ /******************************************************************************
+ *
+ * Module: LIMIT SWITCH
+ *
+ * File Name: limit_switch.h
+ *
+ * Description: Header file for the door end-of-travel limit switches driver
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#ifndef LIMIT_SWITCH_H_
+#define LIMIT_SWITCH_H_
+
+#include "../UTIL/std_types.h"
+#include "../MCAL/ext_interrupt.h"
+
+/*******************************************************************************
+ *                            Definitions                                      *
+ *******************************************************************************/
+/* The switches close to ground at the end of travel (internal pull-ups) */
+#define LIMIT_SWITCH_OPEN_INT EXT_INT0 /* PD2: door fully unlocked */
+#define LIMIT_SWITCH_CLOSED_INT EXT_INT1 /* PD3: door fully locked */
+#define LIMIT_SWITCH_PRESSED LOGIC_LOW
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef enum {
+	LimitSwitch_OPEN, LimitSwitch_CLOSED
+} LimitSwitch_Id;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ * Description:
+ * 1. Initializes both switch pins with pull-ups
+ * 2. Interrupts on the falling edge (switch pressed)
+ * */
+void LimitSwitch_init(void);
+
+/*
+ * Description:
+ * Sets the function called from the ISR when the required switch gets pressed
+ * */
+void LimitSwitch_setCallBack(LimitSwitch_Id id, void(*a_ptr)(void));
+
+/*
+ * Description:
+ * Returns TRUE if the required switch is currently pressed
+ * */
+boolean LimitSwitch_isPressed(LimitSwitch_Id id);
+
+#endif /* LIMIT_SWITCH_H_ */
@@ -1,58 +1,340 @@
-/******************************************************************************
- *
- * Module: MOTOR
- *
- * File Name: motor.c
- *
- * Description: Source file for the AVR MOTOR driver
- *
- * Author: Yousouf Soliman
- *
- *******************************************************************************/
-#include "motor.h"
-
-#include "../MCAL/gpio.h"
-#include "../MCAL/timer.h"
-
-
-/*******************************************************************************
- *                      Functions Definitions                                  *
- *******************************************************************************/
-/*
- * Description :
- * Initializes the motor module with connected h-bridge
- */
-void DcMotor_init(void) {
-	//Configuring output pins.
-	GPIO_setupPinDirection(DcMotor_PORT, DcMotor_PIN, PIN_OUTPUT);
-	GPIO_setupPinDirection(DcMotor_PORT, (DcMotor_PIN + 1), PIN_OUTPUT);
-	//Initializing motor pins to LOGIC_LOW (Stop motors from spinning).
-	GPIO_writePin(DcMotor_PORT, DcMotor_PIN, LOGIC_LOW);
-	GPIO_writePin(DcMotor_PORT, (DcMotor_PIN + 1), LOGIC_LOW);
-}
-
-
-/*
- * Description :
- * Changes the direction the motor is moving towards
- */
-void DcMotor_Rotate(DcMotor_State state,uint8 speed){
-
-	switch (state) {
-	case STOP:
-		GPIO_writePin(DcMotor_PORT, DcMotor_PIN, LOGIC_LOW);
-		GPIO_writePin(DcMotor_PORT, (DcMotor_PIN + 1), LOGIC_LOW);
-		break;
-	case CW:
-		GPIO_writePin(DcMotor_PORT, DcMotor_PIN, LOGIC_HIGH);
-		GPIO_writePin(DcMotor_PORT, (DcMotor_PIN + 1), LOGIC_LOW);
-		break;
-	case A_CW:
-		GPIO_writePin(DcMotor_PORT, DcMotor_PIN, LOGIC_LOW);
-		GPIO_writePin(DcMotor_PORT, (DcMotor_PIN + 1), LOGIC_HIGH);
-		break;
-	}
-	/*call the timer start function to provide the correct speed for the motor*/
-	PWM_Timer0_Start(255 * ((float) speed / 100.0));
-}
-
+/******************************************************************************
+ *
+ * Module: MOTOR
+ *
+ * File Name: motor.c
+ *
+ * Description: Source file for the AVR MOTOR driver
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#include "motor.h"
+
+#include "../MCAL/gpio.h"
+#include "../MCAL/timer.h"
+#include "../MCAL/adc.h"
+#include <util/delay.h> /* For the reversal dead-time */
+#include <avr/pgmspace.h> /* For the ramp tables in flash */
+
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static DcMotor_State g_motorState = STOP; /* Direction currently applied to the H-bridge */
+
+/* Ramp shapes as a fraction of the cruise duty (0..255) for each of the DcMotor_RAMP_STEPS steps */
+static const uint8 g_rampShapes[2][DcMotor_RAMP_STEPS + 1] PROGMEM =
+{
+	/* DcMotor_RAMP_TRAPEZOIDAL: linear */
+	{  0,   8,  16,  24,  32,  40,  48,  56,  64,  72,  80,  88,  96, 104, 112, 120,
+	 128, 135, 143, 151, 159, 167, 175, 183, 191, 199, 207, 215, 223, 231, 239, 247, 255},
+	/* DcMotor_RAMP_S_CURVE: smoothstep 3x^2 - 2x^3 */
+	{  0,   1,   3,   6,  11,  17,  24,  31,  40,  49,  59,  70,  81,  92, 104, 116,
+	 128, 139, 151, 163, 174, 185, 196, 206, 215, 224, 231, 238, 244, 249, 252, 254, 255}
+};
+
+/* Running profile state, updated from the tick ISR */
+typedef enum{
+	PROFILE_IDLE, PROFILE_RAMP_UP, PROFILE_CRUISE, PROFILE_RAMP_DOWN
+}DcMotor_ProfilePhase;
+
+static volatile DcMotor_ProfilePhase g_profilePhase = PROFILE_IDLE;
+static uint8 g_profileShape; /* DcMotor_RampShape of the running profile */
+static uint8 g_profileCruiseDuty; /* Timer0 compare value at the cruise speed */
+static uint8 g_profileStep; /* current ramp step 0..DcMotor_RAMP_STEPS */
+static uint8 g_profileStepMsLeft; /* ms left before the next ramp step */
+static uint8 g_profileUpStepMs; /* duration of one ramp up step */
+static uint8 g_profileDownStepMs; /* duration of one ramp down step */
+static uint16 g_profileDownStartMs; /* remaining time at which the ramp down starts */
+static uint16 g_profileMsLeft; /* remaining time of the whole profile */
+
+/* Current monitor state, updated from the ADC ISR */
+static volatile DcMotor_FaultType g_fault = DcMotor_FAULT_NONE;
+static uint16 g_currentFiltered; /* filtered current in ADC counts << DcMotor_FILTER_SHIFT */
+static uint8 g_stallSamples; /* consecutive filtered samples above the stall limit */
+static uint8 g_overCurrentSamples; /* consecutive raw samples above the over-current limit */
+static volatile uint8 g_blankMsLeft; /* ms left before faults may be raised */
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+/*
+ * Converts a speed in percent to the Timer0 compare value (integer only, rounded)
+ */
+static uint8 DcMotor_speedToDuty(uint8 speed);
+
+/*
+ * Applies the duty of the current ramp step to the PWM
+ */
+static void DcMotor_applyRampStep(void);
+
+/*
+ * Filters one current sample and cuts the motor on a stall or an over-current,
+ * called from the ADC ISR
+ */
+static void DcMotor_currentSample(uint16 sample);
+
+/*
+ * Ends the running profile: stops the motor and the current sampling
+ */
+static void DcMotor_endProfile(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description :
+ * Initializes the motor module with connected h-bridge and its current sense ADC channel
+ */
+void DcMotor_init(void) {
+	ADC_ConfigType ADC_Config = { ADC_AVCC, ADC_Prescalar_128 };
+	/* F_CPU = 8Mhz -> ADC clock = 62.5Khz -> 13 clocks per sample = 208us per sample */
+	//Initializing motor pins to LOGIC_LOW (Stop motors from spinning) before they become outputs.
+	GPIO_writePinsMasked(DcMotor_PORT, DcMotor_PINS_MASK, 0);
+	//Configuring output pins.
+	GPIO_setupPinDirection(DcMotor_PORT, DcMotor_PIN, PIN_OUTPUT);
+	GPIO_setupPinDirection(DcMotor_PORT, (DcMotor_PIN + 1), PIN_OUTPUT);
+	g_motorState = STOP;
+	GPIO_setupPinDirection(PORTA_ID, DcMotor_SENSE_CHANNEL, PIN_INPUT);
+	ADC_init(&ADC_Config);
+	ADC_setCallBack(DcMotor_currentSample);
+	/* The current is only sampled while a profile runs */
+}
+
+
+/*
+ * Description :
+ * Changes the direction the motor is moving towards
+ * Both H-bridge inputs change in a single interrupt safe store, and a reversal
+ * always passes through STOP for DcMotor_DEAD_TIME_US so the two inputs are
+ * never high together and the bridge is never driven both ways.
+ */
+void DcMotor_Rotate(DcMotor_State state,uint8 speed){
+	uint8 inputs = 0;
+
+	switch (state) {
+	case STOP:
+		inputs = 0;
+		break;
+	case CW:
+		inputs = (1 << DcMotor_PIN);
+		break;
+	case A_CW:
+		inputs = (1 << (DcMotor_PIN + 1));
+		break;
+	}
+
+	if ((g_motorState != STOP) && (state != STOP) && (state != g_motorState)) {
+		/* Direction reversal: release the bridge first and wait the dead-time */
+		GPIO_writePinsMasked(DcMotor_PORT, DcMotor_PINS_MASK, 0);
+		_delay_us(DcMotor_DEAD_TIME_US);
+	}
+	GPIO_writePinsMasked(DcMotor_PORT, DcMotor_PINS_MASK, inputs);
+	g_motorState = state;
+
+	/*call the timer start function to provide the correct speed for the motor*/
+	PWM_Timer0_Start(DcMotor_speedToDuty(speed));
+}
+
+/*
+ * Description :
+ * Starts running a motion profile in the background, DcMotor_profileTick() must be
+ * called every 1ms. The profile is copied so it doesn't need to outlive the call.
+ * The motor current is sampled while the profile runs, a stall or over-current
+ * cuts the H-bridge from the ADC ISR and ends the profile with a fault.
+ */
+void DcMotor_startProfile(const DcMotor_ProfileType *profile) {
+	uint16 ramp_up_ms = profile->ramp_up_ms;
+	uint16 ramp_down_ms = profile->ramp_down_ms;
+
+	g_profilePhase = PROFILE_IDLE;
+	ADC_stop();
+	/* Freeze the tick and the current monitor while the profile is being loaded */
+	g_fault = DcMotor_FAULT_NONE;
+
+	if ((ramp_up_ms + ramp_down_ms) > profile->total_ms) {
+		/* Not enough time to reach the cruise speed, split the time between both ramps */
+		ramp_up_ms = profile->total_ms / 2;
+		ramp_down_ms = profile->total_ms - ramp_up_ms;
+	}
+	g_profileUpStepMs = (ramp_up_ms / DcMotor_RAMP_STEPS) ? (ramp_up_ms / DcMotor_RAMP_STEPS) : 1;
+	g_profileDownStepMs = (ramp_down_ms / DcMotor_RAMP_STEPS) ? (ramp_down_ms / DcMotor_RAMP_STEPS) : 1;
+	g_profileDownStartMs = ramp_down_ms;
+	g_profileMsLeft = profile->total_ms;
+	g_profileShape = profile->shape;
+	g_profileCruiseDuty = DcMotor_speedToDuty(profile->speed);
+
+	if (profile->total_ms == 0) {
+		DcMotor_Rotate(STOP, 0);
+		return;
+	}
+
+	g_currentFiltered = 0;
+	g_stallSamples = 0;
+	g_overCurrentSamples = 0;
+	g_blankMsLeft = DcMotor_INRUSH_BLANK_MS;
+	ADC_startFreeRunning(DcMotor_SENSE_CHANNEL);
+	/* Start monitoring the current, faults are blanked during the starting current */
+
+	if (ramp_up_ms == 0) {
+		/* No soft-start, start directly at the cruise speed */
+		g_profileStep = DcMotor_RAMP_STEPS;
+		DcMotor_Rotate(profile->direction, profile->speed);
+		g_profilePhase = PROFILE_CRUISE;
+	} else {
+		g_profileStep = 0;
+		g_profileStepMsLeft = g_profileUpStepMs;
+		DcMotor_Rotate(profile->direction, 0);
+		/* Apply the direction with 0% duty, the ramp raises it from the tick */
+		g_profilePhase = PROFILE_RAMP_UP;
+	}
+}
+
+/*
+ * Description :
+ * Advances the running motion profile by 1ms, to be called from the system tick ISR
+ */
+void DcMotor_profileTick(void) {
+	if (g_profilePhase == PROFILE_IDLE) {
+		return;
+	}
+
+	if (g_blankMsLeft != 0) {
+		g_blankMsLeft--;
+	}
+
+	g_profileMsLeft--;
+	if (g_profileMsLeft == 0) {
+		/* End of the motion */
+		DcMotor_endProfile();
+		return;
+	}
+
+	switch (g_profilePhase) {
+	case PROFILE_RAMP_UP:
+		g_profileStepMsLeft--;
+		if (g_profileStepMsLeft == 0) {
+			g_profileStepMsLeft = g_profileUpStepMs;
+			g_profileStep++;
+			DcMotor_applyRampStep();
+			if (g_profileStep == DcMotor_RAMP_STEPS) {
+				g_profilePhase = PROFILE_CRUISE;
+			}
+		}
+		break;
+	case PROFILE_CRUISE:
+		break;
+	case PROFILE_RAMP_DOWN:
+		g_profileStepMsLeft--;
+		if ((g_profileStepMsLeft == 0) && (g_profileStep != 0)) {
+			g_profileStepMsLeft = g_profileDownStepMs;
+			g_profileStep--;
+			DcMotor_applyRampStep();
+		}
+		break;
+	default:
+		break;
+	}
+
+	if ((g_profilePhase != PROFILE_RAMP_DOWN) && (g_profileMsLeft <= g_profileDownStartMs)) {
+		/* Start the soft-stop from wherever the ramp up reached */
+		g_profilePhase = PROFILE_RAMP_DOWN;
+		g_profileStepMsLeft = g_profileDownStepMs;
+	}
+}
+
+/*
+ * Description :
+ * Returns TRUE when no motion profile is running (finished or stopped)
+ */
+boolean DcMotor_isProfileDone(void) {
+	return (g_profilePhase == PROFILE_IDLE);
+}
+
+/*
+ * Description :
+ * Aborts the running motion profile and stops the motor immediately
+ */
+void DcMotor_stopProfile(void) {
+	DcMotor_endProfile();
+}
+
+/*
+ * Description :
+ * Returns the fault that aborted the last motion profile, DcMotor_FAULT_NONE if none
+ */
+DcMotor_FaultType DcMotor_getFault(void) {
+	return g_fault;
+}
+
+/*
+ * Description :
+ * Converts a speed in percent to the Timer0 compare value (integer only, rounded)
+ */
+static uint8 DcMotor_speedToDuty(uint8 speed) {
+	if (speed > 100) {
+		speed = 100;
+	}
+	return (uint8)((((uint16)speed * 255) + 50) / 100);
+}
+
+/*
+ * Description :
+ * Applies the duty of the current ramp step to the PWM
+ */
+static void DcMotor_applyRampStep(void) {
+	uint16 duty = (uint16)pgm_read_byte(&g_rampShapes[g_profileShape][g_profileStep]) * g_profileCruiseDuty;
+	PWM_Timer0_setDuty((uint8)((duty + 255) >> 8));
+	/* fraction (0..255) x cruise duty (0..255) / 256, rounded up so 255 x 255 gives 255 */
+}
+
+/*
+ * Description :
+ * Filters one current sample and cuts the motor on a stall or an over-current,
+ * called from the ADC ISR
+ */
+static void DcMotor_currentSample(uint16 sample) {
+	if (g_profilePhase == PROFILE_IDLE) {
+		return;
+	}
+
+	g_currentFiltered += sample - (g_currentFiltered >> DcMotor_FILTER_SHIFT);
+	/* filtered += (sample - filtered) / 8, kept scaled by 8 to avoid losing the fraction */
+	if (g_blankMsLeft != 0) {
+		return;
+	}
+
+	if (sample >= DcMotor_MA_TO_ADC(DcMotor_OVER_CURRENT_MA)) {
+		g_overCurrentSamples++;
+		if (g_overCurrentSamples >= DcMotor_OVER_CURRENT_SAMPLES) {
+			DcMotor_endProfile();
+			g_fault = DcMotor_FAULT_OVER_CURRENT;
+			return;
+		}
+	} else {
+		g_overCurrentSamples = 0;
+	}
+	/* Hard limit on the raw samples: a short or a locked rotor at full duty */
+
+	if ((g_currentFiltered >> DcMotor_FILTER_SHIFT) >= DcMotor_MA_TO_ADC(DcMotor_STALL_MA)) {
+		g_stallSamples++;
+		if (g_stallSamples >= DcMotor_STALL_SAMPLES) {
+			DcMotor_endProfile();
+			g_fault = DcMotor_FAULT_STALL;
+		}
+	} else {
+		g_stallSamples = 0;
+	}
+	/* Stall limit on the filtered current: the door is jammed */
+}
+
+/*
+ * Description :
+ * Ends the running profile: stops the motor and the current sampling
+ */
+static void DcMotor_endProfile(void) {
+	g_profilePhase = PROFILE_IDLE;
+	DcMotor_Rotate(STOP, 0);
+	ADC_stop();
+}
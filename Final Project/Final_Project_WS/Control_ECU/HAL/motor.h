@@ -1,44 +1,123 @@
- /******************************************************************************
- *
- * Module: MOTOR
- *
- * File Name: motor.h
- *
- * Description: Header file for the AVR MOTOR driver
- *
- * Author: Yousouf Soliman
- *
- *******************************************************************************/
-#ifndef MOTOR_H_
-#define MOTOR_H_
-
-/*******************************************************************************
- *                                Definitions                                  *
- *******************************************************************************/
-#include "../UTIL/std_types.h"
-#define DcMotor_PORT PORTC_ID
-#define DcMotor_PIN PIN2_ID
-/*******************************************************************************
- *                               Types Declaration                             *
- *******************************************************************************/
-typedef enum{
-	STOP,CW,A_CW
-}DcMotor_State;
-/*type definition for rotation directions of the Dc Motor*/
-/*******************************************************************************
- *                              Functions Prototypes                           *
- *******************************************************************************/
-
-/*
- * Description :
- * Initializes the motor module with connected h-bridge
- */
-void DcMotor_init(void);
-
-/*
- * Description :
- * Changes the direction the motor is moving towards
- */
-void DcMotor_Rotate(DcMotor_State state,uint8 speed);
-
-#endif /* MOTOR_H_ */
+ /******************************************************************************
+ *
+ * Module: MOTOR
+ *
+ * File Name: motor.h
+ *
+ * Description: Header file for the AVR MOTOR driver
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#ifndef MOTOR_H_
+#define MOTOR_H_
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#include "../UTIL/std_types.h"
+#define DcMotor_PORT PORTC_ID
+#define DcMotor_PIN PIN2_ID
+/* The two H-bridge inputs are DcMotor_PIN and DcMotor_PIN+1 */
+#define DcMotor_PINS_MASK (0x03 << DcMotor_PIN)
+#define DcMotor_DEAD_TIME_US 50
+/* Both H-bridge inputs are held low for this time when the direction is reversed */
+#define DcMotor_RAMP_STEPS 32
+/* Number of duty steps of a soft-start/soft-stop ramp */
+
+#define DcMotor_SENSE_CHANNEL 1
+/* Voltage across the current shunt on ADC1/PA1, AVCC reference */
+#define DcMotor_SHUNT_MILLIOHM 500
+#define DcMotor_ADC_REF_MV 5000
+#define DcMotor_MA_TO_ADC(ma) ((uint16)(((uint32)(ma) * DcMotor_SHUNT_MILLIOHM * 1024UL) / (1000UL * DcMotor_ADC_REF_MV)))
+/* Motor current in mA to ADC counts, evaluated at compile time */
+#define DcMotor_STALL_MA 1500
+#define DcMotor_STALL_SAMPLES 4
+/* Stall: the filtered current stays above the limit for this many samples */
+#define DcMotor_OVER_CURRENT_MA 3000
+#define DcMotor_OVER_CURRENT_SAMPLES 2
+/* Over-current: the raw current is above the hard limit for this many samples */
+#define DcMotor_FILTER_SHIFT 3
+/* Exponential moving average with a weight of 1/8 for each new sample */
+#define DcMotor_INRUSH_BLANK_MS 100
+/* No fault is raised during the first ms of a motion (starting current) */
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef enum{
+	STOP,CW,A_CW
+}DcMotor_State;
+/*type definition for rotation directions of the Dc Motor*/
+
+typedef enum{
+	DcMotor_RAMP_TRAPEZOIDAL, DcMotor_RAMP_S_CURVE
+}DcMotor_RampShape;
+/*type definition for the shape of the soft-start/soft-stop ramps*/
+
+typedef struct{
+	DcMotor_State direction;
+	uint8 speed; /* cruise speed in percent */
+	DcMotor_RampShape shape;
+	uint16 ramp_up_ms; /* soft-start time from 0 to the cruise speed */
+	uint16 ramp_down_ms; /* soft-stop time from the cruise speed to 0 */
+	uint16 total_ms; /* whole motion time including both ramps */
+}DcMotor_ProfileType;
+/*type definition for a motion profile: ramp up, cruise, ramp down then STOP*/
+
+typedef enum{
+	DcMotor_FAULT_NONE, DcMotor_FAULT_STALL, DcMotor_FAULT_OVER_CURRENT
+}DcMotor_FaultType;
+/*type definition for the reason a motion profile was aborted by the current monitor*/
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Initializes the motor module with connected h-bridge and its current sense ADC channel
+ */
+void DcMotor_init(void);
+
+/*
+ * Description :
+ * Changes the direction the motor is moving towards
+ * Both H-bridge inputs change in a single interrupt safe store, and a reversal
+ * always passes through STOP for DcMotor_DEAD_TIME_US so the two inputs are
+ * never high together and the bridge is never driven both ways.
+ */
+void DcMotor_Rotate(DcMotor_State state,uint8 speed);
+
+/*
+ * Description :
+ * Starts running a motion profile in the background, DcMotor_profileTick() must be
+ * called every 1ms. The profile is copied so it doesn't need to outlive the call.
+ * The motor current is sampled while the profile runs, a stall or over-current
+ * cuts the H-bridge from the ADC ISR and ends the profile with a fault.
+ */
+void DcMotor_startProfile(const DcMotor_ProfileType *profile);
+
+/*
+ * Description :
+ * Advances the running motion profile by 1ms, to be called from the system tick ISR
+ */
+void DcMotor_profileTick(void);
+
+/*
+ * Description :
+ * Returns TRUE when no motion profile is running (finished or stopped)
+ */
+boolean DcMotor_isProfileDone(void);
+
+/*
+ * Description :
+ * Aborts the running motion profile and stops the motor immediately
+ */
+void DcMotor_stopProfile(void);
+
+/*
+ * Description :
+ * Returns the fault that aborted the last motion profile, DcMotor_FAULT_NONE if none
+ */
+DcMotor_FaultType DcMotor_getFault(void);
+
+#endif /* MOTOR_H_ */
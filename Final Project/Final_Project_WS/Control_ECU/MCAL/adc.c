@@ -0,0 +1,100 @@
+ /******************************************************************************
+ *
+ * Module: ADC
+ *
+ * File Name: adc.c
+ *
+ * Description: Source file for the AVR ADC driver
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "adc.h"
+#include "avr/io.h" /* To use the ADC Registers */
+#include <avr/interrupt.h> /* For ADC ISR */
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Global variable to hold the address of the call back function in the application */
+static void (*volatile g_adcCallBackPtr)(uint16) = NULL_PTR;
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+ISR(ADC_vect)
+{
+	if(g_adcCallBackPtr != NULL_PTR)
+	{
+		/* Call the Call Back function in the application with the conversion result */
+		(*g_adcCallBackPtr)(ADC);
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description : Function to initialize the ADC driver
+ * 	1. Set the required reference voltage.
+ * 	2. Set the required prescalar.
+ * 	3. Enable the ADC, no conversion is started.
+ */
+void ADC_init(const ADC_ConfigType *Config_Ptr) {
+	ADMUX = ((Config_Ptr->ref_volt) & 0x03) << REFS0;
+	/* Insert the reference voltage in REFS1:REFS0, right adjusted result, channel 0 */
+	ADCSRA = (1 << ADEN) | ((Config_Ptr->prescalar) & 0x07);
+	/* Enable the ADC and insert the required prescalar in ADPS2:ADPS0 */
+}
+
+/*
+ * Description : Function to start converting the required channel (0..7) back to back
+ * 	in free running mode, each result is passed to the call back function from the ISR.
+ */
+void ADC_startFreeRunning(uint8 channel_num) {
+	ADMUX = (ADMUX & 0xE0) | (channel_num & 0x07);
+	/* Insert the channel number in MUX4:MUX0 (single ended input) */
+	SFIOR &= 0x1F;
+	/* Auto trigger source: free running mode ADTS2:ADTS0 = 000 */
+	ADCSRA |= (1 << ADIF) | (1 << ADATE) | (1 << ADIE);
+	/* Clear any old result flag, enable auto triggering and the conversion complete interrupt */
+	ADCSRA |= (1 << ADSC);
+	/* Start the first conversion, the next ones start by themselves */
+}
+
+/*
+ * Description : Function to stop the free running conversions
+ * 	The conversion in progress (if any) completes but its result is discarded.
+ */
+void ADC_stop(void) {
+	ADCSRA &= ~((1 << ADATE) | (1 << ADIE));
+	/* No more auto triggering and no more interrupts */
+	ADCSRA |= (1 << ADIF);
+	/* Discard a result that may be pending (written one to clear) */
+}
+
+/*
+ * Description : Function to convert the required channel (0..7 or ADC_CHANNEL_BANDGAP) once
+ * 	and return the result, it waits for the end of the conversion. Not while free running.
+ */
+uint16 ADC_readChannel(uint8 channel_num) {
+	ADMUX = (ADMUX & 0xE0) | (channel_num & 0x1F);
+	/* Insert the channel number in MUX4:MUX0 */
+	ADCSRA |= (1 << ADSC);
+	/* Start one conversion, the interrupt is disabled out of the free running mode */
+	while (ADCSRA & (1 << ADSC)) {
+	}
+	/* ADSC is cleared at the end of the conversion */
+	return ADC;
+}
+
+/*
+ * Description: Function to set the Call Back function address, called with each result.
+ */
+void ADC_setCallBack(void(*a_ptr)(uint16)) {
+	/* Save the address of the Call back function in a global variable */
+	g_adcCallBackPtr = a_ptr;
+}
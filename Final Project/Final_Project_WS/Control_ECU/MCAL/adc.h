@@ -0,0 +1,76 @@
+ /******************************************************************************
+ *
+ * Module: ADC
+ *
+ * File Name: adc.h
+ *
+ * Description: Header file for the AVR ADC driver
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef ADC_H_
+#define ADC_H_
+
+#include "../UTIL/std_types.h"
+
+/*******************************************************************************
+ *                            Definitions                                      *
+ *******************************************************************************/
+#define ADC_MAXIMUM_VALUE 1023
+#define ADC_CONVERSION_CLOCKS 13 /* ADC clocks per free running conversion */
+#define ADC_CHANNEL_BANDGAP 0x1E /* Internal 1.22V bandgap reference (MUX4:0 = 11110) */
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef enum{
+	ADC_AREF, ADC_AVCC, ADC_INTERNAL_2_56 = 3
+}ADC_ReferenceVoltage;
+
+typedef enum{
+	ADC_Prescalar_2 = 1, ADC_Prescalar_4, ADC_Prescalar_8, ADC_Prescalar_16, ADC_Prescalar_32, ADC_Prescalar_64, ADC_Prescalar_128
+}ADC_Prescalar;
+
+typedef struct{
+	ADC_ReferenceVoltage ref_volt;
+	ADC_Prescalar prescalar;
+}ADC_ConfigType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description : Function to initialize the ADC driver
+ * 	1. Set the required reference voltage.
+ * 	2. Set the required prescalar.
+ * 	3. Enable the ADC, no conversion is started.
+ */
+void ADC_init(const ADC_ConfigType *Config_Ptr);
+
+/*
+ * Description : Function to start converting the required channel (0..7) back to back
+ * 	in free running mode, each result is passed to the call back function from the ISR.
+ */
+void ADC_startFreeRunning(uint8 channel_num);
+
+/*
+ * Description : Function to stop the free running conversions
+ * 	The conversion in progress (if any) completes but its result is discarded.
+ */
+void ADC_stop(void);
+
+/*
+ * Description : Function to convert the required channel (0..7 or ADC_CHANNEL_BANDGAP) once
+ * 	and return the result, it waits for the end of the conversion. Not while free running.
+ */
+uint16 ADC_readChannel(uint8 channel_num);
+
+/*
+ * Description: Function to set the Call Back function address, called with each result.
+ */
+void ADC_setCallBack(void(*a_ptr)(uint16));
+
+#endif /* ADC_H_ */
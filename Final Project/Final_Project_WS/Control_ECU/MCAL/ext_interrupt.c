@@ -0,0 +1,102 @@
+ /******************************************************************************
+ *
+ * Module: External Interrupts
+ *
+ * File Name: ext_interrupt.c
+ *
+ * Description: Source file for the AVR External Interrupts (INT0/INT1) driver
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "ext_interrupt.h"
+#include <avr/interrupt.h> /* For INT0/INT1 ISRs */
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Global variables to hold the addresses of the call back functions in the application */
+static void (*volatile g_int0CallBackPtr)(void) = NULL_PTR;
+static void (*volatile g_int1CallBackPtr)(void) = NULL_PTR;
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+ISR(INT0_vect)
+{
+	if(g_int0CallBackPtr != NULL_PTR)
+	{
+		/* Call the Call Back function in the application after the edge is detected */
+		(*g_int0CallBackPtr)();
+	}
+}
+
+ISR(INT1_vect)
+{
+	if(g_int1CallBackPtr != NULL_PTR)
+	{
+		/* Call the Call Back function in the application after the edge is detected */
+		(*g_int1CallBackPtr)();
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description : Function to initialize an external interrupt
+ * 	1. Set the interrupt pin as input (with or without pull-up).
+ * 	2. Set the required sense control.
+ * 	3. Clear any pending flag and enable the interrupt.
+ */
+void EXT_INT_init(const EXT_INT_ConfigType *Config_Ptr) {
+	if (Config_Ptr->id == EXT_INT0) {
+		GPIO_setupPinDirection(EXT_INT0_PORT_ID, EXT_INT0_PIN_ID, PIN_INPUT);
+		GPIO_writePin(EXT_INT0_PORT_ID, EXT_INT0_PIN_ID, Config_Ptr->pull_up);
+		/* INT0 pin as input, enable/disable the internal pull-up */
+		MCUCR = (MCUCR & 0xFC) | ((Config_Ptr->sense) & 0x03);
+		/* Insert the required sense control in ISC01:ISC00 */
+		GIFR = (1 << INTF0);
+		/* Clear any edge detected before the configuration (written one to clear) */
+		GICR |= (1 << INT0);
+		/* Enable external interrupt request 0 */
+	} else {
+		GPIO_setupPinDirection(EXT_INT1_PORT_ID, EXT_INT1_PIN_ID, PIN_INPUT);
+		GPIO_writePin(EXT_INT1_PORT_ID, EXT_INT1_PIN_ID, Config_Ptr->pull_up);
+		/* INT1 pin as input, enable/disable the internal pull-up */
+		MCUCR = (MCUCR & 0xF3) | (((Config_Ptr->sense) & 0x03) << ISC10);
+		/* Insert the required sense control in ISC11:ISC10 */
+		GIFR = (1 << INTF1);
+		/* Clear any edge detected before the configuration (written one to clear) */
+		GICR |= (1 << INT1);
+		/* Enable external interrupt request 1 */
+	}
+}
+
+/*
+ * Description: Function to disable an external interrupt
+ */
+void EXT_INT_deInit(EXT_INT_Id id) {
+	if (id == EXT_INT0) {
+		GICR &= ~(1 << INT0);
+		g_int0CallBackPtr = NULL_PTR;
+	} else {
+		GICR &= ~(1 << INT1);
+		g_int1CallBackPtr = NULL_PTR;
+	}
+}
+
+/*
+ * Description: Function to set the Call Back function address of an external interrupt.
+ */
+void EXT_INT_setCallBack(EXT_INT_Id id, void(*a_ptr)(void)) {
+	/* Save the address of the Call back function in a global variable */
+	if (id == EXT_INT0) {
+		g_int0CallBackPtr = a_ptr;
+	} else {
+		g_int1CallBackPtr = a_ptr;
+	}
+}
@@ -0,0 +1,66 @@
+ /******************************************************************************
+ *
+ * Module: External Interrupts
+ *
+ * File Name: ext_interrupt.h
+ *
+ * Description: Header file for the AVR External Interrupts (INT0/INT1) driver
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef EXT_INTERRUPT_H_
+#define EXT_INTERRUPT_H_
+
+#include "../UTIL/std_types.h"
+#include "gpio.h"
+
+/*******************************************************************************
+ *                            Definitions                                      *
+ *******************************************************************************/
+#define EXT_INT0_PORT_ID PORTD_ID
+#define EXT_INT0_PIN_ID PIN2_ID
+#define EXT_INT1_PORT_ID PORTD_ID
+#define EXT_INT1_PIN_ID PIN3_ID
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef enum{
+	EXT_INT0, EXT_INT1
+}EXT_INT_Id;
+
+typedef enum{
+	EXT_INT_LowLevel, EXT_INT_AnyChange, EXT_INT_FallingEdge, EXT_INT_RisingEdge
+}EXT_INT_Sense;
+
+typedef struct{
+	EXT_INT_Id id;
+	EXT_INT_Sense sense;
+	uint8 pull_up; /* LOGIC_HIGH to enable the internal pull-up on the interrupt pin */
+}EXT_INT_ConfigType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description : Function to initialize an external interrupt
+ * 	1. Set the interrupt pin as input (with or without pull-up).
+ * 	2. Set the required sense control.
+ * 	3. Clear any pending flag and enable the interrupt.
+ */
+void EXT_INT_init(const EXT_INT_ConfigType *Config_Ptr);
+
+/*
+ * Description: Function to disable an external interrupt
+ */
+void EXT_INT_deInit(EXT_INT_Id id);
+
+/*
+ * Description: Function to set the Call Back function address of an external interrupt.
+ */
+void EXT_INT_setCallBack(EXT_INT_Id id, void(*a_ptr)(void));
+
+#endif /* EXT_INTERRUPT_H_ */
@@ -0,0 +1,250 @@
+ /******************************************************************************
+ *
+ * Module: Ascon
+ *
+ * File Name: ascon.c
+ *
+ * Description: Source file for the Ascon-128 authenticated encryption used on the UART link
+ *              (NIST lightweight cryptography, Ascon v1.2: 64-bit rate, 12/6 rounds)
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#include "ascon.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define ASCON_128_IV                     0x80400c0600000000ULL
+#define ASCON_RATE                       8
+#define ASCON_ROUNDS_A                   12
+#define ASCON_ROUNDS_B                   6
+
+#define ASCON_ROTR(x,n)                  (((x) >> (n)) | ((x) << (64 - (n))))
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	uint64 x[5];
+}ASCON_StateType;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Function responsible for applying the last required number of rounds of the permutation
+ */
+static void ASCON_permute(ASCON_StateType *s, uint8 rounds);
+
+/*
+ * Function responsible for loading length (0..8) bytes as a big endian word
+ */
+static uint64 ASCON_load(const uint8 *bytes, uint8 length);
+
+/*
+ * Function responsible for storing length (0..8) bytes of a big endian word
+ */
+static void ASCON_store(uint8 *bytes, uint64 word, uint8 length);
+
+/*
+ * Function responsible for the initialization and the associated data phases
+ */
+static void ASCON_start(ASCON_StateType *s, const uint8 *key, const uint8 *nonce, const uint8 *ad, uint8 ad_length);
+
+/*
+ * Function responsible for the finalization phase, writes the full tag
+ */
+static void ASCON_finish(ASCON_StateType *s, const uint8 *key, uint8 *tag);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Encrypt length bytes of input to output and write the first tag_length bytes of the tag.
+ * The associated data is authenticated but not encrypted. input and output may be the same buffer.
+ */
+void ASCON_encrypt(const uint8 *key, const uint8 *nonce, const uint8 *ad, uint8 ad_length,
+		const uint8 *input, uint8 *output, uint8 length, uint8 *tag, uint8 tag_length)
+{
+	ASCON_StateType s;
+	uint8 full_tag[ASCON_TAG_SIZE];
+	uint8 i;
+
+	ASCON_start(&s, key, nonce, ad, ad_length);
+	while(length >= ASCON_RATE)
+	{
+		s.x[0] ^= ASCON_load(input, ASCON_RATE);
+		ASCON_store(output, s.x[0], ASCON_RATE);
+		ASCON_permute(&s, ASCON_ROUNDS_B);
+		input += ASCON_RATE;
+		output += ASCON_RATE;
+		length -= ASCON_RATE;
+	}
+	s.x[0] ^= ASCON_load(input, length);
+	s.x[0] ^= 0x80ULL << (56 - 8 * length);
+	ASCON_store(output, s.x[0], length);
+	/* Last block, padded with 0x80 then zeros */
+
+	ASCON_finish(&s, key, full_tag);
+	for(i = 0; i < tag_length; i++)
+	{
+		tag[i] = full_tag[i];
+	}
+}
+
+/*
+ * Description :
+ * Decrypt length bytes of input to output and check the first tag_length bytes of the tag
+ * in constant time. Returns FALSE if the message or its associated data were modified,
+ * the output must not be used then. input and output may be the same buffer.
+ */
+boolean ASCON_decrypt(const uint8 *key, const uint8 *nonce, const uint8 *ad, uint8 ad_length,
+		const uint8 *input, uint8 *output, uint8 length, const uint8 *tag, uint8 tag_length)
+{
+	ASCON_StateType s;
+	uint8 full_tag[ASCON_TAG_SIZE];
+	uint64 c;
+	uint64 mask;
+	uint8 diff = 0;
+	uint8 i;
+
+	ASCON_start(&s, key, nonce, ad, ad_length);
+	while(length >= ASCON_RATE)
+	{
+		c = ASCON_load(input, ASCON_RATE);
+		ASCON_store(output, s.x[0] ^ c, ASCON_RATE);
+		s.x[0] = c;
+		ASCON_permute(&s, ASCON_ROUNDS_B);
+		input += ASCON_RATE;
+		output += ASCON_RATE;
+		length -= ASCON_RATE;
+	}
+	c = ASCON_load(input, length);
+	ASCON_store(output, s.x[0] ^ c, length);
+	mask = (length == 0) ? 0 : (~0ULL << (64 - 8 * length));
+	s.x[0] = (s.x[0] & ~mask) | c;
+	s.x[0] ^= 0x80ULL << (56 - 8 * length);
+	/* The state takes the ciphertext bytes, then the padding */
+
+	ASCON_finish(&s, key, full_tag);
+	for(i = 0; i < tag_length; i++)
+	{
+		diff |= full_tag[i] ^ tag[i];
+	}
+	/* All the tag bytes are compared whatever the result */
+	return (diff == 0);
+}
+
+/*
+ * Description :
+ * Initialization: IV, key and nonce then 12 rounds, then the associated data
+ * absorbed 8 bytes per 6 rounds, then the domain separation bit
+ */
+static void ASCON_start(ASCON_StateType *s, const uint8 *key, const uint8 *nonce, const uint8 *ad, uint8 ad_length)
+{
+	uint64 k0 = ASCON_load(key, 8);
+	uint64 k1 = ASCON_load(key + 8, 8);
+
+	s->x[0] = ASCON_128_IV;
+	s->x[1] = k0;
+	s->x[2] = k1;
+	s->x[3] = ASCON_load(nonce, 8);
+	s->x[4] = ASCON_load(nonce + 8, 8);
+	ASCON_permute(s, ASCON_ROUNDS_A);
+	s->x[3] ^= k0;
+	s->x[4] ^= k1;
+
+	if(ad_length != 0)
+	{
+		while(ad_length >= ASCON_RATE)
+		{
+			s->x[0] ^= ASCON_load(ad, ASCON_RATE);
+			ASCON_permute(s, ASCON_ROUNDS_B);
+			ad += ASCON_RATE;
+			ad_length -= ASCON_RATE;
+		}
+		s->x[0] ^= ASCON_load(ad, ad_length);
+		s->x[0] ^= 0x80ULL << (56 - 8 * ad_length);
+		ASCON_permute(s, ASCON_ROUNDS_B);
+	}
+	s->x[4] ^= 1;
+}
+
+/*
+ * Description :
+ * Finalization: key added, 12 rounds, the tag is the last 128 bits xor the key
+ */
+static void ASCON_finish(ASCON_StateType *s, const uint8 *key, uint8 *tag)
+{
+	uint64 k0 = ASCON_load(key, 8);
+	uint64 k1 = ASCON_load(key + 8, 8);
+
+	s->x[1] ^= k0;
+	s->x[2] ^= k1;
+	ASCON_permute(s, ASCON_ROUNDS_A);
+	ASCON_store(tag, s->x[3] ^ k0, 8);
+	ASCON_store(tag + 8, s->x[4] ^ k1, 8);
+}
+
+/*
+ * Description :
+ * Apply the last required number of rounds of the 12 rounds permutation:
+ * constant addition, 5-bit S-box on the bit slices, then the linear diffusion
+ */
+static void ASCON_permute(ASCON_StateType *s, uint8 rounds)
+{
+	uint64 x0 = s->x[0], x1 = s->x[1], x2 = s->x[2], x3 = s->x[3], x4 = s->x[4];
+	uint64 t0, t1, t2, t3, t4;
+	uint8 round;
+
+	for(round = ASCON_ROUNDS_A - rounds; round < ASCON_ROUNDS_A; round++)
+	{
+		x2 ^= (uint64)(((0x0F - round) << 4) | round);
+
+		x0 ^= x4; x4 ^= x3; x2 ^= x1;
+		t0 = ~x0 & x1; t1 = ~x1 & x2; t2 = ~x2 & x3; t3 = ~x3 & x4; t4 = ~x4 & x0;
+		x0 ^= t1; x1 ^= t2; x2 ^= t3; x3 ^= t4; x4 ^= t0;
+		x1 ^= x0; x0 ^= x4; x3 ^= x2; x2 = ~x2;
+
+		x0 ^= ASCON_ROTR(x0, 19) ^ ASCON_ROTR(x0, 28);
+		x1 ^= ASCON_ROTR(x1, 61) ^ ASCON_ROTR(x1, 39);
+		x2 ^= ASCON_ROTR(x2, 1) ^ ASCON_ROTR(x2, 6);
+		x3 ^= ASCON_ROTR(x3, 10) ^ ASCON_ROTR(x3, 17);
+		x4 ^= ASCON_ROTR(x4, 7) ^ ASCON_ROTR(x4, 41);
+	}
+
+	s->x[0] = x0; s->x[1] = x1; s->x[2] = x2; s->x[3] = x3; s->x[4] = x4;
+}
+
+/*
+ * Description :
+ * Load length (0..8) bytes as the high bytes of a big endian word, the others are 0
+ */
+static uint64 ASCON_load(const uint8 *bytes, uint8 length)
+{
+	uint64 word = 0;
+	uint8 i;
+	for(i = 0; i < length; i++)
+	{
+		word |= (uint64)bytes[i] << (56 - 8 * i);
+	}
+	return word;
+}
+
+/*
+ * Description :
+ * Store the length (0..8) high bytes of a big endian word
+ */
+static void ASCON_store(uint8 *bytes, uint64 word, uint8 length)
+{
+	uint8 i;
+	for(i = 0; i < length; i++)
+	{
+		bytes[i] = (uint8)(word >> (56 - 8 * i));
+	}
+}
@@ -1,25 +1,88 @@
- /******************************************************************************
- *
- * Module: Common - Platform Types Abstraction
- *
- * File Name: communication commands.h
- *
- * Description: Communication Commands Document
- *
- * Author: Yousouf Soliman
- *
- *******************************************************************************/
-#ifndef UTIL_COMMUNICATION_COMMANDS_H_
-#define UTIL_COMMUNICATION_COMMANDS_H_
-
-#define PASSWORD_LENGTH 5
-#define CONTROL_ECU_READY 0x10
-#define HMI_ECU_READY 0x01
-#define PASSWORDS_MATCHED 0x0F
-#define PASSWORDS_UNMATCHED 0xF0
-#define SET_PASSWORD 0x33
-#define CHECK_PASSWORD 0x25
-#define UNLOCK_DOOR 0xCC
-#define ALARM 0x22
-
-#endif /* UTIL_COMMUNICATION_COMMANDS_H_ */
+ /******************************************************************************
+ *
+ * Module: Common - Platform Types Abstraction
+ *
+ * File Name: communication commands.h
+ *
+ * Description: Communication Commands Document
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#ifndef UTIL_COMMUNICATION_COMMANDS_H_
+#define UTIL_COMMUNICATION_COMMANDS_H_
+
+#define PASSWORD_LENGTH 5
+#define CONTROL_ECU_READY 0x10
+#define HMI_ECU_READY 0x01
+#define PASSWORDS_MATCHED 0x0F
+#define PASSWORDS_UNMATCHED 0xF0
+#define ATTEMPTS_LOCKED 0x4C /* Check refused or wrong password during a lockout, followed by the seconds left (2 bytes, big endian) */
+#define SET_PASSWORD 0x33
+#define PASSWORD_CHANGE_REFUSED 0x7A /* SET_PASSWORD refused: a password is set and it wasn't checked just before */
+#define GET_PASSWORD_STATE 0x77 /* Control ECU answers PASSWORD_IS_SET or PASSWORD_NOT_SET */
+#define PASSWORD_IS_SET 0x78
+#define PASSWORD_NOT_SET 0x79 /* New product: the first SET_PASSWORD needs no check */
+#define CHECK_PASSWORD 0x25
+#define UNLOCK_DOOR 0xCC
+#define ALARM 0x22
+#define GET_STATUS 0x47 /* Control ECU answers with one STATUS_xxx byte */
+#define ABORT 0xAB /* Stop the door cycle where it is and the alarm */
+#define STREAM_CHECK_START 0x5C /* Start checking a password typed digit by digit */
+#define STREAM_CHECK_DIGIT 0x5D /* Followed by one typed digit */
+#define STREAM_CHECK_FINISH 0x5E /* Control ECU answers PASSWORDS_MATCHED, PASSWORDS_UNMATCHED or ATTEMPTS_LOCKED */
+#define SET_TIME 0x71 /* Followed by the Unix time (4 bytes, big endian) for the one-time codes, sent by the provisioning tool */
+#define GET_CONFIG 0x6C /* Control ECU answers CONFIG_REPORT */
+#define SET_CONFIG 0x6E /* Followed by a new config, Control ECU answers CONFIG_REPORT or CONFIG_REJECTED */
+#define CONFIG_REPORT 0x6D /* Followed by the config in use, also sent by Control ECU at its boot */
+#define CONFIG_REJECTED 0x6F /* SET_CONFIG refused: other version or a value out of range */
+#define GET_STACK 0x73 /* Control ECU answers STACK_REPORT */
+#define STACK_REPORT 0x74 /* Followed by the stack report of Control ECU (STACK_REPORT_SIZE bytes) */
+#define GET_LATENCY 0x75 /* Control ECU answers one LATENCY_REPORT per instrumented ISR (ISR_LATENCY builds) */
+#define LATENCY_REPORT 0x76 /* Followed by the latency stats of one ISR of Control ECU (LATENCY_REPORT_SIZE bytes) */
+#define DOOR_MOTION_DONE 0x3C /* End-of-travel switch reached, followed by the travel time byte */
+#define DOOR_MOTION_TIMEOUT 0xC3 /* Fault: switch not reached in time, followed by the travel time byte */
+#define DOOR_MOTION_STALL 0x5A /* Fault: motor stalled (door jammed), followed by the travel time byte */
+#define DOOR_MOTION_OVER_CURRENT 0xA5 /* Fault: motor over-current, followed by the travel time byte */
+#define DOOR_MOTION_ABORTED 0x69 /* Stopped by an ABORT command, followed by the travel time byte */
+#define DOOR_TRAVEL_TIME_UNIT_MS 100 /* Resolution of the reported travel time */
+#define STATUS_IDLE 0x50
+#define STATUS_OPENING 0x51
+#define STATUS_HOLD 0x52
+#define STATUS_CLOSING 0x53
+#define STATUS_ALARM 0x54
+
+/* Config layout on the link (CONFIG_SIZE bytes, 16-bit values big endian) */
+#define CONFIG_VERSION 1
+#define CONFIG_SIZE 13
+#define CONFIG_VERSION_OFFSET 0
+#define CONFIG_MOTION_TIME_OFFSET 1 /* Door motion fault timeout in ms */
+#define CONFIG_RAMP_TIME_OFFSET 3 /* Door motor soft-start and soft-stop time in ms */
+#define CONFIG_HOLD_TIME_OFFSET 5 /* Time the door is held open in ms */
+#define CONFIG_ALARM_TIME_OFFSET 7 /* Longest alarm time in ms */
+#define CONFIG_MOTOR_SPEED_OFFSET 9 /* Door motor cruise speed in percent */
+#define CONFIG_FREE_ATTEMPTS_OFFSET 10 /* Password attempts before the first lockout */
+#define CONFIG_LOCKOUT_TIME_OFFSET 11 /* First lockout time in seconds */
+
+/* Stack report layout on the link (STACK_REPORT_SIZE bytes, 16-bit values big endian) */
+#define STACK_REPORT_SIZE 7
+#define STACK_CURRENT_OFFSET 0 /* Stack bytes used now */
+#define STACK_PEAK_OFFSET 2 /* Most stack bytes used since the boot */
+#define STACK_FREE_OFFSET 4 /* Bytes the stack never used before reaching .bss */
+#define STACK_CANARY_OFFSET 6 /* 1 while the canary after .bss is intact, 0 once the stack overwrote it */
+
+/* ISR latency report layout on the link (LATENCY_REPORT_SIZE bytes, 16-bit values big endian) */
+#define LATENCY_REPORT_SIZE 25
+#define LATENCY_VECTOR_OFFSET 0 /* ISRLAT_xxx vector */
+#define LATENCY_MIN_OFFSET 1 /* Latencies in us */
+#define LATENCY_MAX_OFFSET 3
+#define LATENCY_COUNT_OFFSET 5 /* Entries measured */
+#define LATENCY_RESYNCS_OFFSET 7 /* Entries a period late or more */
+#define LATENCY_BUCKETS_OFFSET 9 /* 8 histogram buckets: under 4us, 8us, ... 256us, then 256us or more */
+
+/* Link baud rate of both ECUs (UART_BaudRate), the host build can set another one */
+#ifndef LINK_BAUD_RATE
+#define LINK_BAUD_RATE BaudRate_9600
+#endif
+
+#endif /* UTIL_COMMUNICATION_COMMANDS_H_ */
@@ -0,0 +1,138 @@
+ /******************************************************************************
+ *
+ * Module: ISR Latency
+ *
+ * File Name: isr_latency.h
+ *
+ * Description: Header file for the interrupt latency instrumentation: the entry
+ *              of the instrumented ISRs is timestamped on a free-running Timer1
+ *              and compared with the time of its event, per vector min, max and
+ *              histogram are kept in RAM
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef ISR_LATENCY_H_
+#define ISR_LATENCY_H_
+
+#include "std_types.h"
+
+/*#define ISR_LATENCY*/
+/* Define it to build the instrumentation in (or make -C Host ISR_LATENCY=1). Without it the
+ * hooks expand to nothing and the module has no code and no RAM. Timer1 is taken as the
+ * time base: it cannot be used by the application (nor by the benchmarks) at the same time. */
+
+/*
+ * Timer1 runs free with a 1us tick and its overflow interrupt enabled. Latencies are
+ * taken at the hook, after the ISR prologue, and are in us:
+ *
+ * - TIMER1_OVF  : the overflow is at count 0, so the latency is TCNT1 at the entry.
+ * - TIMER2_COMP : the 1ms system tick, expected one period after the previous one.
+ * - USART_RXC   : the frames of a link frame come back to back, one frame time apart.
+ *                 A gap longer than a frame starts a new burst, its first byte is not
+ *                 measured. A sender pausing for less than a frame reads as latency.
+ *
+ * The periodic vectors measure against their earliest entry (the expected time moves
+ * back if an entry comes earlier than it), so their latency does not include the fixed
+ * part the earliest entry had: it is the jitter over it.
+ * The TWI driver polls TWINT with the interrupts enabled: it has no ISR to measure and
+ * it cannot delay the ones above.
+ */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define ISRLAT_TIMER1_OVF                0
+#define ISRLAT_TIMER2_COMP               1
+#define ISRLAT_USART_RXC                 2
+#define ISRLAT_VECTORS_NUM               3
+
+#define ISRLAT_BUCKETS_NUM               8
+/* Bucket 0 is under 4us, bucket i under 2^(i+2)us, the last one is 256us or more */
+#define ISRLAT_TICK_PERIOD_US            1000  /* Timer2 1ms system tick of both ECUs */
+
+#if (F_CPU == 8000000UL)
+#define ISRLAT_TIMER1_PRESCALAR          Prescalar_8
+#elif (F_CPU == 1000000UL)
+#define ISRLAT_TIMER1_PRESCALAR          Prescalar_noPrescalar
+#endif
+#define ISRLAT_CYCLES_TO_US(cycles)      ((cycles) / (F_CPU / 1000000UL))
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	uint16 min;           /* Latencies in us */
+	uint16 max;
+	uint16 count;         /* Entries measured, stops at 0xFFFF like the buckets */
+	uint16 resyncs;       /* Entries a period late or more: new UART burst, lost Timer2 tick */
+	uint16 buckets[ISRLAT_BUCKETS_NUM];
+}ISRLAT_StatsType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+#ifdef ISR_LATENCY
+
+/* Hooks of the instrumented drivers, first thing in their ISR */
+#define ISRLAT_ELAPSED(vector, us)       ISRLAT_record((vector), (us))
+#define ISRLAT_PERIODIC(vector)          ISRLAT_periodic(vector)
+#define ISRLAT_SET_PERIOD(vector, us)    ISRLAT_setPeriod((vector), (us))
+
+/*
+ * Description :
+ * Start Timer1 as the free-running time base, with its overflow interrupt.
+ */
+void ISRLAT_init(void);
+
+/*
+ * Description :
+ * Record a latency measured by the caller (us since the event).
+ */
+void ISRLAT_record(uint8 vector, uint16 latency);
+
+/*
+ * Description :
+ * Record the latency of a periodic vector against its expected time.
+ */
+void ISRLAT_periodic(uint8 vector);
+
+/*
+ * Description :
+ * Set the period of a periodic vector (us), 0 if it is not measured.
+ */
+void ISRLAT_setPeriod(uint8 vector, uint16 period);
+
+/*
+ * Description :
+ * Copy the stats of a vector, they keep counting.
+ */
+void ISRLAT_getStats(uint8 vector, ISRLAT_StatsType *stats);
+
+/*
+ * Description :
+ * Write the stats of a vector in their link layout (LATENCY_REPORT_SIZE bytes), and read them back.
+ */
+void ISRLAT_encode(uint8 vector, const ISRLAT_StatsType *stats, uint8 *bytes);
+uint8 ISRLAT_decode(const uint8 *bytes, ISRLAT_StatsType *stats);
+
+#ifdef HOST_BUILD
+/*
+ * Description :
+ * Host build: the stats of a vector as they are, read by the host boards between two runs
+ * of the firmware (no register access).
+ */
+const ISRLAT_StatsType *ISRLAT_peekStats(uint8 vector);
+#endif
+
+#else
+
+#define ISRLAT_ELAPSED(vector, us)
+#define ISRLAT_PERIODIC(vector)
+#define ISRLAT_SET_PERIOD(vector, us)
+
+#endif /* ISR_LATENCY */
+
+#endif /* ISR_LATENCY_H_ */
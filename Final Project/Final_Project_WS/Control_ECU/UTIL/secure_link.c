@@ -0,0 +1,399 @@
+ /******************************************************************************
+ *
+ * Module: Secure Link
+ *
+ * File Name: secure_link.c
+ *
+ * Description: Source file for the authenticated and encrypted HMI ECU <-> Control ECU UART link
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#include "secure_link.h"
+#include "ascon.h"
+#include "../MCAL/uart.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define SLINK_FRAME_HELLO                'H'
+#define SLINK_FRAME_DATA                 'D'
+#define SLINK_HELLO_HEADER_SIZE          8
+#define SLINK_DATA_HEADER_SIZE           2
+#define SLINK_HELLO_REPLY                0x01  /* HELLO flag: answer with our own HELLO */
+#define SLINK_BODY_MAX_SIZE              (SLINK_HELLO_HEADER_SIZE + SLINK_MAX_PAYLOAD + SLINK_TAG_SIZE)
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef enum
+{
+	SLINK_RX_START, SLINK_RX_TYPE, SLINK_RX_LENGTH, SLINK_RX_BODY
+}SLINK_RxStateType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static const uint8 g_key[ASCON_KEY_SIZE] = SLINK_KEY;
+
+static uint8 g_ownId;
+static uint32 g_ownSession;
+static uint32 g_peerSession = 0;     /* Session announced by the peer, 0 if none yet */
+static uint32 g_txCounter = 0;       /* Counter of the last frame sent in our session */
+static uint32 g_rxCounter = 0;       /* Counter of the last frame accepted from the peer session */
+static boolean g_helloPending = FALSE; /* A HELLO asking for the peer session is not answered yet */
+static uint16 g_helloSentMs;         /* Time of the last HELLO asking for the peer session */
+static uint16 g_nowMs = 0;           /* Time given to the last SLINK_flush */
+static uint16 g_rejected = 0;
+
+static uint8 g_txPayload[SLINK_MAX_PAYLOAD];
+static uint8 g_txLength = 0;
+
+static uint8 g_rxPayload[SLINK_MAX_PAYLOAD]; /* Plaintext of the last accepted DATA frame */
+static uint8 g_rxLength = 0;
+static uint8 g_rxIndex = 0;          /* Next payload byte to give to the application */
+
+static SLINK_RxStateType g_rxState = SLINK_RX_START;
+static uint8 g_rxType;
+static uint8 g_rxPayloadSize;        /* Length field of the frame being received */
+static uint8 g_rxBodySize;           /* Header, ciphertext and tag size */
+static uint8 g_rxCount;
+static uint8 g_rxBody[SLINK_BODY_MAX_SIZE];
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Function responsible for building the 16 bytes nonce of a frame
+ */
+static void SLINK_makeNonce(uint8 *nonce, uint8 sender, uint32 sender_session,
+		uint32 receiver_session, uint32 counter, uint8 type);
+
+/*
+ * Function responsible for encrypting and sending one frame
+ */
+static void SLINK_sendFrame(uint8 type, const uint8 *payload, uint8 length);
+
+/*
+ * Function responsible for asking the peer for its session, once until it answers
+ * or SLINK_HELLO_RETRY_MS pass
+ */
+static void SLINK_requestHello(void);
+
+/*
+ * Function responsible for the received frame parser
+ */
+static void SLINK_parse(uint8 data);
+
+/*
+ * Function responsible for checking a complete received frame
+ */
+static void SLINK_frameReceived(void);
+
+static void SLINK_put32(uint8 *bytes, uint32 value);
+static uint32 SLINK_get32(const uint8 *bytes);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start the link with this ECU id and its new session number (not 0, never used before
+ * with this key) and announce the session to the peer. The UART must be initialized.
+ */
+void SLINK_init(uint8 own_id, uint32 session)
+{
+	g_ownId = own_id;
+	g_ownSession = session;
+	g_rxState = SLINK_RX_START;
+	SLINK_requestHello();
+}
+
+/*
+ * Description :
+ * Queue one byte for the peer. The queued bytes are sent in one frame by SLINK_flush,
+ * or right away if the frame is full.
+ */
+void SLINK_sendByte(uint8 data)
+{
+	if(g_txLength == SLINK_MAX_PAYLOAD)
+	{
+		SLINK_flush(g_nowMs);
+		if(g_txLength == SLINK_MAX_PAYLOAD)
+		{
+			return;
+			/* No peer session yet: the byte is lost like on a disconnected line */
+		}
+	}
+	g_txPayload[g_txLength] = data;
+	g_txLength++;
+}
+
+/*
+ * Description :
+ * Queue size bytes for the peer.
+ */
+void SLINK_sendData(const uint8 *data, uint8 size)
+{
+	uint8 i;
+	for(i = 0; i < size; i++)
+	{
+		SLINK_sendByte(data[i]);
+	}
+}
+
+/*
+ * Description :
+ * Send the queued bytes in one frame. They stay queued until the peer session is known,
+ * the HELLO asking for it is sent again every SLINK_HELLO_RETRY_MS.
+ * Called once per main loop iteration with the current time in ms.
+ */
+void SLINK_flush(uint16 now_ms)
+{
+	g_nowMs = now_ms;
+	if(g_helloPending && (uint16)(now_ms - g_helloSentMs) >= SLINK_HELLO_RETRY_MS)
+	{
+		g_helloPending = FALSE;
+		/* The HELLO or its answer was lost: the next request sends a new one */
+	}
+	if(g_peerSession == 0)
+	{
+		SLINK_requestHello();
+		return;
+	}
+	if(g_txLength == 0)
+	{
+		return;
+	}
+	SLINK_sendFrame(SLINK_FRAME_DATA, g_txPayload, g_txLength);
+	g_txLength = 0;
+}
+
+/*
+ * Description :
+ * Non-blocking receive: if a byte of an authentic frame is available, store it in data
+ * and return TRUE, otherwise return FALSE. Received frames are checked here.
+ */
+boolean SLINK_receiveByte(uint8 *data)
+{
+	uint8 byte;
+	while(g_rxIndex == g_rxLength)
+	{
+		if(!UART_receiveByteNonBlocking(&byte))
+		{
+			return FALSE;
+		}
+		SLINK_parse(byte);
+	}
+	*data = g_rxPayload[g_rxIndex];
+	g_rxIndex++;
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Number of received frames rejected: bad tag, replayed or malformed.
+ */
+uint16 SLINK_getRejectedCount(void)
+{
+	return g_rejected;
+}
+
+/*
+ * Description :
+ * Nonce: sender id, sender session, receiver session (0 in a HELLO), frame counter,
+ * frame type then two zero bytes, all big endian
+ */
+static void SLINK_makeNonce(uint8 *nonce, uint8 sender, uint32 sender_session,
+		uint32 receiver_session, uint32 counter, uint8 type)
+{
+	nonce[0] = sender;
+	SLINK_put32(&nonce[1], sender_session);
+	SLINK_put32(&nonce[5], receiver_session);
+	SLINK_put32(&nonce[9], counter);
+	nonce[13] = type;
+	nonce[14] = 0;
+	nonce[15] = 0;
+}
+
+/*
+ * Description :
+ * Encrypt the payload with the next frame counter and send the frame
+ */
+static void SLINK_sendFrame(uint8 type, const uint8 *payload, uint8 length)
+{
+	uint8 nonce[ASCON_NONCE_SIZE];
+	uint8 header[SLINK_HELLO_HEADER_SIZE];
+	uint8 ciphertext[SLINK_MAX_PAYLOAD];
+	uint8 tag[SLINK_TAG_SIZE];
+	uint8 header_size;
+
+	g_txCounter++;
+	if(type == SLINK_FRAME_HELLO)
+	{
+		SLINK_put32(&header[0], g_ownSession);
+		SLINK_put32(&header[4], g_txCounter);
+		header_size = SLINK_HELLO_HEADER_SIZE;
+		SLINK_makeNonce(nonce, g_ownId, g_ownSession, 0, g_txCounter, type);
+	}
+	else
+	{
+		header[0] = (uint8)(g_txCounter >> 8);
+		header[1] = (uint8)g_txCounter;
+		header_size = SLINK_DATA_HEADER_SIZE;
+		SLINK_makeNonce(nonce, g_ownId, g_ownSession, g_peerSession, g_txCounter, type);
+	}
+	ASCON_encrypt(g_key, nonce, NULL_PTR, 0, payload, ciphertext, length, tag, SLINK_TAG_SIZE);
+
+	UART_sendByte(SLINK_FRAME_START);
+	UART_sendByte(type);
+	UART_sendByte(length);
+	UART_sendData(header, header_size);
+	UART_sendData(ciphertext, length);
+	UART_sendData(tag, SLINK_TAG_SIZE);
+}
+
+/*
+ * Description :
+ * Send a HELLO asking for the peer HELLO, unless one is already waiting for its answer
+ */
+static void SLINK_requestHello(void)
+{
+	uint8 flags = SLINK_HELLO_REPLY;
+	if(!g_helloPending)
+	{
+		SLINK_sendFrame(SLINK_FRAME_HELLO, &flags, 1);
+		g_helloPending = TRUE;
+		g_helloSentMs = g_nowMs;
+	}
+}
+
+/*
+ * Description :
+ * Find the frame start, then take the type, the length and the body.
+ * A malformed frame is dropped and the parser looks for the next frame start.
+ */
+static void SLINK_parse(uint8 data)
+{
+	switch(g_rxState)
+	{
+	case SLINK_RX_START:
+		if(data == SLINK_FRAME_START)
+		{
+			g_rxState = SLINK_RX_TYPE;
+		}
+		break;
+	case SLINK_RX_TYPE:
+		if(data == SLINK_FRAME_HELLO || data == SLINK_FRAME_DATA)
+		{
+			g_rxType = data;
+			g_rxState = SLINK_RX_LENGTH;
+		}
+		else if(data != SLINK_FRAME_START)
+		{
+			g_rxState = SLINK_RX_START;
+		}
+		break;
+	case SLINK_RX_LENGTH:
+		if(data > SLINK_MAX_PAYLOAD || (g_rxType == SLINK_FRAME_HELLO && data == 0))
+		{
+			g_rejected++;
+			g_rxState = (data == SLINK_FRAME_START) ? SLINK_RX_TYPE : SLINK_RX_START;
+			break;
+		}
+		g_rxPayloadSize = data;
+		g_rxBodySize = ((g_rxType == SLINK_FRAME_HELLO) ? SLINK_HELLO_HEADER_SIZE : SLINK_DATA_HEADER_SIZE)
+				+ data + SLINK_TAG_SIZE;
+		g_rxCount = 0;
+		g_rxState = SLINK_RX_BODY;
+		break;
+	case SLINK_RX_BODY:
+		g_rxBody[g_rxCount] = data;
+		g_rxCount++;
+		if(g_rxCount == g_rxBodySize)
+		{
+			g_rxState = SLINK_RX_START;
+			SLINK_frameReceived();
+		}
+		break;
+	}
+}
+
+/*
+ * Description :
+ * HELLO: accept a newer peer session (or a newer frame of the same session), adopt it
+ * and answer if asked.
+ * DATA: rebuild the full counter from its low 16 bits, check the tag with both sessions
+ * and make the plaintext available. A failure asks the peer for its session again,
+ * in case one of the two ECUs has restarted.
+ */
+static void SLINK_frameReceived(void)
+{
+	uint8 nonce[ASCON_NONCE_SIZE];
+	uint8 flags[SLINK_MAX_PAYLOAD];
+	uint8 header_size;
+	uint32 session;
+	uint32 counter;
+
+	if(g_rxType == SLINK_FRAME_HELLO)
+	{
+		session = SLINK_get32(&g_rxBody[0]);
+		counter = SLINK_get32(&g_rxBody[4]);
+		header_size = SLINK_HELLO_HEADER_SIZE;
+		SLINK_makeNonce(nonce, g_ownId ^ (SLINK_ID_HMI | SLINK_ID_CONTROL), session, 0, counter, g_rxType);
+		if(session == 0 || session < g_peerSession || (session == g_peerSession && counter <= g_rxCounter)
+				|| !ASCON_decrypt(g_key, nonce, NULL_PTR, 0, &g_rxBody[header_size], flags,
+						g_rxPayloadSize, &g_rxBody[header_size + g_rxPayloadSize], SLINK_TAG_SIZE))
+		{
+			g_rejected++;
+			return;
+		}
+		g_peerSession = session;
+		g_rxCounter = counter;
+		g_helloPending = FALSE;
+		if(flags[0] & SLINK_HELLO_REPLY)
+		{
+			flags[0] = 0;
+			SLINK_sendFrame(SLINK_FRAME_HELLO, flags, 1);
+		}
+		return;
+	}
+
+	counter = (g_rxCounter & 0xFFFF0000UL) | ((uint16)g_rxBody[0] << 8) | g_rxBody[1];
+	if(counter <= g_rxCounter)
+	{
+		counter += 0x10000UL;
+	}
+	/* Smallest counter above the last accepted one with these low bits */
+	header_size = SLINK_DATA_HEADER_SIZE;
+	SLINK_makeNonce(nonce, g_ownId ^ (SLINK_ID_HMI | SLINK_ID_CONTROL), g_peerSession, g_ownSession,
+			counter, g_rxType);
+	if(g_peerSession == 0 || !ASCON_decrypt(g_key, nonce, NULL_PTR, 0, &g_rxBody[header_size], g_rxPayload,
+			g_rxPayloadSize, &g_rxBody[header_size + g_rxPayloadSize], SLINK_TAG_SIZE))
+	{
+		g_rejected++;
+		g_rxLength = 0;
+		g_rxIndex = 0;
+		SLINK_requestHello();
+		return;
+	}
+	g_rxCounter = counter;
+	g_rxLength = g_rxPayloadSize;
+	g_rxIndex = 0;
+	g_helloPending = FALSE;
+}
+
+static void SLINK_put32(uint8 *bytes, uint32 value)
+{
+	bytes[0] = (uint8)(value >> 24);
+	bytes[1] = (uint8)(value >> 16);
+	bytes[2] = (uint8)(value >> 8);
+	bytes[3] = (uint8)value;
+}
+
+static uint32 SLINK_get32(const uint8 *bytes)
+{
+	return ((uint32)bytes[0] << 24) | ((uint32)bytes[1] << 16) | ((uint32)bytes[2] << 8) | bytes[3];
+}
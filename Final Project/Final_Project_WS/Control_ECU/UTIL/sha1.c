@@ -0,0 +1,281 @@
+ /******************************************************************************
+ *
+ * Module: SHA-1
+ *
+ * File Name: sha1.c
+ *
+ * Description: Source file for the SHA-1 hash (FIPS 180-4) and HMAC-SHA1 (RFC 2104)
+ *              used by the one-time codes
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#include "sha1.h"
+
+#include <avr/pgmspace.h> /* The initial state is kept in flash */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define HMAC_SHA1_IPAD       0x36
+#define HMAC_SHA1_OPAD       0x5C
+
+/* Rotations are written on uint32 so the AVR compiler turns the multiples of 8 into byte moves */
+#define SHA1_ROTL(x,n)       ((uint32)(((uint32)(x) << (n)) | ((uint32)(x) >> (32 - (n)))))
+#define SHA1_CH(x,y,z)       ((z) ^ ((x) & ((y) ^ (z))))
+#define SHA1_PARITY(x,y,z)   ((x) ^ (y) ^ (z))
+#define SHA1_MAJ(x,y,z)      (((x) & (y)) | ((z) & ((x) | (y))))
+
+/*
+ * One round, the working variables are renamed instead of being moved:
+ * five rounds with the names rotated by one give the same result as
+ * five rounds with a..e shifted, without the 16 byte copies per round.
+ */
+#define SHA1_ROUND(a,b,c,d,e,F,k,i) \
+	do{ \
+		e += SHA1_ROTL(a,5) + F(b,c,d) + (k) + SHA1_schedule(w, round + (i)); \
+		b = SHA1_ROTL(b,30); \
+	}while(0)
+
+/* Twenty rounds of the same function and constant */
+#define SHA1_ROUNDS(F,k) \
+	do{ \
+		for(i = 0; i < 20; i += 5, round += 5) \
+		{ \
+			SHA1_ROUND(a,b,c,d,e,F,k,0); \
+			SHA1_ROUND(e,a,b,c,d,F,k,1); \
+			SHA1_ROUND(d,e,a,b,c,F,k,2); \
+			SHA1_ROUND(c,d,e,a,b,F,k,3); \
+			SHA1_ROUND(b,c,d,e,a,F,k,4); \
+		} \
+	}while(0)
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static const uint32 g_sha1InitialState[5] PROGMEM =
+{
+	0x67452301UL, 0xEFCDAB89UL, 0x98BADCFEUL, 0x10325476UL, 0xC3D2E1F0UL
+};
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Function responsible for returning the message schedule word of the required round,
+ * only the last 16 words are kept (64 bytes of RAM instead of 320)
+ */
+static uint32 SHA1_schedule(uint32 *w, uint8 round);
+
+/*
+ * Function responsible for hashing one full block into the state
+ */
+static void SHA1_transform(SHA1_ContextType *context);
+
+/*
+ * Function responsible for hashing the secret xor pad block and saving the state
+ */
+static void HMAC_SHA1_padBlock(uint32 *state, const uint8 *secret, uint8 length, uint8 pad);
+
+/*
+ * Function responsible for starting a hash from a saved key schedule state
+ */
+static void HMAC_SHA1_resume(SHA1_ContextType *context, const uint32 *state);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start a new hash
+ */
+void SHA1_init(SHA1_ContextType *context)
+{
+	uint8 i;
+	for(i = 0; i < 5; i++)
+	{
+		context->state[i] = pgm_read_dword(&g_sha1InitialState[i]);
+	}
+	context->block_length = 0;
+	context->total_length = 0;
+}
+
+/*
+ * Description :
+ * Add the required data to the hash, can be called any number of times
+ */
+void SHA1_update(SHA1_ContextType *context, const uint8 *data, uint16 length)
+{
+	while(length != 0)
+	{
+		context->block[context->block_length] = *data;
+		context->block_length++;
+		context->total_length++;
+		data++;
+		length--;
+		if(context->block_length == SHA1_BLOCK_SIZE)
+		{
+			SHA1_transform(context);
+			context->block_length = 0;
+		}
+	}
+}
+
+/*
+ * Description :
+ * Pad the message and write the digest, the context must be initialized again before reuse
+ */
+void SHA1_final(SHA1_ContextType *context, uint8 *digest)
+{
+	uint8 i;
+	uint32 bit_length = context->total_length << 3;
+
+	context->block[context->block_length] = 0x80;
+	context->block_length++;
+	if(context->block_length > SHA1_BLOCK_SIZE - 8)
+	{
+		while(context->block_length < SHA1_BLOCK_SIZE)
+		{
+			context->block[context->block_length] = 0;
+			context->block_length++;
+		}
+		SHA1_transform(context);
+		context->block_length = 0;
+	}
+	/* The length doesn't fit in this block, pad it and use a new one */
+	while(context->block_length < SHA1_BLOCK_SIZE - 4)
+	{
+		context->block[context->block_length] = 0;
+		context->block_length++;
+	}
+	/* The 64-bit length, messages here are shorter than 512MB so its high half is 0 */
+	for(i = 0; i < 4; i++)
+	{
+		context->block[SHA1_BLOCK_SIZE - 1 - i] = (uint8)(bit_length >> (8 * i));
+	}
+	SHA1_transform(context);
+
+	for(i = 0; i < SHA1_DIGEST_SIZE; i++)
+	{
+		digest[i] = (uint8)(context->state[i >> 2] >> (24 - 8 * (i & 3)));
+	}
+	/* Big endian output */
+}
+
+/*
+ * Description :
+ * Compute the HMAC key schedule of a secret of up to SHA1_BLOCK_SIZE bytes
+ */
+void HMAC_SHA1_setKey(HMAC_SHA1_KeyType *key, const uint8 *secret, uint8 length)
+{
+	HMAC_SHA1_padBlock(key->inner, secret, length, HMAC_SHA1_IPAD);
+	HMAC_SHA1_padBlock(key->outer, secret, length, HMAC_SHA1_OPAD);
+}
+
+/*
+ * Description :
+ * Write the HMAC-SHA1 of the message: H(key ^ opad, H(key ^ ipad, message)).
+ * The key blocks are already hashed in the key schedule, so only the message
+ * and the inner digest blocks are left.
+ */
+void HMAC_SHA1_compute(const HMAC_SHA1_KeyType *key, const uint8 *message, uint8 length, uint8 *mac)
+{
+	SHA1_ContextType context;
+	uint8 digest[SHA1_DIGEST_SIZE];
+
+	HMAC_SHA1_resume(&context, key->inner);
+	SHA1_update(&context, message, length);
+	SHA1_final(&context, digest);
+	HMAC_SHA1_resume(&context, key->outer);
+	SHA1_update(&context, digest, SHA1_DIGEST_SIZE);
+	SHA1_final(&context, mac);
+}
+
+/*
+ * Description :
+ * Hash the secret padded with zeros and xored with the pad byte as the first block,
+ * then keep the state
+ */
+static void HMAC_SHA1_padBlock(uint32 *state, const uint8 *secret, uint8 length, uint8 pad)
+{
+	SHA1_ContextType context;
+	uint8 i;
+
+	SHA1_init(&context);
+	for(i = 0; i < SHA1_BLOCK_SIZE; i++)
+	{
+		context.block[i] = ((i < length) ? secret[i] : 0) ^ pad;
+	}
+	SHA1_transform(&context);
+	for(i = 0; i < 5; i++)
+	{
+		state[i] = context.state[i];
+	}
+}
+
+/*
+ * Description :
+ * Continue a hash whose first block was the key block of the saved state
+ */
+static void HMAC_SHA1_resume(SHA1_ContextType *context, const uint32 *state)
+{
+	uint8 i;
+	for(i = 0; i < 5; i++)
+	{
+		context->state[i] = state[i];
+	}
+	context->block_length = 0;
+	context->total_length = SHA1_BLOCK_SIZE;
+}
+
+/*
+ * Description :
+ * Return the message schedule word of the required round, only the last 16 words are kept.
+ * Rounds 0..15 use the block words already loaded in w, the next ones are computed in place.
+ */
+static uint32 SHA1_schedule(uint32 *w, uint8 round)
+{
+	uint8 i = round & 15;
+	if(round >= 16)
+	{
+		w[i] = SHA1_ROTL(w[(i + 13) & 15] ^ w[(i + 8) & 15] ^ w[(i + 2) & 15] ^ w[i], 1);
+	}
+	return w[i];
+}
+
+/*
+ * Description :
+ * Hash one full block into the state
+ */
+static void SHA1_transform(SHA1_ContextType *context)
+{
+	uint32 w[16];
+	uint32 a, b, c, d, e;
+	uint8 round = 0;
+	uint8 i;
+
+	for(i = 0; i < 16; i++)
+	{
+		w[i] = ((uint32)context->block[4 * i] << 24) | ((uint32)context->block[4 * i + 1] << 16)
+				| ((uint32)context->block[4 * i + 2] << 8) | (uint32)context->block[4 * i + 3];
+	}
+
+	a = context->state[0];
+	b = context->state[1];
+	c = context->state[2];
+	d = context->state[3];
+	e = context->state[4];
+
+	SHA1_ROUNDS(SHA1_CH, 0x5A827999UL);
+	SHA1_ROUNDS(SHA1_PARITY, 0x6ED9EBA1UL);
+	SHA1_ROUNDS(SHA1_MAJ, 0x8F1BBCDCUL);
+	SHA1_ROUNDS(SHA1_PARITY, 0xCA62C1D6UL);
+
+	context->state[0] += a;
+	context->state[1] += b;
+	context->state[2] += c;
+	context->state[3] += d;
+	context->state[4] += e;
+}
@@ -0,0 +1,77 @@
+ /******************************************************************************
+ *
+ * Module: SHA-1
+ *
+ * File Name: sha1.h
+ *
+ * Description: Header file for the SHA-1 hash (FIPS 180-4) and HMAC-SHA1 (RFC 2104)
+ *              used by the one-time codes
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef SHA1_H_
+#define SHA1_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define SHA1_BLOCK_SIZE                  64
+#define SHA1_DIGEST_SIZE                 20
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	uint32 state[5];
+	uint8 block[SHA1_BLOCK_SIZE]; /* Data waiting for a full block */
+	uint8 block_length;
+	uint32 total_length; /* Bytes hashed so far, the messages hashed here are short */
+}SHA1_ContextType;
+
+typedef struct
+{
+	uint32 inner[5]; /* State after the key xor ipad block */
+	uint32 outer[5]; /* State after the key xor opad block */
+}HMAC_SHA1_KeyType;
+/* HMAC key schedule: both key blocks are hashed once, each MAC then starts from these states */
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start a new hash
+ */
+void SHA1_init(SHA1_ContextType *context);
+
+/*
+ * Description :
+ * Add the required data to the hash, can be called any number of times
+ */
+void SHA1_update(SHA1_ContextType *context, const uint8 *data, uint16 length);
+
+/*
+ * Description :
+ * Pad the message and write the digest, the context must be initialized again before reuse
+ */
+void SHA1_final(SHA1_ContextType *context, uint8 *digest);
+
+/*
+ * Description :
+ * Compute the HMAC key schedule of a secret of up to SHA1_BLOCK_SIZE bytes
+ */
+void HMAC_SHA1_setKey(HMAC_SHA1_KeyType *key, const uint8 *secret, uint8 length);
+
+/*
+ * Description :
+ * Write the HMAC-SHA1 of the message, messages up to 55 bytes cost two SHA-1 blocks
+ */
+void HMAC_SHA1_compute(const HMAC_SHA1_KeyType *key, const uint8 *message, uint8 length, uint8 *mac);
+
+#endif /* SHA1_H_ */
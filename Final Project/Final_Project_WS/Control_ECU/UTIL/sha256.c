@@ -0,0 +1,218 @@
+ /******************************************************************************
+ *
+ * Module: SHA-256
+ *
+ * File Name: sha256.c
+ *
+ * Description: Source file for the SHA-256 hash (FIPS 180-4) used to store the password
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#include "sha256.h"
+
+#include <avr/pgmspace.h> /* The round constants are kept in flash */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Rotations are written on uint32 so the AVR compiler turns the multiples of 8 into byte moves */
+#define SHA256_ROTR(x,n)     ((uint32)(((uint32)(x) >> (n)) | ((uint32)(x) << (32 - (n)))))
+#define SHA256_CH(x,y,z)     ((z) ^ ((x) & ((y) ^ (z))))
+#define SHA256_MAJ(x,y,z)    (((x) & (y)) | ((z) & ((x) | (y))))
+#define SHA256_SIGMA0(x)     (SHA256_ROTR(x,2) ^ SHA256_ROTR(x,13) ^ SHA256_ROTR(x,22))
+#define SHA256_SIGMA1(x)     (SHA256_ROTR(x,6) ^ SHA256_ROTR(x,11) ^ SHA256_ROTR(x,25))
+#define SHA256_GAMMA0(x)     (SHA256_ROTR(x,7) ^ SHA256_ROTR(x,18) ^ ((uint32)(x) >> 3))
+#define SHA256_GAMMA1(x)     (SHA256_ROTR(x,17) ^ SHA256_ROTR(x,19) ^ ((uint32)(x) >> 10))
+
+/*
+ * One round, the working variables are renamed instead of being moved:
+ * eight rounds with the names rotated by one give the same result as
+ * eight rounds with a..h shifted, without the 28 byte copies per round.
+ */
+#define SHA256_ROUND(a,b,c,d,e,f,g,h,i) \
+	do{ \
+		h += SHA256_SIGMA1(e) + SHA256_CH(e,f,g) + pgm_read_dword(&g_sha256K[round + (i)]) + SHA256_schedule(w, round + (i)); \
+		d += h; \
+		h += SHA256_SIGMA0(a) + SHA256_MAJ(a,b,c); \
+	}while(0)
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static const uint32 g_sha256K[64] PROGMEM =
+{
+	0x428a2f98UL, 0x71374491UL, 0xb5c0fbcfUL, 0xe9b5dba5UL, 0x3956c25bUL, 0x59f111f1UL, 0x923f82a4UL, 0xab1c5ed5UL,
+	0xd807aa98UL, 0x12835b01UL, 0x243185beUL, 0x550c7dc3UL, 0x72be5d74UL, 0x80deb1feUL, 0x9bdc06a7UL, 0xc19bf174UL,
+	0xe49b69c1UL, 0xefbe4786UL, 0x0fc19dc6UL, 0x240ca1ccUL, 0x2de92c6fUL, 0x4a7484aaUL, 0x5cb0a9dcUL, 0x76f988daUL,
+	0x983e5152UL, 0xa831c66dUL, 0xb00327c8UL, 0xbf597fc7UL, 0xc6e00bf3UL, 0xd5a79147UL, 0x06ca6351UL, 0x14292967UL,
+	0x27b70a85UL, 0x2e1b2138UL, 0x4d2c6dfcUL, 0x53380d13UL, 0x650a7354UL, 0x766a0abbUL, 0x81c2c92eUL, 0x92722c85UL,
+	0xa2bfe8a1UL, 0xa81a664bUL, 0xc24b8b70UL, 0xc76c51a3UL, 0xd192e819UL, 0xd6990624UL, 0xf40e3585UL, 0x106aa070UL,
+	0x19a4c116UL, 0x1e376c08UL, 0x2748774cUL, 0x34b0bcb5UL, 0x391c0cb3UL, 0x4ed8aa4aUL, 0x5b9cca4fUL, 0x682e6ff3UL,
+	0x748f82eeUL, 0x78a5636fUL, 0x84c87814UL, 0x8cc70208UL, 0x90befffaUL, 0xa4506cebUL, 0xbef9a3f7UL, 0xc67178f2UL
+};
+
+static const uint32 g_sha256InitialState[8] PROGMEM =
+{
+	0x6a09e667UL, 0xbb67ae85UL, 0x3c6ef372UL, 0xa54ff53aUL, 0x510e527fUL, 0x9b05688cUL, 0x1f83d9abUL, 0x5be0cd19UL
+};
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Function responsible for returning the message schedule word of the required round,
+ * only the last 16 words are kept (64 bytes of RAM instead of 256)
+ */
+static uint32 SHA256_schedule(uint32 *w, uint8 round);
+
+/*
+ * Function responsible for hashing one full block into the state
+ */
+static void SHA256_transform(SHA256_ContextType *context);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start a new hash
+ */
+void SHA256_init(SHA256_ContextType *context)
+{
+	uint8 i;
+	for(i = 0; i < 8; i++)
+	{
+		context->state[i] = pgm_read_dword(&g_sha256InitialState[i]);
+	}
+	context->block_length = 0;
+	context->total_length = 0;
+}
+
+/*
+ * Description :
+ * Add the required data to the hash, can be called any number of times
+ */
+void SHA256_update(SHA256_ContextType *context, const uint8 *data, uint16 length)
+{
+	while(length != 0)
+	{
+		context->block[context->block_length] = *data;
+		context->block_length++;
+		context->total_length++;
+		data++;
+		length--;
+		if(context->block_length == SHA256_BLOCK_SIZE)
+		{
+			SHA256_transform(context);
+			context->block_length = 0;
+		}
+	}
+}
+
+/*
+ * Description :
+ * Pad the message and write the digest, the context must be initialized again before reuse
+ */
+void SHA256_final(SHA256_ContextType *context, uint8 *digest)
+{
+	uint8 i;
+	uint32 bit_length = context->total_length << 3;
+
+	context->block[context->block_length] = 0x80;
+	context->block_length++;
+	if(context->block_length > SHA256_BLOCK_SIZE - 8)
+	{
+		while(context->block_length < SHA256_BLOCK_SIZE)
+		{
+			context->block[context->block_length] = 0;
+			context->block_length++;
+		}
+		SHA256_transform(context);
+		context->block_length = 0;
+	}
+	/* The length doesn't fit in this block, pad it and use a new one */
+	while(context->block_length < SHA256_BLOCK_SIZE - 4)
+	{
+		context->block[context->block_length] = 0;
+		context->block_length++;
+	}
+	/* The 64-bit length, messages here are shorter than 512MB so its high half is 0 */
+	for(i = 0; i < 4; i++)
+	{
+		context->block[SHA256_BLOCK_SIZE - 1 - i] = (uint8)(bit_length >> (8 * i));
+	}
+	SHA256_transform(context);
+
+	for(i = 0; i < SHA256_DIGEST_SIZE; i++)
+	{
+		digest[i] = (uint8)(context->state[i >> 2] >> (24 - 8 * (i & 3)));
+	}
+	/* Big endian output */
+}
+
+/*
+ * Description :
+ * Return the message schedule word of the required round, only the last 16 words are kept.
+ * Rounds 0..15 use the block words already loaded in w, the next ones are computed in place.
+ */
+static uint32 SHA256_schedule(uint32 *w, uint8 round)
+{
+	uint8 i = round & 15;
+	if(round >= 16)
+	{
+		w[i] += SHA256_GAMMA1(w[(i + 14) & 15]) + w[(i + 9) & 15] + SHA256_GAMMA0(w[(i + 1) & 15]);
+	}
+	return w[i];
+}
+
+/*
+ * Description :
+ * Hash one full block into the state
+ */
+static void SHA256_transform(SHA256_ContextType *context)
+{
+	uint32 w[16];
+	uint32 a, b, c, d, e, f, g, h;
+	uint8 round;
+	uint8 i;
+
+	for(i = 0; i < 16; i++)
+	{
+		w[i] = ((uint32)context->block[4 * i] << 24) | ((uint32)context->block[4 * i + 1] << 16)
+				| ((uint32)context->block[4 * i + 2] << 8) | (uint32)context->block[4 * i + 3];
+	}
+
+	a = context->state[0];
+	b = context->state[1];
+	c = context->state[2];
+	d = context->state[3];
+	e = context->state[4];
+	f = context->state[5];
+	g = context->state[6];
+	h = context->state[7];
+
+	for(round = 0; round < 64; round += 8)
+	{
+		SHA256_ROUND(a,b,c,d,e,f,g,h,0);
+		SHA256_ROUND(h,a,b,c,d,e,f,g,1);
+		SHA256_ROUND(g,h,a,b,c,d,e,f,2);
+		SHA256_ROUND(f,g,h,a,b,c,d,e,3);
+		SHA256_ROUND(e,f,g,h,a,b,c,d,4);
+		SHA256_ROUND(d,e,f,g,h,a,b,c,5);
+		SHA256_ROUND(c,d,e,f,g,h,a,b,6);
+		SHA256_ROUND(b,c,d,e,f,g,h,a,7);
+	}
+
+	context->state[0] += a;
+	context->state[1] += b;
+	context->state[2] += c;
+	context->state[3] += d;
+	context->state[4] += e;
+	context->state[5] += f;
+	context->state[6] += g;
+	context->state[7] += h;
+}
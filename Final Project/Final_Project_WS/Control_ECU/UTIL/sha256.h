@@ -0,0 +1,57 @@
+ /******************************************************************************
+ *
+ * Module: SHA-256
+ *
+ * File Name: sha256.h
+ *
+ * Description: Header file for the SHA-256 hash (FIPS 180-4) used to store the password
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef SHA256_H_
+#define SHA256_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define SHA256_BLOCK_SIZE                64
+#define SHA256_DIGEST_SIZE               32
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	uint32 state[8];
+	uint8 block[SHA256_BLOCK_SIZE]; /* Data waiting for a full block */
+	uint8 block_length;
+	uint32 total_length; /* Bytes hashed so far, the messages hashed here are short */
+}SHA256_ContextType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start a new hash
+ */
+void SHA256_init(SHA256_ContextType *context);
+
+/*
+ * Description :
+ * Add the required data to the hash, can be called any number of times
+ */
+void SHA256_update(SHA256_ContextType *context, const uint8 *data, uint16 length);
+
+/*
+ * Description :
+ * Pad the message and write the digest, the context must be initialized again before reuse
+ */
+void SHA256_final(SHA256_ContextType *context, uint8 *digest);
+
+#endif /* SHA256_H_ */
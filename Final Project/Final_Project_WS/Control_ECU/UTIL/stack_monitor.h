@@ -0,0 +1,72 @@
+ /******************************************************************************
+ *
+ * Module: Stack Monitor
+ *
+ * File Name: stack_monitor.h
+ *
+ * Description: Header file for the stack monitor: the free RAM is painted at boot,
+ *              the high-water mark of the stack is found by scanning the paint
+ *              and a canary after .bss tells if the stack ever reached it
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef STACK_MONITOR_H_
+#define STACK_MONITOR_H_
+
+#include "std_types.h"
+
+/*
+ * The main loop and every ISR share the one stack that grows down from RAMEND
+ * towards the end of .bss (no heap is used). The bytes between them are painted
+ * with STACK_PAINT_BYTE before main() runs: the lowest byte that lost its paint is
+ * the deepest the stack ever went. A used byte that happens to hold the paint value
+ * is not seen, so the peak may be a few bytes short.
+ */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define STACK_PAINT_BYTE                 0xC5
+#define STACK_CANARY                     { 0x5A, 0xA5, 0x3C, 0xC3 }
+#define STACK_CANARY_SIZE                4   /* Right after .bss, the stack must never reach it */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	uint16 size;          /* Bytes between the canary and the top of the RAM */
+	uint16 current;       /* Bytes used now */
+	uint16 peak;          /* Most bytes used since the boot (high-water mark) */
+	uint16 free;          /* Bytes never used, left before the stack reaches the canary */
+	boolean canary_ok;    /* FALSE once the stack overwrote the canary: .bss may be corrupted */
+}STACK_ReportType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Put the canary after .bss, to be called first in main().
+ * The chip paints the stack before main() (.init1), the host build paints it here.
+ */
+void STACK_init(void);
+
+/*
+ * Description :
+ * Scan the paint for the high-water mark and check the canary.
+ * The scan reads at most the free RAM once, it can be called from the main loop at any time.
+ */
+void STACK_getReport(STACK_ReportType *report);
+
+/*
+ * Description :
+ * Write a report in its link layout (STACK_REPORT_SIZE bytes), and read it back.
+ */
+void STACK_encode(const STACK_ReportType *report, uint8 *bytes);
+void STACK_decode(const uint8 *bytes, STACK_ReportType *report);
+
+#endif /* STACK_MONITOR_H_ */
@@ -0,0 +1,93 @@
+ /******************************************************************************
+ *
+ * Module: TOTP
+ *
+ * File Name: totp.c
+ *
+ * Description: Source file for the time-based one-time codes (RFC 6238, HMAC-SHA1)
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#include "totp.h"
+#include "sha1.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static HMAC_SHA1_KeyType g_totpKey;
+static uint32 g_lastUsedStep = 0; /* Step of the last accepted code, codes can't be used twice */
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Set the shared secret (up to 64 bytes) and precompute its HMAC key schedule
+ */
+void TOTP_init(const uint8 *secret, uint8 length)
+{
+	HMAC_SHA1_setKey(&g_totpKey, secret, length);
+	g_lastUsedStep = 0;
+}
+
+/*
+ * Description :
+ * Return the code of a time step: HMAC of the 8 bytes big endian step, then the
+ * RFC 4226 dynamic truncation (31 bits at the offset given by the last nibble)
+ * reduced to the required number of digits
+ */
+uint32 TOTP_code(uint32 step, uint8 digits)
+{
+	uint8 message[8] = { 0 };
+	uint8 mac[SHA1_DIGEST_SIZE];
+	uint8 offset;
+	uint32 value;
+	uint32 modulus = 1;
+
+	message[4] = (uint8)(step >> 24);
+	message[5] = (uint8)(step >> 16);
+	message[6] = (uint8)(step >> 8);
+	message[7] = (uint8)step;
+	/* The high half of the counter stays 0 until year 4000 */
+	HMAC_SHA1_compute(&g_totpKey, message, sizeof(message), mac);
+
+	offset = mac[SHA1_DIGEST_SIZE - 1] & 0x0F;
+	value = ((uint32)(mac[offset] & 0x7F) << 24) | ((uint32)mac[offset + 1] << 16)
+			| ((uint32)mac[offset + 2] << 8) | mac[offset + 3];
+	while(digits != 0)
+	{
+		modulus *= 10;
+		digits--;
+	}
+	return value % modulus;
+}
+
+/*
+ * Description :
+ * Check a code against window time steps centered on the current step (1: current step only,
+ * 3: one step before and after, ...). All the steps are computed whatever the result.
+ * A step whose code was accepted, and the steps before it, are not accepted anymore.
+ * Returns TRUE if the code is right.
+ */
+boolean TOTP_verify(uint32 code, uint32 step, uint8 digits, uint8 window)
+{
+	uint32 candidate = step - (window / 2);
+	uint32 matched = 0;
+	uint8 i;
+
+	for(i = 0; i < window; i++, candidate++)
+	{
+		if(TOTP_code(candidate, digits) == code && candidate > g_lastUsedStep)
+		{
+			matched = candidate;
+		}
+	}
+	if(matched == 0)
+	{
+		return FALSE;
+	}
+	g_lastUsedStep = matched;
+	return TRUE;
+}
@@ -0,0 +1,49 @@
+ /******************************************************************************
+ *
+ * Module: TOTP
+ *
+ * File Name: totp.h
+ *
+ * Description: Header file for the time-based one-time codes (RFC 6238, HMAC-SHA1)
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef TOTP_H_
+#define TOTP_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define TOTP_STEP_SECONDS                30  /* A code is valid for one 30s time step */
+#define TOTP_MAX_DIGITS                  9
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Set the shared secret (up to 64 bytes) and precompute its HMAC key schedule
+ */
+void TOTP_init(const uint8 *secret, uint8 length);
+
+/*
+ * Description :
+ * Return the code of a time step (Unix time / TOTP_STEP_SECONDS) with the required number of digits
+ */
+uint32 TOTP_code(uint32 step, uint8 digits);
+
+/*
+ * Description :
+ * Check a code against window time steps centered on the current step (1: current step only,
+ * 3: one step before and after, ...). All the steps are computed whatever the result.
+ * A step whose code was accepted, and the steps before it, are not accepted anymore.
+ * Returns TRUE if the code is right.
+ */
+boolean TOTP_verify(uint32 code, uint32 step, uint8 digits, uint8 window);
+
+#endif /* TOTP_H_ */
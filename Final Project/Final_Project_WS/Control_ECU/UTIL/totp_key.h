@@ -0,0 +1,29 @@
+ /******************************************************************************
+ *
+ * Module: TOTP
+ *
+ * File Name: totp_key.h
+ *
+ * Description: Secret of the time-based one-time codes of this product
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef TOTP_KEY_H_
+#define TOTP_KEY_H_
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * The owner's code generator (an RFC 6238 authenticator set to HMAC-SHA1, 30 s
+ * and 5 digits) is loaded with the same 20 bytes. Whoever reads them can make
+ * codes that open the door: the production line writes 20 random bytes here for
+ * each unit and hands them to its owner, they never leave this file otherwise.
+ */
+#define TOTP_SECRET { 0x8C, 0x21, 0xF5, 0x4A, 0x06, 0xDE, 0x73, 0x9B, 0x30, 0xC7, \
+		0x5E, 0x12, 0xA8, 0x64, 0xFB, 0x0D, 0x97, 0x3F, 0xB2, 0x4E }
+
+#endif /* TOTP_KEY_H_ */
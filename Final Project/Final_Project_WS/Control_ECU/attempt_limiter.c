@@ -0,0 +1,158 @@
+ /******************************************************************************
+ *
+ * Module: Attempt Limiter
+ *
+ * File Name: attempt_limiter.c
+ *
+ * Description: Source file for the password attempt limiter: lockouts with exponential backoff
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#include "attempt_limiter.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static uint8 g_failures = 0;      /* Wrong attempts not forgotten yet */
+static uint32 g_lockoutEnd = 0;   /* Time the current lockout ends */
+static uint32 g_decayStart = 0;   /* Time the next wrong attempt starts to be forgotten from */
+static uint8 g_freeAttempts = LIMITER_FREE_ATTEMPTS;
+static uint16 g_baseLockout = LIMITER_BASE_LOCKOUT_S;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Function responsible for returning the lockout due to a wrong attempts count
+ */
+static uint16 LIMITER_window(uint8 failures);
+
+/*
+ * Function responsible for forgetting the wrong attempts whose decay time passed
+ */
+static void LIMITER_decay(uint32 now);
+
+/*
+ * Function responsible for starting the lockout due to the current count
+ */
+static void LIMITER_startLockout(uint32 now);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start from the wrong attempts count saved in the EEPROM (0xFF if never saved).
+ * A lockout due to this count starts again in full: a reset can't shorten it.
+ */
+void LIMITER_init(uint8 failures, uint32 now)
+{
+	g_failures = (failures > LIMITER_MAX_FAILURES) ? 0 : failures;
+	LIMITER_startLockout(now);
+}
+
+/*
+ * Description :
+ * Set the attempts allowed before the first lockout and the first lockout time
+ * (at most LIMITER_MAX_BASE_LOCKOUT_S). The running lockout is kept.
+ */
+void LIMITER_configure(uint8 free_attempts, uint16 base_lockout_s)
+{
+	g_freeAttempts = free_attempts;
+	g_baseLockout = (base_lockout_s > LIMITER_MAX_BASE_LOCKOUT_S) ? LIMITER_MAX_BASE_LOCKOUT_S : base_lockout_s;
+}
+
+/*
+ * Description :
+ * Return the lockout time left in seconds, 0 if an attempt is allowed.
+ */
+uint16 LIMITER_lockoutLeft(uint32 now)
+{
+	LIMITER_decay(now);
+	if(now >= g_lockoutEnd)
+	{
+		return 0;
+	}
+	return (uint16)(g_lockoutEnd - now);
+}
+
+/*
+ * Description :
+ * Count an allowed attempt as wrong until LIMITER_attemptSucceeded says otherwise,
+ * so a reset during the check still counts it. The count must be saved before the check.
+ */
+void LIMITER_attemptStarted(uint32 now)
+{
+	LIMITER_decay(now);
+	if(g_failures < LIMITER_MAX_FAILURES)
+	{
+		g_failures++;
+	}
+	LIMITER_startLockout(now);
+}
+
+/*
+ * Description :
+ * The attempt was right: forget the wrong attempts and end the lockout.
+ */
+void LIMITER_attemptSucceeded(void)
+{
+	g_failures = 0;
+	g_lockoutEnd = 0;
+}
+
+/*
+ * Description :
+ * Return the wrong attempts count to save in the EEPROM.
+ */
+uint8 LIMITER_getFailures(uint32 now)
+{
+	LIMITER_decay(now);
+	return g_failures;
+}
+
+/*
+ * Description :
+ * No lockout below the free attempts, then the base lockout doubled for
+ * each further wrong attempt, up to LIMITER_MAX_DOUBLINGS times
+ */
+static uint16 LIMITER_window(uint8 failures)
+{
+	uint8 doublings;
+	if(failures < g_freeAttempts)
+	{
+		return 0;
+	}
+	doublings = failures - g_freeAttempts;
+	if(doublings > LIMITER_MAX_DOUBLINGS)
+	{
+		doublings = LIMITER_MAX_DOUBLINGS;
+	}
+	return g_baseLockout << doublings;
+}
+
+/*
+ * Description :
+ * One wrong attempt is forgotten for each LIMITER_DECAY_S passed since the decay start
+ */
+static void LIMITER_decay(uint32 now)
+{
+	while(g_failures != 0 && now >= g_decayStart && (now - g_decayStart) >= LIMITER_DECAY_S)
+	{
+		g_failures--;
+		g_decayStart += LIMITER_DECAY_S;
+	}
+}
+
+/*
+ * Description :
+ * Lock out for the window of the current count, nothing is forgotten before its end
+ */
+static void LIMITER_startLockout(uint32 now)
+{
+	g_lockoutEnd = now + LIMITER_window(g_failures);
+	g_decayStart = g_lockoutEnd;
+}
@@ -0,0 +1,78 @@
+ /******************************************************************************
+ *
+ * Module: Attempt Limiter
+ *
+ * File Name: attempt_limiter.h
+ *
+ * Description: Header file for the password attempt limiter: lockouts with exponential backoff
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef ATTEMPT_LIMITER_H_
+#define ATTEMPT_LIMITER_H_
+
+#include "UTIL/std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * The first free attempts - 1 wrong attempts cost nothing, the next one starts a base
+ * lockout and each further one doubles it, up to LIMITER_MAX_DOUBLINGS times.
+ * Each LIMITER_DECAY_S without a wrong attempt (after the end of the lockout) forgets
+ * one wrong attempt, a right password forgets all of them.
+ */
+#define LIMITER_FREE_ATTEMPTS            3    /* Until LIMITER_configure is called */
+#define LIMITER_BASE_LOCKOUT_S           30   /* Until LIMITER_configure is called */
+#define LIMITER_MAX_BASE_LOCKOUT_S       480  /* So the longest lockout fits 16 bits */
+#define LIMITER_MAX_DOUBLINGS            7    /* Longest lockout: 30s * 128 = 64 min */
+#define LIMITER_DECAY_S                  600
+#define LIMITER_MAX_FAILURES             0xFE /* 0xFF is an erased EEPROM */
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start from the wrong attempts count saved in the EEPROM (0xFF if never saved).
+ * A lockout due to this count starts again in full: a reset can't shorten it.
+ */
+void LIMITER_init(uint8 failures, uint32 now);
+
+/*
+ * Description :
+ * Set the attempts allowed before the first lockout and the first lockout time
+ * (at most LIMITER_MAX_BASE_LOCKOUT_S). The running lockout is kept.
+ */
+void LIMITER_configure(uint8 free_attempts, uint16 base_lockout_s);
+
+/*
+ * Description :
+ * Return the lockout time left in seconds, 0 if an attempt is allowed.
+ */
+uint16 LIMITER_lockoutLeft(uint32 now);
+
+/*
+ * Description :
+ * Count an allowed attempt as wrong until LIMITER_attemptSucceeded says otherwise,
+ * so a reset during the check still counts it. The count must be saved before the check.
+ */
+void LIMITER_attemptStarted(uint32 now);
+
+/*
+ * Description :
+ * The attempt was right: forget the wrong attempts and end the lockout.
+ */
+void LIMITER_attemptSucceeded(void);
+
+/*
+ * Description :
+ * Return the wrong attempts count to save in the EEPROM.
+ */
+uint8 LIMITER_getFailures(uint32 now);
+
+#endif /* ATTEMPT_LIMITER_H_ */
@@ -0,0 +1,322 @@
+ /******************************************************************************
+ *
+ * Module: Bench
+ *
+ * File Name: bench.c
+ *
+ * Description: Source file for the boot benchmarks of Control ECU
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#include "bench.h"
+
+#ifdef BENCH_ENABLED
+
+#include "HAL/external_eeprom.h"
+#include "HAL/motor.h"
+#include "MCAL/uart.h"
+#include "MCAL/timer.h"
+#include "UTIL/communication_commands.h"
+#include "UTIL/secure_link.h"
+#include "UTIL/ascon.h"
+#include "UTIL/totp.h"
+#include <avr/io.h> /* For TCNT1 and TCCR1B */
+#include <avr/interrupt.h> /* For sei() and cli() */
+#include <util/delay.h> /* For the EEPROM write cycles */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define BENCH_EEPROM_ADDRESS             0x0104
+/* Wrong attempts count of the application: read, then the same value written back */
+#define BENCH_EEPROM_WRITE_TIME_MS       10
+/* Write cycle time of the external EEPROM */
+#define BENCH_DRIVER_ROWS                9
+
+/*******************************************************************************
+ *                      Global Variables Declarations                          *
+ *******************************************************************************/
+static volatile uint16 g_benchOverflows; /* Timer1 overflows during the measure */
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Function responsible for counting the Timer1 overflows during a measure
+ */
+static void BENCH_overflow(void);
+
+/*
+ * Function responsible for starting and stopping the count of the CPU cycles
+ */
+static void BENCH_start(void);
+static uint32 BENCH_stop(void);
+
+/*
+ * Function responsible for sending "<label><value>" on the UART
+ */
+static void BENCH_send(const char *label, uint32 value, boolean last);
+
+/*
+ * Functions responsible for each benchmark
+ */
+#ifdef PASSWORD_HASH_BENCHMARK
+static void BENCH_passwordVerify(BENCH_PasswordVerifyType password_verify, uint8 hash_iterations);
+#endif
+#ifdef LINK_CIPHER_BENCHMARK
+static void BENCH_linkCipher(void);
+#endif
+#ifdef TOTP_BENCHMARK
+static void BENCH_oneTimeCode(void);
+#endif
+#ifdef DRIVER_BENCHMARK
+static void BENCH_drivers(void);
+#endif
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Run the benchmarks of this build and send their results on the UART.
+ */
+void BENCH_run(BENCH_PasswordVerifyType password_verify, uint8 hash_iterations)
+{
+#ifdef PASSWORD_HASH_BENCHMARK
+	BENCH_passwordVerify(password_verify, hash_iterations);
+#endif
+#ifdef LINK_CIPHER_BENCHMARK
+	BENCH_linkCipher();
+#endif
+#ifdef TOTP_BENCHMARK
+	BENCH_oneTimeCode();
+#endif
+#ifdef DRIVER_BENCHMARK
+	BENCH_drivers();
+#endif
+}
+
+static void BENCH_overflow(void)
+{
+	g_benchOverflows++;
+}
+
+/*
+ * Description :
+ * Start counting the CPU cycles with Timer1 running at F_CPU.
+ */
+static void BENCH_start(void)
+{
+	Timer1_ConfigType Timer1_Config = { 0, 0, Prescalar_noPrescalar, Timer1_NormalMode };
+	g_benchOverflows = 0;
+	Timer1_setCall(BENCH_overflow);
+	sei();
+	Timer1_Init(&Timer1_Config);
+}
+
+/*
+ * Description :
+ * Stop the count.
+ * Returns the CPU cycles counted since BENCH_start.
+ */
+static uint32 BENCH_stop(void)
+{
+	uint32 cycles;
+	TCCR1B &= 0xF8;
+	/* Stop the count */
+	cycles = ((uint32)g_benchOverflows << 16) | TCNT1;
+	Timer1_DeInit();
+	cli();
+	return cycles;
+}
+
+/*
+ * Description :
+ * Send "<label><value>" on the UART, followed by the end of line if last is set.
+ */
+static void BENCH_send(const char *label, uint32 value, boolean last)
+{
+	uint8 text[40];
+	uint8 index = 0;
+	uint8 digits[10];
+	uint8 digits_num;
+
+	while(*label != '\0')
+	{
+		text[index++] = *label++;
+	}
+	digits_num = 0;
+	do
+	{
+		digits[digits_num++] = '0' + (value % 10);
+		value /= 10;
+	} while(value != 0);
+	while(digits_num != 0)
+	{
+		text[index++] = digits[--digits_num];
+	}
+	if(last)
+	{
+		text[index++] = '\r';
+		text[index++] = '\n';
+	}
+	text[index] = '\0';
+	UART_sendString(text);
+}
+
+#ifdef PASSWORD_HASH_BENCHMARK
+/*
+ * Description :
+ * Count the CPU cycles of one password verify,
+ * then send "verify_cycles=<n> iterations=<n>" on the UART.
+ */
+static void BENCH_passwordVerify(BENCH_PasswordVerifyType password_verify, uint8 hash_iterations)
+{
+	uint8 password[PASSWORD_LENGTH] = { 0 };
+	uint32 cycles;
+	BENCH_start();
+	password_verify(password);
+	cycles = BENCH_stop();
+	BENCH_send("verify_cycles=", cycles, FALSE);
+	BENCH_send(" iterations=", hash_iterations, TRUE);
+}
+#endif
+
+#ifdef LINK_CIPHER_BENCHMARK
+/*
+ * Description :
+ * Count the CPU cycles of the link cipher, then send
+ * "ascon_empty_cycles=<n> ascon_cycles_per_byte=<n> command_frame_cycles=<n>" on the UART:
+ * the fixed cost of a message (initialization and finalization), the cost of each
+ * 64 bytes message byte, and the check of a received 2 bytes command frame.
+ */
+static void BENCH_linkCipher(void)
+{
+	uint8 key[ASCON_KEY_SIZE] = { 0 };
+	uint8 nonce[ASCON_NONCE_SIZE] = { 0 };
+	uint8 message[64] = { 0 };
+	uint8 tag[SLINK_TAG_SIZE];
+	uint32 empty;
+	uint32 full;
+	uint32 command;
+
+	BENCH_start();
+	ASCON_encrypt(key, nonce, NULL_PTR, 0, message, message, 0, tag, SLINK_TAG_SIZE);
+	empty = BENCH_stop();
+	BENCH_start();
+	ASCON_encrypt(key, nonce, NULL_PTR, 0, message, message, sizeof(message), tag, SLINK_TAG_SIZE);
+	full = BENCH_stop();
+	BENCH_start();
+	ASCON_decrypt(key, nonce, NULL_PTR, 0, message, message, 2, tag, SLINK_TAG_SIZE);
+	command = BENCH_stop();
+
+	BENCH_send("ascon_empty_cycles=", empty, FALSE);
+	BENCH_send(" ascon_cycles_per_byte=", (full - empty) / sizeof(message), FALSE);
+	BENCH_send(" command_frame_cycles=", command, TRUE);
+}
+#endif
+
+#ifdef TOTP_BENCHMARK
+/*
+ * Description :
+ * Count the CPU cycles of a one-time code verify (2 SHA-1 blocks per time step),
+ * then send "totp_verify_cycles_w1=<n> w3=<n> w5=<n>" on the UART.
+ */
+static void BENCH_oneTimeCode(void)
+{
+	uint32 cycles[3];
+	uint8 window;
+	for(window = 1; window <= 5; window += 2)
+	{
+		BENCH_start();
+		TOTP_verify(0, 1000, PASSWORD_LENGTH, window);
+		cycles[window / 2] = BENCH_stop();
+	}
+	BENCH_send("totp_verify_cycles_w1=", cycles[0], FALSE);
+	BENCH_send(" w3=", cycles[1], FALSE);
+	BENCH_send(" w5=", cycles[2], TRUE);
+}
+#endif
+
+#ifdef DRIVER_BENCHMARK
+/*
+ * Description :
+ * Count the CPU cycles of each driver primitive of this ECU, minus the cost of an
+ * empty measure, then send them on the UART as a CSV table:
+ * "primitive,case,cycles_min,cycles_max,time_ns_max", one measure per row so the min
+ * and max are the same. The LCD and keypad (HMI ECU) and Timer1_Init (Timer1 does the
+ * count) are only measured by the host bench (Host/bench).
+ */
+static void BENCH_drivers(void)
+{
+	static const char *const rows[BENCH_DRIVER_ROWS] = {
+			"uart_send_byte,idle,", "uart_send_byte,busy,",
+			"eeprom_read_byte,random,", "eeprom_write_byte,byte,",
+			"gpio_write_pin,pin,", "dc_motor_rotate,start,", "dc_motor_rotate,reverse,",
+			"dc_motor_rotate,stop,", "dc_motor_rotate,stopped," };
+	uint32 cycles[BENCH_DRIVER_ROWS];
+	uint32 overhead;
+	uint8 data = 0;
+	uint8 row;
+
+	BENCH_start();
+	overhead = BENCH_stop();
+
+	_delay_ms(5);
+	/* Let the previous output leave the transmitter (two frames at 4800 baud and more) */
+	BENCH_start();
+	UART_sendByte('#');
+	cycles[0] = BENCH_stop();
+	UART_sendByte('#');
+	/* UDR was free again as soon as the first byte moved to the shift register */
+	BENCH_start();
+	UART_sendByte('\n');
+	cycles[1] = BENCH_stop();
+	/* Waits for the first byte to leave: about one frame */
+
+	_delay_ms(BENCH_EEPROM_WRITE_TIME_MS);
+	/* The boot counter write cycle must be over */
+	BENCH_start();
+	EEPROM_readByte(BENCH_EEPROM_ADDRESS, &data);
+	cycles[2] = BENCH_stop();
+	BENCH_start();
+	EEPROM_writeByte(BENCH_EEPROM_ADDRESS, data);
+	cycles[3] = BENCH_stop();
+	/* Same value written back: the saved attempts are kept */
+	_delay_ms(BENCH_EEPROM_WRITE_TIME_MS);
+
+	DcMotor_init();
+	BENCH_start();
+	GPIO_writePin(DcMotor_PORT, DcMotor_PIN, LOGIC_LOW);
+	cycles[4] = BENCH_stop();
+	/* The motor is stopped, its input is already low */
+	BENCH_start();
+	DcMotor_Rotate(CW, 50);
+	cycles[5] = BENCH_stop();
+	BENCH_start();
+	DcMotor_Rotate(A_CW, 50);
+	cycles[6] = BENCH_stop();
+	/* A reversal includes the dead-time */
+	BENCH_start();
+	DcMotor_Rotate(STOP, 0);
+	cycles[7] = BENCH_stop();
+	/* The door only moved for a few microseconds */
+	BENCH_start();
+	DcMotor_Rotate(STOP, 0);
+	cycles[8] = BENCH_stop();
+
+	UART_sendString((const uint8*)"primitive,case,cycles_min,cycles_max,time_ns_max\r\n");
+	for(row = 0; row < BENCH_DRIVER_ROWS; row++)
+	{
+		cycles[row] -= overhead;
+		BENCH_send(rows[row], cycles[row], FALSE);
+		BENCH_send(",", cycles[row], FALSE);
+		BENCH_send(",", cycles[row] * (1000000000UL / F_CPU), TRUE);
+	}
+}
+#endif
+
+#endif /* BENCH_ENABLED */
@@ -0,0 +1,68 @@
+ /******************************************************************************
+ *
+ * Module: Bench
+ *
+ * File Name: bench.h
+ *
+ * Description: Header file for the boot benchmarks of Control ECU: CPU cycles counted
+ *              with Timer1 and reported on the UART, enabled one by one below
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include "UTIL/std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*#define PASSWORD_HASH_BENCHMARK*/
+/* Report the cycles of one password verify */
+/*#define LINK_CIPHER_BENCHMARK*/
+/* Report the cycles per byte of the link cipher */
+/*#define TOTP_BENCHMARK*/
+/* Report the cycles of a one-time code verify for windows 1, 3 and 5 */
+/*#define DRIVER_BENCHMARK*/
+/* Report the cycles of each driver primitive as CSV rows
+ * "primitive,case,cycles_min,cycles_max,time_ns_max" (same table as Host/bench) */
+
+#if defined(PASSWORD_HASH_BENCHMARK) || defined(LINK_CIPHER_BENCHMARK) || defined(TOTP_BENCHMARK) \
+	|| defined(DRIVER_BENCHMARK)
+#define BENCH_ENABLED
+#endif
+
+#if defined(ISR_LATENCY) && defined(BENCH_ENABLED)
+#error "ISR_LATENCY and the benchmarks both need Timer1"
+#endif
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* Password check of the application: MATCH_xxx flags of the password, 0 if it is wrong */
+typedef uint8 (*BENCH_PasswordVerifyType)(const uint8 *password);
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+#ifdef BENCH_ENABLED
+
+/*
+ * Description :
+ * Run the benchmarks of this build and send their results on the UART. Called at boot,
+ * after the UART and the EEPROM are initialized and before the system tick is started,
+ * so nothing else is counted. The password check is measured with the iterations given.
+ */
+void BENCH_run(BENCH_PasswordVerifyType password_verify, uint8 hash_iterations);
+
+#else
+
+#define BENCH_run(password_verify, hash_iterations)
+
+#endif /* BENCH_ENABLED */
+
+#endif /* BENCH_H_ */
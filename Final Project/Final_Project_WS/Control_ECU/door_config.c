@@ -0,0 +1,121 @@
+ /******************************************************************************
+ *
+ * Module: Door Config
+ *
+ * File Name: door_config.c
+ *
+ * Description: Source file for the door config: timing profile, motor speed and attempt limits,
+ *              kept in the EEPROM and set over the link
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#include "door_config.h"
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Function responsible for reading a big endian 16-bit value
+ */
+static uint16 CONFIG_readWord(const uint8 *bytes);
+
+/*
+ * Function responsible for writing a big endian 16-bit value
+ */
+static void CONFIG_writeWord(uint8 *bytes, uint16 value);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Read a config from its link layout (CONFIG_SIZE bytes).
+ * Returns FALSE, leaving the config untouched, for another version or a value out of range.
+ */
+boolean CONFIG_decode(const uint8 *bytes, CONFIG_Type *config)
+{
+	CONFIG_Type decoded;
+	if(bytes[CONFIG_VERSION_OFFSET] != CONFIG_VERSION)
+	{
+		return FALSE;
+	}
+	decoded.motion_ms = CONFIG_readWord(&bytes[CONFIG_MOTION_TIME_OFFSET]);
+	decoded.ramp_ms = CONFIG_readWord(&bytes[CONFIG_RAMP_TIME_OFFSET]);
+	decoded.hold_ms = CONFIG_readWord(&bytes[CONFIG_HOLD_TIME_OFFSET]);
+	decoded.alarm_ms = CONFIG_readWord(&bytes[CONFIG_ALARM_TIME_OFFSET]);
+	decoded.motor_speed = bytes[CONFIG_MOTOR_SPEED_OFFSET];
+	decoded.free_attempts = bytes[CONFIG_FREE_ATTEMPTS_OFFSET];
+	decoded.lockout_s = CONFIG_readWord(&bytes[CONFIG_LOCKOUT_TIME_OFFSET]);
+	if(decoded.motion_ms < CONFIG_MIN_MOTION_MS || decoded.motion_ms > CONFIG_MAX_MOTION_MS
+			|| (decoded.motion_ms % DOOR_TRAVEL_TIME_UNIT_MS) != 0
+			|| decoded.ramp_ms > CONFIG_MAX_RAMP_MS
+			|| decoded.hold_ms < CONFIG_MIN_HOLD_MS || decoded.hold_ms > CONFIG_MAX_HOLD_MS
+			|| decoded.alarm_ms < CONFIG_MIN_ALARM_MS || decoded.alarm_ms > CONFIG_MAX_ALARM_MS
+			|| decoded.motor_speed < CONFIG_MIN_MOTOR_SPEED || decoded.motor_speed > CONFIG_MAX_MOTOR_SPEED
+			|| decoded.free_attempts < CONFIG_MIN_FREE_ATTEMPTS || decoded.free_attempts > CONFIG_MAX_FREE_ATTEMPTS
+			|| decoded.lockout_s < CONFIG_MIN_LOCKOUT_S || decoded.lockout_s > CONFIG_MAX_LOCKOUT_S)
+	{
+		return FALSE;
+	}
+	*config = decoded;
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Write a config in its link layout (CONFIG_SIZE bytes).
+ */
+void CONFIG_encode(const CONFIG_Type *config, uint8 *bytes)
+{
+	bytes[CONFIG_VERSION_OFFSET] = CONFIG_VERSION;
+	CONFIG_writeWord(&bytes[CONFIG_MOTION_TIME_OFFSET], config->motion_ms);
+	CONFIG_writeWord(&bytes[CONFIG_RAMP_TIME_OFFSET], config->ramp_ms);
+	CONFIG_writeWord(&bytes[CONFIG_HOLD_TIME_OFFSET], config->hold_ms);
+	CONFIG_writeWord(&bytes[CONFIG_ALARM_TIME_OFFSET], config->alarm_ms);
+	bytes[CONFIG_MOTOR_SPEED_OFFSET] = config->motor_speed;
+	bytes[CONFIG_FREE_ATTEMPTS_OFFSET] = config->free_attempts;
+	CONFIG_writeWord(&bytes[CONFIG_LOCKOUT_TIME_OFFSET], config->lockout_s);
+}
+
+/*
+ * Description :
+ * Return the CRC-8 (polynomial 0x07) of the given bytes, saved after the config in the EEPROM.
+ */
+uint8 CONFIG_crc(const uint8 *bytes, uint8 length)
+{
+	uint8 crc = 0;
+	uint8 bit;
+	while(length != 0)
+	{
+		crc ^= *bytes;
+		for(bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x80) ? (uint8)((crc << 1) ^ 0x07) : (uint8)(crc << 1);
+		}
+		bytes++;
+		length--;
+	}
+	return crc;
+}
+
+/*
+ * Description :
+ * Read a big endian 16-bit value
+ */
+static uint16 CONFIG_readWord(const uint8 *bytes)
+{
+	return ((uint16)bytes[0] << 8) | bytes[1];
+}
+
+/*
+ * Description :
+ * Write a big endian 16-bit value
+ */
+static void CONFIG_writeWord(uint8 *bytes, uint16 value)
+{
+	bytes[0] = (uint8)(value >> 8);
+	bytes[1] = (uint8)value;
+}
@@ -0,0 +1,83 @@
+ /******************************************************************************
+ *
+ * Module: Door Config
+ *
+ * File Name: door_config.h
+ *
+ * Description: Header file for the door config: timing profile, motor speed and attempt limits,
+ *              kept in the EEPROM and set over the link
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef DOOR_CONFIG_H_
+#define DOOR_CONFIG_H_
+
+#include "UTIL/std_types.h"
+#include "UTIL/communication_commands.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * The EEPROM keeps the CONFIG_SIZE bytes of the link layout then their CRC-8.
+ * A block with a wrong CRC (never saved, or a write cut by a reset) or another
+ * CONFIG_VERSION is ignored: the defaults are used until a new config is set.
+ */
+#define CONFIG_BLOCK_SIZE                (CONFIG_SIZE + 1)
+
+/* Accepted ranges, the motion time is a multiple of the 100ms units of the travel time byte and fits it */
+#define CONFIG_MIN_MOTION_MS             1000
+#define CONFIG_MAX_MOTION_MS             25000
+#define CONFIG_MAX_RAMP_MS               5000
+#define CONFIG_MIN_HOLD_MS               1000
+#define CONFIG_MAX_HOLD_MS               60000
+#define CONFIG_MIN_ALARM_MS              1250  /* One alarm pattern */
+#define CONFIG_MAX_ALARM_MS              60000
+#define CONFIG_MIN_MOTOR_SPEED           10
+#define CONFIG_MAX_MOTOR_SPEED           100
+#define CONFIG_MIN_FREE_ATTEMPTS         1
+#define CONFIG_MAX_FREE_ATTEMPTS         10
+#define CONFIG_MIN_LOCKOUT_S             5
+#define CONFIG_MAX_LOCKOUT_S             60    /* Longest lockout (x128) fits the HMI 4 digits countdown */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	uint16 motion_ms;      /* Door motion fault timeout */
+	uint16 ramp_ms;        /* Door motor soft-start and soft-stop time */
+	uint16 hold_ms;        /* Time the door is held open */
+	uint16 alarm_ms;       /* Longest alarm time */
+	uint8 motor_speed;     /* Door motor cruise speed in percent */
+	uint8 free_attempts;   /* Password attempts before the first lockout */
+	uint16 lockout_s;      /* First lockout time */
+}CONFIG_Type;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Read a config from its link layout (CONFIG_SIZE bytes).
+ * Returns FALSE, leaving the config untouched, for another version or a value out of range.
+ */
+boolean CONFIG_decode(const uint8 *bytes, CONFIG_Type *config);
+
+/*
+ * Description :
+ * Write a config in its link layout (CONFIG_SIZE bytes).
+ */
+void CONFIG_encode(const CONFIG_Type *config, uint8 *bytes);
+
+/*
+ * Description :
+ * Return the CRC-8 (polynomial 0x07) of the given bytes, saved after the config in the EEPROM.
+ */
+uint8 CONFIG_crc(const uint8 *bytes, uint8 length);
+
+#endif /* DOOR_CONFIG_H_ */
@@ -1,291 +1,1039 @@
-/******************************************************************************
- *
- * Module: Application Layer
- *
- * File Name: main.c
- *
- * Description: Source file for the Control ECU
- *
- * Author: Yousouf Soliman
- *
- *******************************************************************************/
-
-
-/*******************************************************************************
- *                                Includes                                     *
- *******************************************************************************/
-#include "HAL/buzzer.h" /*Includes BUZZER module and related functions*/
-#include "HAL/external_eeprom.h" /*Includes External EEPROM module and related functions*/
-#include "HAL/motor.h" /*Includes MOTOR module and related functions*/
-#include "MCAL/twi.h" /*Includes TWI module and related functions*/
-#include "MCAL/uart.h" /*Includes UART module and related functions*/
-#include "MCAL/timer.h" /*Includes TIMER1/Timer0-PWM module and related functions*/
-#include "UTIL/communication_commands.h" /*Includes all communication agreements between Control ECU and HMI ECU*/
-#include <util/delay.h> /* For the delay functions */
-#include <avr/io.h> /* To enable and disable interrupts*/
-
-
-/*******************************************************************************
- *                               Definitions                                   *
- *******************************************************************************/
-#define Interrupts_Enable() (SREG |= (1<<7))
-#define Interrupts_Disable() (SREG &= ~(1<<7))
-/* Macro to Enable and Disable interrupts using I-bit in S-Reg*/
-
-#define PASSWORD_ADDRESS 0x0111
-
-/*******************************************************************************
- *                      Global Variables Declarations                          *
- *******************************************************************************/
-uint8 password[PASSWORD_LENGTH]; /* Array to store the password input from user in */
-uint8 password_verification[PASSWORD_LENGTH]; /* Array to store the password verification input from user in */
-
-
-
-/*******************************************************************************
- *                           Function Callback                                 *
- *******************************************************************************/
-void CountThreeSeconds(void){
-	/* 1 ISR = 3 seconds pass */
-	count3Seconds = 0;
-	/* mask flag to indicate that the count has finished */
-	Timer1_DeInit();
-	/* DeInit the timer for next use */
-}
-
-void CountFifteenSeconds(void){
-	/* 1 ISR = 3 seconds pass */
-	static uint8 counter = 0;
-	counter++;
-	TCNT1 = TIMER1_OVF_INITIAL_VALUE_FOR_3_SECONDS;
-	/* with each ISR, we shall reset the TCNT1 register the correct value */
-	if(counter == 5)
-	{
-		/* 5 ISRs = 15 seconds */
-	count15Seconds = 0;
-	/* mask flag to indicate that the count has finished */
-	Timer1_DeInit();
-	/* DeInit the timer for next use */
-	counter = 0;
-	/* mask count for next use */
-	}
-}
-
-void CountSixtySeconds(void){
-	/* 1 ISR = 3 seconds pass */
-	static uint8 counter = 0;
-	counter++;
-	TCNT1 = TIMER1_OVF_INITIAL_VALUE_FOR_3_SECONDS;
-	/* with each ISR, we shall reset the TCNT1 register the correct value */
-	if(counter == 20)
-	{
-		/* 20 ISRs = 60 seconds */
-	count60Seconds = 0;
-	/* mask flag to indicate that the count has finished */
-	Timer1_DeInit();
-	/* DeInit the timer for next use */
-	counter = 0;
-	/* mask count for next use */
-	}
-}
-/*******************************************************************************
- *                          Function Definitions                               *
- *******************************************************************************/
-
-/* Function Description:
- * Set the system password for first time entry or changing password
- * */
-void setSystemPassword(void) {
-	uint8 loop_counter = 0;
-	uint8 passwordsUnmatchedFlag = 0;
-	/* variable initialization */
-	/* Signal to HMI ECU that we are ready to receive password */
-	UART_sendByte(CONTROL_ECU_READY);
-	UART_receiveData(password, PASSWORD_LENGTH);
-	/* Receive password from HMI ECU */
-	UART_sendByte(CONTROL_ECU_READY);
-	/* Signal to HMI ECU that we are ready to receive password verification */
-	UART_receiveData(password_verification, PASSWORD_LENGTH);
-	/* Receive password verification from HMI ECU */
-
-	for (loop_counter = 0; loop_counter < PASSWORD_LENGTH; loop_counter++) {
-		if (password[loop_counter] != password_verification[loop_counter]) {
-			passwordsUnmatchedFlag = 1;
-			UART_sendByte(PASSWORDS_UNMATCHED);
-			break;
-		}
-	}
-	/* if any digits are unmatched (between pass and pass verify) we set the passwordsUnmatchedFlag and break from loop */
-
-	if (passwordsUnmatchedFlag == 0) {
-		UART_sendByte(PASSWORDS_MATCHED);
-		/* If all digits matched, we signal to HMI ECU that the passwords matched */
-		for (loop_counter = 0; loop_counter < PASSWORD_LENGTH; loop_counter++) {
-			EEPROM_writeByte(PASSWORD_ADDRESS + loop_counter,
-					password[loop_counter]);
-			_delay_ms(10);
-		}
-	}
-	/* If all digits are matched then passwords matched, start saving it in the EEPROM */
-}
-
-/* Function description:
- * Compare password to the saved password
- * */
-void passwordVerify(void) {
-	uint8 loop_counter = 0;
-	uint8 passwordsUnmatchedFlag = 0;
-	uint8 passwordCheck;
-	/* variable initialization */
-	/* Signal to HMI ECU that we are ready to receive password */
-	UART_sendByte(CONTROL_ECU_READY);
-	UART_receiveData(password, PASSWORD_LENGTH);
-	/* Receive password from HMI ECU */
-	for (loop_counter = 0; loop_counter < PASSWORD_LENGTH; loop_counter++) {
-		EEPROM_readByte(PASSWORD_ADDRESS + loop_counter, &passwordCheck);
-		/* fetch the saved password from the EEPROM */
-		if (password[loop_counter] != passwordCheck) {
-			passwordsUnmatchedFlag = 1;
-			UART_sendByte(CONTROL_ECU_READY);
-			UART_sendByte(PASSWORDS_UNMATCHED);
-			break;
-		}
-		_delay_ms(15);
-	}
-	/* if any digits are unmatched (between pass and the saved pass)
-	 *  we set the passwordsUnmatchedFlag and break from loop */
-
-
-	if (passwordsUnmatchedFlag == 0) {
-		UART_sendByte(CONTROL_ECU_READY);
-		UART_sendByte(PASSWORDS_MATCHED);
-	}
-	/* If all digits matched, we signal to HMI ECU that the passwords matched */
-}
-
-/* Function Description:
- * Unlock the door for 15s
- * Hold the door open for 3s
- * Close the door for 15s
- * */
-void unlockDoor(void) {
-
-	Timer1_ConfigType Timer1_Config;
-	Timer1_Config.initial_value = TIMER1_OVF_INITIAL_VALUE_FOR_3_SECONDS;
-	Timer1_Config.compare_value = 0;
-	Timer1_Config.prescalar = Prescalar_1024;
-	Timer1_Config.mode = Timer1_NormalMode;
-	/* Configure timer:
-	 * 1- Normal Mode (Overflow Mode)
-	 * 2- Prescalar set to 1024
-	 * 3- Count three seconds
-	 * 4- F_CPU = 8Mhz -> F_Timer = 8Khz -> Time for 1 tick = 0.000125s Ticks for 3s = 24000 tick
-	 * Timer initial value = 65535 - 24000 =  41535 */
-
-	DcMotor_Rotate(CW, 100);
-	/* Unlock the door using motor */
-	Timer1_Init(&Timer1_Config);
-	Timer1_setCall(CountFifteenSeconds);
-	count15Seconds = 1;
-	while (count15Seconds)
-		;
-	/* Start timer and Count 15 Seconds */
-
-	DcMotor_Rotate(STOP, 0);
-	/* Hold the door open */
-	Timer1_Init(&Timer1_Config);
-	Timer1_setCall(CountThreeSeconds);
-	count3Seconds = 1;
-	while (count3Seconds)
-		;
-	/* Start timer and Count 3 Seconds */
-
-	DcMotor_Rotate(A_CW, 100);
-	/* Lock the door using motor */
-	Timer1_Init(&Timer1_Config);
-	Timer1_setCall(CountFifteenSeconds);
-	count15Seconds = 1;
-	while (count15Seconds)
-		;
-	/* Start timer and Count 15 Seconds */
-	DcMotor_Rotate(STOP, 0);
-	/* Close the door shut */
-}
-
-/* Function description:
- * Initiate the alam protocol:
- * turn on the buzzer for 1 minute
- * */
-void alarm(void) {
-	Timer1_ConfigType Timer1_Config;
-	Timer1_Config.initial_value = TIMER1_OVF_INITIAL_VALUE_FOR_3_SECONDS;
-	Timer1_Config.compare_value = 0;
-	Timer1_Config.prescalar = Prescalar_1024;
-	Timer1_Config.mode = Timer1_NormalMode;
-	/* Configure timer:
-	 * 1- Normal Mode (Overflow Mode)
-	 * 2- Prescalar set to 1024
-	 * 3- Count three seconds
-	 * 4- F_CPU = 8Mhz -> F_Timer = 8Khz -> Time for 1 tick = 0.000125s Ticks for 3s = 24000 tick
-	 * Timer initial value = 65535 - 24000 =  41535 */
-	Buzzer_on();
-	/* Turn the buzzer on */
-	Timer1_Init(&Timer1_Config);
-	Timer1_setCall(CountSixtySeconds);
-	count60Seconds = 1;
-	while (count60Seconds)
-		;
-	/* Start timer and Count 60 Seconds */
-	Buzzer_off();
-	/* Turn the buzzer off */
-}
-
-/*
- * Function Description:
- * Main function:
- * Responsible for initiating all modules, enabling interrupts, and configuring UART
- * */
-int main(void) {
-	uint8 command;
-	UART_ConfigType UART_Config;
-	UART_Config.baud_rate = BaudRate_9600;
-	UART_Config.bit_data = BitData_8;
-	UART_Config.parity = Parity_Even;
-	UART_Config.stop_bit = StopBit_1;
-	UART_init(&UART_Config);
-	/* Initialize the UART driver with Baud-rate = 9600 bits/sec, 8_bit data, Even parity and One stop-bit */
-	TWI_ConfigType TWI_Config = { 0x10, 400000 };
-	TWI_init(&TWI_Config);
-	/* Initialize the TWI driver with slave address 10 and 400kbps data rate  */
-	Buzzer_init();
-	DcMotor_init();
-	/* Initialize the buzzer module and motor module */
-	Interrupts_Enable();
-	/* Enable interrupts */
-
-	for (;;) {
-		uint8 HMI_readyFlag;
-		do {
-			HMI_readyFlag = UART_receiveByte();
-		} while (HMI_readyFlag != HMI_ECU_READY);
-		/* Stay here until the theHMI ECU is ready to send us the command */
-		command = UART_receiveByte();
-		/* Receive the command */
-		switch (command) {
-		/* Switch on the command and act accordingly */
-		case SET_PASSWORD:
-			setSystemPassword();
-			break;
-		case CHECK_PASSWORD:
-			passwordVerify();
-			break;
-		case UNLOCK_DOOR:
-			unlockDoor();
-			break;
-		case ALARM:
-			alarm();
-			break;
-		}
-	}
-}
-
+/******************************************************************************
+ *
+ * Module: Application Layer
+ *
+ * File Name: main.c
+ *
+ * Description: Source file for the Control ECU
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "HAL/buzzer.h" /*Includes BUZZER module and related functions*/
+#include "HAL/external_eeprom.h" /*Includes External EEPROM module and related functions*/
+#include "HAL/motor.h" /*Includes MOTOR module and related functions*/
+#include "HAL/limit_switch.h" /*Includes LIMIT SWITCH module and related functions*/
+#include "MCAL/twi.h" /*Includes TWI module and related functions*/
+#include "MCAL/uart.h" /*Includes UART module and related functions*/
+#include "MCAL/timer.h" /*Includes TIMER1/Timer0-PWM module and related functions*/
+#include "MCAL/adc.h" /*Includes the ADC conversions whose noise goes in the password salt*/
+#include "UTIL/communication_commands.h" /*Includes all communication agreements between Control ECU and HMI ECU*/
+#include "UTIL/sha256.h" /*Includes the hash used to store the password*/
+#include "UTIL/secure_link.h" /*Includes the encrypted and authenticated link to HMI ECU*/
+#include "UTIL/totp.h" /*Includes the one-time codes accepted in place of the password*/
+#include "UTIL/totp_key.h" /*Includes the one-time code secret of this product*/
+#include "UTIL/stack_monitor.h" /*Includes the stack high-water mark reported to HMI ECU*/
+#include "UTIL/isr_latency.h" /*Includes the ISR latency stats reported to HMI ECU (ISR_LATENCY builds)*/
+#include "attempt_limiter.h" /*Includes the lockouts after wrong passwords*/
+#include "door_config.h" /*Includes the timing profile, motor speed and attempt limits set over the link*/
+#include "bench.h" /*Includes the boot benchmarks (bench builds)*/
+#include <avr/io.h> /* To enable and disable interrupts*/
+#include <avr/pgmspace.h> /* For the buzzer patterns in flash */
+#include <util/delay.h> /* For the EEPROM write cycles at boot */
+
+
+/*******************************************************************************
+ *                               Definitions                                   *
+ *******************************************************************************/
+#define Interrupts_Enable() (SREG |= (1<<7))
+#define Interrupts_Disable() (SREG &= ~(1<<7))
+/* Macro to Enable and Disable interrupts using I-bit in S-Reg*/
+
+#define PASSWORD_ADDRESS 0x0111
+#define PASSWORD_SALT_SIZE 8
+#define CREDENTIAL_SIZE (PASSWORD_SALT_SIZE + SHA256_DIGEST_SIZE)
+/* The EEPROM keeps a random salt then the digest of the password, never the password itself */
+#define SALT_NOISE_SAMPLES 16
+/* ADC conversions of the bandgap reference hashed into a new salt, their low bits are noise */
+#define PASSWORD_HASH_ITERATIONS 8
+/* Each iteration hashes one more SHA-256 block, more iterations slow down guessing from
+ * a copy of the EEPROM but add to the unlock time: tune it with PASSWORD_HASH_BENCHMARK (bench.h) */
+#define MATCH_PASSWORD 0x01
+#define MATCH_CODE 0x02
+/* What a password check matched: the saved password, a one-time code, or both (0 if none) */
+#define PASSWORD_CHANGE_WINDOW_S 60
+/* Once the saved password is checked, a SET_PASSWORD is accepted during this time */
+#define TOTP_WINDOW 3
+/* Time steps checked around the current one (1, 3, 5...): tolerated clock drift is (TOTP_WINDOW / 2) * 30s */
+#define LINK_SESSION_ADDRESS 0x0100
+/* Boot counter (4 bytes): a new secure link session number is taken from it at every boot */
+#define ATTEMPTS_ADDRESS 0x0104
+/* Wrong password attempts count (1 byte), saved before each check so a reset can't undo it */
+#define CONFIG_ADDRESS 0x0140
+/* Door config block (CONFIG_BLOCK_SIZE bytes), after the credential */
+
+#define DOOR_MOTION_TIME_MS 15000
+/* Fault timeout: the door must reach its limit switch before this time passes */
+#define DOOR_RAMP_TIME_MS 1000
+/* Soft-start and soft-stop time of the door motor */
+#define DOOR_HOLD_TIME_MS 3000
+/* Time the door is held open between unlocking and locking */
+#define DOOR_MOTOR_SPEED 100
+/* Cruise speed of the door motor in percent */
+#define ALARM_PATTERN_MS 1250
+#define ALARM_TIME_MS 60000
+/* The alarm pattern is played for 1 minute */
+/* The values above are the defaults of the door config, until another one is set with SET_CONFIG */
+#define EEPROM_WRITE_TIME_MS 10
+/* Write cycle time of the external EEPROM, one byte is written per cycle */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef enum {
+	LINK_WAIT_READY, LINK_WAIT_COMMAND, LINK_RX_PASSWORD, LINK_RX_VERIFICATION, LINK_RX_STREAM_DIGIT, LINK_RX_TIME,
+	LINK_RX_CONFIG
+} Control_LinkState;
+/* Where the command parser is in the byte stream received from HMI ECU */
+
+typedef enum {
+	DOOR_IDLE, DOOR_OPENING, DOOR_HOLD, DOOR_CLOSING
+} Control_DoorState;
+/* Phase of the door unlock cycle */
+
+/*******************************************************************************
+ *                      Global Variables Declarations                          *
+ *******************************************************************************/
+uint8 password[PASSWORD_LENGTH]; /* Array to store the password input from user in */
+uint8 password_verification[PASSWORD_LENGTH]; /* Array to store the password verification input from user in */
+
+const CONFIG_Type g_defaultConfig = { DOOR_MOTION_TIME_MS, DOOR_RAMP_TIME_MS, DOOR_HOLD_TIME_MS,
+		ALARM_TIME_MS, DOOR_MOTOR_SPEED, LIMITER_FREE_ATTEMPTS, LIMITER_BASE_LOCKOUT_S };
+CONFIG_Type g_config; /* Door config in use, read once from the EEPROM at boot */
+uint8 g_configBlock[CONFIG_BLOCK_SIZE]; /* Config and its CRC as saved in the EEPROM */
+uint8 g_configStoreIndex = CONFIG_BLOCK_SIZE; /* Next config byte to write in the EEPROM, CONFIG_BLOCK_SIZE if none */
+uint8 g_linkConfig[CONFIG_SIZE]; /* Config received with SET_CONFIG */
+
+DcMotor_ProfileType g_doorOpenProfile = { CW, DOOR_MOTOR_SPEED, DcMotor_RAMP_S_CURVE,
+		DOOR_RAMP_TIME_MS, DOOR_RAMP_TIME_MS, DOOR_MOTION_TIME_MS };
+/* Unlock the door: soft-start, cruise speed, soft-stop */
+DcMotor_ProfileType g_doorCloseProfile = { A_CW, DOOR_MOTOR_SPEED, DcMotor_RAMP_S_CURVE,
+		DOOR_RAMP_TIME_MS, DOOR_RAMP_TIME_MS, DOOR_MOTION_TIME_MS };
+/* Lock the door: soft-start, cruise speed, soft-stop */
+
+const Buzzer_StepType g_alarmSteps[] PROGMEM = { { 150, Buzzer_ON }, { 100, Buzzer_OFF },
+		{ 150, Buzzer_ON }, { 100, Buzzer_OFF }, { 150, Buzzer_ON }, { 600, Buzzer_OFF }, { 0, Buzzer_OFF } };
+Buzzer_PatternType g_alarmPattern = { g_alarmSteps, ALARM_TIME_MS / ALARM_PATTERN_MS };
+/* Alarm: three short beeps then a pause (1.25s), repeated for the config alarm time */
+Buzzer_PatternType g_lockoutPattern = { g_alarmSteps, 0 };
+/* Alarm played when a lockout starts, for the lockout time but at most the config alarm time */
+
+volatile uint16 g_tickMs = 0; /* Free running system time in ms, wraps around */
+volatile uint16 g_doorTravelMs = 0; /* Time the door has been moving in the current phase */
+volatile uint8 g_doorEndReached = 0; /* Set when the target limit switch stops the motor */
+volatile LimitSwitch_Id g_doorTarget = LimitSwitch_OPEN; /* Limit switch that ends the current phase */
+
+Control_LinkState g_linkState = LINK_WAIT_READY; /* Command parser state */
+uint8 g_linkCommand; /* Command whose data is being received */
+uint8 *g_linkRxBuffer; /* Where the data bytes of the command go */
+uint8 g_linkRxCount; /* Number of data bytes received */
+uint8 g_linkTime[4]; /* Unix time received with SET_TIME */
+
+SHA256_ContextType g_streamHash; /* Hash of the salt and the digits streamed so far */
+uint8 g_streamError = 0xFF; /* Non zero if too many digits were streamed or no check is started */
+uint8 g_streamCount = 0; /* Number of streamed digits */
+uint8 g_streamDigits[PASSWORD_LENGTH]; /* Streamed digits, for the one-time code check */
+
+Control_DoorState g_doorState = DOOR_IDLE; /* Door unlock cycle state */
+uint8 g_doorAborted = 0; /* Set when an ABORT command stopped the door cycle */
+uint16 g_doorHoldStartMs; /* Time the door hold started */
+
+uint8 g_savedCredential[CREDENTIAL_SIZE]; /* Copy of the salt and password digest saved in the EEPROM */
+uint8 g_storeIndex = CREDENTIAL_SIZE; /* Next credential byte to write in the EEPROM, CREDENTIAL_SIZE if none */
+uint16 g_storeLastWriteMs; /* Time of the last EEPROM write */
+
+volatile uint32 g_epochSeconds = 0; /* Unix time set with SET_TIME, 0 if not set */
+volatile uint32 g_uptimeSeconds = 0; /* Time since the boot, for the lockouts */
+volatile uint16 g_secondMs = 0; /* Milliseconds in the current second */
+uint8 g_savedFailures; /* Wrong attempts count saved in the EEPROM */
+boolean g_passwordChangeAllowed = FALSE; /* Set when the saved password was checked for a change */
+uint32 g_passwordCheckSeconds; /* Uptime of that check */
+const uint8 g_totpSecret[] = TOTP_SECRET;
+
+
+/*******************************************************************************
+ *                           Function Callback                                 *
+ *******************************************************************************/
+void Control_tick(void){
+	/* 1 ISR = 1 millisecond passes */
+	g_tickMs++;
+	if (!DcMotor_isProfileDone()) {
+		g_doorTravelMs++;
+	}
+	/* Measure the actual door travel time */
+	DcMotor_profileTick();
+	/* Advance the door motion profile */
+	Buzzer_tick();
+	/* Advance the buzzer pattern */
+	g_secondMs++;
+	if (g_secondMs == 1000) {
+		g_secondMs = 0;
+		g_uptimeSeconds++;
+		if (g_epochSeconds != 0) {
+			g_epochSeconds++;
+		}
+	}
+	/* Count the uptime, and the Unix time once it is set */
+}
+
+void DoorOpenReached(void){
+	/* Open limit switch pressed */
+	if (g_doorTarget == LimitSwitch_OPEN && !DcMotor_isProfileDone()) {
+		DcMotor_stopProfile();
+		g_doorEndReached = 1;
+	}
+	/* Stop the motor immediately at the end of travel */
+}
+
+void DoorClosedReached(void){
+	/* Closed limit switch pressed */
+	if (g_doorTarget == LimitSwitch_CLOSED && !DcMotor_isProfileDone()) {
+		DcMotor_stopProfile();
+		g_doorEndReached = 1;
+	}
+	/* Stop the motor immediately at the end of travel */
+}
+
+/*******************************************************************************
+ *                          Function Definitions                               *
+ *******************************************************************************/
+
+/* Function Description:
+ * Read the system time, the tick ISR updates it
+ * */
+uint16 getTickMs(void) {
+	uint16 now;
+	Interrupts_Disable();
+	now = g_tickMs;
+	Interrupts_Enable();
+	/* Both bytes are read without the tick changing them in between */
+	return now;
+}
+
+/* Function Description:
+ * Compare two byte arrays, all the bytes are compared whatever the result
+ * so the time taken doesn't tell where the first difference is
+ * Returns: TRUE if all bytes match
+ * */
+boolean bytesMatch(const uint8 *first, const uint8 *second, uint8 length) {
+	uint8 loop_counter;
+	uint8 diff = 0;
+	for (loop_counter = 0; loop_counter < length; loop_counter++) {
+		diff |= first[loop_counter] ^ second[loop_counter];
+	}
+	return (diff == 0);
+}
+
+/* Function Description:
+ * Start hashing a password: the salt saved with the credential goes first
+ * */
+void startPasswordHash(SHA256_ContextType *context) {
+	SHA256_init(context);
+	SHA256_update(context, g_savedCredential, PASSWORD_SALT_SIZE);
+}
+
+/* Function Description:
+ * Finish hashing a password whose digits were added to the context:
+ * digest = H(salt, password) then PASSWORD_HASH_ITERATIONS - 1 times digest = H(salt, digest)
+ * */
+void finishPasswordHash(SHA256_ContextType *context, uint8 *digest) {
+	uint8 loop_counter;
+	SHA256_final(context, digest);
+	for (loop_counter = 1; loop_counter < PASSWORD_HASH_ITERATIONS; loop_counter++) {
+		startPasswordHash(context);
+		SHA256_update(context, digest, SHA256_DIGEST_SIZE);
+		SHA256_final(context, digest);
+	}
+}
+
+/* Function Description:
+ * Read the Unix time, the tick ISR updates it
+ * Returns: the Unix time in seconds, 0 if it was never set
+ * */
+uint32 getEpochSeconds(void) {
+	uint32 now;
+	Interrupts_Disable();
+	now = g_epochSeconds;
+	Interrupts_Enable();
+	return now;
+}
+
+/* Function Description:
+ * Read the time since the boot, the tick ISR updates it
+ * Returns: the uptime in seconds
+ * */
+uint32 getUptimeSeconds(void) {
+	uint32 now;
+	Interrupts_Disable();
+	now = g_uptimeSeconds;
+	Interrupts_Enable();
+	return now;
+}
+
+/* Function Description:
+ * Set the Unix time received with SET_TIME (4 bytes, big endian)
+ * */
+void setEpochSeconds(const uint8 *time) {
+	uint32 now = ((uint32)time[0] << 24) | ((uint32)time[1] << 16) | ((uint32)time[2] << 8) | time[3];
+	Interrupts_Disable();
+	g_epochSeconds = now;
+	Interrupts_Enable();
+}
+
+/* Function Description:
+ * Check the digits against the one-time codes of the time steps around the current time,
+ * a code is accepted once
+ * Returns: TRUE if the digits are a valid code, FALSE if not or if the time is not set
+ * */
+boolean oneTimeCodeVerify(const uint8 *digits) {
+	uint32 now = getEpochSeconds();
+	uint32 code = 0;
+	uint8 loop_counter;
+	if (now == 0) {
+		return FALSE;
+	}
+	for (loop_counter = 0; loop_counter < PASSWORD_LENGTH; loop_counter++) {
+		code = code * 10 + digits[loop_counter];
+	}
+	return TOTP_verify(code, now / TOTP_STEP_SECONDS, PASSWORD_LENGTH, TOTP_WINDOW);
+}
+
+/* Function Description:
+ * Compare a password to the saved credential, the digests are compared in constant time.
+ * A valid one-time code is accepted too
+ * Returns: MATCH_PASSWORD and/or MATCH_CODE if the password or the code is right, 0 if not
+ * */
+uint8 passwordVerify(const uint8 *password) {
+	SHA256_ContextType context;
+	uint8 digest[SHA256_DIGEST_SIZE];
+	boolean code_matched = oneTimeCodeVerify(password);
+	startPasswordHash(&context);
+	SHA256_update(&context, password, PASSWORD_LENGTH);
+	finishPasswordHash(&context, digest);
+	return (bytesMatch(digest, &g_savedCredential[PASSWORD_SALT_SIZE], SHA256_DIGEST_SIZE) * MATCH_PASSWORD)
+			| (code_matched * MATCH_CODE);
+}
+
+/* Function Description:
+ * Check whether a password was ever set: the EEPROM of a new product is erased (all 0xFF)
+ * Returns: TRUE if a credential is saved
+ * */
+boolean passwordIsSet(void) {
+	uint8 loop_counter;
+	uint8 erased = 0xFF;
+	for (loop_counter = 0; loop_counter < CREDENTIAL_SIZE; loop_counter++) {
+		erased &= g_savedCredential[loop_counter];
+	}
+	return (erased != 0xFF);
+}
+
+/* Function Description:
+ * Replace the saved credential with a new salt and the digest of the new password.
+ * The salt is not a secret: it only has to differ between products and between changes, so
+ * digests precomputed for common passwords are useless. It hashes the previous salt (never the
+ * same twice on this product), the time the password was set and the noise in the low bits of
+ * the bandgap conversions (two products set at the same tick still differ). The bandgap is
+ * skipped while the door moves, the ADC samples the motor current then
+ * */
+void setSystemPassword(const uint8 *password) {
+	SHA256_ContextType context;
+	uint8 digest[SHA256_DIGEST_SIZE];
+	uint16 now = getTickMs();
+	uint16 sample;
+	uint8 timers[2];
+	uint8 loop_counter;
+	timers[0] = TCNT0;
+	timers[1] = TCNT2;
+	SHA256_init(&context);
+	SHA256_update(&context, g_savedCredential, PASSWORD_SALT_SIZE);
+	SHA256_update(&context, (const uint8 *)&now, sizeof(now));
+	SHA256_update(&context, timers, sizeof(timers));
+	if (g_doorState == DOOR_IDLE) {
+		for (loop_counter = 0; loop_counter < SALT_NOISE_SAMPLES; loop_counter++) {
+			sample = ADC_readChannel(ADC_CHANNEL_BANDGAP);
+			SHA256_update(&context, (const uint8 *)&sample, sizeof(sample));
+		}
+	}
+	SHA256_final(&context, digest);
+	for (loop_counter = 0; loop_counter < PASSWORD_SALT_SIZE; loop_counter++) {
+		g_savedCredential[loop_counter] = digest[loop_counter];
+	}
+	/* New salt */
+	startPasswordHash(&context);
+	SHA256_update(&context, password, PASSWORD_LENGTH);
+	finishPasswordHash(&context, &g_savedCredential[PASSWORD_SALT_SIZE]);
+	g_storeIndex = 0;
+	g_storeLastWriteMs = getTickMs() - EEPROM_WRITE_TIME_MS;
+	/* Save it in the EEPROM starting with the next service */
+}
+
+/* Function Description:
+ * Write one EEPROM byte now, after the write cycle of the previous byte
+ * */
+void eepromWriteNow(uint16 address, uint8 data) {
+	while ((uint16)(getTickMs() - g_storeLastWriteMs) < EEPROM_WRITE_TIME_MS) {
+	}
+	EEPROM_writeByte(address, data);
+	g_storeLastWriteMs = getTickMs();
+}
+
+/* Function Description:
+ * Start a password check: during a lockout it is refused right away from RAM
+ * (ATTEMPTS_LOCKED and the time left), without any hashing nor EEPROM access.
+ * Otherwise the attempt is counted as wrong and saved before the check
+ * Returns: TRUE if the check can be done
+ * */
+boolean attemptAllowed(void) {
+	uint16 left = LIMITER_lockoutLeft(getUptimeSeconds());
+	if (left != 0) {
+		SLINK_sendByte(ATTEMPTS_LOCKED);
+		SLINK_sendByte((uint8)(left >> 8));
+		SLINK_sendByte((uint8)left);
+		return FALSE;
+	}
+	LIMITER_attemptStarted(getUptimeSeconds());
+	g_savedFailures = LIMITER_getFailures(getUptimeSeconds());
+	eepromWriteNow(ATTEMPTS_ADDRESS, g_savedFailures);
+	return TRUE;
+}
+
+/* Function Description:
+ * Answer a password check: a right password clears the wrong attempts count,
+ * a wrong one that starts a lockout is answered ATTEMPTS_LOCKED and sounds the alarm.
+ * The cleared count is saved in the background by attemptsService, a reset before
+ * that only leaves this attempt counted as wrong. Only the saved password (not a
+ * one-time code) allows a password change
+ * Inputs: MATCH_xxx flags of the check
+ * */
+void attemptFinished(uint8 match) {
+	uint16 left;
+	g_passwordChangeAllowed = ((match & MATCH_PASSWORD) != 0);
+	g_passwordCheckSeconds = getUptimeSeconds();
+	if (match != 0) {
+		LIMITER_attemptSucceeded();
+		SLINK_sendByte(PASSWORDS_MATCHED);
+		return;
+	}
+	left = LIMITER_lockoutLeft(getUptimeSeconds());
+	if (left == 0) {
+		SLINK_sendByte(PASSWORDS_UNMATCHED);
+		return;
+	}
+	SLINK_sendByte(ATTEMPTS_LOCKED);
+	SLINK_sendByte((uint8)(left >> 8));
+	SLINK_sendByte((uint8)left);
+	g_lockoutPattern.repeat = ((uint32)left * 1000 >= g_config.alarm_ms) ? g_alarmPattern.repeat
+			: (uint8)(((uint32)left * 1000) / ALARM_PATTERN_MS);
+	if (g_lockoutPattern.repeat == 0) {
+		g_lockoutPattern.repeat = 1;
+	}
+	/* Less than one pattern of lockout left: play it once, a repeat of 0 would play it until Buzzer_stop() */
+	Buzzer_play(&g_lockoutPattern);
+	/* The tick plays the pattern and turns the buzzer off at its end */
+}
+
+/* Function Description:
+ * Add one digit of a streamed password check to its hash,
+ * the same work is done whether the digit is right or wrong
+ * */
+void streamDigitReceived(uint8 digit) {
+	if (g_streamCount < PASSWORD_LENGTH) {
+		SHA256_update(&g_streamHash, &digit, 1);
+		g_streamDigits[g_streamCount] = digit;
+		g_streamCount++;
+	} else {
+		g_streamError = 0xFF;
+	}
+	/* Extra digits can only make the check fail */
+}
+
+/* Function Description:
+ * End a streamed password check: the digits are already hashed, only the
+ * iterations are left, then the digests are compared in constant time.
+ * A valid one-time code is accepted too
+ * */
+void streamCheckFinished(void) {
+	uint8 digest[SHA256_DIGEST_SIZE];
+	uint8 result;
+	uint8 match;
+	boolean code_matched = FALSE;
+	if (!attemptAllowed()) {
+		g_streamError = 0xFF;
+		return;
+	}
+	/* Refused during a lockout, the hash isn't even finished */
+	finishPasswordHash(&g_streamHash, digest);
+	result = g_streamError | (g_streamCount ^ PASSWORD_LENGTH);
+	if (result == 0) {
+		code_matched = oneTimeCodeVerify(g_streamDigits);
+	}
+	match = (bytesMatch(digest, &g_savedCredential[PASSWORD_SALT_SIZE], SHA256_DIGEST_SIZE) * MATCH_PASSWORD)
+			| (code_matched * MATCH_CODE);
+	if (result != 0) {
+		match = 0;
+	}
+	attemptFinished(match);
+	g_streamError = 0xFF;
+	/* A new STREAM_CHECK_START is required before the next check */
+}
+
+/* Function Description:
+ * Start receiving the data bytes of a command in the required buffer
+ * */
+void startPasswordReception(Control_LinkState state, uint8 *buffer) {
+	g_linkState = state;
+	g_linkRxBuffer = buffer;
+	g_linkRxCount = 0;
+	SLINK_sendByte(CONTROL_ECU_READY);
+	/* Signal to HMI ECU that we are ready to receive the password */
+}
+
+/* Function Description:
+ * Accept a SET_PASSWORD: the first password of a new product, or a change within
+ * PASSWORD_CHANGE_WINDOW_S of a check of the saved password. Refused with ATTEMPTS_LOCKED
+ * and the time left during a lockout, with PASSWORD_CHANGE_REFUSED otherwise
+ * Returns: TRUE if the new password can be received
+ * */
+boolean passwordChangeAllowed(void) {
+	uint16 left = LIMITER_lockoutLeft(getUptimeSeconds());
+	if (left != 0) {
+		SLINK_sendByte(ATTEMPTS_LOCKED);
+		SLINK_sendByte((uint8)(left >> 8));
+		SLINK_sendByte((uint8)left);
+		return FALSE;
+	}
+	if (!passwordIsSet()) {
+		return TRUE;
+	}
+	if (g_passwordChangeAllowed && ((getUptimeSeconds() - g_passwordCheckSeconds) < PASSWORD_CHANGE_WINDOW_S)) {
+		return TRUE;
+	}
+	SLINK_sendByte(PASSWORD_CHANGE_REFUSED);
+	return FALSE;
+}
+
+/* Function Description:
+ * Handle a complete password frame:
+ * SET_PASSWORD: first the password, then its verification, if they match
+ * its salted digest is saved in the EEPROM in the background and the change is used up
+ * CHECK_PASSWORD: compare its digest to the saved one, unless a lockout is running
+ * */
+void passwordReceived(void) {
+	if (g_linkCommand == CHECK_PASSWORD) {
+		SLINK_sendByte(CONTROL_ECU_READY);
+		if (attemptAllowed()) {
+			attemptFinished(passwordVerify(password));
+		}
+		g_linkState = LINK_WAIT_READY;
+	} else if (g_linkState == LINK_RX_PASSWORD) {
+		startPasswordReception(LINK_RX_VERIFICATION, password_verification);
+		/* Now receive the password verification */
+	} else {
+		if (bytesMatch(password, password_verification, PASSWORD_LENGTH)) {
+			setSystemPassword(password);
+			g_passwordChangeAllowed = FALSE;
+			SLINK_sendByte(PASSWORDS_MATCHED);
+		} else {
+			SLINK_sendByte(PASSWORDS_UNMATCHED);
+		}
+		g_linkState = LINK_WAIT_READY;
+	}
+}
+
+/* Function Description:
+ * Start moving the door until the target limit switch is pressed, or until
+ * the profile fault timeout expires, or until the current monitor detects
+ * a stall or an over-current
+ * */
+void startDoorMotion(const DcMotor_ProfileType *profile, LimitSwitch_Id target) {
+	g_doorTarget = target;
+	g_doorEndReached = 0;
+	g_doorTravelMs = 0;
+	if (LimitSwitch_isPressed(target)) {
+		g_doorEndReached = 1;
+	} else {
+		DcMotor_startProfile(profile);
+	}
+	/* Skip the motion if the door already sits at the target switch */
+}
+
+/* Function Description:
+ * Report how a door motion ended and the actual travel time to HMI ECU
+ * Returns: the reported result (DOOR_MOTION_xxx)
+ * */
+uint8 reportDoorMotion(void) {
+	uint16 travel;
+	uint8 status;
+	if (g_doorAborted) {
+		status = DOOR_MOTION_ABORTED;
+	} else if (g_doorEndReached) {
+		status = DOOR_MOTION_DONE;
+	} else if (DcMotor_getFault() == DcMotor_FAULT_STALL) {
+		status = DOOR_MOTION_STALL;
+	} else if (DcMotor_getFault() == DcMotor_FAULT_OVER_CURRENT) {
+		status = DOOR_MOTION_OVER_CURRENT;
+	} else {
+		status = DOOR_MOTION_TIMEOUT;
+	}
+	travel = (g_doorTravelMs + (DOOR_TRAVEL_TIME_UNIT_MS / 2)) / DOOR_TRAVEL_TIME_UNIT_MS;
+	SLINK_sendByte(status);
+	SLINK_sendByte((uint8)travel);
+	/* Report how the phase ended and how long it took (in 100ms units) */
+	return status;
+}
+
+/* Function Description:
+ * Start the door unlock cycle with the config timings:
+ * Unlock the door until the open limit switch (15s fault timeout by default)
+ * Hold the door open (3s by default)
+ * Close the door until the closed limit switch
+ * A stalled or over-current motor aborts the cycle where it stopped
+ * */
+void unlockDoor(void) {
+	if (g_doorState != DOOR_IDLE) {
+		return;
+	}
+	/* One cycle at a time */
+	g_doorAborted = 0;
+	startDoorMotion(&g_doorOpenProfile, LimitSwitch_OPEN);
+	g_doorState = DOOR_OPENING;
+}
+
+/* Function Description:
+ * Advance the door unlock cycle on its events:
+ * end of a motion (limit switch, fault, timeout or abort) and end of the hold
+ * */
+void doorService(void) {
+	uint8 status;
+	switch (g_doorState) {
+	case DOOR_OPENING:
+		if (DcMotor_isProfileDone()) {
+			status = reportDoorMotion();
+			if (status == DOOR_MOTION_DONE || status == DOOR_MOTION_TIMEOUT) {
+				g_doorHoldStartMs = getTickMs();
+				g_doorState = DOOR_HOLD;
+				/* Hold the door open */
+			} else {
+				g_doorState = DOOR_IDLE;
+				/* Leave a jammed or aborted door where it is */
+			}
+		}
+		break;
+	case DOOR_HOLD:
+		if ((uint16)(getTickMs() - g_doorHoldStartMs) >= g_config.hold_ms) {
+			startDoorMotion(&g_doorCloseProfile, LimitSwitch_CLOSED);
+			g_doorState = DOOR_CLOSING;
+			/* Lock the door using motor, stopped by the closed limit switch */
+		}
+		break;
+	case DOOR_CLOSING:
+		if (DcMotor_isProfileDone()) {
+			reportDoorMotion();
+			g_doorState = DOOR_IDLE;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/* Function Description:
+ * Abort the door cycle (the door stays where it is) and the alarm
+ * */
+void abortAll(void) {
+	Buzzer_stop();
+	if (g_doorState == DOOR_IDLE) {
+		return;
+	}
+	g_doorAborted = 1;
+	if (g_doorState == DOOR_HOLD) {
+		g_doorTravelMs = 0;
+		reportDoorMotion();
+		g_doorState = DOOR_IDLE;
+		/* The locking motion is reported as aborted before it starts */
+	} else {
+		DcMotor_stopProfile();
+		/* The door service reports the aborted motion */
+	}
+}
+
+/* Function Description:
+ * Current state reported to a GET_STATUS command
+ * */
+uint8 getStatus(void) {
+	if (Buzzer_isPlaying()) {
+		return STATUS_ALARM;
+	}
+	switch (g_doorState) {
+	case DOOR_OPENING:
+		return STATUS_OPENING;
+	case DOOR_HOLD:
+		return STATUS_HOLD;
+	case DOOR_CLOSING:
+		return STATUS_CLOSING;
+	default:
+		return STATUS_IDLE;
+	}
+}
+
+/* Function Description:
+ * Write the next byte of the new credential in the EEPROM,
+ * one byte per EEPROM write cycle
+ * */
+void storeService(void) {
+	uint16 now;
+	if (g_storeIndex >= CREDENTIAL_SIZE) {
+		return;
+	}
+	now = getTickMs();
+	if ((uint16)(now - g_storeLastWriteMs) >= EEPROM_WRITE_TIME_MS) {
+		EEPROM_writeByte(PASSWORD_ADDRESS + g_storeIndex, g_savedCredential[g_storeIndex]);
+		g_storeIndex++;
+		g_storeLastWriteMs = now;
+	}
+}
+
+/* Function Description:
+ * Save the wrong attempts count when the decay has forgotten some of them,
+ * between the credential writes
+ * */
+void attemptsService(void) {
+	uint8 failures;
+	if (g_storeIndex < CREDENTIAL_SIZE
+			|| (uint16)(getTickMs() - g_storeLastWriteMs) < EEPROM_WRITE_TIME_MS) {
+		return;
+	}
+	failures = LIMITER_getFailures(getUptimeSeconds());
+	if (failures != g_savedFailures) {
+		g_savedFailures = failures;
+		EEPROM_writeByte(ATTEMPTS_ADDRESS, failures);
+		g_storeLastWriteMs = getTickMs();
+	}
+}
+
+/* Function Description:
+ * Use the door config in RAM: motor profiles, alarm time and attempt limits.
+ * A running door motion keeps its profile, the next one uses the new config
+ * */
+void applyConfig(void) {
+	g_doorOpenProfile.speed = g_config.motor_speed;
+	g_doorOpenProfile.ramp_up_ms = g_config.ramp_ms;
+	g_doorOpenProfile.ramp_down_ms = g_config.ramp_ms;
+	g_doorOpenProfile.total_ms = g_config.motion_ms;
+	g_doorCloseProfile.speed = g_config.motor_speed;
+	g_doorCloseProfile.ramp_up_ms = g_config.ramp_ms;
+	g_doorCloseProfile.ramp_down_ms = g_config.ramp_ms;
+	g_doorCloseProfile.total_ms = g_config.motion_ms;
+	g_alarmPattern.repeat = g_config.alarm_ms / ALARM_PATTERN_MS;
+	LIMITER_configure(g_config.free_attempts, g_config.lockout_s);
+}
+
+/* Function Description:
+ * Read the door config from the EEPROM once, the defaults are used
+ * if no valid config of this version was saved
+ * */
+void loadConfig(void) {
+	uint8 i;
+	for (i = 0; i < CONFIG_BLOCK_SIZE; i++) {
+		EEPROM_readByte(CONFIG_ADDRESS + i, &g_configBlock[i]);
+	}
+	g_config = g_defaultConfig;
+	if (CONFIG_crc(g_configBlock, CONFIG_SIZE) == g_configBlock[CONFIG_SIZE]) {
+		CONFIG_decode(g_configBlock, &g_config);
+	}
+	applyConfig();
+}
+
+/* Function Description:
+ * Send the door config in use to HMI ECU, it takes its display timings from it
+ * */
+void sendConfigReport(void) {
+	uint8 bytes[CONFIG_SIZE];
+	CONFIG_encode(&g_config, bytes);
+	SLINK_sendByte(CONFIG_REPORT);
+	SLINK_sendData(bytes, CONFIG_SIZE);
+}
+
+/* Function Description:
+ * Send the stack use of this ECU to HMI ECU, for its diagnostic screen
+ * */
+void sendStackReport(void) {
+	STACK_ReportType report;
+	uint8 bytes[STACK_REPORT_SIZE];
+	STACK_getReport(&report);
+	STACK_encode(&report, bytes);
+	SLINK_sendByte(STACK_REPORT);
+	SLINK_sendData(bytes, STACK_REPORT_SIZE);
+}
+
+#ifdef ISR_LATENCY
+/* Function Description:
+ * Send the latency stats of every instrumented ISR to HMI ECU, for its diagnostic screen
+ * */
+void sendLatencyReports(void) {
+	ISRLAT_StatsType stats;
+	uint8 bytes[LATENCY_REPORT_SIZE];
+	uint8 vector;
+	for (vector = 0; vector < ISRLAT_VECTORS_NUM; vector++) {
+		ISRLAT_getStats(vector, &stats);
+		ISRLAT_encode(vector, &stats, bytes);
+		SLINK_sendByte(LATENCY_REPORT);
+		SLINK_sendData(bytes, LATENCY_REPORT_SIZE);
+	}
+}
+#endif
+
+/* Function Description:
+ * Handle a config received with SET_CONFIG: use it at once if it is valid,
+ * and save it in the EEPROM in the background
+ * */
+void configReceived(void) {
+	if (!CONFIG_decode(g_linkConfig, &g_config)) {
+		SLINK_sendByte(CONFIG_REJECTED);
+		return;
+	}
+	applyConfig();
+	CONFIG_encode(&g_config, g_configBlock);
+	g_configBlock[CONFIG_SIZE] = CONFIG_crc(g_configBlock, CONFIG_SIZE);
+	g_configStoreIndex = 0;
+	/* A reset before the last byte leaves a wrong CRC: the defaults are used then */
+	sendConfigReport();
+}
+
+/* Function Description:
+ * Write the next byte of the new config in the EEPROM,
+ * one byte per EEPROM write cycle
+ * */
+void configService(void) {
+	uint16 now;
+	if (g_configStoreIndex >= CONFIG_BLOCK_SIZE) {
+		return;
+	}
+	now = getTickMs();
+	if ((uint16)(now - g_storeLastWriteMs) >= EEPROM_WRITE_TIME_MS) {
+		EEPROM_writeByte(CONFIG_ADDRESS + g_configStoreIndex, g_configBlock[g_configStoreIndex]);
+		g_configStoreIndex++;
+		g_storeLastWriteMs = now;
+	}
+}
+
+/* Function Description:
+ * Handle one byte received from HMI ECU:
+ * HMI_ECU_READY, then the command, then the command data (if any)
+ * */
+void linkByteReceived(uint8 data) {
+	switch (g_linkState) {
+	case LINK_WAIT_READY:
+		if (data == HMI_ECU_READY) {
+			g_linkState = LINK_WAIT_COMMAND;
+		}
+		/* Stay here until the HMI ECU is ready to send us the command */
+		break;
+	case LINK_WAIT_COMMAND:
+		g_linkCommand = data;
+		g_linkState = LINK_WAIT_READY;
+		switch (data) {
+		/* Switch on the command and act accordingly */
+		case SET_PASSWORD:
+			if (passwordChangeAllowed()) {
+				startPasswordReception(LINK_RX_PASSWORD, password);
+			}
+			break;
+		case CHECK_PASSWORD:
+			startPasswordReception(LINK_RX_PASSWORD, password);
+			break;
+		case GET_PASSWORD_STATE:
+			SLINK_sendByte(passwordIsSet() ? PASSWORD_IS_SET : PASSWORD_NOT_SET);
+			break;
+		case UNLOCK_DOOR:
+			g_passwordChangeAllowed = FALSE;
+			/* The check was for this door cycle, a change needs its own check */
+			unlockDoor();
+			break;
+		case ALARM:
+			Buzzer_play(&g_alarmPattern);
+			/* The tick plays the pattern and turns the buzzer off at its end */
+			break;
+		case GET_STATUS:
+			SLINK_sendByte(getStatus());
+			break;
+		case ABORT:
+			abortAll();
+			break;
+		case STREAM_CHECK_START:
+			startPasswordHash(&g_streamHash);
+			g_streamError = 0;
+			g_streamCount = 0;
+			break;
+		case STREAM_CHECK_DIGIT:
+			g_linkState = LINK_RX_STREAM_DIGIT;
+			/* The digit follows the command */
+			break;
+		case STREAM_CHECK_FINISH:
+			streamCheckFinished();
+			break;
+		case SET_TIME:
+			g_linkState = LINK_RX_TIME;
+			g_linkRxCount = 0;
+			/* The Unix time follows the command */
+			break;
+		case GET_CONFIG:
+			sendConfigReport();
+			break;
+		case GET_STACK:
+			sendStackReport();
+			break;
+#ifdef ISR_LATENCY
+		case GET_LATENCY:
+			sendLatencyReports();
+			break;
+#endif
+		case SET_CONFIG:
+			g_linkState = LINK_RX_CONFIG;
+			g_linkRxCount = 0;
+			/* The config follows the command */
+			break;
+		}
+		break;
+	case LINK_RX_STREAM_DIGIT:
+		streamDigitReceived(data);
+		g_linkState = LINK_WAIT_READY;
+		break;
+	case LINK_RX_TIME:
+		g_linkTime[g_linkRxCount] = data;
+		g_linkRxCount++;
+		if (g_linkRxCount == sizeof(g_linkTime)) {
+			setEpochSeconds(g_linkTime);
+			g_linkState = LINK_WAIT_READY;
+		}
+		break;
+	case LINK_RX_CONFIG:
+		g_linkConfig[g_linkRxCount] = data;
+		g_linkRxCount++;
+		if (g_linkRxCount == CONFIG_SIZE) {
+			configReceived();
+			g_linkState = LINK_WAIT_READY;
+		}
+		break;
+	case LINK_RX_PASSWORD:
+	case LINK_RX_VERIFICATION:
+		g_linkRxBuffer[g_linkRxCount] = data;
+		g_linkRxCount++;
+		if (g_linkRxCount == PASSWORD_LENGTH) {
+			passwordReceived();
+		}
+		break;
+	}
+}
+
+/* Function Description:
+ * Take the next secure link session number from the EEPROM boot counter
+ * and save it before it is used, so a session number is never used twice
+ * Returns: the new session number (never 0)
+ * */
+uint32 nextLinkSession(void) {
+	uint32 session = 0;
+	uint8 byte;
+	uint8 i;
+	for (i = 0; i < sizeof(session); i++) {
+		EEPROM_readByte(LINK_SESSION_ADDRESS + i, &byte);
+		session = (session << 8) | byte;
+	}
+	session++;
+	if (session == 0) {
+		session = 1;
+	}
+	/* An erased EEPROM reads 0xFFFFFFFF, session 0 means no session */
+	for (i = 0; i < sizeof(session); i++) {
+		EEPROM_writeByte(LINK_SESSION_ADDRESS + i, (uint8)(session >> (24 - 8 * i)));
+		_delay_ms(EEPROM_WRITE_TIME_MS);
+	}
+	return session;
+}
+
+/*
+ * Function Description:
+ * Main function:
+ * Responsible for initiating all modules, enabling interrupts, and configuring UART
+ * Then runs the event loop: every handler returns within a few ms
+ * (at most one link frame), so a command is accepted at any time,
+ * even while the door moves or the alarm plays. A password check is the exception:
+ * it holds the loop for its hash iterations and one-time code window (their cycles are
+ * given by PASSWORD_HASH_BENCHMARK and TOTP_BENCHMARK) and at most one EEPROM write
+ * cycle, to save the attempt before it. The other EEPROM writes are done in the background
+ * */
+int main(void) {
+	uint8 data;
+	uint32 session;
+	UART_ConfigType UART_Config;
+	STACK_init();
+	/* Put the canary after .bss, the free RAM was painted before main */
+	UART_Config.baud_rate = LINK_BAUD_RATE;
+	UART_Config.bit_data = BitData_8;
+	UART_Config.parity = Parity_Even;
+	UART_Config.stop_bit = StopBit_1;
+	UART_init(&UART_Config);
+	/* Initialize the UART driver with Baud-rate = 9600 bits/sec, 8_bit data, Even parity and One stop-bit */
+	TWI_ConfigType TWI_Config = { 0x10, 400000 };
+	TWI_init(&TWI_Config);
+	/* Initialize the TWI driver with slave address 10 and 400kbps data rate  */
+	for (data = 0; data < CREDENTIAL_SIZE; data++) {
+		EEPROM_readByte(PASSWORD_ADDRESS + data, &g_savedCredential[data]);
+	}
+	/* Fetch the saved credential from the EEPROM once */
+	loadConfig();
+	/* Fetch the door config from the EEPROM once, the attempt limits included */
+	EEPROM_readByte(ATTEMPTS_ADDRESS, &g_savedFailures);
+	LIMITER_init(g_savedFailures, getUptimeSeconds());
+	g_savedFailures = LIMITER_getFailures(getUptimeSeconds());
+	/* Wrong attempts before the reset: their lockout starts again */
+	TOTP_init(g_totpSecret, sizeof(g_totpSecret));
+	/* Precompute the one-time code key schedule */
+	session = nextLinkSession();
+	/* New link session for this boot */
+	BENCH_run(passwordVerify, PASSWORD_HASH_ITERATIONS);
+	/* Bench builds (bench.h) report their cycle counts here, before the system tick starts */
+	Buzzer_init();
+	DcMotor_init();
+	/* Initialize the buzzer module and motor module */
+	LimitSwitch_init();
+	LimitSwitch_setCallBack(LimitSwitch_OPEN, DoorOpenReached);
+	LimitSwitch_setCallBack(LimitSwitch_CLOSED, DoorClosedReached);
+	/* Stop the door motor from INT0/INT1 as soon as it reaches the end of travel */
+#ifdef ISR_LATENCY
+	ISRLAT_init();
+	/* Start the Timer1 time base of the ISR latency hooks */
+#endif
+	Timer2_ConfigType Timer2_Config;
+	Timer2_Config.compare_value = TIMER2_COMPARE_VALUE_FOR_1_MS;
+	Timer2_Config.prescalar = TIMER2_PRESCALAR_FOR_1_MS;
+	Timer2_Init(&Timer2_Config);
+	Timer2_setCall(Control_tick);
+	/* Start the 1ms system tick that runs the motor profiles */
+	Interrupts_Enable();
+	/* Enable interrupts */
+	SLINK_init(SLINK_ID_CONTROL, session);
+	/* Announce the session to HMI ECU */
+	sendConfigReport();
+	/* HMI ECU takes its display timings from it, in case it booted first */
+
+	for (;;) {
+		if (SLINK_receiveByte(&data)) {
+			linkByteReceived(data);
+		}
+		/* Link event */
+		doorService();
+		/* Limit switch, motor fault and hold timer events */
+		storeService();
+		attemptsService();
+		configService();
+		/* Background EEPROM writes */
+		SLINK_flush(getTickMs());
+		/* Send the bytes answered in this iteration in one frame */
+	}
+}
@@ -5,15 +5,18 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
 ../HAL/keypad.c \
-../HAL/lcd.c 
+../HAL/lcd.c \
+../HAL/lcd_widgets.c 
 
 OBJS += \
 ./HAL/keypad.o \
-./HAL/lcd.o 
+./HAL/lcd.o \
+./HAL/lcd_widgets.o 
 
 C_DEPS += \
 ./HAL/keypad.d \
-./HAL/lcd.d 
+./HAL/lcd.d \
+./HAL/lcd_widgets.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
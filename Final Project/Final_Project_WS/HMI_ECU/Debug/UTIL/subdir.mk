@@ -0,0 +1,33 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+C_SRCS += \
+../UTIL/ascon.c \
+../UTIL/secure_link.c \
+../UTIL/stack_monitor.c \
+../UTIL/isr_latency.c 
+
+OBJS += \
+./UTIL/ascon.o \
+./UTIL/secure_link.o \
+./UTIL/stack_monitor.o \
+./UTIL/isr_latency.o 
+
+C_DEPS += \
+./UTIL/ascon.d \
+./UTIL/secure_link.d \
+./UTIL/stack_monitor.d \
+./UTIL/isr_latency.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+UTIL/%.o: ../UTIL/%.c UTIL/subdir.mk
+	@echo 'Building file: $<'
+	@echo 'Invoking: AVR Compiler'
+	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega32 -DF_CPU=1000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
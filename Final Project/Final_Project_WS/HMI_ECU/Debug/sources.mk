@@ -21,5 +21,6 @@ C_DEPS :=
 SUBDIRS := \
 HAL \
 MCAL \
+UTIL \
 . \
 
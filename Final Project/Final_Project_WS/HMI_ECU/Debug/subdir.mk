@@ -4,13 +4,19 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
-../main.c 
+../main.c \
+../ui_messages.c \
+../password_entry.c 
 
 OBJS += \
-./main.o 
+./main.o \
+./ui_messages.o \
+./password_entry.o 
 
 C_DEPS += \
-./main.d 
+./main.d \
+./ui_messages.d \
+./password_entry.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -1,208 +1,438 @@
- /******************************************************************************
- *
- * Module: KEYPAD
- *
- * File Name: keypad.c
- *
- * Description: Source file for the Keypad driver
- *
- * Author: Yousouf Soliman
- *
- *******************************************************************************/
-#include "keypad.h"
-#include "../MCAL/gpio.h"
-#include <util/delay.h>
-
-/*******************************************************************************
- *                      Functions Prototypes(Private)                          *
- *******************************************************************************/
-
-#ifndef STANDARD_KEYPAD
-
-#if (KEYPAD_NUM_COLS == 3)
-/*
- * Function responsible for mapping the switch number in the keypad to
- * its corresponding functional number in the proteus for 4x3 keypad
- */
-static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number);
-#elif (KEYPAD_NUM_COLS == 4)
-/*
- * Function responsible for mapping the switch number in the keypad to
- * its corresponding functional number in the proteus for 4x4 keypad
- */
-static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number);
-#endif
-
-#endif /* STANDARD_KEYPAD */
-
-/*******************************************************************************
- *                      Functions Definitions                                  *
- *******************************************************************************/
-
-/*
- * Description :
- * Enable the keypad to accept input from user
- */
-void KEYPAD_enable(void){
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+1, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+2, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+3, PIN_INPUT);
-
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+1, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+2, PIN_INPUT);
-#if(KEYPAD_NUM_COLS == 4)
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+3, PIN_INPUT);
-#endif
-}
-
-/*
- * Description :
- * Disable the keypad from accepting any input from user
- */
-void KEYPAD_disable(void){
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID, PIN_OUTPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+1, PIN_OUTPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+2, PIN_OUTPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+3, PIN_OUTPUT);
-
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID, PIN_OUTPUT);
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+1, PIN_OUTPUT);
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+2, PIN_OUTPUT);
-#if(KEYPAD_NUM_COLS == 4)
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+3, PIN_OUTPUT);
-#endif
-}
-
-
-/*
- * Description :
- * Get the pressed key ASCII value
- */
-
-uint8 KEYPAD_getPressedKey(void)
-{
-	uint8 col,row;
-	KEYPAD_enable();
-	for(;;)
-	{
-		for(row=0 ; row<KEYPAD_NUM_ROWS ; row++) /* loop for rows */
-		{
-			/* 
-			 * Each time setup the direction for all keypad port as input pins,
-			 * except this row will be output pin
-			 */
-			GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_OUTPUT);
-
-			/* Set/Clear the row output pin */
-			GPIO_writePin(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+row, KEYPAD_BUTTON_PRESSED);
-
-			for(col=0 ; col<KEYPAD_NUM_COLS ; col++) /* loop for columns */
-			{
-				/* Check if the switch is pressed in this column */
-				if(GPIO_readPin(KEYPAD_COL_PORT_ID,KEYPAD_FIRST_COL_PIN_ID+col) == KEYPAD_BUTTON_PRESSED)
-				{
-					_delay_ms(10);
-					/* De-bouncing */
-					if(GPIO_readPin(KEYPAD_COL_PORT_ID,KEYPAD_FIRST_COL_PIN_ID+col) == KEYPAD_BUTTON_PRESSED)
-					{
-					#if (KEYPAD_NUM_COLS == 3)
-						#ifdef STANDARD_KEYPAD
-							return ((row*KEYPAD_NUM_COLS)+col+1);
-						#else
-							return KEYPAD_4x3_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
-						#endif
-					#elif (KEYPAD_NUM_COLS == 4)
-						#ifdef STANDARD_KEYPAD
-							return ((row*KEYPAD_NUM_COLS)+col+1);
-						#else
-							return KEYPAD_4x4_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
-						#endif
-					#endif
-				}
-			  }
-			}
-			GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_INPUT);
-			_delay_ms(75); /* Add small delay to fix CPU load issue in proteus */
-		}
-	}	
-	return FALSE;
-}
-
-#ifndef STANDARD_KEYPAD
-
-#if (KEYPAD_NUM_COLS == 3)
-/*
- * Description :
- * Update the keypad pressed button value with the correct one in keypad 4x3 shape
- */
-static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number)
-{
-	uint8 keypad_button = 0;
-	switch(button_number)
-	{
-		case 10: keypad_button = '*'; // ASCII Code of *
-				 break;
-		case 11: keypad_button = 0;
-				 break;		
-		case 12: keypad_button = '#'; // ASCII Code of #
-				 break;
-		default: keypad_button = button_number;
-				break;
-	}
-	return keypad_button;
-} 
-
-#elif (KEYPAD_NUM_COLS == 4)
-
-/*
- * Description :
- * Update the keypad pressed button value with the correct one in keypad 4x4 shape
- */
-static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number)
-{
-	uint8 keypad_button = 0;
-	switch(button_number)
-	{
-		case 1: keypad_button = 7;
-				break;
-		case 2: keypad_button = 8;
-				break;
-		case 3: keypad_button = 9;
-				break;
-		case 4: keypad_button = '%'; // ASCII Code of %
-				break;
-		case 5: keypad_button = 4;
-				break;
-		case 6: keypad_button = 5;
-				break;
-		case 7: keypad_button = 6;
-				break;
-		case 8: keypad_button = '*'; /* ASCII Code of '*' */
-				break;		
-		case 9: keypad_button = 1;
-				break;
-		case 10: keypad_button = 2;
-				break;
-		case 11: keypad_button = 3;
-				break;
-		case 12: keypad_button = '-'; /* ASCII Code of '-' */
-				break;
-		case 13: keypad_button = 13;  /* ASCII of Enter */
-				break;			
-		case 14: keypad_button = 0;
-				break;
-		case 15: keypad_button = '='; /* ASCII Code of '=' */
-				break;
-		case 16: keypad_button = '+'; /* ASCII Code of '+' */
-				break;
-		default: keypad_button = button_number;
-				break;
-	}
-	return keypad_button;
-}
-
-#endif
-
-#endif /* STANDARD_KEYPAD */
+ /******************************************************************************
+ *
+ * Module: KEYPAD
+ *
+ * File Name: keypad.c
+ *
+ * Description: Source file for the Keypad driver
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#include "keypad.h"
+#include "../MCAL/gpio.h"
+#include "../MCAL/gpio_fast.h" /* To read all the columns in one port read */
+#include <avr/interrupt.h> /* To read the detected key atomically */
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* Background scan state, updated from the tick ISR */
+static volatile boolean g_keypadEnabled = FALSE;
+static volatile uint16 g_keypadTime = 0; /* ms counted by the scan, used to time stamp the presses */
+/* Queue of the detected key presses with their time stamps */
+static volatile uint8 g_queueKeys[KEYPAD_QUEUE_SIZE];
+static volatile uint16 g_queueTimes[KEYPAD_QUEUE_SIZE];
+static volatile uint8 g_queueHead = 0; /* next press to read */
+static volatile uint8 g_queueCount = 0;
+static volatile uint16 g_droppedCount = 0;
+static uint8 g_scanRow = 0; /* row currently driven */
+static uint8 g_scanTicks = 0; /* ticks since the row was driven */
+static uint8 g_scanFound = KEYPAD_NO_KEY; /* key found so far in this scan */
+static uint8 g_scanCandidate = KEYPAD_NO_KEY; /* key found by the previous scans */
+static uint8 g_scanStableCount = 0; /* number of scans in a row that found g_scanCandidate */
+static uint8 g_scanReported = KEYPAD_NO_KEY; /* debounced state already reported */
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+#ifndef STANDARD_KEYPAD
+
+#if (KEYPAD_NUM_COLS == 3)
+/*
+ * Function responsible for mapping the switch number in the keypad to
+ * its corresponding functional number in the proteus for 4x3 keypad
+ */
+static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number);
+#elif (KEYPAD_NUM_COLS == 4)
+/*
+ * Function responsible for mapping the switch number in the keypad to
+ * its corresponding functional number in the proteus for 4x4 keypad
+ */
+static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number);
+#endif
+
+#endif /* STANDARD_KEYPAD */
+
+/*
+ * Function responsible for returning the key value of the button in the required row and column
+ */
+static uint8 KEYPAD_buttonToKey(uint8 row, uint8 col);
+
+/*
+ * Function responsible for driving the required row to the pressed level, the others are released
+ */
+static void KEYPAD_driveRow(uint8 row);
+
+/*
+ * Function responsible for debouncing the result of a whole scan
+ */
+static void KEYPAD_scanDone(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Enable the keypad to accept input from user and start the background scan
+ */
+void KEYPAD_enable(void){
+	g_keypadEnabled = FALSE;
+	/* Freeze the scan while the pins are reconfigured */
+	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID, PIN_INPUT);
+	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+1, PIN_INPUT);
+	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+2, PIN_INPUT);
+	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+3, PIN_INPUT);
+
+	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID, PIN_INPUT);
+	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+1, PIN_INPUT);
+	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+2, PIN_INPUT);
+#if(KEYPAD_NUM_COLS == 4)
+	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+3, PIN_INPUT);
+#endif
+
+	g_scanRow = 0;
+	g_scanTicks = 0;
+	g_scanFound = KEYPAD_NO_KEY;
+	g_scanCandidate = KEYPAD_NO_KEY;
+	g_scanStableCount = 0;
+	g_scanReported = KEYPAD_NO_KEY;
+	KEYPAD_flush();
+	KEYPAD_driveRow(0);
+	g_keypadEnabled = TRUE;
+}
+
+/*
+ * Description :
+ * Disable the keypad from accepting any input from user and stop the background scan
+ */
+void KEYPAD_disable(void){
+	g_keypadEnabled = FALSE;
+	KEYPAD_flush();
+	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID, PIN_OUTPUT);
+	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+1, PIN_OUTPUT);
+	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+2, PIN_OUTPUT);
+	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+3, PIN_OUTPUT);
+
+	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID, PIN_OUTPUT);
+	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+1, PIN_OUTPUT);
+	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+2, PIN_OUTPUT);
+#if(KEYPAD_NUM_COLS == 4)
+	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+3, PIN_OUTPUT);
+#endif
+}
+
+
+/*
+ * Description :
+ * Get the Keypad pressed button, waits until a key is pressed.
+ * KEYPAD_scanTick() must be running.
+ */
+uint8 KEYPAD_getPressedKey(void)
+{
+	uint8 key;
+	while(!KEYPAD_getKey(&key))
+	{
+	}
+	return key;
+}
+
+/*
+ * Description :
+ * Non-blocking: if a key press waits in the queue, store the oldest one in key and return TRUE,
+ * otherwise return FALSE immediately. A key held down is reported once.
+ */
+boolean KEYPAD_getKey(uint8 *key)
+{
+	KEYPAD_EventType event;
+	if(!KEYPAD_getKeyEvent(&event))
+	{
+		return FALSE;
+	}
+	*key = event.key;
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Non-blocking: same as KEYPAD_getKey() but also returns how long the key waited in the queue.
+ */
+boolean KEYPAD_getKeyEvent(KEYPAD_EventType *event)
+{
+	boolean ready;
+	uint8 sreg = SREG;
+	cli();
+	/* The tick may queue a new key while the queue is updated */
+	ready = (g_queueCount != 0);
+	if(ready)
+	{
+		event->key = g_queueKeys[g_queueHead];
+		event->age_ms = g_keypadTime - g_queueTimes[g_queueHead];
+		g_queueHead = (g_queueHead + 1) % KEYPAD_QUEUE_SIZE;
+		g_queueCount--;
+	}
+	SREG = sreg;
+	return ready;
+}
+
+/*
+ * Description :
+ * Non-blocking: remove the oldest press of the required key from the queue and return TRUE,
+ * or return FALSE if it is not queued. The other presses are left in the queue in their order.
+ */
+boolean KEYPAD_takeKey(uint8 key)
+{
+	boolean found = FALSE;
+	uint8 i;
+	uint8 slot;
+	uint8 next;
+	uint8 sreg = SREG;
+	cli();
+	/* The tick may queue a new key while the queue is updated */
+	for(i = 0; i < g_queueCount; i++)
+	{
+		slot = (g_queueHead + i) % KEYPAD_QUEUE_SIZE;
+		if(found)
+		{
+			next = (slot + KEYPAD_QUEUE_SIZE - 1) % KEYPAD_QUEUE_SIZE;
+			g_queueKeys[next] = g_queueKeys[slot];
+			g_queueTimes[next] = g_queueTimes[slot];
+		}
+		else if(g_queueKeys[slot] == key)
+		{
+			found = TRUE;
+		}
+	}
+	/* The presses after the removed one move down one slot */
+	if(found)
+	{
+		g_queueCount--;
+	}
+	SREG = sreg;
+	return found;
+}
+
+/*
+ * Description :
+ * Discard every key press waiting in the queue
+ */
+void KEYPAD_flush(void)
+{
+	uint8 sreg = SREG;
+	cli();
+	g_queueCount = 0;
+	SREG = sreg;
+}
+
+/*
+ * Description :
+ * Return the number of key presses dropped because the queue was full
+ */
+uint16 KEYPAD_getDroppedCount(void)
+{
+	uint16 count;
+	uint8 sreg = SREG;
+	cli();
+	count = g_droppedCount;
+	SREG = sreg;
+	return count;
+}
+
+/*
+ * Description :
+ * Scans the keypad in the background, to be called from the system tick ISR every 1ms
+ * Each call that ends a KEYPAD_SCAN_PERIOD_MS period reads the columns of the driven
+ * row (it had the whole period to settle) then drives the next row.
+ */
+void KEYPAD_scanTick(void)
+{
+	uint8 col;
+	uint8 columns_state; /* All the column pins, read at once */
+
+	g_keypadTime++;
+	if(!g_keypadEnabled)
+	{
+		return;
+	}
+	g_scanTicks++;
+	if(g_scanTicks < KEYPAD_SCAN_PERIOD_MS)
+	{
+		return;
+	}
+	g_scanTicks = 0;
+
+	/* Read the state of all the columns with a single port read */
+	columns_state = GPIO_FAST_READ_PORT(KEYPAD_COL_PORT_ID) >> KEYPAD_FIRST_COL_PIN_ID;
+	for(col=0 ; (col<KEYPAD_NUM_COLS) && (g_scanFound == KEYPAD_NO_KEY) ; col++) /* loop for columns */
+	{
+		/* Check if the switch is pressed in this column, the first pressed button wins */
+		if(((columns_state >> col) & 1) == KEYPAD_BUTTON_PRESSED)
+		{
+			g_scanFound = KEYPAD_buttonToKey(g_scanRow, col);
+		}
+	}
+
+	g_scanRow++;
+	if(g_scanRow == KEYPAD_NUM_ROWS)
+	{
+		g_scanRow = 0;
+		KEYPAD_scanDone();
+	}
+	KEYPAD_driveRow(g_scanRow);
+}
+
+/*
+ * Description :
+ * Return the key value of the button in the required row and column
+ */
+static uint8 KEYPAD_buttonToKey(uint8 row, uint8 col)
+{
+#if (KEYPAD_NUM_COLS == 3)
+	#ifdef STANDARD_KEYPAD
+		return ((row*KEYPAD_NUM_COLS)+col+1);
+	#else
+		return KEYPAD_4x3_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
+	#endif
+#elif (KEYPAD_NUM_COLS == 4)
+	#ifdef STANDARD_KEYPAD
+		return ((row*KEYPAD_NUM_COLS)+col+1);
+	#else
+		return KEYPAD_4x4_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
+	#endif
+#endif
+}
+
+/*
+ * Description :
+ * Drive the required row to the pressed level, the others are released (inputs)
+ */
+static void KEYPAD_driveRow(uint8 row)
+{
+	uint8 loop_counter;
+	for(loop_counter=0 ; loop_counter<KEYPAD_NUM_ROWS ; loop_counter++)
+	{
+		GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+loop_counter,PIN_INPUT);
+	}
+	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_OUTPUT);
+	GPIO_writePin(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+row, KEYPAD_BUTTON_PRESSED);
+}
+
+/*
+ * Description :
+ * Debounce the result of a whole scan: a state change is accepted once it is
+ * seen on KEYPAD_DEBOUNCE_SCANS scans in a row, and a key is reported when it
+ * becomes the accepted state (pressed edge)
+ */
+static void KEYPAD_scanDone(void)
+{
+	if(g_scanFound == g_scanCandidate)
+	{
+		if(g_scanStableCount < KEYPAD_DEBOUNCE_SCANS)
+		{
+			g_scanStableCount++;
+		}
+	}
+	else
+	{
+		g_scanCandidate = g_scanFound;
+		g_scanStableCount = 1;
+	}
+	g_scanFound = KEYPAD_NO_KEY;
+
+	if((g_scanStableCount == KEYPAD_DEBOUNCE_SCANS) && (g_scanCandidate != g_scanReported))
+	{
+		g_scanReported = g_scanCandidate;
+		if(g_scanReported != KEYPAD_NO_KEY)
+		{
+			if(g_queueCount < KEYPAD_QUEUE_SIZE)
+			{
+				g_queueKeys[(g_queueHead + g_queueCount) % KEYPAD_QUEUE_SIZE] = g_scanReported;
+				g_queueTimes[(g_queueHead + g_queueCount) % KEYPAD_QUEUE_SIZE] = g_keypadTime;
+				g_queueCount++;
+			}
+			else
+			{
+				g_droppedCount++;
+			}
+		}
+	}
+}
+
+#ifndef STANDARD_KEYPAD
+
+#if (KEYPAD_NUM_COLS == 3)
+/*
+ * Description :
+ * Update the keypad pressed button value with the correct one in keypad 4x3 shape
+ */
+static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number)
+{
+	uint8 keypad_button = 0;
+	switch(button_number)
+	{
+		case 10: keypad_button = '*'; // ASCII Code of *
+				 break;
+		case 11: keypad_button = 0;
+				 break;		
+		case 12: keypad_button = '#'; // ASCII Code of #
+				 break;
+		default: keypad_button = button_number;
+				break;
+	}
+	return keypad_button;
+} 
+
+#elif (KEYPAD_NUM_COLS == 4)
+
+/*
+ * Description :
+ * Update the keypad pressed button value with the correct one in keypad 4x4 shape
+ */
+static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number)
+{
+	uint8 keypad_button = 0;
+	switch(button_number)
+	{
+		case 1: keypad_button = 7;
+				break;
+		case 2: keypad_button = 8;
+				break;
+		case 3: keypad_button = 9;
+				break;
+		case 4: keypad_button = '%'; // ASCII Code of %
+				break;
+		case 5: keypad_button = 4;
+				break;
+		case 6: keypad_button = 5;
+				break;
+		case 7: keypad_button = 6;
+				break;
+		case 8: keypad_button = '*'; /* ASCII Code of '*' */
+				break;		
+		case 9: keypad_button = 1;
+				break;
+		case 10: keypad_button = 2;
+				break;
+		case 11: keypad_button = 3;
+				break;
+		case 12: keypad_button = '-'; /* ASCII Code of '-' */
+				break;
+		case 13: keypad_button = 13;  /* ASCII of Enter */
+				break;			
+		case 14: keypad_button = 0;
+				break;
+		case 15: keypad_button = '='; /* ASCII Code of '=' */
+				break;
+		case 16: keypad_button = '+'; /* ASCII Code of '+' */
+				break;
+		default: keypad_button = button_number;
+				break;
+	}
+	return keypad_button;
+}
+
+#endif
+
+#endif /* STANDARD_KEYPAD */
@@ -1,57 +1,115 @@
- /******************************************************************************
- *
- * Module: KEYPAD
- *
- * File Name: keypad.h
- *
- * Description: Header file for the Keypad driver
- *
- * Author: Yousouf Soliman
- *
- *******************************************************************************/
-
-#ifndef KEYPAD_H_
-#define KEYPAD_H_
-
-#include "../UTIL/std_types.h"
-
-/*******************************************************************************
- *                                Definitions                                  *
- *******************************************************************************/
-
-/* Keypad configurations for number of rows and columns */
-#define KEYPAD_NUM_COLS                   4
-#define KEYPAD_NUM_ROWS                   4
-
-/* Keypad Port Configurations */
-#define KEYPAD_ROW_PORT_ID                PORTB_ID
-#define KEYPAD_FIRST_ROW_PIN_ID           PIN4_ID
-
-#define KEYPAD_COL_PORT_ID                PORTC_ID
-#define KEYPAD_FIRST_COL_PIN_ID           PIN0_ID
-
-/* Keypad button logic configurations */
-#define KEYPAD_BUTTON_PRESSED            LOGIC_LOW
-#define KEYPAD_BUTTON_RELEASED           LOGIC_HIGH
-/*******************************************************************************
- *                      Functions Prototypes                                   *
- *******************************************************************************/
-
-/*
- * Description :
- * Get the Keypad pressed button
- */
-uint8 KEYPAD_getPressedKey(void);
-
-/*
- * Description :
- * Enable the keypad to accept input from user
- */
-void KEYPAD_enable(void);
-
-/*
- * Description :
- * Disable the keypad from accepting any input from user
- */
-void KEYPAD_disable(void);
-#endif /* KEYPAD_H_ */
+ /******************************************************************************
+ *
+ * Module: KEYPAD
+ *
+ * File Name: keypad.h
+ *
+ * Description: Header file for the Keypad driver
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef KEYPAD_H_
+#define KEYPAD_H_
+
+#include "../UTIL/std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Keypad configurations for number of rows and columns */
+#define KEYPAD_NUM_COLS                   4
+#define KEYPAD_NUM_ROWS                   4
+
+/* Keypad Port Configurations */
+#define KEYPAD_ROW_PORT_ID                PORTB_ID
+#define KEYPAD_FIRST_ROW_PIN_ID           PIN4_ID
+
+#define KEYPAD_COL_PORT_ID                PORTC_ID
+#define KEYPAD_FIRST_COL_PIN_ID           PIN0_ID
+
+/* Keypad button logic configurations */
+#define KEYPAD_BUTTON_PRESSED            LOGIC_LOW
+#define KEYPAD_BUTTON_RELEASED           LOGIC_HIGH
+
+/* Background scan: one row every KEYPAD_SCAN_PERIOD_MS calls of KEYPAD_scanTick() (1ms each),
+ * a key is reported once it is seen on KEYPAD_DEBOUNCE_SCANS whole scans in a row */
+#define KEYPAD_SCAN_PERIOD_MS             2
+#define KEYPAD_DEBOUNCE_SCANS             2
+#define KEYPAD_NO_KEY                     0xFF
+
+/* Detected key presses wait in a queue of this size until they are read,
+ * presses that find the queue full are dropped and counted */
+#define KEYPAD_QUEUE_SIZE                 16
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	uint8 key;
+	uint16 age_ms; /* Time since the key was pressed, when it is read */
+}KEYPAD_EventType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Get the Keypad pressed button, waits until a key is pressed.
+ * KEYPAD_scanTick() must be running.
+ */
+uint8 KEYPAD_getPressedKey(void);
+
+/*
+ * Description :
+ * Non-blocking: if a key press waits in the queue, store the oldest one in key and return TRUE,
+ * otherwise return FALSE immediately. A key held down is reported once.
+ */
+boolean KEYPAD_getKey(uint8 *key);
+
+/*
+ * Description :
+ * Non-blocking: same as KEYPAD_getKey() but also returns how long the key waited in the queue.
+ */
+boolean KEYPAD_getKeyEvent(KEYPAD_EventType *event);
+
+/*
+ * Description :
+ * Non-blocking: remove the oldest press of the required key from the queue and return TRUE,
+ * or return FALSE if it is not queued. The other presses are left in the queue in their order.
+ */
+boolean KEYPAD_takeKey(uint8 key);
+/*
+ * Description :
+ * Discard every key press waiting in the queue
+ */
+void KEYPAD_flush(void);
+
+/*
+ * Description :
+ * Return the number of key presses dropped because the queue was full
+ */
+uint16 KEYPAD_getDroppedCount(void);
+
+/*
+ * Description :
+ * Scans the keypad in the background, to be called from the system tick ISR every 1ms
+ */
+void KEYPAD_scanTick(void);
+
+/*
+ * Description :
+ * Enable the keypad to accept input from user and start the background scan
+ */
+void KEYPAD_enable(void);
+
+/*
+ * Description :
+ * Disable the keypad from accepting any input from user and stop the background scan
+ */
+void KEYPAD_disable(void);
+#endif /* KEYPAD_H_ */
@@ -1,214 +1,440 @@
- /******************************************************************************
- *
- * Module: LCD
- *
- * File Name: lcd.c
- *
- * Description: Source file for the LCD driver
- *
- * Author: Yousouf Soliman
- *
- *******************************************************************************/
-
-#include "lcd.h"
-
-#include <util/delay.h> /* For the delay functions */
-#include "../UTIL/common_macros.h" /* For GET_BIT Macro */
-#include "../MCAL/gpio.h"
-
-/*******************************************************************************
- *                      Functions Definitions                                  *
- *******************************************************************************/
-
-/*
- * Description :
- * Initialize the LCD:
- * 1. Setup the LCD pins directions by use the GPIO driver.
- * 2. Setup the LCD Data Mode 4-bits or 8-bits.
- */
-void LCD_init(void)
-{
-	/* Configure the direction for RS and E pins as output pins */
-	GPIO_setupPinDirection(LCD_RS_PORT_ID,LCD_RS_PIN_ID,PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_E_PORT_ID,LCD_E_PIN_ID,PIN_OUTPUT);
-
-	_delay_ms(20);		/* LCD Power ON delay always > 15ms */
-
-#if(LCD_DATA_BITS_MODE == 4)
-	/* Configure 4 pins in the data port as output pins */
-	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,PIN_OUTPUT);
-
-	/* Send for 4 bit initialization of LCD  */
-	LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE_INIT1);
-	LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE_INIT2);
-
-	/* use 2-lines LCD + 4-bits Data Mode + 5*7 dot display Mode */
-	LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE);
-
-#elif(LCD_DATA_BITS_MODE == 8)
-	/* Configure the data port as output port */
-	GPIO_setupPortDirection(LCD_DATA_PORT_ID,PORT_OUTPUT);
-
-	/* use 2-lines LCD + 8-bits Data Mode + 5*7 dot display Mode */
-	LCD_sendCommand(LCD_TWO_LINES_EIGHT_BITS_MODE);
-
-#endif
-
-	LCD_sendCommand(LCD_CURSOR_OFF); /* cursor off */
-	LCD_sendCommand(LCD_CLEAR_COMMAND); /* clear LCD at the beginning */
-}
-
-/*
- * Description :
- * Send the required command to the screen
- */
-void LCD_sendCommand(uint8 command)
-{
-	GPIO_writePin(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_LOW); /* Instruction Mode RS=0 */
-	_delay_ms(1); /* delay for processing Tas = 50ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
-
-#if(LCD_DATA_BITS_MODE == 4)
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(command,4));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(command,5));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(command,6));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(command,7));
-
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
-
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(command,0));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(command,1));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(command,2));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(command,3));
-
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-
-#elif(LCD_DATA_BITS_MODE == 8)
-	GPIO_writePort(LCD_DATA_PORT_ID,command); /* out the required command to the data bus D0 --> D7 */
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-#endif
-}
-
-/*
- * Description :
- * Display the required character on the screen
- */
-void LCD_displayCharacter(uint8 data)
-{
-	GPIO_writePin(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_HIGH); /* Data Mode RS=1 */
-	_delay_ms(1); /* delay for processing Tas = 50ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
-
-#if(LCD_DATA_BITS_MODE == 4)
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(data,4));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(data,5));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(data,6));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(data,7));
-
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
-
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(data,0));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(data,1));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(data,2));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(data,3));
-
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-
-#elif(LCD_DATA_BITS_MODE == 8)
-	GPIO_writePort(LCD_DATA_PORT_ID,data); /* out the required command to the data bus D0 --> D7 */
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-#endif
-}
-
-/*
- * Description :
- * Display the required string on the screen
- */
-void LCD_displayString(const char *Str)
-{
-	uint8 i = 0;
-	while(Str[i] != '\0')
-	{
-		LCD_displayCharacter(Str[i]);
-		i++;
-	}
-}
-
-/*
- * Description :
- * Move the cursor to a specified row and column index on the screen
- */
-void LCD_moveCursor(uint8 row,uint8 col)
-{
-	uint8 lcd_memory_address;
-	
-	/* Calculate the required address in the LCD DDRAM */
-	switch(row)
-	{
-		case 0:
-			lcd_memory_address=col;
-				break;
-		case 1:
-			lcd_memory_address=col+0x40;
-				break;
-		case 2:
-			lcd_memory_address=col+0x10;
-				break;
-		case 3:
-			lcd_memory_address=col+0x50;
-				break;
-	}					
-	/* Move the LCD cursor to this specific address */
-	LCD_sendCommand(lcd_memory_address | LCD_SET_CURSOR_LOCATION);
-}
-
-/*
- * Description :
- * Display the required string in a specified row and column index on the screen
- */
-void LCD_displayStringRowColumn(uint8 row,uint8 col,const char *Str)
-{
-	LCD_moveCursor(row,col); /* go to to the required LCD position */
-	LCD_displayString(Str); /* display the string */
-}
-
-/*
- * Description :
- * Display the required decimal value on the screen
- */
-void LCD_intgerToString(int data)
-{
-   char buff[16]; /* String to hold the ascii result */
-   itoa(data,buff,10); /* Use itoa C function to convert the data to its corresponding ASCII value, 10 for decimal */
-   LCD_displayString(buff); /* Display the string */
-}
-
-/*
- * Description :
- * Send the clear screen command
- */
-void LCD_clearScreen(void)
-{
-	LCD_sendCommand(LCD_CLEAR_COMMAND); /* Send clear display command */
-}
+ /******************************************************************************
+ *
+ * Module: LCD
+ *
+ * File Name: lcd.c
+ *
+ * Description: Source file for the LCD driver
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "lcd.h"
+
+#include <util/delay.h> /* For the delay functions */
+#include <avr/interrupt.h> /* For SREG and cli() to protect the render queue */
+#include <avr/pgmspace.h> /* For pgm_read_byte to read strings from flash */
+#include "../MCAL/gpio.h"
+#include "../MCAL/gpio_fast.h" /* Single instruction access to the LCD control pins */
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Render queue, filled by LCD_submit() and drained by LCD_service() */
+static volatile uint8 g_lcdQueueValue[LCD_QUEUE_SIZE];
+static volatile uint8 g_lcdQueueType[LCD_QUEUE_SIZE];
+static volatile uint8 g_lcdQueueHead = 0; /* next slot to write in */
+static volatile uint8 g_lcdQueueTail = 0; /* next slot to send on the bus */
+static volatile uint8 g_lcdQueueCount = 0;
+static volatile uint8 g_lcdBusyTicks = 0; /* ticks to wait for a long command to finish */
+
+/* 5x8 progress bar glyphs for CGRAM slots 1..5, kept in flash */
+static const uint8 g_lcdGlyphs[LCD_GLYPHS_NUM][LCD_GLYPH_ROWS] PROGMEM =
+{
+	{0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10}, /* LCD_GLYPH_BAR_1 */
+	{0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18}, /* LCD_GLYPH_BAR_2 */
+	{0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C}, /* LCD_GLYPH_BAR_3 */
+	{0x1E,0x1E,0x1E,0x1E,0x1E,0x1E,0x1E,0x1E}, /* LCD_GLYPH_BAR_4 */
+	{0x1F,0x1F,0x1F,0x1F,0x1F,0x1F,0x1F,0x1F}  /* LCD_GLYPH_BAR_FULL */
+};
+
+/* Powers of ten used by LCD_formatDecimal() */
+static const uint16 g_lcdPowersOfTen[] = {10000, 1000, 100, 10, 1};
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Write one byte on the LCD bus, RS selects command or data.
+ * It only waits for the bus timing (in us), not for the LCD execution time.
+ */
+static void LCD_writeBus(uint8 value, uint8 rs);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Initialize the LCD:
+ * 1. Setup the LCD pins directions by use the GPIO driver.
+ * 2. Setup the LCD Data Mode 4-bits or 8-bits.
+ * The initialization is synchronous, the queue is used only after it.
+ */
+void LCD_init(void)
+{
+	uint8 glyph;
+	uint8 row;
+
+	/* Configure the direction for RS and E pins as output pins */
+	GPIO_setupPinDirection(LCD_RS_PORT_ID,LCD_RS_PIN_ID,PIN_OUTPUT);
+	GPIO_setupPinDirection(LCD_E_PORT_ID,LCD_E_PIN_ID,PIN_OUTPUT);
+	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW);
+
+	_delay_ms(20);		/* LCD Power ON delay always > 15ms */
+
+#if(LCD_DATA_BITS_MODE == 4)
+	/* Configure 4 pins in the data port as output pins */
+	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,PIN_OUTPUT);
+	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,PIN_OUTPUT);
+	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,PIN_OUTPUT);
+	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,PIN_OUTPUT);
+
+	/* Send for 4 bit initialization of LCD  */
+	LCD_writeBus(LCD_TWO_LINES_FOUR_BITS_MODE_INIT1,LOGIC_LOW);
+	_delay_ms(5);
+	LCD_writeBus(LCD_TWO_LINES_FOUR_BITS_MODE_INIT2,LOGIC_LOW);
+	_delay_ms(1);
+
+	/* use 2-lines LCD + 4-bits Data Mode + 5*7 dot display Mode */
+	LCD_writeBus(LCD_TWO_LINES_FOUR_BITS_MODE,LOGIC_LOW);
+	_delay_ms(1);
+
+#elif(LCD_DATA_BITS_MODE == 8)
+	/* Configure the data port as output port */
+	GPIO_setupPortDirection(LCD_DATA_PORT_ID,PORT_OUTPUT);
+
+	/* use 2-lines LCD + 8-bits Data Mode + 5*7 dot display Mode */
+	LCD_writeBus(LCD_TWO_LINES_EIGHT_BITS_MODE,LOGIC_LOW);
+	_delay_ms(1);
+
+#endif
+
+	LCD_writeBus(LCD_CURSOR_OFF,LOGIC_LOW); /* cursor off */
+	_delay_ms(1);
+
+	/* Load the custom glyphs once, starting from CGRAM slot 1 */
+	LCD_writeBus(LCD_SET_CGRAM_ADDRESS | (LCD_GLYPH_BAR_1 * LCD_GLYPH_ROWS),LOGIC_LOW);
+	_delay_ms(1);
+	for(glyph = 0; glyph < LCD_GLYPHS_NUM; glyph++)
+	{
+		for(row = 0; row < LCD_GLYPH_ROWS; row++)
+		{
+			LCD_writeBus(pgm_read_byte(&g_lcdGlyphs[glyph][row]),LOGIC_HIGH);
+			_delay_us(50); /* Write data to CGRAM takes 43us */
+		}
+	}
+
+	LCD_writeBus(LCD_CLEAR_COMMAND,LOGIC_LOW); /* clear LCD at the beginning, also goes back to DDRAM */
+	_delay_ms(2);
+}
+
+/*
+ * Description :
+ * Queue one byte (command or data) to be written to the screen in the background.
+ * Never blocks, can be called from the application or from an ISR.
+ * Returns FALSE if the queue is full and the byte was not queued.
+ */
+boolean LCD_submit(LCD_TransferType type, uint8 value)
+{
+	boolean queued = FALSE;
+	uint8 sreg = SREG;
+	cli(); /* The queue may be filled from both the application and the tick ISR */
+
+	if(g_lcdQueueCount < LCD_QUEUE_SIZE)
+	{
+		g_lcdQueueValue[g_lcdQueueHead] = value;
+		g_lcdQueueType[g_lcdQueueHead] = type;
+		g_lcdQueueHead++;
+		if(g_lcdQueueHead == LCD_QUEUE_SIZE)
+		{
+			g_lcdQueueHead = 0;
+		}
+		g_lcdQueueCount++;
+		queued = TRUE;
+	}
+
+	SREG = sreg; /* Restore the interrupts state */
+	return queued;
+}
+
+/*
+ * Description :
+ * Write the next queued byte to the screen, must be called periodically (every 1ms)
+ * from the system tick. Each call writes at most one byte on the bus.
+ * A tick of 1ms is longer than the 37us execution time of any LCD command except
+ * Clear/Home, so only those need extra ticks and the LCD busy flag is not needed.
+ */
+void LCD_service(void)
+{
+	uint8 value;
+	uint8 type;
+
+	if(g_lcdBusyTicks != 0)
+	{
+		g_lcdBusyTicks--; /* Clear/Home is still executing */
+		return;
+	}
+	if(g_lcdQueueCount == 0)
+	{
+		return; /* Nothing to render */
+	}
+
+	value = g_lcdQueueValue[g_lcdQueueTail];
+	type = g_lcdQueueType[g_lcdQueueTail];
+	g_lcdQueueTail++;
+	if(g_lcdQueueTail == LCD_QUEUE_SIZE)
+	{
+		g_lcdQueueTail = 0;
+	}
+
+	/*
+	 * E is always left low after a write, so an application read-modify-write
+	 * on the same port interrupted by this ISR can never latch a stale E=1
+	 */
+	if(type == LCD_COMMAND)
+	{
+		LCD_writeBus(value,LOGIC_LOW);
+		if((value == LCD_CLEAR_COMMAND) || (value == LCD_GO_TO_HOME))
+		{
+			g_lcdBusyTicks = LCD_LONG_COMMAND_TICKS;
+		}
+	}
+	else
+	{
+		LCD_writeBus(value,LOGIC_HIGH);
+	}
+
+	g_lcdQueueCount--; /* Only the ISR decrements, the increment is done with interrupts disabled */
+}
+
+/*
+ * Description :
+ * Completion barrier: wait until every queued byte has been written to the screen.
+ */
+void LCD_flush(void)
+{
+	while((g_lcdQueueCount != 0) || (g_lcdBusyTicks != 0))
+	{
+		/* LCD_service() keeps draining the queue from the tick ISR */
+	}
+}
+
+/*
+ * Description :
+ * Return the number of free slots in the render queue, used by callers that need
+ * to queue several bytes from an ISR without partially drawing them.
+ */
+uint8 LCD_getQueueSpace(void)
+{
+	return LCD_QUEUE_SIZE - g_lcdQueueCount;
+}
+
+/*
+ * Description :
+ * Send the required command to the screen
+ * It is only queued, the call waits only if the queue is full.
+ */
+void LCD_sendCommand(uint8 command)
+{
+	while(LCD_submit(LCD_COMMAND,command) == FALSE)
+	{
+		/* Queue is full, wait for the tick to free a slot */
+	}
+}
+
+/*
+ * Description :
+ * Display the required character on the screen
+ * It is only queued, the call waits only if the queue is full.
+ */
+void LCD_displayCharacter(uint8 data)
+{
+	while(LCD_submit(LCD_DATA,data) == FALSE)
+	{
+		/* Queue is full, wait for the tick to free a slot */
+	}
+}
+
+/*
+ * Description :
+ * Display the required string on the screen
+ */
+void LCD_displayString(const char *Str)
+{
+	uint8 i = 0;
+	while(Str[i] != '\0')
+	{
+		LCD_displayCharacter(Str[i]);
+		i++;
+	}
+}
+
+/*
+ * Description :
+ * Display the required string stored in the program memory (flash) on the screen
+ * The string is streamed byte by byte from flash without a copy in SRAM.
+ */
+void LCD_displayString_P(const char *Str)
+{
+	uint8 character = pgm_read_byte(Str);
+	while(character != '\0')
+	{
+		LCD_displayCharacter(character);
+		Str++;
+		character = pgm_read_byte(Str);
+	}
+}
+
+/*
+ * Description :
+ * Move the cursor to a specified row and column index on the screen
+ */
+void LCD_moveCursor(uint8 row,uint8 col)
+{
+	uint8 lcd_memory_address;
+	
+	/* Calculate the required address in the LCD DDRAM */
+	switch(row)
+	{
+		case 0:
+			lcd_memory_address=col;
+				break;
+		case 1:
+			lcd_memory_address=col+0x40;
+				break;
+		case 2:
+			lcd_memory_address=col+0x10;
+				break;
+		case 3:
+			lcd_memory_address=col+0x50;
+				break;
+		default:
+			lcd_memory_address=col;
+				break;
+	}					
+	/* Move the LCD cursor to this specific address */
+	LCD_sendCommand(lcd_memory_address | LCD_SET_CURSOR_LOCATION);
+}
+
+/*
+ * Description :
+ * Display the required string in a specified row and column index on the screen
+ */
+void LCD_displayStringRowColumn(uint8 row,uint8 col,const char *Str)
+{
+	LCD_moveCursor(row,col); /* go to to the required LCD position */
+	LCD_displayString(Str); /* display the string */
+}
+
+/*
+ * Description :
+ * Display the required flash string in a specified row and column index on the screen
+ */
+void LCD_displayStringRowColumn_P(uint8 row,uint8 col,const char *Str)
+{
+	LCD_moveCursor(row,col); /* go to to the required LCD position */
+	LCD_displayString_P(Str); /* display the string from flash */
+}
+
+/*
+ * Description :
+ * Display the required decimal value on the screen
+ */
+void LCD_intgerToString(int data)
+{
+	char buff[7]; /* String to hold the ascii result, sign + 5 digits + '\0' */
+	uint16 magnitude = (uint16)data;
+
+	if(data < 0)
+	{
+		LCD_displayCharacter('-');
+		magnitude = (uint16)(-(sint32)data); /* also correct for -32768 */
+	}
+	LCD_formatDecimal(magnitude,buff,0); /* convert without padding */
+	LCD_displayString(buff); /* Display the string */
+}
+
+/*
+ * Description :
+ * Convert the value to decimal ASCII right aligned in a field of the required width
+ * (padded with spaces), or with no padding if width is 0. No division and no itoa.
+ * buff must hold at least max(width, 5) + 1 characters.
+ * Returns the number of characters written (without the '\0').
+ */
+uint8 LCD_formatDecimal(uint16 value, char *buff, uint8 width)
+{
+	uint8 i;
+	uint8 digit;
+	uint8 length = 0;
+	uint8 digits_num = 0;
+	char digits[5];
+
+	/* Repeated subtraction of the powers of ten, at most 9 subtractions per digit */
+	for(i = 0; i < 5; i++)
+	{
+		digit = '0';
+		while(value >= g_lcdPowersOfTen[i])
+		{
+			value -= g_lcdPowersOfTen[i];
+			digit++;
+		}
+		if((digit != '0') || (digits_num != 0) || (i == 4))
+		{
+			digits[digits_num] = digit; /* skip the leading zeros */
+			digits_num++;
+		}
+	}
+
+	while((width > digits_num) && (length < (width - digits_num)))
+	{
+		buff[length] = ' '; /* right align */
+		length++;
+	}
+	for(i = 0; i < digits_num; i++)
+	{
+		buff[length] = digits[i];
+		length++;
+	}
+	buff[length] = '\0';
+	return length;
+}
+
+/*
+ * Description :
+ * Send the clear screen command
+ */
+void LCD_clearScreen(void)
+{
+	LCD_sendCommand(LCD_CLEAR_COMMAND); /* Send clear display command */
+}
+
+/*
+ * Description :
+ * Write one byte on the LCD bus, RS selects command or data.
+ * It only waits for the bus timing (in us), not for the LCD execution time.
+ */
+static void LCD_writeBus(uint8 value, uint8 rs)
+{
+	GPIO_FAST_WRITE(LCD_RS_PIN,rs); /* Instruction Mode RS=0, Data Mode RS=1 */
+	_delay_us(1); /* delay for processing Tas = 50ns */
+	GPIO_FAST_SET(LCD_E_PIN); /* Enable LCD E=1 */
+	_delay_us(1); /* delay for processing Tpw - Tdws = 190ns */
+
+#if(LCD_DATA_BITS_MODE == 4)
+	/* out the high nibble on DB4 --> DB7 in one masked store */
+	GPIO_FAST_WRITE_MASKED(LCD_DATA_PORT_ID,LCD_DATA_NIBBLE_MASK,(value >> 4) << LCD_DB4_PIN_ID);
+
+	_delay_us(1); /* delay for processing Tdsw = 100ns */
+	GPIO_FAST_CLEAR(LCD_E_PIN); /* Disable LCD E=0 */
+	_delay_us(1); /* delay for processing Th = 13ns */
+	GPIO_FAST_SET(LCD_E_PIN); /* Enable LCD E=1 */
+	_delay_us(1); /* delay for processing Tpw - Tdws = 190ns */
+
+	/* out the low nibble on DB4 --> DB7 in one masked store */
+	GPIO_FAST_WRITE_MASKED(LCD_DATA_PORT_ID,LCD_DATA_NIBBLE_MASK,(value & 0x0F) << LCD_DB4_PIN_ID);
+
+	_delay_us(1); /* delay for processing Tdsw = 100ns */
+	GPIO_FAST_CLEAR(LCD_E_PIN); /* Disable LCD E=0 */
+	_delay_us(1); /* delay for processing Th = 13ns */
+
+#elif(LCD_DATA_BITS_MODE == 8)
+	GPIO_FAST_WRITE_PORT(LCD_DATA_PORT_ID,value); /* out the required byte to the data bus D0 --> D7 */
+	_delay_us(1); /* delay for processing Tdsw = 100ns */
+	GPIO_FAST_CLEAR(LCD_E_PIN); /* Disable LCD E=0 */
+	_delay_us(1); /* delay for processing Th = 13ns */
+#endif
+}
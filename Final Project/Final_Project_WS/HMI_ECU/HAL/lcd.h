@@ -1,114 +1,208 @@
- /******************************************************************************
- *
- * Module: LCD
- *
- * File Name: lcd.h
- *
- * Description: Header file for the LCD driver
- *
- * Author: Yousouf Soliman
- *
- *******************************************************************************/
-
-#ifndef LCD_H_
-#define LCD_H_
-
-#include "../UTIL/std_types.h"
-
-/*******************************************************************************
- *                                Definitions                                  *
- *******************************************************************************/
-
-/* LCD Data bits mode configuration, its value should be 4 or 8*/
-#define LCD_DATA_BITS_MODE 8
-
-#if((LCD_DATA_BITS_MODE != 4) && (LCD_DATA_BITS_MODE != 8))
-
-#error "Number of Data bits should be equal to 4 or 8"
-
-#endif
-
-/* LCD HW Ports and Pins Ids */
-#define LCD_RS_PORT_ID                 PORTB_ID
-#define LCD_RS_PIN_ID                  PIN0_ID
-
-#define LCD_E_PORT_ID                  PORTB_ID
-#define LCD_E_PIN_ID                   PIN1_ID
-
-#define LCD_DATA_PORT_ID               PORTA_ID
-
-#if (LCD_DATA_BITS_MODE == 4)
-
-#define LCD_DB4_PIN_ID                 PIN3_ID
-#define LCD_DB5_PIN_ID                 PIN4_ID
-#define LCD_DB6_PIN_ID                 PIN5_ID
-#define LCD_DB7_PIN_ID                 PIN6_ID
-
-#endif
-
-/* LCD Commands */
-#define LCD_CLEAR_COMMAND                    0x01
-#define LCD_GO_TO_HOME                       0x02
-#define LCD_TWO_LINES_EIGHT_BITS_MODE        0x38
-#define LCD_TWO_LINES_FOUR_BITS_MODE         0x28
-#define LCD_TWO_LINES_FOUR_BITS_MODE_INIT1   0x33
-#define LCD_TWO_LINES_FOUR_BITS_MODE_INIT2   0x32
-#define LCD_CURSOR_OFF                       0x0C
-#define LCD_CURSOR_ON                        0x0E
-#define LCD_SET_CURSOR_LOCATION              0x80
-
-/*******************************************************************************
- *                      Functions Prototypes                                   *
- *******************************************************************************/
-
-/*
- * Description :
- * Initialize the LCD:
- * 1. Setup the LCD pins directions by use the GPIO driver.
- * 2. Setup the LCD Data Mode 4-bits or 8-bits.
- */
-void LCD_init(void);
-
-/*
- * Description :
- * Send the required command to the screen
- */
-void LCD_sendCommand(uint8 command);
-
-/*
- * Description :
- * Display the required character on the screen
- */
-void LCD_displayCharacter(uint8 data);
-
-/*
- * Description :
- * Display the required string on the screen
- */
-void LCD_displayString(const char *Str);
-
-/*
- * Description :
- * Move the cursor to a specified row and column index on the screen
- */
-void LCD_moveCursor(uint8 row,uint8 col);
-
-/*
- * Description :
- * Display the required string in a specified row and column index on the screen
- */
-void LCD_displayStringRowColumn(uint8 row,uint8 col,const char *Str);
-
-/*
- * Description :
- * Display the required decimal value on the screen
- */
-void LCD_intgerToString(int data);
-
-/*
- * Description :
- * Send the clear screen command
- */
-void LCD_clearScreen(void);
-
-#endif /* LCD_H_ */
+ /******************************************************************************
+ *
+ * Module: LCD
+ *
+ * File Name: lcd.h
+ *
+ * Description: Header file for the LCD driver
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef LCD_H_
+#define LCD_H_
+
+#include "../UTIL/std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* LCD Data bits mode configuration, its value should be 4 or 8*/
+#define LCD_DATA_BITS_MODE 8
+
+#if((LCD_DATA_BITS_MODE != 4) && (LCD_DATA_BITS_MODE != 8))
+
+#error "Number of Data bits should be equal to 4 or 8"
+
+#endif
+
+/* LCD HW Ports and Pins Ids */
+#define LCD_RS_PORT_ID                 PORTB_ID
+#define LCD_RS_PIN_ID                  PIN0_ID
+
+#define LCD_E_PORT_ID                  PORTB_ID
+#define LCD_E_PIN_ID                   PIN1_ID
+
+#define LCD_DATA_PORT_ID               PORTA_ID
+
+/* Compile-time pin descriptors for the GPIO fast path */
+#define LCD_RS_PIN                     GPIO_PIN(LCD_RS_PORT_ID,LCD_RS_PIN_ID)
+#define LCD_E_PIN                      GPIO_PIN(LCD_E_PORT_ID,LCD_E_PIN_ID)
+
+#if (LCD_DATA_BITS_MODE == 4)
+
+#define LCD_DB4_PIN_ID                 PIN3_ID
+#define LCD_DB5_PIN_ID                 PIN4_ID
+#define LCD_DB6_PIN_ID                 PIN5_ID
+#define LCD_DB7_PIN_ID                 PIN6_ID
+
+/* DB4..DB7 must be contiguous so a whole nibble is written with one masked store */
+#if((LCD_DB5_PIN_ID != LCD_DB4_PIN_ID + 1) || (LCD_DB6_PIN_ID != LCD_DB4_PIN_ID + 2) || (LCD_DB7_PIN_ID != LCD_DB4_PIN_ID + 3))
+
+#error "LCD DB4..DB7 pins should be contiguous in the data port"
+
+#endif
+
+#define LCD_DATA_NIBBLE_MASK           (0x0F << LCD_DB4_PIN_ID)
+
+#endif
+
+/* LCD Commands */
+#define LCD_CLEAR_COMMAND                    0x01
+#define LCD_GO_TO_HOME                       0x02
+#define LCD_TWO_LINES_EIGHT_BITS_MODE        0x38
+#define LCD_TWO_LINES_FOUR_BITS_MODE         0x28
+#define LCD_TWO_LINES_FOUR_BITS_MODE_INIT1   0x33
+#define LCD_TWO_LINES_FOUR_BITS_MODE_INIT2   0x32
+#define LCD_CURSOR_OFF                       0x0C
+#define LCD_CURSOR_ON                        0x0E
+#define LCD_SET_CURSOR_LOCATION              0x80
+#define LCD_CURSOR_SHIFT_LEFT                0x10
+#define LCD_SET_CGRAM_ADDRESS                0x40
+
+/* Custom CGRAM glyphs loaded once by LCD_init(), slot 0 is not used so a glyph is never '\0'.
+ * LCD_GLYPH_BAR_n is a cell with its n left pixel columns filled (5 columns per cell).
+ */
+#define LCD_GLYPH_BAR_1                      1
+#define LCD_GLYPH_BAR_2                      2
+#define LCD_GLYPH_BAR_3                      3
+#define LCD_GLYPH_BAR_4                      4
+#define LCD_GLYPH_BAR_FULL                   5
+#define LCD_GLYPHS_NUM                       5
+#define LCD_GLYPH_ROWS                       8
+#define LCD_CELL_PIXEL_COLUMNS               5
+
+/* LCD render queue configurations:
+ * Every LCD request is queued and written to the bus one byte per call to
+ * LCD_service(), which should be called from a periodic tick (1ms).
+ * The queue holds a full 2x16 screen update (clear + 2 cursor moves + 32 chars).
+ */
+#define LCD_QUEUE_SIZE                       40
+/* Clear/Home take 1.52ms to execute, skip this number of ticks after them */
+#define LCD_LONG_COMMAND_TICKS               2
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef enum
+{
+	LCD_COMMAND, LCD_DATA
+}LCD_TransferType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Initialize the LCD:
+ * 1. Setup the LCD pins directions by use the GPIO driver.
+ * 2. Setup the LCD Data Mode 4-bits or 8-bits.
+ */
+void LCD_init(void);
+
+/*
+ * Description :
+ * Queue one byte (command or data) to be written to the screen in the background.
+ * Never blocks, can be called from the application or from an ISR.
+ * Returns FALSE if the queue is full and the byte was not queued.
+ */
+boolean LCD_submit(LCD_TransferType type, uint8 value);
+
+/*
+ * Description :
+ * Write the next queued byte to the screen, must be called periodically (every 1ms)
+ * from the system tick. Each call writes at most one byte on the bus.
+ */
+void LCD_service(void);
+
+/*
+ * Description :
+ * Completion barrier: wait until every queued byte has been written to the screen.
+ */
+void LCD_flush(void);
+
+/*
+ * Description :
+ * Return the number of free slots in the render queue, used by callers that need
+ * to queue several bytes from an ISR without partially drawing them.
+ */
+uint8 LCD_getQueueSpace(void);
+
+/*
+ * Description :
+ * Send the required command to the screen
+ */
+void LCD_sendCommand(uint8 command);
+
+/*
+ * Description :
+ * Display the required character on the screen
+ */
+void LCD_displayCharacter(uint8 data);
+
+/*
+ * Description :
+ * Display the required string on the screen
+ */
+void LCD_displayString(const char *Str);
+
+/*
+ * Description :
+ * Display the required string stored in the program memory (flash) on the screen
+ * The string is streamed byte by byte from flash without a copy in SRAM.
+ */
+void LCD_displayString_P(const char *Str);
+
+/*
+ * Description :
+ * Move the cursor to a specified row and column index on the screen
+ */
+void LCD_moveCursor(uint8 row,uint8 col);
+
+/*
+ * Description :
+ * Display the required string in a specified row and column index on the screen
+ */
+void LCD_displayStringRowColumn(uint8 row,uint8 col,const char *Str);
+
+/*
+ * Description :
+ * Display the required flash string in a specified row and column index on the screen
+ */
+void LCD_displayStringRowColumn_P(uint8 row,uint8 col,const char *Str);
+
+/*
+ * Description :
+ * Display the required decimal value on the screen
+ */
+void LCD_intgerToString(int data);
+
+/*
+ * Description :
+ * Convert the value to decimal ASCII right aligned in a field of the required width
+ * (padded with spaces), or with no padding if width is 0. No division and no itoa.
+ * buff must hold at least max(width, 5) + 1 characters.
+ * Returns the number of characters written (without the '\0').
+ */
+uint8 LCD_formatDecimal(uint16 value, char *buff, uint8 width);
+
+/*
+ * Description :
+ * Send the clear screen command
+ */
+void LCD_clearScreen(void);
+
+#endif /* LCD_H_ */
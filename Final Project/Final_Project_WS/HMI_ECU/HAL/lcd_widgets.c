@@ -0,0 +1,204 @@
+ /******************************************************************************
+ *
+ * Module: LCD Widgets
+ *
+ * File Name: lcd_widgets.c
+ *
+ * Description: Source file for the LCD progress bar and countdown widgets
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "lcd_widgets.h"
+
+#include "lcd.h"
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Return the character of a bar cell that has the required number of filled pixel columns
+ */
+static uint8 WIDGET_barCellCharacter(uint8 filled);
+
+/*
+ * Return the LCD DDRAM address of a cell, same mapping as LCD_moveCursor()
+ */
+static uint8 WIDGET_cellAddress(uint8 row, uint8 col);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Draw an empty progress bar at the required position (from the application only).
+ */
+void WIDGET_progressBarInit(WIDGET_ProgressBarType *bar, uint8 row, uint8 col, uint8 width)
+{
+	uint8 cell;
+
+	bar->row = row;
+	bar->col = col;
+	bar->width = width;
+	bar->drawn = 0;
+
+	LCD_moveCursor(row,col);
+	for(cell = 0; cell < width; cell++)
+	{
+		LCD_displayCharacter(' ');
+	}
+}
+
+/*
+ * Description :
+ * Update the progress bar to the required number of filled pixel columns.
+ * Only the cells between the old and the new fill level are rewritten.
+ * Never blocks. Returns FALSE if the render queue has no room, in that case
+ * nothing is queued and the call should be retried. Call it from the application
+ * like the other LCD writes: from an ISR its cursor move would split their sequences.
+ */
+boolean WIDGET_progressBarUpdate(WIDGET_ProgressBarType *bar, uint8 columns)
+{
+	uint8 first_cell;
+	uint8 last_cell;
+	uint8 cell;
+	uint8 filled;
+	uint8 max_columns = bar->width * LCD_CELL_PIXEL_COLUMNS;
+
+	if(columns > max_columns)
+	{
+		columns = max_columns;
+	}
+	if(columns == bar->drawn)
+	{
+		return TRUE; /* Nothing changed */
+	}
+
+	/* The changed cells are the ones between the old and the new fill level */
+	if(columns > bar->drawn)
+	{
+		first_cell = bar->drawn / LCD_CELL_PIXEL_COLUMNS;
+		last_cell = (columns - 1) / LCD_CELL_PIXEL_COLUMNS;
+	}
+	else
+	{
+		first_cell = columns / LCD_CELL_PIXEL_COLUMNS;
+		last_cell = (bar->drawn - 1) / LCD_CELL_PIXEL_COLUMNS;
+	}
+
+	/* One cursor move, then the cells are written consecutively (the LCD auto increments) */
+	if(LCD_getQueueSpace() < (last_cell - first_cell + 2))
+	{
+		return FALSE;
+	}
+	LCD_submit(LCD_COMMAND,LCD_SET_CURSOR_LOCATION | WIDGET_cellAddress(bar->row,bar->col + first_cell));
+	for(cell = first_cell; cell <= last_cell; cell++)
+	{
+		if(columns >= ((cell + 1) * LCD_CELL_PIXEL_COLUMNS))
+		{
+			filled = LCD_CELL_PIXEL_COLUMNS;
+		}
+		else if(columns > (cell * LCD_CELL_PIXEL_COLUMNS))
+		{
+			filled = columns - (cell * LCD_CELL_PIXEL_COLUMNS);
+		}
+		else
+		{
+			filled = 0;
+		}
+		LCD_submit(LCD_DATA,WIDGET_barCellCharacter(filled));
+	}
+
+	bar->drawn = columns;
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Draw the countdown at the required position with its initial value (from the application only).
+ */
+void WIDGET_countdownInit(WIDGET_CountdownType *countdown, uint8 row, uint8 col, uint8 width, uint16 value)
+{
+	if(width > WIDGET_COUNTDOWN_MAX_DIGITS)
+	{
+		width = WIDGET_COUNTDOWN_MAX_DIGITS;
+	}
+	countdown->row = row;
+	countdown->col = col;
+	countdown->width = width;
+
+	LCD_formatDecimal(value,countdown->digits,width);
+	LCD_displayStringRowColumn(row,col,countdown->digits);
+}
+
+/*
+ * Description :
+ * Update the countdown value, only the changed digits are rewritten.
+ * Never blocks. Returns FALSE if the render queue has no room, in that case
+ * nothing is queued and the call should be retried. Call it from the application
+ * like the other LCD writes: from an ISR its cursor move would split their sequences.
+ */
+boolean WIDGET_countdownUpdate(WIDGET_CountdownType *countdown, uint16 value)
+{
+	char digits[WIDGET_COUNTDOWN_MAX_DIGITS + 1];
+	uint8 first = 0xFF;
+	uint8 last = 0;
+	uint8 i;
+
+	LCD_formatDecimal(value,digits,countdown->width);
+
+	/* Find the span of changed digits */
+	for(i = 0; i < countdown->width; i++)
+	{
+		if(digits[i] != countdown->digits[i])
+		{
+			if(first == 0xFF)
+			{
+				first = i;
+			}
+			last = i;
+		}
+	}
+	if(first == 0xFF)
+	{
+		return TRUE; /* Nothing changed */
+	}
+
+	if(LCD_getQueueSpace() < (last - first + 2))
+	{
+		return FALSE;
+	}
+	LCD_submit(LCD_COMMAND,LCD_SET_CURSOR_LOCATION | WIDGET_cellAddress(countdown->row,countdown->col + first));
+	for(i = first; i <= last; i++)
+	{
+		LCD_submit(LCD_DATA,digits[i]);
+		countdown->digits[i] = digits[i];
+	}
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Return the character of a bar cell that has the required number of filled pixel columns
+ */
+static uint8 WIDGET_barCellCharacter(uint8 filled)
+{
+	if(filled == 0)
+	{
+		return ' ';
+	}
+	return LCD_GLYPH_BAR_1 + (filled - 1); /* LCD_GLYPH_BAR_1 .. LCD_GLYPH_BAR_FULL */
+}
+
+/*
+ * Description :
+ * Return the LCD DDRAM address of a cell, same mapping as LCD_moveCursor()
+ */
+static uint8 WIDGET_cellAddress(uint8 row, uint8 col)
+{
+	static const uint8 row_offsets[4] = {0x00, 0x40, 0x10, 0x50};
+	return row_offsets[row & 0x03] + col;
+}
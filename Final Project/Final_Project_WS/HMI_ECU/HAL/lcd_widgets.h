@@ -0,0 +1,85 @@
+ /******************************************************************************
+ *
+ * Module: LCD Widgets
+ *
+ * File Name: lcd_widgets.h
+ *
+ * Description: Header file for the LCD progress bar and countdown widgets
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef LCD_WIDGETS_H_
+#define LCD_WIDGETS_H_
+
+#include "../UTIL/std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Maximum number of digits shown by a countdown widget */
+#define WIDGET_COUNTDOWN_MAX_DIGITS       5
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/*
+ * Horizontal progress bar, every cell has LCD_CELL_PIXEL_COLUMNS steps
+ * so a bar of width cells has (width * 5) steps.
+ */
+typedef struct
+{
+	uint8 row;
+	uint8 col;
+	uint8 width; /* in cells */
+	uint8 drawn; /* filled pixel columns currently on the screen */
+}WIDGET_ProgressBarType;
+
+/* Right aligned decimal number that only rewrites its changed digits */
+typedef struct
+{
+	uint8 row;
+	uint8 col;
+	uint8 width; /* in digits, up to WIDGET_COUNTDOWN_MAX_DIGITS */
+	char digits[WIDGET_COUNTDOWN_MAX_DIGITS + 1]; /* characters currently on the screen */
+}WIDGET_CountdownType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Draw an empty progress bar at the required position (from the application only).
+ */
+void WIDGET_progressBarInit(WIDGET_ProgressBarType *bar, uint8 row, uint8 col, uint8 width);
+
+/*
+ * Description :
+ * Update the progress bar to the required number of filled pixel columns.
+ * Only the cells between the old and the new fill level are rewritten.
+ * Never blocks. Returns FALSE if the render queue has no room, in that case
+ * nothing is queued and the call should be retried. Call it from the application
+ * like the other LCD writes: from an ISR its cursor move would split their sequences.
+ */
+boolean WIDGET_progressBarUpdate(WIDGET_ProgressBarType *bar, uint8 columns);
+
+/*
+ * Description :
+ * Draw the countdown at the required position with its initial value (from the application only).
+ */
+void WIDGET_countdownInit(WIDGET_CountdownType *countdown, uint8 row, uint8 col, uint8 width, uint16 value);
+
+/*
+ * Description :
+ * Update the countdown value, only the changed digits are rewritten.
+ * Never blocks. Returns FALSE if the render queue has no room, in that case
+ * nothing is queued and the call should be retried. Call it from the application
+ * like the other LCD writes: from an ISR its cursor move would split their sequences.
+ */
+boolean WIDGET_countdownUpdate(WIDGET_CountdownType *countdown, uint16 value);
+
+#endif /* LCD_WIDGETS_H_ */
@@ -0,0 +1,118 @@
+ /******************************************************************************
+ *
+ * Module: GPIO
+ *
+ * File Name: gpio_fast.h
+ *
+ * Description: Header only fast path of the AVR GPIO driver for compile-time pins
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef GPIO_FAST_H_
+#define GPIO_FAST_H_
+
+#include "gpio.h"
+#include <avr/io.h> /* To use the IO Ports Registers */
+#include <avr/interrupt.h> /* For cli() in the masked write */
+
+/*
+ * A pin descriptor is a compile-time (port id, pin id) pair:
+ *     #define LCD_E_PIN GPIO_PIN(PORTB_ID,PIN1_ID)
+ *     GPIO_FAST_SET(LCD_E_PIN);
+ * The port register is selected by the preprocessor and every pin access
+ * is a single sbi/cbi/sbic instruction, even with -O0, with no argument
+ * checks and no switch on the port at run time.
+ * The GPIO_* functions in gpio.c remain for pins only known at run time.
+ */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define GPIO_PIN(port_id,pin_id)        port_id,pin_id
+
+/* Registers of each port id */
+#define GPIO_FAST_PORT_REG_0            PORTA
+#define GPIO_FAST_PORT_REG_1            PORTB
+#define GPIO_FAST_PORT_REG_2            PORTC
+#define GPIO_FAST_PORT_REG_3            PORTD
+#define GPIO_FAST_DDR_REG_0             DDRA
+#define GPIO_FAST_DDR_REG_1             DDRB
+#define GPIO_FAST_DDR_REG_2             DDRC
+#define GPIO_FAST_DDR_REG_3             DDRD
+#define GPIO_FAST_PIN_REG_0             PINA
+#define GPIO_FAST_PIN_REG_1             PINB
+#define GPIO_FAST_PIN_REG_2             PINC
+#define GPIO_FAST_PIN_REG_3             PIND
+
+#define GPIO_FAST_CONCAT_(a,b)          a##b
+#define GPIO_FAST_CONCAT(a,b)           GPIO_FAST_CONCAT_(a,b)
+
+/* Port id (a constant like PORTB_ID) to its registers */
+#define GPIO_FAST_PORT(port_id)         GPIO_FAST_CONCAT(GPIO_FAST_PORT_REG_,port_id)
+#define GPIO_FAST_DDR(port_id)          GPIO_FAST_CONCAT(GPIO_FAST_DDR_REG_,port_id)
+#define GPIO_FAST_PIN(port_id)          GPIO_FAST_CONCAT(GPIO_FAST_PIN_REG_,port_id)
+
+/* Single instruction bit access of an I/O register */
+#ifdef __AVR__
+#define GPIO_FAST_SBI(reg,bit)          __asm__ __volatile__ ("sbi %0, %1" : : "I" (_SFR_IO_ADDR(reg)), "I" (bit))
+#define GPIO_FAST_CBI(reg,bit)          __asm__ __volatile__ ("cbi %0, %1" : : "I" (_SFR_IO_ADDR(reg)), "I" (bit))
+#define GPIO_FAST_BIT(reg,bit)          ({ uint8 bit_value;                           \
+                                           __asm__ __volatile__ ("ldi %0, 0" "\n\t"   \
+                                                                 "sbic %1, %2" "\n\t" \
+                                                                 "ldi %0, 1"          \
+                                               : "=d" (bit_value)                     \
+                                               : "I" (_SFR_IO_ADDR(reg)), "I" (bit)); \
+                                           bit_value; })
+#else
+/* Any other target: plain read-modify-write, the compiler picks the instructions */
+#define GPIO_FAST_SBI(reg,bit)          ((reg) |= (uint8)(1 << (bit)))
+#define GPIO_FAST_CBI(reg,bit)          ((reg) &= (uint8)(~(1 << (bit))))
+#define GPIO_FAST_BIT(reg,bit)          ((uint8)(((reg) >> (bit)) & 1))
+#endif
+
+/*******************************************************************************
+ *                      Pin Operations (descriptor argument)                   *
+ *******************************************************************************/
+
+/* Setup the pin as output / input */
+#define GPIO_FAST_OUTPUT(pin)           GPIO_FAST_OUTPUT_(pin)
+#define GPIO_FAST_INPUT(pin)            GPIO_FAST_INPUT_(pin)
+
+/* Write Logic High / Logic Low on the pin (or enable/disable the pull-up of an input pin) */
+#define GPIO_FAST_SET(pin)              GPIO_FAST_SET_(pin)
+#define GPIO_FAST_CLEAR(pin)            GPIO_FAST_CLEAR_(pin)
+
+/* Write a value (Logic High or Logic Low) that may only be known at run time */
+#define GPIO_FAST_WRITE(pin,value)      GPIO_FAST_WRITE_(pin,value)
+
+/* Read the pin, returns Logic High or Logic Low */
+#define GPIO_FAST_READ(pin)             GPIO_FAST_READ_(pin)
+
+#define GPIO_FAST_OUTPUT_(port_id,pin_id) GPIO_FAST_SBI(GPIO_FAST_DDR(port_id),pin_id)
+#define GPIO_FAST_INPUT_(port_id,pin_id)  GPIO_FAST_CBI(GPIO_FAST_DDR(port_id),pin_id)
+#define GPIO_FAST_SET_(port_id,pin_id)    GPIO_FAST_SBI(GPIO_FAST_PORT(port_id),pin_id)
+#define GPIO_FAST_CLEAR_(port_id,pin_id)  GPIO_FAST_CBI(GPIO_FAST_PORT(port_id),pin_id)
+#define GPIO_FAST_READ_(port_id,pin_id)   GPIO_FAST_BIT(GPIO_FAST_PIN(port_id),pin_id)
+#define GPIO_FAST_WRITE_(port_id,pin_id,value) \
+        do { if(value) { GPIO_FAST_SET_(port_id,pin_id); } else { GPIO_FAST_CLEAR_(port_id,pin_id); } } while(0)
+
+/*******************************************************************************
+ *                      Port Operations (port id argument)                     *
+ *******************************************************************************/
+
+/* Write / read a whole port */
+#define GPIO_FAST_WRITE_PORT(port_id,value)  (GPIO_FAST_PORT(port_id) = (value))
+#define GPIO_FAST_READ_PORT(port_id)         (GPIO_FAST_PIN(port_id))
+
+/* Write only the pins selected by the mask in a single store, interrupt safe */
+#define GPIO_FAST_WRITE_MASKED(port_id,mask,value)                                                      \
+	do {                                                                                                \
+		uint8 gpio_fast_sreg = SREG;                                                                    \
+		cli();                                                                                          \
+		GPIO_FAST_PORT(port_id) = (GPIO_FAST_PORT(port_id) & (uint8)(~(mask))) | ((value) & (mask));   \
+		SREG = gpio_fast_sreg;                                                                          \
+	} while(0)
+
+#endif /* GPIO_FAST_H_ */
@@ -1,85 +1,132 @@
-/******************************************************************************
- *
- * Module: TIMER
- *
- * File Name: timer.h
- *
- * Description: Header file for the AVR Timer driver
- *
- * Author: Yousouf Soliman
- *
- *******************************************************************************/
-#ifndef TIMER_H_
-#define TIMER_H_
-
-#include "../UTIL/std_types.h"
-#include "gpio.h"
-
-/*******************************************************************************
- *                            Definitions                                      *
- *******************************************************************************/
-/*#define COMPARE_OUTPUT_A*/
-/*#define COMPARE_OUTPUT_B*/
-#define COMPARE_OUTPUT_PORT_ID PORTD_ID
-#define OC1A PIN5_ID
-#define OC1B PIN4_ID
-#define TIMER1_OVF_INITIAL_VALUE_FOR_3_SECONDS 62535
-/*******************************************************************************
- *                         External Variables                                  *
- *******************************************************************************/
-extern volatile uint8 count15Seconds;
-extern volatile uint8 count3Seconds;
-extern volatile uint8 count60Seconds;
-/*******************************************************************************
- *                         Types Declaration                                   *
- *******************************************************************************/
-typedef enum{
-	Prescalar_OFF, Prescalar_noPrescalar, Prescalar_8, Prescalar_64, Prescalar_256, Prescalar_1024, Prescalar_EXT_FALLING, Prescalar_EXT_RISING
-}Timer1_Prescalar;
-
-typedef enum{
-	Timer1_NormalMode, Timer1_CompareToggle, Timer1_CompareClear, Timer1_CompareSet
-}Timer1_ModeSelect;
-
-typedef struct{
-	uint16 initial_value;
-	uint16 compare_value;
-	Timer1_Prescalar prescalar;
-	Timer1_ModeSelect mode;
-}Timer1_ConfigType;
-
-
-/*******************************************************************************
- *                      Functions Prototypes                                   *
- *******************************************************************************/
-
-/*
- * Description : Function to initialize the Timer0 driver
- * 	1. Set the required duty cycle.
- * 	2. Set the required clock.
- * 	2. Set PWM mode.
- * 	3. Initialize Timer0 Registers.
- */
-void PWM_Timer0_Start(uint8 duty_cycle);
-
-/*
- * Description : Function to initialize the Timer1 driver
- * 	1. Set the required clock.
- * 	2. Set the required mode.
- * 	3. Initialize Timer1 Registers.
- * 	4. Enable Interrupts for the according mode.
- */
-void Timer1_Init(const Timer1_ConfigType *Config_Ptr);
-
-/*
- * Description: Function to disable the Timer1
- */
-void Timer1_Deinit(void);
-
-/*
- * Description: Function to set the Call Back function address.
- */
-void Timer1_setCall(void(*a_ptr)(void));
-
-
-#endif /* MCAL_TIMER_H_ */
+/******************************************************************************
+ *
+ * Module: TIMER
+ *
+ * File Name: timer.h
+ *
+ * Description: Header file for the AVR Timer driver
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#ifndef TIMER_H_
+#define TIMER_H_
+
+#include "../UTIL/std_types.h"
+#include "gpio.h"
+
+/*******************************************************************************
+ *                            Definitions                                      *
+ *******************************************************************************/
+/*#define COMPARE_OUTPUT_A*/
+/*#define COMPARE_OUTPUT_B*/
+#define COMPARE_OUTPUT_PORT_ID PORTD_ID
+#define OC1A PIN5_ID
+#define OC1B PIN4_ID
+#define TIMER1_OVF_INITIAL_VALUE_FOR_3_SECONDS 62535
+/* System tick: F_CPU = 1Mhz -> Prescalar 8 -> F_Timer = 125Khz -> 125 ticks = 1ms */
+#define TIMER2_PRESCALAR_FOR_1_MS Timer2_Prescalar_8
+#define TIMER2_COMPARE_VALUE_FOR_1_MS 124
+/*******************************************************************************
+ *                         External Variables                                  *
+ *******************************************************************************/
+extern volatile uint8 count15Seconds;
+extern volatile uint8 count3Seconds;
+extern volatile uint8 count60Seconds;
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef enum{
+	Prescalar_OFF, Prescalar_noPrescalar, Prescalar_8, Prescalar_64, Prescalar_256, Prescalar_1024, Prescalar_EXT_FALLING, Prescalar_EXT_RISING
+}Timer1_Prescalar;
+
+typedef enum{
+	Timer1_NormalMode, Timer1_CompareToggle, Timer1_CompareClear, Timer1_CompareSet
+}Timer1_ModeSelect;
+
+typedef struct{
+	uint16 initial_value;
+	uint16 compare_value;
+	Timer1_Prescalar prescalar;
+	Timer1_ModeSelect mode;
+}Timer1_ConfigType;
+
+typedef enum{
+	Timer2_Prescalar_OFF, Timer2_Prescalar_noPrescalar, Timer2_Prescalar_8, Timer2_Prescalar_32, Timer2_Prescalar_64, Timer2_Prescalar_128, Timer2_Prescalar_256, Timer2_Prescalar_1024
+}Timer2_Prescalar;
+
+typedef struct{
+	uint8 compare_value;
+	Timer2_Prescalar prescalar;
+}Timer2_ConfigType;
+
+typedef enum{
+	Timer2_OC2_Disconnected, Timer2_OC2_Toggle, Timer2_OC2_Clear, Timer2_OC2_Set
+}Timer2_CompareOutput;
+
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description : Function to initialize the Timer0 driver
+ * 	1. Set the required duty cycle.
+ * 	2. Set the required clock.
+ * 	2. Set PWM mode.
+ * 	3. Initialize Timer0 Registers.
+ */
+void PWM_Timer0_Start(uint8 duty_cycle);
+
+/*
+ * Description : Function to change the Timer0 PWM duty cycle while it is running
+ * 	Only the compare value is updated, the PWM period is not restarted.
+ */
+void PWM_Timer0_setDuty(uint8 duty_cycle);
+
+/*
+ * Description : Function to initialize the Timer1 driver
+ * 	1. Set the required clock.
+ * 	2. Set the required mode.
+ * 	3. Initialize Timer1 Registers.
+ * 	4. Enable Interrupts for the according mode.
+ */
+void Timer1_Init(const Timer1_ConfigType *Config_Ptr);
+
+/*
+ * Description: Function to disable the Timer1
+ */
+void Timer1_DeInit(void);
+
+/*
+ * Description: Function to set the Call Back function address.
+ */
+void Timer1_setCall(void(*a_ptr)(void));
+
+/*
+ * Description : Function to initialize the Timer2 driver as a periodic tick
+ * 	1. Set the required clock.
+ * 	2. Set CTC mode with the required compare value.
+ * 	3. Enable the Output Compare Match Interrupt.
+ */
+void Timer2_Init(const Timer2_ConfigType *Config_Ptr);
+
+/*
+ * Description: Function to disable the Timer2
+ */
+void Timer2_DeInit(void);
+
+/*
+ * Description: Function to set the Timer2 Call Back function address.
+ */
+void Timer2_setCall(void(*a_ptr)(void));
+
+/*
+ * Description: Function to select what happens to the OC2 pin (PD7) on each compare match
+ * 	while the tick keeps running, e.g. toggle it to output a square wave of
+ * 	F = 1 / (2 x tick period). The pin must be set as output by the caller.
+ */
+void Timer2_setCompareOutput(Timer2_CompareOutput mode);
+
+
+#endif /* MCAL_TIMER_H_ */
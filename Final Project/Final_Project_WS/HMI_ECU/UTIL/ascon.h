@@ -0,0 +1,46 @@
+ /******************************************************************************
+ *
+ * Module: Ascon
+ *
+ * File Name: ascon.h
+ *
+ * Description: Header file for the Ascon-128 authenticated encryption used on the UART link
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef ASCON_H_
+#define ASCON_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define ASCON_KEY_SIZE                   16
+#define ASCON_NONCE_SIZE                 16
+#define ASCON_TAG_SIZE                   16
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Encrypt length bytes of input to output and write the first tag_length bytes of the tag.
+ * The associated data is authenticated but not encrypted. input and output may be the same buffer.
+ */
+void ASCON_encrypt(const uint8 *key, const uint8 *nonce, const uint8 *ad, uint8 ad_length,
+		const uint8 *input, uint8 *output, uint8 length, uint8 *tag, uint8 tag_length);
+
+/*
+ * Description :
+ * Decrypt length bytes of input to output and check the first tag_length bytes of the tag
+ * in constant time. Returns FALSE if the message or its associated data were modified,
+ * the output must not be used then. input and output may be the same buffer.
+ */
+boolean ASCON_decrypt(const uint8 *key, const uint8 *nonce, const uint8 *ad, uint8 ad_length,
+		const uint8 *input, uint8 *output, uint8 length, const uint8 *tag, uint8 tag_length);
+
+#endif /* ASCON_H_ */
@@ -0,0 +1,203 @@
+ /******************************************************************************
+ *
+ * Module: ISR Latency
+ *
+ * File Name: isr_latency.c
+ *
+ * Description: Source file for the interrupt latency instrumentation: the entry
+ *              of the instrumented ISRs is timestamped on a free-running Timer1
+ *              and compared with the time of its event, per vector min, max and
+ *              histogram are kept in RAM
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#include "isr_latency.h"
+
+#ifdef ISR_LATENCY
+
+#include "communication_commands.h"
+#include "../MCAL/timer.h"
+#include <avr/io.h> /* For TCNT1 and SREG */
+#include <avr/interrupt.h> /* For cli() */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	ISRLAT_StatsType stats;
+	uint16 expected;      /* Timer1 time of the next event of a periodic vector */
+	uint16 period;        /* us, 0 if not periodic */
+	boolean synced;       /* FALSE until the first entry of a periodic vector */
+}ISRLAT_VectorType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* Written by the ISRs only, read with the interrupts disabled */
+static ISRLAT_VectorType g_isrLatency[ISRLAT_VECTORS_NUM];
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start Timer1 as the free-running time base, with its overflow interrupt.
+ */
+void ISRLAT_init(void)
+{
+	Timer1_ConfigType Timer1_Config = { 0, 0, ISRLAT_TIMER1_PRESCALAR, Timer1_NormalMode };
+	uint8 i;
+	for(i = 0; i < ISRLAT_VECTORS_NUM; i++)
+	{
+		g_isrLatency[i].stats.min = 0xFFFF;
+	}
+	g_isrLatency[ISRLAT_TIMER2_COMP].period = ISRLAT_TICK_PERIOD_US;
+	Timer1_Init(&Timer1_Config);
+}
+
+/*
+ * Description :
+ * Record a latency measured by the caller (us since the event).
+ */
+void ISRLAT_record(uint8 vector, uint16 latency)
+{
+	ISRLAT_StatsType *stats = &g_isrLatency[vector].stats;
+	uint16 scaled = latency >> 2;
+	uint8 bucket = 0;
+
+	while((scaled != 0) && (bucket < (ISRLAT_BUCKETS_NUM - 1)))
+	{
+		scaled >>= 1;
+		bucket++;
+	}
+	if(stats->count == 0xFFFF)
+	{
+		return; /* Full: keep the stats as they are */
+	}
+	stats->count++;
+	if(stats->buckets[bucket] != 0xFFFF)
+	{
+		stats->buckets[bucket]++;
+	}
+	if(latency < stats->min)
+	{
+		stats->min = latency;
+	}
+	if(latency > stats->max)
+	{
+		stats->max = latency;
+	}
+}
+
+/*
+ * Description :
+ * Record the latency of a periodic vector against its expected time.
+ */
+void ISRLAT_periodic(uint8 vector)
+{
+	ISRLAT_VectorType *entry = &g_isrLatency[vector];
+	uint16 now = TCNT1;
+	uint16 latency = now - entry->expected;
+
+	if(entry->synced && (latency < entry->period))
+	{
+		ISRLAT_record(vector, latency);
+	}
+	else if(entry->synced && ((uint16)(entry->expected - now) < entry->period))
+	{
+		/* Earlier than expected: this entry is the new reference */
+		ISRLAT_record(vector, 0);
+		entry->expected = now;
+	}
+	else
+	{
+		/* First entry, or a period late or more: start again from this one */
+		if(entry->synced && (entry->stats.resyncs != 0xFFFF))
+		{
+			entry->stats.resyncs++;
+		}
+		entry->synced = TRUE;
+		entry->expected = now;
+	}
+	entry->expected += entry->period;
+}
+
+/*
+ * Description :
+ * Set the period of a periodic vector (us), 0 if it is not measured.
+ */
+void ISRLAT_setPeriod(uint8 vector, uint16 period)
+{
+	g_isrLatency[vector].period = period;
+}
+
+/*
+ * Description :
+ * Copy the stats of a vector, they keep counting.
+ */
+void ISRLAT_getStats(uint8 vector, ISRLAT_StatsType *stats)
+{
+	uint8 sreg = SREG;
+	cli(); /* The ISRs may update them during the copy */
+	*stats = g_isrLatency[vector].stats;
+	SREG = sreg; /* Restore the interrupts state */
+}
+
+/*
+ * Description :
+ * Write the stats of a vector in their link layout (LATENCY_REPORT_SIZE bytes)
+ */
+void ISRLAT_encode(uint8 vector, const ISRLAT_StatsType *stats, uint8 *bytes)
+{
+	uint8 i;
+	bytes[LATENCY_VECTOR_OFFSET] = vector;
+	bytes[LATENCY_MIN_OFFSET] = (uint8)(stats->min >> 8);
+	bytes[LATENCY_MIN_OFFSET + 1] = (uint8)stats->min;
+	bytes[LATENCY_MAX_OFFSET] = (uint8)(stats->max >> 8);
+	bytes[LATENCY_MAX_OFFSET + 1] = (uint8)stats->max;
+	bytes[LATENCY_COUNT_OFFSET] = (uint8)(stats->count >> 8);
+	bytes[LATENCY_COUNT_OFFSET + 1] = (uint8)stats->count;
+	bytes[LATENCY_RESYNCS_OFFSET] = (uint8)(stats->resyncs >> 8);
+	bytes[LATENCY_RESYNCS_OFFSET + 1] = (uint8)stats->resyncs;
+	for(i = 0; i < ISRLAT_BUCKETS_NUM; i++)
+	{
+		bytes[LATENCY_BUCKETS_OFFSET + 2 * i] = (uint8)(stats->buckets[i] >> 8);
+		bytes[LATENCY_BUCKETS_OFFSET + 2 * i + 1] = (uint8)stats->buckets[i];
+	}
+}
+
+/*
+ * Description :
+ * Read the stats of a vector from their link layout (LATENCY_REPORT_SIZE bytes), returns the vector
+ */
+uint8 ISRLAT_decode(const uint8 *bytes, ISRLAT_StatsType *stats)
+{
+	uint8 i;
+	stats->min = ((uint16)bytes[LATENCY_MIN_OFFSET] << 8) | bytes[LATENCY_MIN_OFFSET + 1];
+	stats->max = ((uint16)bytes[LATENCY_MAX_OFFSET] << 8) | bytes[LATENCY_MAX_OFFSET + 1];
+	stats->count = ((uint16)bytes[LATENCY_COUNT_OFFSET] << 8) | bytes[LATENCY_COUNT_OFFSET + 1];
+	stats->resyncs = ((uint16)bytes[LATENCY_RESYNCS_OFFSET] << 8) | bytes[LATENCY_RESYNCS_OFFSET + 1];
+	for(i = 0; i < ISRLAT_BUCKETS_NUM; i++)
+	{
+		stats->buckets[i] = ((uint16)bytes[LATENCY_BUCKETS_OFFSET + 2 * i] << 8)
+				| bytes[LATENCY_BUCKETS_OFFSET + 2 * i + 1];
+	}
+	return bytes[LATENCY_VECTOR_OFFSET];
+}
+
+#ifdef HOST_BUILD
+/*
+ * Description :
+ * Host build: the stats of a vector as they are, read by the host boards between two runs
+ * of the firmware (no register access).
+ */
+const ISRLAT_StatsType *ISRLAT_peekStats(uint8 vector)
+{
+	return &g_isrLatency[vector].stats;
+}
+#endif
+
+#endif /* ISR_LATENCY */
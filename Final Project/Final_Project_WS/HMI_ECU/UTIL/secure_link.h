@@ -0,0 +1,99 @@
+ /******************************************************************************
+ *
+ * Module: Secure Link
+ *
+ * File Name: secure_link.h
+ *
+ * Description: Header file for the authenticated and encrypted HMI ECU <-> Control ECU UART link
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef SECURE_LINK_H_
+#define SECURE_LINK_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * The command bytes of communication_commands.h are carried in frames:
+ *
+ *   SLINK_FRAME_START | type | length | header | ciphertext (length bytes) | tag
+ *
+ * HELLO frame header: sender session (4 bytes) then frame counter (4 bytes)
+ * DATA frame header : low 16 bits of the frame counter
+ *
+ * Every frame is encrypted with Ascon-128 under the pre-shared key. The nonce is
+ * built from the sender, both sessions, the frame counter and the frame type, so it
+ * never repeats: each ECU takes a new session number from its EEPROM at every boot
+ * and counts its frames within the session.
+ * A HELLO announces the sender session. A frame is accepted only if its tag is right
+ * and its counter is higher than the last frame accepted from the peer session;
+ * DATA frames are also bound to the receiver session, so frames recorded before a
+ * reboot of either ECU are rejected.
+ */
+#define SLINK_KEY { 0x3A, 0x91, 0x5C, 0x07, 0xE4, 0x28, 0xB6, 0x6F, \
+		0xD2, 0x13, 0x8E, 0x40, 0x7B, 0xA9, 0x55, 0xC1 }
+/* Pre-shared 128-bit key, the same in both ECUs: change it for every product */
+
+#define SLINK_ID_HMI                     0x01
+#define SLINK_ID_CONTROL                 0x02
+
+#define SLINK_FRAME_START                0x7E
+#define SLINK_MAX_PAYLOAD                16
+/* Bytes sent in the same main loop iteration go in one frame, up to this size */
+#define SLINK_TAG_SIZE                   8
+/* Ascon-128 tag truncated to 64 bits to keep the frame short at 9600 baud */
+#define SLINK_HELLO_RETRY_MS             250
+/* A HELLO left unanswered this long is sent again: the boot HELLOs may be lost on a noisy line */
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start the link with this ECU id and its new session number (not 0, never used before
+ * with this key) and announce the session to the peer. The UART must be initialized.
+ */
+void SLINK_init(uint8 own_id, uint32 session);
+
+/*
+ * Description :
+ * Queue one byte for the peer. The queued bytes are sent in one frame by SLINK_flush,
+ * or right away if the frame is full.
+ */
+void SLINK_sendByte(uint8 data);
+
+/*
+ * Description :
+ * Queue size bytes for the peer.
+ */
+void SLINK_sendData(const uint8 *data, uint8 size);
+
+/*
+ * Description :
+ * Send the queued bytes in one frame. They stay queued until the peer session is known,
+ * the HELLO asking for it is sent again every SLINK_HELLO_RETRY_MS.
+ * Called once per main loop iteration with the current time in ms.
+ */
+void SLINK_flush(uint16 now_ms);
+
+/*
+ * Description :
+ * Non-blocking receive: if a byte of an authentic frame is available, store it in data
+ * and return TRUE, otherwise return FALSE. Received frames are checked here.
+ */
+boolean SLINK_receiveByte(uint8 *data);
+
+/*
+ * Description :
+ * Number of received frames rejected: bad tag, replayed or malformed.
+ */
+uint16 SLINK_getRejectedCount(void);
+
+#endif /* SECURE_LINK_H_ */
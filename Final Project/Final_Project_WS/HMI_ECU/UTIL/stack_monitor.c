@@ -0,0 +1,153 @@
+ /******************************************************************************
+ *
+ * Module: Stack Monitor
+ *
+ * File Name: stack_monitor.c
+ *
+ * Description: Source file for the stack monitor: the free RAM is painted at boot,
+ *              the high-water mark of the stack is found by scanning the paint
+ *              and a canary after .bss tells if the stack ever reached it
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+#include "stack_monitor.h"
+#include "communication_commands.h"
+#include <avr/io.h> /* For SP and RAMEND */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#ifdef HOST_BUILD
+/* The firmware runs on its own stack (host_mcu.c), painted by STACK_init()
+ * except for these bytes under its frame (x86-64 red zone) */
+#define STACK_PAINT_MARGIN               256
+#define STACK_BOTTOM()                   HOST_getStackBottom()
+#define STACK_TOP()                      (HOST_getStackTop() - 1)
+#define STACK_POINTER()                  ((uint8 *)__builtin_frame_address(0))
+#else
+extern uint8 _end; /* End of .bss, from the linker script */
+#define STACK_BOTTOM()                   (&_end)
+#define STACK_TOP()                      ((uint8 *)RAMEND)
+#define STACK_POINTER()                  ((uint8 *)SP)
+#endif
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static const uint8 g_stackCanary[STACK_CANARY_SIZE] = STACK_CANARY;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+#ifndef HOST_BUILD
+/*
+ * Description :
+ * Paint the free RAM from the end of .bss to RAMEND. Runs from .init1 right after
+ * the reset, before the stack pointer and the zero register are set up, so it is
+ * written in assembly and uses neither of them.
+ */
+void STACK_paint(void) __attribute__((naked, used, section(".init1")));
+void STACK_paint(void)
+{
+	__asm__ __volatile__(
+			"ldi r30, lo8(_end)\n\t"
+			"ldi r31, hi8(_end)\n\t"
+			"ldi r24, %0\n\t"
+			"ldi r25, hi8(%1)\n\t"
+			"1:\n\t"
+			"st Z+, r24\n\t"
+			"cpi r30, lo8(%1)\n\t"
+			"cpc r31, r25\n\t"
+			"brlo 1b\n\t"
+			"breq 1b\n\t"
+			:
+			: "i" (STACK_PAINT_BYTE), "i" (RAMEND));
+}
+#endif
+
+/*
+ * Description :
+ * Put the canary after .bss, to be called first in main().
+ * The chip paints the stack before main() (.init1), the host build paints it here.
+ */
+void STACK_init(void)
+{
+	uint8 *byte = STACK_BOTTOM();
+	uint8 i;
+#ifdef HOST_BUILD
+	uint8 *end = STACK_POINTER() - STACK_PAINT_MARGIN;
+	while(byte < end)
+	{
+		*byte = STACK_PAINT_BYTE;
+		byte++;
+	}
+	byte = STACK_BOTTOM();
+#endif
+	for(i = 0; i < STACK_CANARY_SIZE; i++)
+	{
+		byte[i] = g_stackCanary[i];
+	}
+}
+
+/*
+ * Description :
+ * Scan the paint for the high-water mark and check the canary.
+ * The scan reads at most the free RAM once, it can be called from the main loop at any time.
+ */
+void STACK_getReport(STACK_ReportType *report)
+{
+	const uint8 *bottom = STACK_BOTTOM();
+	const uint8 *top = STACK_TOP();
+	const uint8 *pointer = STACK_POINTER();
+	const uint8 *byte = bottom + STACK_CANARY_SIZE;
+	uint8 i;
+
+	report->canary_ok = TRUE;
+	for(i = 0; i < STACK_CANARY_SIZE; i++)
+	{
+		if(bottom[i] != g_stackCanary[i])
+		{
+			report->canary_ok = FALSE;
+		}
+	}
+	/* The lowest byte that lost its paint, never above the bytes in use now */
+	while((byte < pointer) && (*byte == STACK_PAINT_BYTE))
+	{
+		byte++;
+	}
+	bottom += STACK_CANARY_SIZE;
+	report->size = (uint16)(top - bottom + 1);
+	report->current = (uint16)(top - pointer);
+	report->peak = (uint16)(top - byte + 1);
+	report->free = report->canary_ok ? (uint16)(byte - bottom) : 0;
+}
+
+/*
+ * Description :
+ * Write a report in its link layout (STACK_REPORT_SIZE bytes)
+ */
+void STACK_encode(const STACK_ReportType *report, uint8 *bytes)
+{
+	bytes[STACK_CURRENT_OFFSET] = (uint8)(report->current >> 8);
+	bytes[STACK_CURRENT_OFFSET + 1] = (uint8)report->current;
+	bytes[STACK_PEAK_OFFSET] = (uint8)(report->peak >> 8);
+	bytes[STACK_PEAK_OFFSET + 1] = (uint8)report->peak;
+	bytes[STACK_FREE_OFFSET] = (uint8)(report->free >> 8);
+	bytes[STACK_FREE_OFFSET + 1] = (uint8)report->free;
+	bytes[STACK_CANARY_OFFSET] = report->canary_ok ? 1 : 0;
+}
+
+/*
+ * Description :
+ * Read a report from its link layout (STACK_REPORT_SIZE bytes), its size is not sent
+ */
+void STACK_decode(const uint8 *bytes, STACK_ReportType *report)
+{
+	report->current = ((uint16)bytes[STACK_CURRENT_OFFSET] << 8) | bytes[STACK_CURRENT_OFFSET + 1];
+	report->peak = ((uint16)bytes[STACK_PEAK_OFFSET] << 8) | bytes[STACK_PEAK_OFFSET + 1];
+	report->free = ((uint16)bytes[STACK_FREE_OFFSET] << 8) | bytes[STACK_FREE_OFFSET + 1];
+	report->canary_ok = (bytes[STACK_CANARY_OFFSET] != 0);
+	report->size = report->peak + report->free;
+}
@@ -1,402 +1,1081 @@
-/******************************************************************************
- *
- * Module: Application Layer
- *
- * File Name: main.c
- *
- * Description: Source file for the main application for Human-Machine Interface
- *
- * Author: Yousouf Soliman
- *
- *******************************************************************************/
-
-/*******************************************************************************
- *                                Includes                                     *
- *******************************************************************************/
-#include "HAL/lcd.h" /*Includes LCD module and related functions*/
-#include "HAL/keypad.h" /*Includes KEYPAD module and related functions*/
-#include "MCAL/uart.h" /*Includes UART module and related functions*/
-#include "MCAL/timer.h" /*Includes TIMER1/Timer0-PWM module and related functions*/
-#include "UTIL/communication_commands.h" /*Includes all communication agreements between Control ECU and HMI ECU*/
-#include <util/delay.h> /* For the delay functions */
-#include <avr/io.h> /* To enable and disable interrupts*/
-
-/*******************************************************************************
- *                               Definitions                                   *
- *******************************************************************************/
-#define Interrupts_Enable() (SREG |= (1<<7))
-#define Interrupts_Disable() (SREG &= ~(1<<7))
-/* Macro to Enable and Disable interrupts using I-bit in S-Reg*/
-
-#define WRONG_PASS_ATTEMPTS 3
-/* Password input allowed attempts
- * User can input the password incorrectly (AFTER setting it)
- * for this predetermined amount of time
- * */
-
-/*******************************************************************************
- *                      Global Variables Declarations                          *
- *******************************************************************************/
-uint8 g_setSystemPassFlag = 1; /* Flag to indicate that the user is setting the system password */
-uint8 password[PASSWORD_LENGTH]; /* Array to store the password input from user in */
-uint8 password_verification[PASSWORD_LENGTH]; /* Array to store the password verification input from user in */
-
-
-
-
-
-/*******************************************************************************
- *                         Function Callback                                   *
- *******************************************************************************/
-void CountThreeSeconds(void){
-	/* 1 ISR = 3 seconds pass */
-	count3Seconds = 0;
-	/* mask flag to indicate that the count has finished */
-	Timer1_DeInit();
-	/* DeInit the timer for next use */
-}
-
-void CountFifteenSeconds(void){
-	/* 1 ISR = 3 seconds pass */
-	static uint8 counter = 0;
-	counter++;
-	TCNT1 = TIMER1_OVF_INITIAL_VALUE_FOR_3_SECONDS;
-	/* with each ISR, we shall reset the TCNT1 register the correct value */
-	if(counter == 5)
-	{
-		/* 5 ISRs = 15 seconds */
-	count15Seconds = 0;
-	/* mask flag to indicate that the count has finished */
-	Timer1_DeInit();
-	/* DeInit the timer for next use */
-	counter = 0;
-	/* mask count for next use */
-	}
-}
-
-void CountSixtySeconds(void){
-	/* 1 ISR = 3 seconds pass */
-	static uint8 counter = 0;
-	counter++;
-	TCNT1 = TIMER1_OVF_INITIAL_VALUE_FOR_3_SECONDS;
-	/* with each ISR, we shall reset the TCNT1 register the correct value */
-	if(counter == 20)
-	{
-		/* 20 ISRs = 60 seconds */
-	count60Seconds = 0;
-	/* mask flag to indicate that the count has finished */
-	Timer1_DeInit();
-	/* DeInit the timer for next use */
-	counter = 0;
-	/* mask count for next use */
-	}
-}
-
-/*******************************************************************************
- *                          Function Definitions                               *
- *******************************************************************************/
-
-/*
- * Function Description:
- * Function used to send the password input by user to Control ECU to check it via UART module
- * Inputs: void
- * Returns: void
- * */
-
-void HMI_sendPasswords(void) {
-	uint8 CONTROL_readyFlag;
-	/* Flag for synchronizing between HMI ECU and Control ECU */
-
-	UART_sendByte(HMI_ECU_READY);
-	/* Tell Control ECU that we are ready to send the command */
-
-	if (g_setSystemPassFlag == 1) {
-		UART_sendByte(SET_PASSWORD);
-		/* If we are setting the system's password, we will send SET_PASSWORD command to the Control ECU */
-	} else {
-		UART_sendByte(CHECK_PASSWORD);
-		/* If we taking password input from user for authentication,
-		 *  we will send CHECK_PASSWORD command to the Control ECU */
-	}
-	do {
-		CONTROL_readyFlag = UART_receiveByte();
-		/* Wait until Control_ECU is ready to receive the data */
-	} while (CONTROL_readyFlag != CONTROL_ECU_READY);
-
-	UART_sendData(password, PASSWORD_LENGTH);
-	/* Send the required string to Control_ECU through UART */
-
-	/* Send the password verification if we are setting system password */
-	if (g_setSystemPassFlag == 1) {
-		CONTROL_readyFlag = 0;
-		do {
-			CONTROL_readyFlag = UART_receiveByte();
-			/* Wait until Control_ECU is ready to receive the string */
-		} while (CONTROL_readyFlag != CONTROL_ECU_READY);
-		/* Send the required string to Control_ECU through UART */
-		UART_sendData(password_verification, PASSWORD_LENGTH);
-		g_setSystemPassFlag = 0;
-		/* Mask the set system password flag so */
-	}
-}
-
-/*
- * Function Description:
- * Function used to accept the user's password entry
- * Inputs: void
- * Returns: void
- * */
-void HMI_passwordInput(void) {
-	uint8 loop_counter = 0;
-	uint8 key = 0;
-	/* initializing loop counter used in all for loops
-	 * initializing key to act as buffer input for our keypad
-	 *  */
-	LCD_clearScreen();
-	LCD_displayStringRowColumn(0, 0, "Plz Enter Pass:");
-	LCD_moveCursor(1, 0); /* Move the cursor to the second row */
-	/* display the desired message on LCD */
-
-	for (loop_counter = 0; loop_counter < PASSWORD_LENGTH + 1; loop_counter++) {
-			key = KEYPAD_getPressedKey();
-		if ((key <= 9) && (key >= 0)) {
-			/* Get the pressed key number, if any switch pressed for more than 500 ms it will considered more than one press */
-			password[loop_counter] = key;
-			LCD_displayCharacter('*');/* display '*' with each pressed key */
-		}
-		/* Accept user input and display a '*' with each number */
-		if (loop_counter == PASSWORD_LENGTH) {
-			if (key == '=') {
-				break;
-			}
-			/* If user click Enter button "=", the we break out of the input loop */
-			else {
-				HMI_passwordInput();
-			}
-			/* if they don't hit enter after they are done, re-call the function*/
-		}
-		_delay_ms(500); /* Press time */
-	}
-
-	/* If we are setting the system password, then repeat the same steps but with password verification this time */
-	if (g_setSystemPassFlag == 1) {
-		LCD_clearScreen();
-
-		LCD_displayStringRowColumn(0, 0, "Plz Enter The");
-		LCD_displayStringRowColumn(1, 0, "Same Pass:");
-		LCD_moveCursor(1, 10); /* Move the cursor to the second row */
-
-		for (loop_counter = 0; loop_counter < PASSWORD_LENGTH + 1; loop_counter++) {
-			key = KEYPAD_getPressedKey();
-			if ((key <= 9) && (key >= 0)) {
-				LCD_displayCharacter('*'); /* display '*' with each pressed key */
-				/* Get the pressed key number, if any switch pressed for more than 500 ms it will considered more than one press */
-				password_verification[loop_counter] = key;
-			}
-			if (loop_counter == PASSWORD_LENGTH) {
-				if (key == '=') {
-					break;
-				} else {
-					HMI_passwordInput();
-				}
-			}
-			_delay_ms(500); /* Press time */
-		}
-	}
-
-	LCD_clearScreen();
-	HMI_sendPasswords();
-	/* After accepting all inputs, clear the screen and call the send pass
-	 * function to send the passwords to Control ECU */
-}
-
-/*
- * Function Description:
- * Function used to initiate the alarm protocol:
- * 1- Start the timer with required configurations
- * 2- Display the phrase "ERROR" for the required amount of time
- * 3- Disabling any keypad input
- * 4- Send the ALARM command to the Control ECU
- * Inputs: void
- * Returns: void
- * */
-
-void alarmProtocol(void) {
-	Timer1_ConfigType Timer1_Config;
-	Timer1_Config.initial_value =
-	TIMER1_OVF_INITIAL_VALUE_FOR_3_SECONDS;
-	Timer1_Config.compare_value = 0;
-	Timer1_Config.prescalar = Prescalar_1024;
-	Timer1_Config.mode = Timer1_NormalMode;
-	/* Configure timer:
-	 * 1- Normal Mode (Overflow Mode)
-	 * 2- Prescalar set to 1024
-	 * 3- Count three seconds
-	 * 4- F_CPU = 1Mhz -> F_Timer = 1Khz -> Time for 1 tick = 1ms Ticks for 3s = 3000 tick
-	 * Timer initial value = 65535 - 300 =  62535 */
-	LCD_clearScreen();
-	LCD_displayString("ERROR");
-	/* Display "ERROR" */
-	KEYPAD_disable();
-	/* Disable input from user */
-	UART_sendByte(HMI_ECU_READY);
-	UART_sendByte(ALARM);
-	/* Send the ALARM command to Control ECU */
-	Timer1_Init(&Timer1_Config);
-	Timer1_setCall(CountSixtySeconds);
-	count60Seconds = 1;
-	/* Start timer and Count 60 Seconds */
-	while (count60Seconds)
-		;
-	KEYPAD_enable();
-	/* Re-enable the keypad to accept input again from user */
-}
-
-/*
- * Function Description:
- * Function used to initiate the Door Unlock protocol:
- * 1- Start the timer with required configurations
- * 2- Display the phrase "Door is Unlocking" for the required amount of time
- * 3- Send the UNLOCK_DOOR command to the Control ECU
- * 4- Display the phrase "Door is Locking" for the required amount of time
- * Inputs: void
- * Returns: void
- * */
-void doorUnlockProtocol(void) {
-	Timer1_ConfigType Timer1_Config;
-	Timer1_Config.initial_value =
-	TIMER1_OVF_INITIAL_VALUE_FOR_3_SECONDS;
-	Timer1_Config.compare_value = 0;
-	Timer1_Config.prescalar = Prescalar_1024;
-	Timer1_Config.mode = Timer1_NormalMode;
-	/* Configure timer:
-	/* Configure timer:
-	 * 1- Normal Mode (Overflow Mode)
-	 * 2- Prescalar set to 1024
-	 * 3- Count three seconds
-	 * 4- F_CPU = 1Mhz -> F_Timer = 1Khz -> Time for 1 tick = 1ms Ticks for 3s = 3000 tick
-	 * Timer initial value = 65535 - 300 =  62535 */
-
-	LCD_clearScreen();
-	LCD_displayString("Door is Unlocking");
-	/* Display "Door is Unlocking" */
-	UART_sendByte(HMI_ECU_READY);
-	UART_sendByte(UNLOCK_DOOR);
-	/* Send the UNLOCK_DOOR command to Control ECU */
-	Timer1_Init(&Timer1_Config);
-	Timer1_setCall(CountFifteenSeconds);
-	count15Seconds = 1;
-	while (count15Seconds)
-		;
-	/* Start timer and Count 15 Seconds */
-	LCD_clearScreen();
-	/* Display Nothing while door is open */
-	Timer1_Init(&Timer1_Config);
-	Timer1_setCall(CountThreeSeconds);
-	count3Seconds = 1;
-	while (count3Seconds)
-		;
-	/* Start timer and Count 3 Seconds */
-	LCD_displayString("Door is Locking");
-	/* Display "Door is Locking" */
-	Timer1_Init(&Timer1_Config);
-	Timer1_setCall(CountFifteenSeconds);
-	count15Seconds = 1;
-	while (count15Seconds)
-		;
-	/* Start timer and Count 15 Seconds */
-}
-
-/*
- * Function Description:
- * Main function:
- * Responsible for initiating all modules, enabling interrupts, and configuring UART
- * */
-int main(void) {
-	uint8 loop_counter = 0;
-	uint8 userChoice;
-	uint8 passMatchFlag;
-	uint8 ready;
-	/* Variables used in main logic */
-	Interrupts_Enable();
-	LCD_init();
-	KEYPAD_enable();
-	/* Initialize LCD and enable keypad input */
-
-	UART_ConfigType UART_Config;
-	UART_Config.baud_rate = BaudRate_9600;
-	UART_Config.bit_data = BitData_8;
-	UART_Config.parity = Parity_Even;
-	UART_Config.stop_bit = StopBit_1;
-	UART_init(&UART_Config);
-	/* Initialize the UART driver with Baud-rate = 9600 bits/sec, 8_bit data, Even parity and One stop-bit */
-
-	do {
-		g_setSystemPassFlag = 1;
-		HMI_passwordInput();
-		passMatchFlag = UART_receiveByte();
-
-	} while (passMatchFlag != PASSWORDS_MATCHED);
-	/* Set the system password until the input password and its verification are matched */
-
-	for (;;) {
-		LCD_clearScreen();
-		LCD_displayStringRowColumn(0, 0, "+ : Open Door");
-		LCD_displayStringRowColumn(1, 0, "- : Change Pass");
-		/* Main screen with main options */
-		userChoice = KEYPAD_getPressedKey();
-		/* get user's choice */
-
-		if (userChoice == '+') {
-			for (loop_counter = 0; loop_counter < WRONG_PASS_ATTEMPTS;
-					/* Loop to only allow user 3 password attempts */
-					loop_counter++) {
-				HMI_passwordInput();
-				/* get the password from user until they input it correctly or they run out of attempts */
-				do {
-					ready = UART_receiveByte();
-				} while (ready != CONTROL_ECU_READY);
-				/* wait until Control ECU is ready to receive command */
-
-				passMatchFlag = 0;
-				do {
-					passMatchFlag = UART_receiveByte();
-				} while (passMatchFlag != PASSWORDS_MATCHED
-						&& passMatchFlag != PASSWORDS_UNMATCHED);
-				/* Receive the password status */
-				if (passMatchFlag == PASSWORDS_MATCHED) {
-					break;
-				}
-				/* if passwords are matched, break from the for loop */
-			}
-			if (passMatchFlag == PASSWORDS_MATCHED) {
-				doorUnlockProtocol();
-			}
-			/* and then call the unlock protocol */
-			else {
-				alarmProtocol();
-			}
-			/* if user runs out of attempts, call the alarm protocol */
-
-		} else if (userChoice == '-') {
-			passMatchFlag = 0;
-			loop_counter = WRONG_PASS_ATTEMPTS;
-			do {
-				g_setSystemPassFlag = 1;
-				HMI_passwordInput();
-				passMatchFlag = UART_receiveByte();
-				loop_counter--;
-			} while ((passMatchFlag != PASSWORDS_MATCHED) && loop_counter);
-			/* get the new passwords from user and allow them only three attempts */
-			/* ALTERNATIE LOGIC TO THE ONE USED ABOVE */
-			if (passMatchFlag != PASSWORDS_MATCHED) {
-				alarmProtocol();
-			}
-
-
-
-			/* if user runs out of attempts, call the alarm protocol */
-		}
-	}
-}
-
+/******************************************************************************
+ *
+ * Module: Application Layer
+ *
+ * File Name: main.c
+ *
+ * Description: Source file for the main application for Human-Machine Interface
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes                                     *
+ *******************************************************************************/
+#include "HAL/lcd.h" /*Includes LCD module and related functions*/
+#include "HAL/keypad.h" /*Includes KEYPAD module and related functions*/
+#include "MCAL/uart.h" /*Includes UART module and related functions*/
+#include "MCAL/timer.h" /*Includes the Timer2 system tick*/
+#include "UTIL/communication_commands.h" /*Includes all communication agreements between Control ECU and HMI ECU*/
+#include "HAL/lcd_widgets.h" /*Includes the progress bar and countdown widgets*/
+#include "ui_messages.h" /*Includes the UI strings and screens stored in flash*/
+#include "password_entry.h" /*Includes the password input engine*/
+#include "UTIL/secure_link.h" /*Includes the encrypted and authenticated link to Control ECU*/
+#include "UTIL/stack_monitor.h" /*Includes the stack high-water mark of the diagnostic screen*/
+#include "UTIL/isr_latency.h" /*Includes the ISR latency stats of the diagnostic screen (ISR_LATENCY builds)*/
+#include <avr/io.h> /* To enable and disable interrupts*/
+#include <avr/eeprom.h> /* For the link session boot counter */
+
+/*******************************************************************************
+ *                               Definitions                                   *
+ *******************************************************************************/
+#define Interrupts_Enable() (SREG |= (1<<7))
+#define Interrupts_Disable() (SREG &= ~(1<<7))
+/* Macro to Enable and Disable interrupts using I-bit in S-Reg*/
+
+#define DOOR_MOTION_TIME_MS 15000
+/* Longest time the door may take to unlock or lock (Control ECU fault timeout), shown as a countdown,
+ * until Control ECU reports its config */
+#define COUNTDOWN_REFRESH_MS 50
+/* The countdown and progress bar are refreshed every 50 ticks */
+#define COUNTDOWN_BAR_ROW 1
+#define COUNTDOWN_BAR_COL 0
+#define COUNTDOWN_BAR_WIDTH 12
+#define COUNTDOWN_SECONDS_COL 13
+#define COUNTDOWN_SECONDS_WIDTH 2
+/* Second row layout: 12 cells progress bar, then "SS" seconds and 's' */
+#define DOOR_HOLD_TIME_MS 3000
+/* Time the door is held open between unlocking and locking, until Control ECU reports its config */
+#define DOOR_FAULT_TIME_MS 3000
+/* Time a door fault stays on the screen */
+#define LOCKOUT_SECONDS_COL 9
+#define LOCKOUT_SECONDS_WIDTH 4
+/* Second row layout of the lockout screen: "Retry in SSSSs" */
+#define WAIT_ANIMATION_MS 250
+/* Period of the "Please Wait" dots animation */
+#define WAIT_ANIMATION_COL 11
+#define WAIT_ANIMATION_DOTS 3
+#define VERIFY_TIMEOUT_MS 5000
+/* Longest wait for the answer of Control ECU to a password, a lost or rejected frame
+ * leaves the wait screen after it */
+
+#ifdef HOST_BUILD
+#define HOST_COMMAND_MAX_SIZE (1 + CONFIG_SIZE)
+/* Longest command the host board can send through the HMI (SET_CONFIG and its config) */
+#endif
+
+#define STREAM_PASSWORD_CHECK
+/* Stream the digits of a password check to Control ECU while they are typed, so the
+ * result is known right after '=', comment it to send the whole password after '=' */
+
+#define TYPEAHEAD_MAX_AGE_MS 2000
+/* Keys typed while waiting for Control ECU are kept for the next entry screen,
+ * those older than this when the screen is ready are discarded (0 discards all of them) */
+
+#define LINK_SESSION_ADDRESS ((uint32 *)0x0000)
+/* Boot counter in the internal EEPROM: a new secure link session number is taken from it at every boot */
+
+#define HMI_KEY_OPEN_DOOR '+'
+#define HMI_KEY_CHANGE_PASS '-'
+#define HMI_KEY_CANCEL 13 /* ON/C */
+#define HMI_KEY_STATUS '%'
+#define HMI_KEY_DIAGNOSTICS '*' /* Service key of the menu: stack diagnostic screen */
+
+#define DIAGNOSTICS_REFRESH_MS 500
+/* The diagnostic screen asks Control ECU for its stack report and redraws both rows every 500ms */
+#define DIAGNOSTICS_FLAG_COL 1
+#define DIAGNOSTICS_VALUE_WIDTH 4
+/* Row layout: "X!cccc pppp ffff" ECU letter, '!' if its canary was overwritten, then the
+ * current, peak and free stack bytes */
+#define DIAGNOSTICS_PAGE_STACK 0
+#define DIAGNOSTICS_PAGE_LATENCY 1
+/* ISR_LATENCY builds: HMI_KEY_DIAGNOSTICS on the stack page shows the latency page,
+ * "X!tttt tttt rrrr" the max latency in us of the Timer1 overflow, Timer2 tick and UART RX
+ * ISRs, '!' if a Timer2 tick was lost */
+#define DIAGNOSTICS_VALUE_MAX 9999
+#ifdef ISR_LATENCY
+#define DIAGNOSTICS_SHOWS(page) ((g_state == HMI_DIAGNOSTICS) && (g_diagnosticsPage == (page)))
+#else
+#define DIAGNOSTICS_SHOWS(page) (g_state == HMI_DIAGNOSTICS)
+#endif
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef enum {
+	HMI_MENU, HMI_ENTRY, HMI_VERIFY_PENDING, HMI_UNLOCKING, HMI_ALARM, HMI_DIAGNOSTICS
+} HMI_State;
+/* Application states, each one is left on keypad, link or timer events */
+
+typedef enum {
+	ENTRY_NEW_PASS, ENTRY_CHANGE_PASS, ENTRY_CHECK_PASS, ENTRY_OLD_PASS
+} HMI_EntryPurpose;
+/* Why a password is entered: first system password, new password of a change, door unlock
+ * or the current password checked before a change */
+
+typedef enum {
+	LINK_IDLE, LINK_WAIT_READY_PASS, LINK_WAIT_READY_VERIFICATION, LINK_WAIT_RESULT
+} HMI_LinkWait;
+/* What HMI ECU waits for from Control ECU while a password is being checked */
+
+typedef enum {
+	DOOR_PHASE_OPENING, DOOR_PHASE_HOLD, DOOR_PHASE_CLOSING, DOOR_PHASE_FAULT
+} HMI_DoorPhase;
+/* Phase of the door unlock cycle shown on the screen */
+
+/*******************************************************************************
+ *                      Global Variables Declarations                          *
+ *******************************************************************************/
+uint8 password[PASSWORD_LENGTH]; /* Array to store the password input from user in */
+uint8 password_verification[PASSWORD_LENGTH]; /* Array to store the password verification input from user in */
+static volatile uint16 g_countdownMsLeft = 0; /* Remaining time of the running countdown, 0 if none is running */
+static uint16 g_countdownTotalMs = 0; /* Total time of the running countdown */
+static uint8 g_countdownRefreshTicks = 0; /* Ticks left until the next countdown refresh */
+static volatile uint8 g_countdownRefresh = FALSE; /* Set by the tick when the countdown widgets are due */
+static WIDGET_ProgressBarType g_countdownBar; /* Progress bar of the running countdown */
+static WIDGET_CountdownType g_countdownSeconds; /* Remaining seconds of the running countdown */
+static volatile uint16 g_tickMs = 0; /* Free running system time in ms, wraps around */
+
+static HMI_State g_state = HMI_ENTRY; /* Application state */
+static HMI_EntryPurpose g_entryPurpose = ENTRY_NEW_PASS; /* Purpose of the password entry */
+static uint8 g_entryVerification = FALSE; /* TRUE while the password verification is entered */
+static HMI_LinkWait g_linkWait = LINK_IDLE; /* Expected answer while a password is checked */
+static HMI_DoorPhase g_doorPhase; /* Door unlock cycle phase */
+static uint8 g_doorReport = 0; /* Door motion result waiting for its travel time byte, 0 if none */
+static uint8 g_lockoutReport = 0; /* Lockout time bytes still expected after ATTEMPTS_LOCKED, 0 if none */
+static uint16 g_lockoutSecondsLeft; /* Time left before a password can be checked again */
+static WIDGET_CountdownType g_lockoutSeconds; /* Lockout time left on the screen */
+static uint8 g_configReport = 0; /* Config bytes still expected after CONFIG_REPORT, 0 if none */
+static uint8 g_configBytes[CONFIG_SIZE]; /* Config reported by Control ECU */
+static uint8 g_stackReport = 0; /* Stack report bytes still expected after STACK_REPORT, 0 if none */
+static uint8 g_stackBytes[STACK_REPORT_SIZE]; /* Stack report of Control ECU */
+#ifdef ISR_LATENCY
+static uint8 g_diagnosticsPage = DIAGNOSTICS_PAGE_STACK; /* Page of the diagnostic screen */
+static uint8 g_latencyReport = 0; /* Latency report bytes still expected after LATENCY_REPORT, 0 if none */
+static uint8 g_latencyBytes[LATENCY_REPORT_SIZE]; /* Latency report of one ISR of Control ECU */
+static ISRLAT_StatsType g_controlLatency[ISRLAT_VECTORS_NUM]; /* Latency stats of Control ECU */
+#endif
+static uint16 g_doorMotionMs = DOOR_MOTION_TIME_MS; /* Door motion fault timeout of Control ECU */
+static uint16 g_doorHoldMs = DOOR_HOLD_TIME_MS; /* Door hold time of Control ECU */
+static uint16 g_timerStartMs; /* Start of the hold, fault, alarm or animation period */
+static uint8 g_waitDots = 0; /* Dots currently shown by the wait animation */
+static uint16 g_verifyStartMs; /* Time the password was sent to Control ECU */
+static boolean g_verifyCancelled = FALSE; /* TRUE if the answer to the last password is to be ignored */
+#ifdef STREAM_PASSWORD_CHECK
+static uint8 g_streamedDigits = 0; /* Digits of the current entry already streamed to Control ECU */
+#endif
+#ifdef HOST_BUILD
+static uint8 g_hostCommand[HOST_COMMAND_MAX_SIZE]; /* Command of the host board, sent by the main loop */
+static uint8 g_hostCommandSize = 0; /* Bytes of the host board command, 0 if none */
+#endif
+
+
+
+
+
+/*******************************************************************************
+ *                         Function Callback                                   *
+ *******************************************************************************/
+void HMI_tick(void){
+	/* 1 ISR = 1 millisecond passes */
+	if (g_countdownMsLeft != 0) {
+		g_countdownMsLeft--;
+		g_countdownRefreshTicks--;
+		if (g_countdownRefreshTicks == 0) {
+			g_countdownRefreshTicks = COUNTDOWN_REFRESH_MS;
+			g_countdownRefresh = TRUE;
+			/* The widgets are redrawn from the main loop: the application writes to the LCD
+			 * with several queued bytes (cursor move then text) that the tick must not split */
+		}
+	}
+	g_tickMs++;
+	KEYPAD_scanTick();
+	/* Scan the keypad in the background */
+	LCD_service();
+	/* Write the next queued byte to the LCD in the background */
+}
+
+/*******************************************************************************
+ *                          Function Definitions                               *
+ *******************************************************************************/
+
+/*
+ * Function Description:
+ * Function used to stop the running countdown, its widgets are left as they are
+ * Inputs: void
+ * Returns: void
+ * */
+void HMI_stopCountdown(void) {
+	g_countdownMsLeft = 0;
+	g_countdownRefresh = FALSE;
+	/* The tick sets no refresh once the time left is 0, drop the one it may have set */
+}
+
+/*
+ * Function Description:
+ * Function used to start the countdown and progress bar on the second row,
+ * they are then redrawn from the main loop until the time runs out
+ * Inputs: total time in ms, multiple of COUNTDOWN_REFRESH_MS
+ * Returns: void
+ * */
+void HMI_startCountdown(uint16 total_ms) {
+	HMI_stopCountdown();
+	/* Stop any running countdown before touching its widgets */
+	WIDGET_progressBarInit(&g_countdownBar, COUNTDOWN_BAR_ROW, COUNTDOWN_BAR_COL, COUNTDOWN_BAR_WIDTH);
+	WIDGET_countdownInit(&g_countdownSeconds, COUNTDOWN_BAR_ROW, COUNTDOWN_SECONDS_COL,
+			COUNTDOWN_SECONDS_WIDTH, (total_ms + 999) / 1000);
+	LCD_displayCharacter('s');
+	g_countdownTotalMs = total_ms;
+	g_countdownRefreshTicks = COUNTDOWN_REFRESH_MS;
+	g_countdownMsLeft = total_ms;
+	/* Start counting down from the tick */
+}
+
+/*
+ * Function Description:
+ * Function used to redraw the countdown and progress bar when the tick asks for it,
+ * only the cells that changed since the last refresh are rewritten
+ * Inputs: void
+ * Returns: void
+ * */
+void HMI_refreshCountdown(void) {
+	uint16 ms_left;
+	uint16 elapsed_steps;
+	uint16 total_steps;
+	boolean drawn;
+
+	if (!g_countdownRefresh) {
+		return;
+	}
+	Interrupts_Disable();
+	ms_left = g_countdownMsLeft;
+	g_countdownRefresh = FALSE;
+	Interrupts_Enable();
+	/* Both bytes of the time left are read without the tick changing them in between */
+	elapsed_steps = (g_countdownTotalMs - ms_left) / COUNTDOWN_REFRESH_MS;
+	total_steps = g_countdownTotalMs / COUNTDOWN_REFRESH_MS;
+	drawn = WIDGET_progressBarUpdate(&g_countdownBar,
+			(elapsed_steps * (COUNTDOWN_BAR_WIDTH * LCD_CELL_PIXEL_COLUMNS)) / total_steps);
+	drawn &= WIDGET_countdownUpdate(&g_countdownSeconds, (ms_left + 999) / 1000);
+	if (!drawn) {
+		g_countdownRefresh = TRUE;
+	}
+	/* The render queue was full, try again on the next loop */
+}
+
+/*
+ * Function Description:
+ * Function used to display a travel time given in 100ms units as "S.Ts"
+ * at the current cursor position
+ * Inputs: travel time
+ * Returns: void
+ * */
+void HMI_displayTravelTime(uint8 travel) {
+	char buff[6];
+	LCD_formatDecimal(travel / 10, buff, 0);
+	LCD_displayString(buff);
+	LCD_displayCharacter('.');
+	LCD_displayCharacter('0' + (travel % 10));
+	LCD_displayCharacter('s');
+}
+
+/*
+ * Function Description:
+ * Function used to read the system time, the tick ISR updates it
+ * Inputs: void
+ * Returns: time in ms
+ * */
+uint16 HMI_getTickMs(void) {
+	uint16 now;
+	Interrupts_Disable();
+	now = g_tickMs;
+	Interrupts_Enable();
+	/* Both bytes are read without the tick changing them in between */
+	return now;
+}
+
+/*
+ * Function Description:
+ * Function used to check if the required time passed since g_timerStartMs
+ * Inputs: time in ms
+ * Returns: TRUE if it passed
+ * */
+boolean HMI_timeElapsed(uint16 time_ms) {
+	return ((uint16)(HMI_getTickMs() - g_timerStartMs) >= time_ms);
+}
+
+/*
+ * Function Description:
+ * Function used to show the main menu and wait for the user's choice
+ * Inputs: void
+ * Returns: void
+ * */
+void HMI_enterMenu(void) {
+	g_state = HMI_MENU;
+	UI_showScreen(SCREEN_MAIN_MENU);
+	/* Main screen with main options */
+}
+
+#ifdef STREAM_PASSWORD_CHECK
+/*
+ * Function Description:
+ * Function used to start a new streamed password check in Control ECU
+ * Inputs: void
+ * Returns: void
+ * */
+void HMI_streamStart(void) {
+	SLINK_sendByte(HMI_ECU_READY);
+	SLINK_sendByte(STREAM_CHECK_START);
+	g_streamedDigits = 0;
+}
+
+/*
+ * Function Description:
+ * Function used to keep Control ECU in step with the password entry: a new digit is
+ * streamed to it, while an erased digit restarts the check and streams the digits left
+ * Inputs: void
+ * Returns: void
+ * */
+void HMI_streamEntry(void) {
+	uint8 length = PASSENTRY_getLength();
+
+	if (length < g_streamedDigits) {
+		HMI_streamStart();
+	}
+	/* Control ECU folds the digits as they come, so it can't drop one */
+	PASSENTRY_getPassword(password);
+	while (g_streamedDigits < length) {
+		SLINK_sendByte(HMI_ECU_READY);
+		SLINK_sendByte(STREAM_CHECK_DIGIT);
+		SLINK_sendByte(password[g_streamedDigits]);
+		g_streamedDigits++;
+	}
+}
+#endif
+
+/*
+ * Function Description:
+ * Function used to tell whether the password entry is checked by Control ECU (door unlock or
+ * current password before a change) rather than set
+ * Inputs: void
+ * Returns: TRUE for a check
+ * */
+boolean HMI_entryIsCheck(void) {
+	return (g_entryPurpose == ENTRY_CHECK_PASS) || (g_entryPurpose == ENTRY_OLD_PASS);
+}
+
+/*
+ * Function Description:
+ * Function used to start a password entry (or the verification entry)
+ * Inputs: TRUE to enter the verification of the password
+ * Returns: void
+ * */
+void HMI_startEntry(uint8 verification) {
+	g_state = HMI_ENTRY;
+	g_entryVerification = verification;
+	UI_showScreen(verification ? SCREEN_ENTER_SAME_PASS : SCREEN_ENTER_PASS);
+	PASSENTRY_start();
+	/* The cursor is left where the '*' are displayed */
+#ifdef STREAM_PASSWORD_CHECK
+	if (HMI_entryIsCheck()) {
+		HMI_streamStart();
+	}
+	/* Control ECU starts a new check */
+#endif
+}
+
+/*
+ * Function Description:
+ * Function used to send the entered password to Control ECU to check or set it,
+ * Control ECU answers are handled by HMI_linkByteReceived
+ * Inputs: void
+ * Returns: void
+ * */
+void HMI_sendPasswords(void) {
+	SLINK_sendByte(HMI_ECU_READY);
+	/* Tell Control ECU that we are ready to send the command */
+#ifdef STREAM_PASSWORD_CHECK
+	if (HMI_entryIsCheck()) {
+		SLINK_sendByte(STREAM_CHECK_FINISH);
+		g_linkWait = LINK_WAIT_RESULT;
+		/* The digits were checked while they were typed, only the result is left */
+	} else
+#endif
+	{
+		SLINK_sendByte(HMI_entryIsCheck() ? CHECK_PASSWORD : SET_PASSWORD);
+		/* SET_PASSWORD for a new password, CHECK_PASSWORD for authentication */
+		g_linkWait = LINK_WAIT_READY_PASS;
+		/* The password is sent once Control ECU is ready to receive it */
+	}
+	g_state = HMI_VERIFY_PENDING;
+	g_verifyCancelled = FALSE;
+	UI_showScreen(SCREEN_WAIT);
+	g_waitDots = 0;
+	g_timerStartMs = HMI_getTickMs();
+	g_verifyStartMs = g_timerStartMs;
+	/* Animate the wait screen until the answer */
+}
+
+/*
+ * Function Description:
+ * Function used to leave the wait screen without the answer of Control ECU, on the cancel key
+ * or after VERIFY_TIMEOUT_MS. Control ECU may still ask for the password: it is sent so the
+ * link stays in step, and its answer is ignored
+ * Inputs: void
+ * Returns: void
+ * */
+void HMI_cancelVerify(void) {
+	g_verifyCancelled = TRUE;
+	KEYPAD_flush();
+	/* Keys typed ahead were for a retry of this password */
+	if (g_entryPurpose == ENTRY_NEW_PASS) {
+		HMI_startEntry(FALSE);
+	} else {
+		HMI_enterMenu();
+	}
+	/* The first system password can't be skipped */
+}
+
+/*
+ * Function Description:
+ * Function used to start the door unlock cycle: send the UNLOCK_DOOR command,
+ * then display the phrase "Door is Unlocking" until Control ECU reports the open limit switch
+ * Inputs: void
+ * Returns: void
+ * */
+void HMI_startDoorCycle(void) {
+	g_state = HMI_UNLOCKING;
+	g_doorPhase = DOOR_PHASE_OPENING;
+	g_doorReport = 0;
+	UI_showScreen(SCREEN_DOOR_UNLOCKING);
+	/* Display "Door is Unlocking" */
+	SLINK_sendByte(HMI_ECU_READY);
+	SLINK_sendByte(UNLOCK_DOOR);
+	/* Send the UNLOCK_DOOR command to Control ECU */
+	HMI_startCountdown(g_doorMotionMs);
+	/* Show the time left while the door is unlocking */
+}
+
+/*
+ * Function Description:
+ * Function used to show a lockout reported by Control ECU: display "ERROR: Locked"
+ * and the time left, and ignore the keypad until it runs out.
+ * Control ECU counts the wrong attempts and sounds the alarm itself
+ * Inputs: lockout time left in seconds
+ * Returns: void
+ * */
+void HMI_startLockout(uint16 seconds) {
+	g_linkWait = LINK_IDLE;
+	g_state = HMI_ALARM;
+	HMI_stopCountdown();
+	UI_showScreen(SCREEN_LOCKED);
+	/* Display "ERROR: Locked" */
+	WIDGET_countdownInit(&g_lockoutSeconds, COUNTDOWN_BAR_ROW, LOCKOUT_SECONDS_COL,
+			LOCKOUT_SECONDS_WIDTH, seconds);
+	LCD_displayCharacter('s');
+	g_lockoutSecondsLeft = seconds;
+	g_timerStartMs = HMI_getTickMs();
+	/* Show the time left before the keypad is accepted again */
+	KEYPAD_flush();
+}
+
+/*
+ * Function Description:
+ * Function used to handle the result of a password check or set
+ * Inputs: PASSWORDS_MATCHED, PASSWORDS_UNMATCHED or PASSWORD_CHANGE_REFUSED
+ * Returns: void
+ * */
+void HMI_passwordResult(uint8 result) {
+	g_linkWait = LINK_IDLE;
+	if (result == PASSWORDS_MATCHED) {
+		if (g_entryPurpose == ENTRY_CHECK_PASS) {
+			HMI_startDoorCycle();
+		} else if (g_entryPurpose == ENTRY_OLD_PASS) {
+			g_entryPurpose = ENTRY_CHANGE_PASS;
+			KEYPAD_flush();
+			HMI_startEntry(FALSE);
+		} else {
+			HMI_enterMenu();
+		}
+		/* Unlock the door, enter the new password once the current one is checked, or the new password is set */
+	} else if (result == PASSWORD_CHANGE_REFUSED) {
+		HMI_enterMenu();
+		/* Control ECU already has a password (this ECU restarted) or the check before the change is too old */
+	} else if (g_entryPurpose == ENTRY_NEW_PASS) {
+		HMI_startEntry(FALSE);
+		/* Set the system password until the input password and its verification are matched */
+	} else {
+		HMI_startEntry(FALSE);
+		/* Retry, Control ECU answers ATTEMPTS_LOCKED instead once too many entries are wrong */
+	}
+	if (g_state != HMI_ENTRY) {
+		KEYPAD_flush();
+	}
+	/* Keys typed ahead are only for a retry entry, not for the door cycle or the menu */
+}
+
+/*
+ * Function Description:
+ * Function used to handle the end of a door motion reported by Control ECU
+ * Inputs: the reported result (DOOR_MOTION_xxx) and the actual travel time
+ * Returns: void
+ * */
+void HMI_doorMotionReported(uint8 status, uint8 travel) {
+	HMI_stopCountdown();
+	/* The door stopped, stop the countdown */
+	if (status == DOOR_MOTION_ABORTED) {
+		HMI_enterMenu();
+		return;
+	}
+	if (status == DOOR_MOTION_STALL || status == DOOR_MOTION_OVER_CURRENT) {
+		UI_showScreen((status == DOOR_MOTION_STALL) ? SCREEN_DOOR_STALL : SCREEN_DOOR_OVER_CURRENT);
+		g_doorPhase = DOOR_PHASE_FAULT;
+		g_timerStartMs = HMI_getTickMs();
+		return;
+	}
+	/* Control ECU aborts the cycle on a motor fault or an ABORT command */
+	if (g_doorPhase == DOOR_PHASE_OPENING) {
+		UI_showScreen((status == DOOR_MOTION_DONE) ? SCREEN_DOOR_OPEN : SCREEN_DOOR_TIMEOUT);
+		HMI_displayTravelTime(travel);
+		/* Display the actual unlocking time while door is open */
+		g_doorPhase = DOOR_PHASE_HOLD;
+		g_timerStartMs = HMI_getTickMs();
+	} else {
+		HMI_enterMenu();
+		/* The door is locked */
+	}
+}
+
+/*
+ * Function Description:
+ * Function used to take the display timings from the config reported by Control ECU,
+ * so both ECUs always use the same door timings. They are used from the next door cycle
+ * Inputs: void
+ * Returns: void
+ * */
+void HMI_configReported(void) {
+	if (g_configBytes[CONFIG_VERSION_OFFSET] != CONFIG_VERSION) {
+		return;
+	}
+	/* Keep the current timings if the layout is unknown */
+	g_doorMotionMs = ((uint16)g_configBytes[CONFIG_MOTION_TIME_OFFSET] << 8)
+			| g_configBytes[CONFIG_MOTION_TIME_OFFSET + 1];
+	g_doorHoldMs = ((uint16)g_configBytes[CONFIG_HOLD_TIME_OFFSET] << 8)
+			| g_configBytes[CONFIG_HOLD_TIME_OFFSET + 1];
+}
+
+/*
+ * Function Description:
+ * Function used to draw the flag and the three values of a row of the diagnostic screen
+ * Inputs: the row, TRUE to flag it with '!', and the values
+ * Returns: void
+ * */
+void HMI_showDiagnosticsRow(uint8 row, boolean flag, const uint16 *values) {
+	char buff[6];
+	uint8 i;
+	LCD_moveCursor(row, DIAGNOSTICS_FLAG_COL);
+	LCD_displayCharacter(flag ? '!' : ' ');
+	for (i = 0; i < 3; i++) {
+		if (i != 0) {
+			LCD_displayCharacter(' ');
+		}
+		LCD_formatDecimal((values[i] > DIAGNOSTICS_VALUE_MAX) ? DIAGNOSTICS_VALUE_MAX : values[i], buff,
+				DIAGNOSTICS_VALUE_WIDTH);
+		LCD_displayString(buff);
+	}
+}
+
+/*
+ * Function Description:
+ * Function used to draw a stack report on a row of the diagnostic screen
+ * Inputs: the row and the report
+ * Returns: void
+ * */
+void HMI_showStackReport(uint8 row, const STACK_ReportType *report) {
+	uint16 values[3];
+	values[0] = report->current;
+	values[1] = report->peak;
+	values[2] = report->free;
+	HMI_showDiagnosticsRow(row, !report->canary_ok, values);
+}
+
+#ifdef ISR_LATENCY
+/*
+ * Function Description:
+ * Function used to draw the max latency of each instrumented ISR on a row of the diagnostic screen
+ * Inputs: the row and the stats of the ISRs
+ * Returns: void
+ * */
+void HMI_showLatency(uint8 row, const ISRLAT_StatsType *stats) {
+	uint16 values[ISRLAT_VECTORS_NUM];
+	uint8 vector;
+	for (vector = 0; vector < ISRLAT_VECTORS_NUM; vector++) {
+		values[vector] = stats[vector].max;
+	}
+	HMI_showDiagnosticsRow(row, stats[ISRLAT_TIMER2_COMP].resyncs != 0, values);
+}
+#endif
+
+/*
+ * Function Description:
+ * Function used to redraw the stack report (or latency) of this ECU on the diagnostic screen
+ * and ask Control ECU for its own, drawn when it comes
+ * Inputs: void
+ * Returns: void
+ * */
+void HMI_refreshDiagnostics(void) {
+	STACK_ReportType report;
+#ifdef ISR_LATENCY
+	ISRLAT_StatsType stats[ISRLAT_VECTORS_NUM];
+	uint8 vector;
+	if (g_diagnosticsPage == DIAGNOSTICS_PAGE_LATENCY) {
+		for (vector = 0; vector < ISRLAT_VECTORS_NUM; vector++) {
+			ISRLAT_getStats(vector, &stats[vector]);
+		}
+		HMI_showLatency(0, stats);
+		SLINK_sendByte(HMI_ECU_READY);
+		SLINK_sendByte(GET_LATENCY);
+		return;
+	}
+#endif
+	STACK_getReport(&report);
+	HMI_showStackReport(0, &report);
+	SLINK_sendByte(HMI_ECU_READY);
+	SLINK_sendByte(GET_STACK);
+}
+
+/*
+ * Function Description:
+ * Function used to show the diagnostic screen on its current page, it is refreshed until a key is pressed
+ * Inputs: void
+ * Returns: void
+ * */
+void HMI_startDiagnostics(void) {
+	g_state = HMI_DIAGNOSTICS;
+	UI_showScreen(SCREEN_STACK);
+	HMI_refreshDiagnostics();
+	g_timerStartMs = HMI_getTickMs();
+}
+
+/*
+ * Function Description:
+ * Function used to handle one byte received from Control ECU
+ * Inputs: the received byte
+ * Returns: void
+ * */
+void HMI_linkByteReceived(uint8 data) {
+	if (g_doorReport != 0) {
+		if (g_state == HMI_UNLOCKING) {
+			HMI_doorMotionReported(g_doorReport, data);
+		}
+		g_doorReport = 0;
+		return;
+	}
+	/* The byte after a door motion result is its travel time, whatever its value. Outside a door cycle
+	 * (this ECU restarted during one) the report is dropped, but its travel time byte is still taken */
+	if (g_lockoutReport != 0) {
+		g_lockoutSecondsLeft = (g_lockoutSecondsLeft << 8) | data;
+		g_lockoutReport--;
+		if (g_lockoutReport == 0) {
+			HMI_startLockout(g_lockoutSecondsLeft);
+		}
+		return;
+	}
+	/* The two bytes after ATTEMPTS_LOCKED are the lockout time left */
+	if (g_configReport != 0) {
+		g_configBytes[CONFIG_SIZE - g_configReport] = data;
+		g_configReport--;
+		if (g_configReport == 0) {
+			HMI_configReported();
+		}
+		return;
+	}
+	/* The bytes after CONFIG_REPORT are the config */
+	if (g_stackReport != 0) {
+		g_stackBytes[STACK_REPORT_SIZE - g_stackReport] = data;
+		g_stackReport--;
+		if ((g_stackReport == 0) && DIAGNOSTICS_SHOWS(DIAGNOSTICS_PAGE_STACK)) {
+			STACK_ReportType report;
+			STACK_decode(g_stackBytes, &report);
+			HMI_showStackReport(1, &report);
+		}
+		return;
+	}
+	/* The bytes after STACK_REPORT are the stack report */
+#ifdef ISR_LATENCY
+	if (g_latencyReport != 0) {
+		g_latencyBytes[LATENCY_REPORT_SIZE - g_latencyReport] = data;
+		g_latencyReport--;
+		if (g_latencyReport == 0) {
+			ISRLAT_StatsType stats;
+			uint8 vector = ISRLAT_decode(g_latencyBytes, &stats);
+			if (vector < ISRLAT_VECTORS_NUM) {
+				g_controlLatency[vector] = stats;
+			}
+			if ((vector == ISRLAT_VECTORS_NUM - 1) && DIAGNOSTICS_SHOWS(DIAGNOSTICS_PAGE_LATENCY)) {
+				HMI_showLatency(1, g_controlLatency);
+			}
+			/* Control ECU reports its ISRs in order, the row is drawn after the last one */
+		}
+		return;
+	}
+	/* The bytes after LATENCY_REPORT are the stats of one ISR */
+#endif
+
+	switch (data) {
+	case CONTROL_ECU_READY:
+		if (g_linkWait == LINK_WAIT_READY_PASS) {
+			SLINK_sendData(password, PASSWORD_LENGTH);
+			g_linkWait = HMI_entryIsCheck() ? LINK_WAIT_RESULT : LINK_WAIT_READY_VERIFICATION;
+		} else if (g_linkWait == LINK_WAIT_READY_VERIFICATION) {
+			SLINK_sendData(password_verification, PASSWORD_LENGTH);
+			g_linkWait = LINK_WAIT_RESULT;
+		}
+		/* Send the required string to Control_ECU through UART once it is ready */
+		break;
+	case PASSWORDS_MATCHED:
+	case PASSWORDS_UNMATCHED:
+		if ((g_linkWait == LINK_WAIT_RESULT) && g_verifyCancelled) {
+			g_linkWait = LINK_IDLE;
+		} else if (g_linkWait == LINK_WAIT_RESULT) {
+			HMI_passwordResult(data);
+		}
+		break;
+	case PASSWORD_CHANGE_REFUSED:
+		if ((g_linkWait == LINK_WAIT_READY_PASS) && g_verifyCancelled) {
+			g_linkWait = LINK_IDLE;
+		} else if (g_linkWait == LINK_WAIT_READY_PASS) {
+			HMI_passwordResult(data);
+		}
+		/* Answered to SET_PASSWORD instead of CONTROL_ECU_READY */
+		break;
+	case PASSWORD_IS_SET:
+		if ((g_state == HMI_ENTRY) && (g_entryPurpose == ENTRY_NEW_PASS)) {
+			HMI_enterMenu();
+		}
+		/* No first password to set, a change needs the current one */
+		break;
+	case ATTEMPTS_LOCKED:
+		g_lockoutReport = 2;
+		g_lockoutSecondsLeft = 0;
+		/* Wait for the lockout time bytes, even after a cancel the lockout is running in Control ECU */
+		break;
+	case CONFIG_REPORT:
+		g_configReport = CONFIG_SIZE;
+		/* Wait for the config bytes */
+		break;
+	case STACK_REPORT:
+		g_stackReport = STACK_REPORT_SIZE;
+		/* Wait for the stack report bytes */
+		break;
+#ifdef ISR_LATENCY
+	case LATENCY_REPORT:
+		g_latencyReport = LATENCY_REPORT_SIZE;
+		/* Wait for the latency report bytes */
+		break;
+#endif
+	case DOOR_MOTION_DONE:
+	case DOOR_MOTION_TIMEOUT:
+	case DOOR_MOTION_STALL:
+	case DOOR_MOTION_OVER_CURRENT:
+	case DOOR_MOTION_ABORTED:
+		g_doorReport = data;
+		/* Wait for the travel time byte */
+		break;
+	case STATUS_IDLE:
+	case STATUS_OPENING:
+	case STATUS_HOLD:
+	case STATUS_CLOSING:
+	case STATUS_ALARM:
+		UI_displayMessage((g_state == HMI_VERIFY_PENDING) ? 1 : 0, 0, MSG_STATUS_IDLE + (data - STATUS_IDLE));
+		/* Answer to the status key, shown on the first row (the second one under the wait animation) */
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+ * Function Description:
+ * Function used to handle a key in the password entry, the input engine edits the password,
+ * it is validated once with '=' and PASSWORD_LENGTH digits, ON/C on an empty entry leaves it
+ * Inputs: the key
+ * Returns: void
+ * */
+void HMI_entryKey(uint8 key) {
+	switch (PASSENTRY_key(key)) {
+	case PASSENTRY_DONE:
+		if (g_entryVerification) {
+			PASSENTRY_getPassword(password_verification);
+			HMI_sendPasswords();
+			/* After accepting all inputs send the passwords to Control ECU */
+		} else {
+			PASSENTRY_getPassword(password);
+			if (HMI_entryIsCheck()) {
+				HMI_sendPasswords();
+			} else {
+				HMI_startEntry(TRUE);
+				/* If we are setting the system password, then enter the password verification */
+			}
+		}
+		break;
+	case PASSENTRY_CANCELLED:
+		if (g_entryPurpose == ENTRY_NEW_PASS) {
+			HMI_startEntry(FALSE);
+		} else {
+			HMI_enterMenu();
+		}
+		/* The first system password can't be skipped */
+		break;
+	default:
+#ifdef STREAM_PASSWORD_CHECK
+		if (HMI_entryIsCheck()) {
+			HMI_streamEntry();
+		}
+		/* Stream the digit just typed or erased */
+#endif
+		break;
+	}
+}
+
+/*
+ * Function Description:
+ * Function used to handle a key press in the current state
+ * Inputs: the key
+ * Returns: void
+ * */
+void HMI_keyPressed(uint8 key) {
+	switch (g_state) {
+	case HMI_MENU:
+		if (key == HMI_KEY_OPEN_DOOR || key == HMI_KEY_CHANGE_PASS) {
+			g_entryPurpose = (key == HMI_KEY_OPEN_DOOR) ? ENTRY_CHECK_PASS : ENTRY_OLD_PASS;
+			HMI_startEntry(FALSE);
+		} else if (key == HMI_KEY_DIAGNOSTICS) {
+			HMI_startDiagnostics();
+		}
+		/* get the password from user until they input it correctly or Control ECU locks them out */
+		break;
+	case HMI_DIAGNOSTICS:
+#ifdef ISR_LATENCY
+		if ((key == HMI_KEY_DIAGNOSTICS) && (g_diagnosticsPage == DIAGNOSTICS_PAGE_STACK)) {
+			g_diagnosticsPage = DIAGNOSTICS_PAGE_LATENCY;
+			HMI_startDiagnostics();
+			break;
+		}
+		g_diagnosticsPage = DIAGNOSTICS_PAGE_STACK;
+#endif
+		HMI_enterMenu();
+		/* Any other key leaves the diagnostic screen, on its stack page the next time */
+		break;
+	case HMI_ENTRY:
+		HMI_entryKey(key);
+		break;
+	case HMI_VERIFY_PENDING:
+		if (key == HMI_KEY_CANCEL) {
+			HMI_cancelVerify();
+		} else if (key == HMI_KEY_STATUS) {
+			SLINK_sendByte(HMI_ECU_READY);
+			SLINK_sendByte(GET_STATUS);
+		}
+		break;
+	case HMI_UNLOCKING:
+		if (key == HMI_KEY_CANCEL) {
+			SLINK_sendByte(HMI_ECU_READY);
+			SLINK_sendByte(ABORT);
+			/* Control ECU stops the door where it is and reports it */
+		} else if (key == HMI_KEY_STATUS) {
+			SLINK_sendByte(HMI_ECU_READY);
+			SLINK_sendByte(GET_STATUS);
+		}
+		break;
+	case HMI_ALARM:
+		if (key == HMI_KEY_STATUS) {
+			SLINK_sendByte(HMI_ECU_READY);
+			SLINK_sendByte(GET_STATUS);
+		}
+		/* Any other input is ignored during the lockout */
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+ * Function Description:
+ * Function used to handle the timed events of the current state:
+ * countdown widgets, wait animation, end of the door hold, end of a fault message, lockout countdown
+ * and diagnostic screen refresh
+ * Inputs: void
+ * Returns: void
+ * */
+void HMI_timeEvents(void) {
+	HMI_refreshCountdown();
+	/* Redraw the countdown widgets if the tick asked for it */
+	switch (g_state) {
+	case HMI_VERIFY_PENDING:
+		if ((uint16)(HMI_getTickMs() - g_verifyStartMs) >= VERIFY_TIMEOUT_MS) {
+			g_linkWait = LINK_IDLE;
+			HMI_cancelVerify();
+			/* No answer will come, Control ECU missed the password or its answer was lost */
+		} else if (HMI_timeElapsed(WAIT_ANIMATION_MS)) {
+			g_timerStartMs += WAIT_ANIMATION_MS;
+			if (g_waitDots == WAIT_ANIMATION_DOTS) {
+				g_waitDots = 0;
+				LCD_displayStringRowColumn(0, WAIT_ANIMATION_COL, "   ");
+			} else {
+				LCD_displayStringRowColumn(0, WAIT_ANIMATION_COL + g_waitDots, ".");
+				g_waitDots++;
+			}
+		}
+		break;
+	case HMI_UNLOCKING:
+		if ((g_doorPhase == DOOR_PHASE_HOLD) && HMI_timeElapsed(g_doorHoldMs)) {
+			g_doorPhase = DOOR_PHASE_CLOSING;
+			UI_showScreen(SCREEN_DOOR_LOCKING);
+			/* Display "Door is Locking" */
+			HMI_startCountdown(g_doorMotionMs);
+			/* Show the time left while the door is locking */
+		} else if ((g_doorPhase == DOOR_PHASE_FAULT) && HMI_timeElapsed(DOOR_FAULT_TIME_MS)) {
+			HMI_enterMenu();
+		}
+		break;
+	case HMI_ALARM:
+		if (HMI_timeElapsed(1000)) {
+			g_timerStartMs += 1000;
+			g_lockoutSecondsLeft--;
+			WIDGET_countdownUpdate(&g_lockoutSeconds, g_lockoutSecondsLeft);
+			if (g_lockoutSecondsLeft == 0) {
+				HMI_enterMenu();
+			}
+		}
+		break;
+	case HMI_DIAGNOSTICS:
+		if (HMI_timeElapsed(DIAGNOSTICS_REFRESH_MS)) {
+			g_timerStartMs += DIAGNOSTICS_REFRESH_MS;
+			HMI_refreshDiagnostics();
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+ * Function Description:
+ * Take the next secure link session number from the EEPROM boot counter
+ * and save it before it is used, so a session number is never used twice
+ * Inputs: void
+ * Returns: the new session number (never 0)
+ * */
+uint32 HMI_nextLinkSession(void) {
+	uint32 session = eeprom_read_dword(LINK_SESSION_ADDRESS) + 1;
+	if (session == 0) {
+		session = 1;
+	}
+	/* An erased EEPROM reads 0xFFFFFFFF, session 0 means no session */
+	eeprom_update_dword(LINK_SESSION_ADDRESS, session);
+	return session;
+}
+
+#ifdef HOST_BUILD
+/*
+ * Function Description:
+ * Host build: function used by the host board, between two runs of the firmware, to send a command
+ * to Control ECU that has no key on the keypad (SET_CONFIG). The main loop sends it as it is
+ * Inputs: the command byte then its data, and their count
+ * Returns: FALSE if the last command is not sent yet or this one is too long
+ * */
+boolean HMI_hostCommand(const uint8 *bytes, uint8 size) {
+	uint8 i;
+	if (g_hostCommandSize != 0 || size == 0 || size > HOST_COMMAND_MAX_SIZE) {
+		return FALSE;
+	}
+	for (i = 0; i < size; i++) {
+		g_hostCommand[i] = bytes[i];
+	}
+	g_hostCommandSize = size;
+	return TRUE;
+}
+#endif
+
+/*
+ * Function Description:
+ * Main function:
+ * Responsible for initiating all modules, enabling interrupts, and configuring UART
+ * Then runs the event loop: keypad, link and timer events are handled as they
+ * come, so the screen stays alive and keys are accepted in every state
+ * */
+int main(void) {
+	KEYPAD_EventType key;
+	uint8 data;
+	Timer2_ConfigType Timer2_Config;
+	STACK_init();
+	/* Put the canary after .bss, the free RAM was painted before main */
+#ifdef ISR_LATENCY
+	ISRLAT_init();
+	/* Start the Timer1 time base of the ISR latency hooks */
+#endif
+	Timer2_Config.compare_value = TIMER2_COMPARE_VALUE_FOR_1_MS;
+	Timer2_Config.prescalar = TIMER2_PRESCALAR_FOR_1_MS;
+	/* Configure the system tick: CTC mode, 1ms period */
+	Interrupts_Enable();
+	Timer2_Init(&Timer2_Config);
+	Timer2_setCall(HMI_tick);
+	/* Start the system tick that drains the LCD render queue */
+	LCD_init();
+	KEYPAD_enable();
+	/* Initialize LCD and enable keypad input */
+
+	UART_ConfigType UART_Config;
+	UART_Config.baud_rate = LINK_BAUD_RATE;
+	UART_Config.bit_data = BitData_8;
+	UART_Config.parity = Parity_Even;
+	UART_Config.stop_bit = StopBit_1;
+	UART_init(&UART_Config);
+	/* Initialize the UART driver with Baud-rate = 9600 bits/sec, 8_bit data, Even parity and One stop-bit */
+	SLINK_init(SLINK_ID_HMI, HMI_nextLinkSession());
+	/* Announce a new link session to Control ECU */
+	SLINK_sendByte(HMI_ECU_READY);
+	SLINK_sendByte(GET_CONFIG);
+	/* Take the door timings from Control ECU, it also reports them at its boot */
+	SLINK_sendByte(HMI_ECU_READY);
+	SLINK_sendByte(GET_PASSWORD_STATE);
+	/* Ask Control ECU whether a system password is already set */
+
+	g_entryPurpose = ENTRY_NEW_PASS;
+	HMI_startEntry(FALSE);
+	/* Set the system password first, the menu is shown instead once Control ECU reports one is set */
+
+	for (;;) {
+		if (g_state == HMI_VERIFY_PENDING) {
+			if (KEYPAD_takeKey(HMI_KEY_CANCEL)) {
+				HMI_keyPressed(HMI_KEY_CANCEL);
+			} else if (KEYPAD_takeKey(HMI_KEY_STATUS)) {
+				HMI_keyPressed(HMI_KEY_STATUS);
+			}
+		} else if (KEYPAD_getKeyEvent(&key)) {
+			if (key.age_ms <= TYPEAHEAD_MAX_AGE_MS) {
+				HMI_keyPressed(key.key);
+			}
+		}
+		/* Keypad event, keys pressed while Control ECU checks a password wait in the keypad queue,
+		 * except the cancel and status keys that are handled at once */
+		if (SLINK_receiveByte(&data)) {
+			HMI_linkByteReceived(data);
+		}
+		/* Link event */
+		HMI_timeEvents();
+		/* Timer events */
+#ifdef HOST_BUILD
+		if (g_hostCommandSize != 0) {
+			SLINK_sendByte(HMI_ECU_READY);
+			SLINK_sendData(g_hostCommand, g_hostCommandSize);
+			g_hostCommandSize = 0;
+		}
+		/* Host board command */
+#endif
+		SLINK_flush(HMI_getTickMs());
+		/* Send the bytes of this iteration in one frame */
+	}
+}
@@ -0,0 +1,136 @@
+ /******************************************************************************
+ *
+ * Module: Password Entry
+ *
+ * File Name: password_entry.c
+ *
+ * Description: Source file for the HMI password input engine
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "password_entry.h"
+
+#include "HAL/lcd.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Fixed size edit buffer, no input can make the entry grow past it */
+static uint8 g_entryBuffer[PASSWORD_LENGTH];
+static uint8 g_entryLength = 0; /* Digits currently in the buffer */
+static boolean g_entryDone = FALSE; /* TRUE once the entry was validated, further keys are ignored */
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Function responsible for removing the last digit from the buffer and the screen
+ */
+static void PASSENTRY_eraseDigit(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start a new entry with an empty buffer, the digits are displayed from the current cursor position.
+ */
+void PASSENTRY_start(void)
+{
+	g_entryLength = 0;
+	g_entryDone = FALSE;
+}
+
+/*
+ * Description :
+ * Handle one key of the entry:
+ * 1. A digit is stored and displayed as PASSENTRY_MASK_CHARACTER, digits after PASSWORD_LENGTH are ignored.
+ * 2. Backspace erases the last digit, clear erases all of them (or cancels an empty entry).
+ * 3. Enter with PASSWORD_LENGTH digits ends the entry, PASSENTRY_DONE is returned only once per entry.
+ * Any other key is ignored.
+ */
+PASSENTRY_Result PASSENTRY_key(uint8 key)
+{
+	if(g_entryDone)
+	{
+		return PASSENTRY_EDITING;
+	}
+
+	if(key <= 9)
+	{
+		if(g_entryLength < PASSWORD_LENGTH)
+		{
+			g_entryBuffer[g_entryLength] = key;
+			g_entryLength++;
+			LCD_displayCharacter(PASSENTRY_MASK_CHARACTER);
+		}
+	}
+	else if(key == PASSENTRY_KEY_BACKSPACE)
+	{
+		if(g_entryLength != 0)
+		{
+			PASSENTRY_eraseDigit();
+		}
+	}
+	else if(key == PASSENTRY_KEY_CLEAR)
+	{
+		if(g_entryLength == 0)
+		{
+			return PASSENTRY_CANCELLED;
+		}
+		while(g_entryLength != 0)
+		{
+			PASSENTRY_eraseDigit();
+		}
+	}
+	else if(key == PASSENTRY_KEY_ENTER)
+	{
+		if(g_entryLength == PASSWORD_LENGTH)
+		{
+			g_entryDone = TRUE;
+			return PASSENTRY_DONE;
+		}
+	}
+	return PASSENTRY_EDITING;
+}
+
+/*
+ * Description :
+ * Copy the entered password (PASSWORD_LENGTH digits) to the given array.
+ */
+void PASSENTRY_getPassword(uint8 *password)
+{
+	uint8 i;
+	for(i = 0; i < PASSWORD_LENGTH; i++)
+	{
+		password[i] = g_entryBuffer[i];
+	}
+}
+
+/*
+ * Description :
+ * Return the number of digits currently entered.
+ */
+uint8 PASSENTRY_getLength(void)
+{
+	return g_entryLength;
+}
+
+/*
+ * Description :
+ * Remove the last digit from the buffer, and its mask character from the screen
+ */
+static void PASSENTRY_eraseDigit(void)
+{
+	g_entryLength--;
+	g_entryBuffer[g_entryLength] = 0;
+	LCD_sendCommand(LCD_CURSOR_SHIFT_LEFT);
+	LCD_displayCharacter(' ');
+	LCD_sendCommand(LCD_CURSOR_SHIFT_LEFT);
+	/* The cursor is left where the erased digit was */
+}
@@ -0,0 +1,71 @@
+ /******************************************************************************
+ *
+ * Module: Password Entry
+ *
+ * File Name: password_entry.h
+ *
+ * Description: Header file for the HMI password input engine
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef PASSWORD_ENTRY_H_
+#define PASSWORD_ENTRY_H_
+
+#include "UTIL/std_types.h"
+#include "UTIL/communication_commands.h" /* For PASSWORD_LENGTH */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Editing keys */
+#define PASSENTRY_KEY_ENTER              '='
+#define PASSENTRY_KEY_BACKSPACE          '*'
+#define PASSENTRY_KEY_CLEAR              13  /* ON/C, cancels the entry if nothing is entered */
+
+/* Character displayed in place of each digit */
+#define PASSENTRY_MASK_CHARACTER         '*'
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef enum
+{
+	PASSENTRY_EDITING, PASSENTRY_DONE, PASSENTRY_CANCELLED
+}PASSENTRY_Result;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start a new entry with an empty buffer, the digits are displayed from the current cursor position.
+ */
+void PASSENTRY_start(void);
+
+/*
+ * Description :
+ * Handle one key of the entry:
+ * 1. A digit is stored and displayed as PASSENTRY_MASK_CHARACTER, digits after PASSWORD_LENGTH are ignored.
+ * 2. Backspace erases the last digit, clear erases all of them (or cancels an empty entry).
+ * 3. Enter with PASSWORD_LENGTH digits ends the entry, PASSENTRY_DONE is returned only once per entry.
+ * Any other key is ignored.
+ */
+PASSENTRY_Result PASSENTRY_key(uint8 key);
+
+/*
+ * Description :
+ * Copy the entered password (PASSWORD_LENGTH digits) to the given array.
+ */
+void PASSENTRY_getPassword(uint8 *password);
+
+/*
+ * Description :
+ * Return the number of digits currently entered.
+ */
+uint8 PASSENTRY_getLength(void);
+
+#endif /* PASSWORD_ENTRY_H_ */
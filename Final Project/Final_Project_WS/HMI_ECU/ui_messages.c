@@ -0,0 +1,164 @@
+ /******************************************************************************
+ *
+ * Module: UI Messages
+ *
+ * File Name: ui_messages.c
+ *
+ * Description: Source file for the HMI message and screen tables stored in flash
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "ui_messages.h"
+
+#include <avr/pgmspace.h> /* For PROGMEM and the pgm_read functions */
+#include "HAL/lcd.h"
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	uint8 line1; /* UI_MessageId displayed on the first row */
+	uint8 line2; /* UI_MessageId displayed on the second row */
+	uint8 cursor_row;
+	uint8 cursor_col;
+}UI_ScreenType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Strings are kept in flash, only their IDs are used by the application */
+static const char g_msgNone[] PROGMEM = "";
+static const char g_msgEnterPass[] PROGMEM = "Plz Enter Pass:";
+static const char g_msgEnterSamePassLine1[] PROGMEM = "Plz Enter The";
+static const char g_msgEnterSamePassLine2[] PROGMEM = "Same Pass:";
+static const char g_msgMenuOpenDoor[] PROGMEM = "+ : Open Door";
+static const char g_msgMenuChangePass[] PROGMEM = "- : Change Pass";
+static const char g_msgDoorUnlocking[] PROGMEM = "Door is Unlocking";
+static const char g_msgDoorLocking[] PROGMEM = "Door is Locking";
+static const char g_msgError[] PROGMEM = "ERROR";
+static const char g_msgDoorOpen[] PROGMEM = "Door is Open";
+static const char g_msgDoorTimeout[] PROGMEM = "Travel Timeout!";
+static const char g_msgTravelTime[] PROGMEM = "Travel:";
+static const char g_msgDoorJammed[] PROGMEM = "Door Jammed!";
+static const char g_msgMotorOverCurrent[] PROGMEM = "Motor Overload!";
+static const char g_msgMotorStopped[] PROGMEM = "Motor Stopped";
+static const char g_msgPleaseWait[] PROGMEM = "Please Wait";
+static const char g_msgLocked[] PROGMEM = "ERROR: Locked";
+static const char g_msgRetryIn[] PROGMEM = "Retry in";
+/* Status texts are padded to the full row to overwrite what is under them */
+static const char g_msgStatusIdle[] PROGMEM = "Status: Idle    ";
+static const char g_msgStatusOpening[] PROGMEM = "Status: Opening ";
+static const char g_msgStatusHold[] PROGMEM = "Status: Open    ";
+static const char g_msgStatusClosing[] PROGMEM = "Status: Closing ";
+static const char g_msgStatusAlarm[] PROGMEM = "Status: Alarm   ";
+/* Row labels of the stack diagnostic screen, the values are drawn after them */
+static const char g_msgStackHmi[] PROGMEM = "H";
+static const char g_msgStackControl[] PROGMEM = "C";
+
+/* Message lookup table indexed by UI_MessageId, also in flash */
+static const char * const g_messages[MSG_COUNT] PROGMEM =
+{
+	g_msgNone,
+	g_msgEnterPass,
+	g_msgEnterSamePassLine1,
+	g_msgEnterSamePassLine2,
+	g_msgMenuOpenDoor,
+	g_msgMenuChangePass,
+	g_msgDoorUnlocking,
+	g_msgDoorLocking,
+	g_msgError,
+	g_msgDoorOpen,
+	g_msgDoorTimeout,
+	g_msgTravelTime,
+	g_msgDoorJammed,
+	g_msgMotorOverCurrent,
+	g_msgMotorStopped,
+	g_msgPleaseWait,
+	g_msgLocked,
+	g_msgRetryIn,
+	g_msgStatusIdle,
+	g_msgStatusOpening,
+	g_msgStatusHold,
+	g_msgStatusClosing,
+	g_msgStatusAlarm,
+	g_msgStackHmi,
+	g_msgStackControl
+};
+
+/* Screen lookup table indexed by UI_ScreenId */
+static const UI_ScreenType g_screens[SCREEN_COUNT] PROGMEM =
+{
+	{MSG_NONE,                  MSG_NONE,                  0, 0},  /* SCREEN_BLANK */
+	{MSG_ENTER_PASS,            MSG_NONE,                  1, 0},  /* SCREEN_ENTER_PASS */
+	{MSG_ENTER_SAME_PASS_LINE1, MSG_ENTER_SAME_PASS_LINE2, 1, 10}, /* SCREEN_ENTER_SAME_PASS */
+	{MSG_MENU_OPEN_DOOR,        MSG_MENU_CHANGE_PASS,      1, 15}, /* SCREEN_MAIN_MENU */
+	{MSG_DOOR_UNLOCKING,        MSG_NONE,                  1, 0},  /* SCREEN_DOOR_UNLOCKING */
+	{MSG_DOOR_LOCKING,          MSG_NONE,                  1, 0},  /* SCREEN_DOOR_LOCKING */
+	{MSG_ERROR,                 MSG_NONE,                  1, 0},  /* SCREEN_ERROR */
+	{MSG_DOOR_OPEN,             MSG_TRAVEL_TIME,           1, 8},  /* SCREEN_DOOR_OPEN */
+	{MSG_DOOR_TIMEOUT,          MSG_TRAVEL_TIME,           1, 8},  /* SCREEN_DOOR_TIMEOUT */
+	{MSG_DOOR_JAMMED,           MSG_MOTOR_STOPPED,         1, 15}, /* SCREEN_DOOR_STALL */
+	{MSG_MOTOR_OVER_CURRENT,    MSG_MOTOR_STOPPED,         1, 15}, /* SCREEN_DOOR_OVER_CURRENT */
+	{MSG_PLEASE_WAIT,           MSG_NONE,                  0, 11}, /* SCREEN_WAIT */
+	{MSG_LOCKED,                MSG_RETRY_IN,              1, 9},  /* SCREEN_LOCKED */
+	{MSG_STACK_HMI,             MSG_STACK_CONTROL,         0, 1}   /* SCREEN_STACK */
+};
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Return the flash address of the required message, to be used with the LCD *_P functions.
+ */
+const char *UI_getMessage(UI_MessageId id)
+{
+	if(id >= MSG_COUNT)
+	{
+		id = MSG_NONE;
+	}
+	return (const char *)pgm_read_ptr(&g_messages[id]);
+}
+
+/*
+ * Description :
+ * Display the required message in a specified row and column index on the screen
+ */
+void UI_displayMessage(uint8 row, uint8 col, UI_MessageId id)
+{
+	LCD_displayStringRowColumn_P(row, col, UI_getMessage(id));
+}
+
+/*
+ * Description :
+ * Clear the screen, draw the required screen and leave the cursor where input is expected
+ */
+void UI_showScreen(UI_ScreenId id)
+{
+	UI_MessageId line;
+
+	if(id >= SCREEN_COUNT)
+	{
+		id = SCREEN_BLANK;
+	}
+
+	LCD_clearScreen();
+
+	line = pgm_read_byte(&g_screens[id].line1);
+	if(line != MSG_NONE)
+	{
+		UI_displayMessage(0, 0, line);
+	}
+	line = pgm_read_byte(&g_screens[id].line2);
+	if(line != MSG_NONE)
+	{
+		UI_displayMessage(1, 0, line);
+	}
+
+	LCD_moveCursor(pgm_read_byte(&g_screens[id].cursor_row), pgm_read_byte(&g_screens[id].cursor_col));
+}
@@ -0,0 +1,96 @@
+ /******************************************************************************
+ *
+ * Module: UI Messages
+ *
+ * File Name: ui_messages.h
+ *
+ * Description: Header file for the HMI message and screen tables stored in flash
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef UI_MESSAGES_H_
+#define UI_MESSAGES_H_
+
+#include "UTIL/std_types.h"
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* IDs of every UI string, the strings themselves live in flash only */
+typedef enum
+{
+	MSG_NONE,
+	MSG_ENTER_PASS,
+	MSG_ENTER_SAME_PASS_LINE1,
+	MSG_ENTER_SAME_PASS_LINE2,
+	MSG_MENU_OPEN_DOOR,
+	MSG_MENU_CHANGE_PASS,
+	MSG_DOOR_UNLOCKING,
+	MSG_DOOR_LOCKING,
+	MSG_ERROR,
+	MSG_DOOR_OPEN,
+	MSG_DOOR_TIMEOUT,
+	MSG_TRAVEL_TIME,
+	MSG_DOOR_JAMMED,
+	MSG_MOTOR_OVER_CURRENT,
+	MSG_MOTOR_STOPPED,
+	MSG_PLEASE_WAIT,
+	MSG_LOCKED,
+	MSG_RETRY_IN,
+	/* Status texts, kept in the order of the STATUS_xxx answers */
+	MSG_STATUS_IDLE,
+	MSG_STATUS_OPENING,
+	MSG_STATUS_HOLD,
+	MSG_STATUS_CLOSING,
+	MSG_STATUS_ALARM,
+	MSG_STACK_HMI,
+	MSG_STACK_CONTROL,
+	MSG_COUNT
+}UI_MessageId;
+
+/* IDs of the full screens, each screen is a clear + up to two lines + cursor position */
+typedef enum
+{
+	SCREEN_BLANK,
+	SCREEN_ENTER_PASS,
+	SCREEN_ENTER_SAME_PASS,
+	SCREEN_MAIN_MENU,
+	SCREEN_DOOR_UNLOCKING,
+	SCREEN_DOOR_LOCKING,
+	SCREEN_ERROR,
+	SCREEN_DOOR_OPEN,
+	SCREEN_DOOR_TIMEOUT,
+	SCREEN_DOOR_STALL,
+	SCREEN_DOOR_OVER_CURRENT,
+	SCREEN_WAIT,
+	SCREEN_LOCKED,
+	SCREEN_STACK,
+	SCREEN_COUNT
+}UI_ScreenId;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Return the flash address of the required message, to be used with the LCD *_P functions.
+ */
+const char *UI_getMessage(UI_MessageId id);
+
+/*
+ * Description :
+ * Display the required message in a specified row and column index on the screen
+ */
+void UI_displayMessage(uint8 row, uint8 col, UI_MessageId id);
+
+/*
+ * Description :
+ * Clear the screen, draw the required screen and leave the cursor where input is expected
+ */
+void UI_showScreen(UI_ScreenId id);
+
+#endif /* UI_MESSAGES_H_ */
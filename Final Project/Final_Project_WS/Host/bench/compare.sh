@@ -0,0 +1,58 @@
+#!/bin/sh
+################################################################################
+#
+# Compare two driver bench tables (build/driver_bench or the DRIVER_BENCHMARK
+# build of Control ECU, captured from its UART) row by row on cycles_max:
+#
+#   sh bench/compare.sh baseline.csv new.csv [threshold_percent]
+#
+# Exits with 1 if a primitive got slower by more than the threshold (default 5%)
+#
+# Author: Yousouf Soliman
+#
+################################################################################
+
+if [ $# -lt 2 ] || [ $# -gt 3 ]; then
+	echo "usage: $0 baseline.csv new.csv [threshold_percent]" >&2
+	exit 2
+fi
+
+awk -F, -v threshold="${3:-5}" '
+	{ sub(/\r$/, "") }
+	/^#/ || NF < 5 || $1 == "primitive" { next }
+	FNR == NR { baseline[$1 "," $2] = $4; order[++rows] = $1 "," $2; next }
+	{
+		key = $1 "," $2
+		measured[key] = $4
+		if (!(key in baseline)) order[++rows] = key
+	}
+	END {
+		printf "%-40s %12s %12s %9s\n", "primitive,case", "baseline", "new", "change"
+		for (row = 1; row <= rows; row++) {
+			key = order[row]
+			if (!(key in measured)) {
+				printf "%-40s %12s %12s %9s\n", key, baseline[key], "-", "removed"
+				continue
+			}
+			if (!(key in baseline)) {
+				printf "%-40s %12s %12s %9s\n", key, "-", measured[key], "new"
+				continue
+			}
+			if (baseline[key] == 0) {
+				change = (measured[key] == 0) ? 0 : 100
+			} else {
+				change = 100 * (measured[key] - baseline[key]) / baseline[key]
+			}
+			verdict = ""
+			if (change > threshold) {
+				verdict = "  SLOWER"
+				slower++
+			}
+			printf "%-40s %12s %12s %8.1f%%%s\n", key, baseline[key], measured[key], change, verdict
+		}
+		if (slower) {
+			printf "%d row(s) slower by more than %s%%\n", slower, threshold
+			exit 1
+		}
+	}
+' "$1" "$2"
@@ -0,0 +1,461 @@
+ /******************************************************************************
+ *
+ * Module: Host Bench
+ *
+ * File Name: driver_bench.c
+ *
+ * Description: Driver micro-benchmarks: every driver primitive of both ECUs is
+ *              called on the host MCU at F_CPU = 8MHz with the device models
+ *              wired, and its cost in CPU cycles and time is printed as a CSV
+ *              table, the same table as the DRIVER_BENCHMARK build of Control ECU
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "host_mcu.h"
+#include "eeprom_model.h"
+#include "hbridge_model.h"
+#include "lcd_model.h"
+#include "keypad_model.h"
+#include "MCAL/gpio.h"
+#include "MCAL/uart.h"
+#include "MCAL/twi.h"
+#include "MCAL/timer.h"
+#include "HAL/external_eeprom.h"
+#include "HAL/motor.h"
+#include "HAL/lcd.h"
+#include "HAL/lcd_widgets.h"
+#include "HAL/keypad.h"
+#include "UTIL/communication_commands.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * The cycles are the host MCU virtual clock (see host_mcu.h): exact for the waits on
+ * the UART, the TWI and the delays, an estimate for the code between two register
+ * accesses. Compare the host tables with each other, and the target table (Control
+ * ECU DRIVER_BENCHMARK build) with each other: bench/compare.sh.
+ */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Every case is measured this many times, the table gives the fastest and the slowest */
+#define BENCH_RUNS                       8
+
+#define BENCH_EEPROM_ADDRESS             0x0123
+#define BENCH_MOTOR_SPEED                50
+#define BENCH_KEY                        '5'
+/* Ticks of a whole keypad scan (every row), and scans to report a held key */
+#define BENCH_SCAN_TICKS                 (KEYPAD_NUM_ROWS * KEYPAD_SCAN_PERIOD_MS)
+#define BENCH_KEY_SCANS                  (KEYPAD_DEBOUNCE_SCANS + 1)
+/* Countdown widgets as HMI ECU draws them: a 12 cells bar and 2 digits of seconds on row 1 */
+#define BENCH_BAR_COL                    0
+#define BENCH_BAR_WIDTH                  12
+#define BENCH_BAR_STEP                   29   /* Filled pixel columns before the step, inside a cell */
+#define BENCH_SECONDS_COL                13
+#define BENCH_SECONDS_WIDTH              2
+#define BENCH_SECONDS                    15   /* Seconds before the change, only the units change */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	const char *primitive;
+	const char *name;
+	/* Puts the drivers in the state of the case, not counted (can be NULL) */
+	void (*setup)(void);
+	/* The measured calls, returns FALSE if the driver failed */
+	boolean (*run)(void);
+}BENCH_CaseType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static EepromModel_Type g_eeprom;
+static HBridgeModel_Type g_motor;
+static LcdModel_Type g_lcd;
+static KeypadModel_Type g_keypad;
+static WIDGET_ProgressBarType g_bar;
+static WIDGET_CountdownType g_seconds;
+static uint64 g_idleCycles = 0; /* Cycles of the current measure spent in BENCH_idle() */
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Let the virtual clock run without counting it in the current measure
+ */
+static void BENCH_idle(uint64 cycles)
+{
+	uint64 start = HOST_getCycles();
+	while(HOST_getCycles() - start < cycles)
+	{
+		HOST_cpuCycles((uint32)(cycles - (HOST_getCycles() - start)));
+	}
+	g_idleCycles += HOST_getCycles() - start;
+}
+
+/*
+ * Description :
+ * Wait for the UART transmitter to be empty (a frame in UDR and one being shifted out)
+ */
+static void BENCH_uartDrain(void)
+{
+	BENCH_idle(2 * (uint64)HOST_getUartBitCycles() * HOST_getUartFrameBits() + 1);
+}
+
+/*
+ * Description :
+ * Write every queued LCD byte with the 1ms tick of the HMI ECU
+ */
+static void BENCH_lcdDrain(void)
+{
+	while(LCD_getQueueSpace() != LCD_QUEUE_SIZE)
+	{
+		LCD_service();
+		BENCH_idle(HOST_msToCycles(1));
+	}
+	/* Clear/Home is still executing */
+	BENCH_idle(HOST_msToCycles(LCD_LONG_COMMAND_TICKS));
+}
+
+/*
+ * Description :
+ * Run whole keypad scans with the 1ms tick of the HMI ECU, the ticks are counted
+ */
+static void BENCH_keypadScans(uint8 scans)
+{
+	uint16 tick;
+	for(tick = 0; tick < (uint16)scans * BENCH_SCAN_TICKS; tick++)
+	{
+		KEYPAD_scanTick();
+		BENCH_idle(HOST_msToCycles(1));
+	}
+}
+
+static void setupUartIdle(void)
+{
+	BENCH_uartDrain();
+}
+
+static void setupUartBusy(void)
+{
+	BENCH_uartDrain();
+	UART_sendByte(0x55);
+	UART_sendByte(0x55);
+	/* The first byte is being shifted out and the second one waits in UDR */
+}
+
+static boolean runUartSendByte(void)
+{
+	UART_sendByte(0x55);
+	return TRUE;
+}
+
+static boolean runEepromReadByte(void)
+{
+	uint8 data;
+	return EEPROM_readByte(BENCH_EEPROM_ADDRESS, &data) == SUCCESS;
+}
+
+static void setupEepromWrite(void)
+{
+	/* The previous write cycle is over */
+	BENCH_idle(HOST_nsToCycles(EEPROM_MODEL_WRITE_NS) + 1);
+}
+
+static boolean runEepromWriteByte(void)
+{
+	return EEPROM_writeByte(BENCH_EEPROM_ADDRESS, 0x5A) == SUCCESS;
+}
+
+static boolean runGpioWritePin(void)
+{
+	GPIO_writePin(DcMotor_PORT, DcMotor_PIN, LOGIC_LOW);
+	return TRUE;
+}
+
+static void setupMotorStopped(void)
+{
+	DcMotor_Rotate(STOP, 0);
+}
+
+static void setupMotorRunning(void)
+{
+	DcMotor_Rotate(STOP, 0);
+	DcMotor_Rotate(CW, BENCH_MOTOR_SPEED);
+}
+
+static boolean runMotorClockwise(void)
+{
+	DcMotor_Rotate(CW, BENCH_MOTOR_SPEED);
+	return TRUE;
+}
+
+static boolean runMotorAntiClockwise(void)
+{
+	DcMotor_Rotate(A_CW, BENCH_MOTOR_SPEED);
+	return TRUE;
+}
+
+static boolean runMotorStop(void)
+{
+	DcMotor_Rotate(STOP, 0);
+	return TRUE;
+}
+
+static void setupTimer1(void)
+{
+	Timer1_DeInit();
+}
+
+static boolean runTimer1InitNormal(void)
+{
+	Timer1_ConfigType config = {0, 0, Prescalar_64, Timer1_NormalMode};
+	Timer1_Init(&config);
+	return TRUE;
+}
+
+static boolean runTimer1InitCompare(void)
+{
+	Timer1_ConfigType config = {0, 1000, Prescalar_64, Timer1_CompareClear};
+	Timer1_Init(&config);
+	return TRUE;
+}
+
+static void setupLcdEmpty(void)
+{
+	BENCH_lcdDrain();
+}
+
+static void setupLcdCharacterQueued(void)
+{
+	BENCH_lcdDrain();
+	LCD_displayCharacter('A');
+}
+
+static void setupLcdCursorQueued(void)
+{
+	BENCH_lcdDrain();
+	LCD_moveCursor(1, 5);
+}
+
+static boolean runLcdDisplayCharacter(void)
+{
+	LCD_displayCharacter('A');
+	return TRUE;
+}
+
+static boolean runLcdMoveCursor(void)
+{
+	LCD_moveCursor(1, 5);
+	return TRUE;
+}
+
+static boolean runLcdService(void)
+{
+	LCD_service();
+	return TRUE;
+}
+
+/*
+ * Description :
+ * The widgets drawn and rendered, the next update is one bar step or one second
+ */
+static void setupWidgets(void)
+{
+	BENCH_lcdDrain();
+	WIDGET_progressBarInit(&g_bar, 1, BENCH_BAR_COL, BENCH_BAR_WIDTH);
+	WIDGET_progressBarUpdate(&g_bar, BENCH_BAR_STEP);
+	WIDGET_countdownInit(&g_seconds, 1, BENCH_SECONDS_COL, BENCH_SECONDS_WIDTH, BENCH_SECONDS);
+	BENCH_lcdDrain();
+}
+
+static void setupBarStepQueued(void)
+{
+	setupWidgets();
+	WIDGET_progressBarUpdate(&g_bar, BENCH_BAR_STEP + 1);
+}
+
+static void setupSecondsChangeQueued(void)
+{
+	setupWidgets();
+	WIDGET_countdownUpdate(&g_seconds, BENCH_SECONDS - 1);
+}
+
+static boolean runBarStep(void)
+{
+	return WIDGET_progressBarUpdate(&g_bar, BENCH_BAR_STEP + 1);
+}
+
+static boolean runSecondsChange(void)
+{
+	return WIDGET_countdownUpdate(&g_seconds, BENCH_SECONDS - 1);
+}
+
+/*
+ * Description :
+ * Write the queued LCD bytes of a widget update, one per 1ms tick as HMI ECU does
+ * (the ticks are not counted)
+ */
+static boolean runLcdRender(void)
+{
+	while(LCD_getQueueSpace() != LCD_QUEUE_SIZE)
+	{
+		LCD_service();
+		BENCH_idle(HOST_msToCycles(1));
+	}
+	return TRUE;
+}
+
+static boolean runKeypadScanTick(void)
+{
+	KEYPAD_scanTick();
+	BENCH_idle(HOST_msToCycles(1));
+	return TRUE;
+}
+
+static void setupKeypadReleased(void)
+{
+	KeypadModel_release(&g_keypad);
+	BENCH_keypadScans(BENCH_KEY_SCANS);
+	KEYPAD_flush();
+}
+
+static void setupKeypadHeld(void)
+{
+	setupKeypadReleased();
+	KeypadModel_press(&g_keypad, BENCH_KEY);
+}
+
+static void setupKeypadQueued(void)
+{
+	setupKeypadHeld();
+	BENCH_keypadScans(BENCH_KEY_SCANS);
+}
+
+static boolean runKeypadScan(void)
+{
+	BENCH_keypadScans(1);
+	return TRUE;
+}
+
+static boolean runKeypadGetPressedKey(void)
+{
+	return KEYPAD_getPressedKey() != KEYPAD_NO_KEY;
+}
+
+/*
+ * Description :
+ * Wire the models and initialize the drivers as both ECUs do, on one 8MHz MCU:
+ * the LCD (PORTA, PB0, PB1), the keypad (PB4-PB7, PC0-PC3), the EEPROM (TWI) and
+ * the H-bridge (PC2, PC3, OC0) are only used one at a time.
+ * The interrupts stay disabled so no ISR is counted.
+ */
+static void BENCH_init(void)
+{
+	HBridgeModel_ConfigType motor_config = {HOST_PORTC, 2, HOST_PORTD, 2, 3, 1, 500, 5000, 400, 2500};
+	LcdModel_ConfigType lcd_config = {HOST_PORTA, 0, 8, HOST_PORTB, 0, HOST_PORTB, 1};
+	KeypadModel_ConfigType keypad_config = {HOST_PORTB, 4, HOST_PORTC, 0};
+	UART_ConfigType uart_config = {BitData_8, Parity_Even, StopBit_1, LINK_BAUD_RATE};
+	TWI_ConfigType twi_config = {0x10, 400000};
+
+	HOST_init();
+	EepromModel_init(&g_eeprom);
+	HBridgeModel_init(&g_motor, &motor_config, 0);
+	LcdModel_init(&g_lcd, &lcd_config);
+	KeypadModel_init(&g_keypad, &keypad_config);
+
+	UART_init(&uart_config);
+	TWI_init(&twi_config);
+	DcMotor_init();
+	LCD_init();
+	KEYPAD_enable();
+}
+
+int main(void)
+{
+	static const BENCH_CaseType cases[] =
+	{
+		{"uart_send_byte", "idle", setupUartIdle, runUartSendByte},
+		{"uart_send_byte", "busy", setupUartBusy, runUartSendByte},
+		{"eeprom_read_byte", "random", setupEepromWrite, runEepromReadByte},
+		{"eeprom_write_byte", "byte", setupEepromWrite, runEepromWriteByte},
+		{"gpio_write_pin", "pin", setupMotorStopped, runGpioWritePin},
+		{"dc_motor_rotate", "start", setupMotorStopped, runMotorClockwise},
+		{"dc_motor_rotate", "reverse", setupMotorRunning, runMotorAntiClockwise},
+		{"dc_motor_rotate", "stop", setupMotorRunning, runMotorStop},
+		{"dc_motor_rotate", "stopped", setupMotorStopped, runMotorStop},
+		{"timer1_init", "normal", setupTimer1, runTimer1InitNormal},
+		{"timer1_init", "compare", setupTimer1, runTimer1InitCompare},
+		{"lcd_display_character", "queue", setupLcdEmpty, runLcdDisplayCharacter},
+		{"lcd_display_character", "bus_write", setupLcdCharacterQueued, runLcdService},
+		{"lcd_move_cursor", "queue", setupLcdEmpty, runLcdMoveCursor},
+		{"lcd_move_cursor", "bus_write", setupLcdCursorQueued, runLcdService},
+		/* Countdown refresh of HMI ECU: the update queues the changed cells, the ticks render them */
+		{"widget_bar_update", "step", setupWidgets, runBarStep},
+		{"widget_bar_update", "render", setupBarStepQueued, runLcdRender},
+		{"widget_countdown_update", "seconds_change", setupWidgets, runSecondsChange},
+		{"widget_countdown_update", "render", setupSecondsChangeQueued, runLcdRender},
+		/* Every other tick reads a row: the fastest is an idle tick, the slowest a row read */
+		{"keypad_scan_tick", "tick", NULL, runKeypadScanTick},
+		{"keypad_scan", "no_key", setupKeypadReleased, runKeypadScan},
+		{"keypad_scan", "key_held", setupKeypadHeld, runKeypadScan},
+		{"keypad_get_pressed_key", "queued", setupKeypadQueued, runKeypadGetPressedKey}
+	};
+	uint8 index;
+	uint8 run;
+	uint64 start;
+	uint64 cycles;
+	uint64 cycles_min;
+	uint64 cycles_max;
+
+	BENCH_init();
+	printf("# driver bench: host MCU, F_CPU=%lu, link %u baud\n", (unsigned long)F_CPU, (unsigned)LINK_BAUD_RATE);
+	printf("primitive,case,cycles_min,cycles_max,time_ns_max\n");
+	for(index = 0; index < sizeof(cases) / sizeof(cases[0]); index++)
+	{
+		cycles_min = HOST_NEVER;
+		cycles_max = 0;
+		for(run = 0; run < BENCH_RUNS; run++)
+		{
+			if(cases[index].setup != NULL)
+			{
+				cases[index].setup();
+			}
+			g_idleCycles = 0;
+			start = HOST_getCycles();
+			if(!cases[index].run())
+			{
+				fprintf(stderr, "%s,%s: the driver failed\n", cases[index].primitive, cases[index].name);
+				return EXIT_FAILURE;
+			}
+			cycles = HOST_getCycles() - start - g_idleCycles;
+			if(cycles < cycles_min)
+			{
+				cycles_min = cycles;
+			}
+			if(cycles > cycles_max)
+			{
+				cycles_max = cycles;
+			}
+		}
+		printf("%s,%s,%llu,%llu,%llu\n", cases[index].primitive, cases[index].name,
+				(unsigned long long)cycles_min, (unsigned long long)cycles_max,
+				(unsigned long long)HOST_cyclesToNs(cycles_max));
+	}
+	if(g_motor.shoot_through != 0 || g_lcd.busy_violations != 0)
+	{
+		fprintf(stderr, "model violations: %u shoot-through, %u LCD busy\n",
+				(unsigned)g_motor.shoot_through, (unsigned)g_lcd.busy_violations);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
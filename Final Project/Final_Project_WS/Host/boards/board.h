@@ -0,0 +1,98 @@
+ /******************************************************************************
+ *
+ * Module: Host Board
+ *
+ * File Name: board.h
+ *
+ * Description: Header file for the host boards: one ECU firmware on the host
+ *              MCU with its device models wired as on the real board, seen
+ *              through one table of functions by the runners and the co-simulation
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef BOARD_H_
+#define BOARD_H_
+
+#include "std_types.h"
+#include "isr_latency.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Name of the function returning the board table, looked up in the ECU shared objects */
+#define BOARD_GET_SYMBOL                 "BOARD_get"
+
+/* UART parity, as the UPM bits */
+#define BOARD_PARITY_NONE                0
+#define BOARD_PARITY_EVEN                2
+#define BOARD_PARITY_ODD                 3
+
+/* Receive status bits of BOARD_Type.uartReceive, as in UCSRA */
+#define BOARD_UART_FRAME_ERROR           (1 << 4)
+#define BOARD_UART_PARITY_ERROR          (1 << 2)
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* A frame starts on TXD at the current time of the board and ends at endNs */
+typedef void (*BOARD_UartTxCallBack)(void *context, uint8 data, uint64 endNs);
+
+typedef struct
+{
+	uint32 bit_ns;             /* Time of one bit */
+	uint8 data_bits;
+	uint8 parity;              /* BOARD_PARITY_xxx */
+	uint8 stop_bits;
+}BOARD_UartFormatType;
+
+/*
+ * The functions an ECU does not have are NULL
+ * (HMI: no door, Control: no display and no keypad).
+ */
+typedef struct
+{
+	const char *name;
+	/* Power on: the models are wired and the firmware starts at time 0, called once */
+	void (*start)(void);
+	/* Run the firmware until the given time, FALSE if its main function returned */
+	boolean (*runUntilNs)(uint64 ns);
+	uint64 (*getTimeNs)(void);
+	/* USART: TXD and RXD */
+	void (*setUartTx)(BOARD_UartTxCallBack callBack, void *context);
+	void (*getUartFormat)(BOARD_UartFormatType *format);
+	boolean (*uartReceive)(uint8 data, uint8 status);
+	/* Protocol violations seen by the models (LCD busy, H-bridge shoot-through, ...) */
+	uint32 (*getModelViolations)(void);
+	/* HMI: LCD and keypad */
+	const char *(*getDisplayLine)(uint8 row);
+	boolean (*pressKey)(char key);
+	void (*releaseKey)(void);
+	/* Send a command to Control ECU through the HMI firmware (command byte then its data),
+	 * FALSE if the last one is not sent yet */
+	boolean (*sendCommand)(const uint8 *bytes, uint8 size);
+	/* Control: door, motor and buzzer */
+	uint8 (*getDoorPercent)(void);
+	sint8 (*getMotorDirection)(void);
+	boolean (*isBuzzerOn)(void);
+	void (*jamDoor)(boolean jammed);
+	/* Write the EEPROM like a programmer, before the first run it is the power-on content */
+	void (*writeEeprom)(uint16 address, const uint8 *bytes, uint16 size);
+	/* Stats of the instrumented ISRs, NULL unless built with ISR_LATENCY */
+	const ISRLAT_StatsType *(*getIsrLatency)(uint8 vector);
+}BOARD_Type;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * The board of the ECU this object is built for.
+ */
+const BOARD_Type *BOARD_get(void);
+
+#endif /* BOARD_H_ */
@@ -0,0 +1,161 @@
+ /******************************************************************************
+ *
+ * Module: Host Board
+ *
+ * File Name: control_board.c
+ *
+ * Description: Source file for the Control ECU host board: 24C16 EEPROM on
+ *              the TWI, door motor H-bridge on PC2/PC3 with EN on OC0, limit
+ *              switches on PD2 (open) and PD3 (closed), current shunt on ADC1
+ *              and the buzzer on PA0 (or PD7 in tone mode)
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "board.h"
+#include "host_mcu.h"
+#include "eeprom_model.h"
+#include "hbridge_model.h"
+#include <stddef.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define BOARD_BUZZER_PORT                HOST_PORTA
+#define BOARD_BUZZER_PIN                 0
+#define BOARD_TONE_PORT                  HOST_PORTD
+#define BOARD_TONE_PIN                   7     /* OC2 */
+#define BOARD_TCCR2_ADDRESS              0x45
+#define BOARD_TCCR2_COM_TOGGLE           0x10  /* COM21:COM20 = 01, OC2 toggles on compare match */
+#define BOARD_TCCR2_COM_MASK             0x30
+
+/* Stats of the instrumented ISRs, read from the firmware RAM like a debugger would */
+#ifdef ISR_LATENCY
+#define BOARD_ISR_LATENCY                ISRLAT_peekStats
+#else
+#define BOARD_ISR_LATENCY                NULL
+#endif
+
+/* The firmware main function (built with -Dmain=FIRMWARE_main) */
+int FIRMWARE_main(void);
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static EepromModel_Type g_eeprom;
+static HBridgeModel_Type g_motor;
+static BOARD_UartTxCallBack g_uartTxCallBack = NULL;
+static void *g_uartTxContext = NULL;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Frame started on TXD, the end cycle is given in ns to the board user
+ */
+static void BOARD_uartTx(void *context, uint8 data, uint64 endCycle)
+{
+	(void)context;
+	if(g_uartTxCallBack != NULL)
+	{
+		g_uartTxCallBack(g_uartTxContext, data, HOST_cyclesToNs(endCycle));
+	}
+}
+
+static void BOARD_start(void)
+{
+	/* 5 s full travel at 100% duty, 400 mA running, 2.5 A stalled on a 0.5 ohm shunt, door closed */
+	HBridgeModel_ConfigType motor_config = {HOST_PORTC, 2, HOST_PORTD, 2, 3, 1, 500, 5000, 400, 2500};
+	HOST_init();
+	EepromModel_init(&g_eeprom);
+	HBridgeModel_init(&g_motor, &motor_config, 0);
+	HOST_setUartTx(BOARD_uartTx, NULL);
+	HOST_start(FIRMWARE_main);
+}
+
+static boolean BOARD_runUntilNs(uint64 ns)
+{
+	return HOST_runUntil(HOST_nsToCycles(ns));
+}
+
+static void BOARD_setUartTx(BOARD_UartTxCallBack callBack, void *context)
+{
+	g_uartTxCallBack = callBack;
+	g_uartTxContext = context;
+}
+
+static void BOARD_getUartFormat(BOARD_UartFormatType *format)
+{
+	format->bit_ns = (uint32)HOST_cyclesToNs(HOST_getUartBitCycles());
+	HOST_getUartFormat(&format->data_bits, &format->parity, &format->stop_bits);
+}
+
+static uint32 BOARD_getModelViolations(void)
+{
+	return g_motor.shoot_through;
+}
+
+static uint8 BOARD_getDoorPercent(void)
+{
+	return (uint8)(HBridgeModel_getPosition(&g_motor) / (HBRIDGE_MODEL_FULL_TRAVEL / 100));
+}
+
+static sint8 BOARD_getMotorDirection(void)
+{
+	return g_motor.direction;
+}
+
+/*
+ * Description :
+ * The buzzer sounds when its pin is driven high, or when Timer2 toggles OC2 (tone mode)
+ */
+static boolean BOARD_isBuzzerOn(void)
+{
+	if((HOST_getPortDirection(BOARD_BUZZER_PORT) & HOST_getPortOutput(BOARD_BUZZER_PORT)) & (1 << BOARD_BUZZER_PIN))
+	{
+		return TRUE;
+	}
+	return (HOST_getPortDirection(BOARD_TONE_PORT) & (1 << BOARD_TONE_PIN))
+			&& ((HOST_peek(BOARD_TCCR2_ADDRESS) & BOARD_TCCR2_COM_MASK) == BOARD_TCCR2_COM_TOGGLE);
+}
+
+static void BOARD_jamDoor(boolean jammed)
+{
+	HBridgeModel_jam(&g_motor, jammed);
+}
+
+/*
+ * Description :
+ * Write the EEPROM memory like a programmer: no TWI traffic and no write time.
+ * Before the first run it is the content the firmware finds at power on.
+ */
+static void BOARD_writeEeprom(uint16 address, const uint8 *bytes, uint16 size)
+{
+	uint16 i;
+	for(i = 0; i < size && address + i < EEPROM_MODEL_SIZE; i++)
+	{
+		g_eeprom.memory[address + i] = bytes[i];
+	}
+}
+
+/*
+ * Description :
+ * The board of the ECU this object is built for.
+ */
+const BOARD_Type *BOARD_get(void)
+{
+	static const BOARD_Type board =
+	{
+		"Control", BOARD_start, BOARD_runUntilNs, HOST_getTimeNs,
+		BOARD_setUartTx, BOARD_getUartFormat, HOST_uartReceive, BOARD_getModelViolations,
+		NULL, NULL, NULL, NULL,
+		BOARD_getDoorPercent, BOARD_getMotorDirection, BOARD_isBuzzerOn, BOARD_jamDoor, BOARD_writeEeprom,
+		BOARD_ISR_LATENCY
+	};
+	return &board;
+}
@@ -0,0 +1,122 @@
+ /******************************************************************************
+ *
+ * Module: Host Board
+ *
+ * File Name: hmi_board.c
+ *
+ * Description: Source file for the HMI ECU host board: LCD data on PORTA
+ *              (8-bit mode), RS on PB0, E on PB1 and the keypad rows on PB4-PB7,
+ *              its columns on PC0-PC3
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "board.h"
+#include "host_mcu.h"
+#include "lcd_model.h"
+#include "keypad_model.h"
+#include <stddef.h>
+
+/* Stats of the instrumented ISRs, read from the firmware RAM like a debugger would */
+#ifdef ISR_LATENCY
+#define BOARD_ISR_LATENCY                ISRLAT_peekStats
+#else
+#define BOARD_ISR_LATENCY                NULL
+#endif
+
+/* The firmware main function (built with -Dmain=FIRMWARE_main) */
+int FIRMWARE_main(void);
+/* The host board mailbox of the firmware main loop (HOST_BUILD) */
+boolean HMI_hostCommand(const uint8 *bytes, uint8 size);
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static LcdModel_Type g_lcd;
+static KeypadModel_Type g_keypad;
+static BOARD_UartTxCallBack g_uartTxCallBack = NULL;
+static void *g_uartTxContext = NULL;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Frame started on TXD, the end cycle is given in ns to the board user
+ */
+static void BOARD_uartTx(void *context, uint8 data, uint64 endCycle)
+{
+	(void)context;
+	if(g_uartTxCallBack != NULL)
+	{
+		g_uartTxCallBack(g_uartTxContext, data, HOST_cyclesToNs(endCycle));
+	}
+}
+
+static void BOARD_start(void)
+{
+	LcdModel_ConfigType lcd_config = {HOST_PORTA, 0, 8, HOST_PORTB, 0, HOST_PORTB, 1};
+	KeypadModel_ConfigType keypad_config = {HOST_PORTB, 4, HOST_PORTC, 0};
+	HOST_init();
+	LcdModel_init(&g_lcd, &lcd_config);
+	KeypadModel_init(&g_keypad, &keypad_config);
+	HOST_setUartTx(BOARD_uartTx, NULL);
+	HOST_start(FIRMWARE_main);
+}
+
+static boolean BOARD_runUntilNs(uint64 ns)
+{
+	return HOST_runUntil(HOST_nsToCycles(ns));
+}
+
+static void BOARD_setUartTx(BOARD_UartTxCallBack callBack, void *context)
+{
+	g_uartTxCallBack = callBack;
+	g_uartTxContext = context;
+}
+
+static void BOARD_getUartFormat(BOARD_UartFormatType *format)
+{
+	format->bit_ns = (uint32)HOST_cyclesToNs(HOST_getUartBitCycles());
+	HOST_getUartFormat(&format->data_bits, &format->parity, &format->stop_bits);
+}
+
+static uint32 BOARD_getModelViolations(void)
+{
+	return g_lcd.busy_violations;
+}
+
+static const char *BOARD_getDisplayLine(uint8 row)
+{
+	return LcdModel_getLine(&g_lcd, row);
+}
+
+static boolean BOARD_pressKey(char key)
+{
+	return KeypadModel_press(&g_keypad, key);
+}
+
+static void BOARD_releaseKey(void)
+{
+	KeypadModel_release(&g_keypad);
+}
+
+/*
+ * Description :
+ * The board of the ECU this object is built for.
+ */
+const BOARD_Type *BOARD_get(void)
+{
+	static const BOARD_Type board =
+	{
+		"HMI", BOARD_start, BOARD_runUntilNs, HOST_getTimeNs,
+		BOARD_setUartTx, BOARD_getUartFormat, HOST_uartReceive, BOARD_getModelViolations,
+		BOARD_getDisplayLine, BOARD_pressKey, BOARD_releaseKey, HMI_hostCommand,
+		NULL, NULL, NULL, NULL, NULL,
+		BOARD_ISR_LATENCY
+	};
+	return &board;
+}
@@ -0,0 +1,86 @@
+ /******************************************************************************
+ *
+ * Module: Control Host
+ *
+ * File Name: control_host.c
+ *
+ * Description: Runs the Control ECU firmware on the host board and prints
+ *              what it does with the door motor and the buzzer
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "board.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define CONTROL_HOST_DEFAULT_MS          2000
+#define CONTROL_HOST_STEP_MS             10
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static uint32 g_txBytes = 0;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * The link bytes to HMI ECU, only counted: there is no HMI ECU here
+ */
+static void controlHostTx(void *context, uint8 data, uint64 endNs)
+{
+	(void)context;
+	(void)data;
+	(void)endNs;
+	g_txBytes++;
+}
+
+int main(int argc, char **argv)
+{
+	const BOARD_Type *board = BOARD_get();
+	uint32 run_ms = (argc > 1) ? (uint32)strtoul(argv[1], NULL, 10) : CONTROL_HOST_DEFAULT_MS;
+	uint32 elapsed;
+	boolean buzzer = FALSE;
+	sint8 direction = 0;
+	if(argc > 2 || (argc > 1 && strcmp(argv[1], "-h") == 0))
+	{
+		fprintf(stderr, "usage: %s [ms]\n  runs the firmware for ms (default %u)\n", argv[0], CONTROL_HOST_DEFAULT_MS);
+		return EXIT_FAILURE;
+	}
+	board->setUartTx(controlHostTx, NULL);
+	board->start();
+
+	for(elapsed = 0; elapsed < run_ms; elapsed += CONTROL_HOST_STEP_MS)
+	{
+		if(!board->runUntilNs(board->getTimeNs() + CONTROL_HOST_STEP_MS * 1000000ULL))
+		{
+			printf("firmware returned\n");
+			return EXIT_FAILURE;
+		}
+		if(board->getMotorDirection() != direction)
+		{
+			direction = board->getMotorDirection();
+			printf("%8.3f ms motor %s, door at %u%%\n", board->getTimeNs() / 1e6,
+					(direction > 0) ? "opening" : ((direction < 0) ? "closing" : "stopped"),
+					board->getDoorPercent());
+		}
+		if(board->isBuzzerOn() != buzzer)
+		{
+			buzzer = !buzzer;
+			printf("%8.3f ms buzzer %s\n", board->getTimeNs() / 1e6, buzzer ? "on" : "off");
+		}
+	}
+
+	printf("model violations: %u | link: %u bytes sent\n", board->getModelViolations(), g_txBytes);
+	return EXIT_SUCCESS;
+}
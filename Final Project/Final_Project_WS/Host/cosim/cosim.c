@@ -0,0 +1,186 @@
+ /******************************************************************************
+ *
+ * Module: Co-Simulation
+ *
+ * File Name: cosim.c
+ *
+ * Description: Source file for the co-simulation of HMI ECU and Control ECU
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "cosim.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* TX call back context of each board */
+typedef struct
+{
+	COSIM_Type *cosim;
+	uint8 id;
+}COSIM_TransmitterType;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Function responsible for queueing a frame started by a board on its line
+ */
+static void COSIM_frameStarted(void *context, uint8 data, uint64 endNs);
+
+/*
+ * Function responsible for running a board until the given time,
+ * delivering it the frames of the other board that end before
+ */
+static boolean COSIM_runBoard(COSIM_Type *cosim, uint8 id, uint64 ns);
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static COSIM_TransmitterType g_transmitters[COSIM_BOARDS_NUM];
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Connect the two boards with the cable and power them on.
+ */
+void COSIM_init(COSIM_Type *cosim, const BOARD_Type *hmi, const BOARD_Type *control, const UartCable_ConfigType *cable)
+{
+	uint8 id;
+	cosim->boards[COSIM_HMI] = hmi;
+	cosim->boards[COSIM_CONTROL] = control;
+	UartCable_init(&cosim->cable, cable);
+	cosim->now_ns = 0;
+	cosim->delay_ns = 0;
+	cosim->late_frames = 0;
+	cosim->stopped = FALSE;
+	for(id = 0; id < COSIM_BOARDS_NUM; id++)
+	{
+		cosim->lines[id].head = 0;
+		cosim->lines[id].count = 0;
+		cosim->lines[id].sent = 0;
+		cosim->lines[id].received = 0;
+		cosim->lines[id].overruns = 0;
+		g_transmitters[id].cosim = cosim;
+		g_transmitters[id].id = id;
+		cosim->boards[id]->setUartTx(COSIM_frameStarted, &g_transmitters[id]);
+		cosim->boards[id]->start();
+	}
+}
+
+/*
+ * Description :
+ * Run both boards until the given time.
+ * Returns FALSE if a firmware main function returned.
+ */
+boolean COSIM_runUntil(COSIM_Type *cosim, uint64 ns)
+{
+	BOARD_UartFormatType format;
+	uint64 slice_ns;
+	uint64 frame_ns;
+	uint8 id;
+	while(!cosim->stopped && cosim->now_ns < ns)
+	{
+		slice_ns = COSIM_MAX_SLICE_NS;
+		for(id = 0; id < COSIM_BOARDS_NUM; id++)
+		{
+			cosim->boards[id]->getUartFormat(&format);
+			frame_ns = UartCable_frameNs(&format);
+			if(frame_ns < slice_ns)
+			{
+				slice_ns = frame_ns;
+			}
+		}
+		if(slice_ns < COSIM_MIN_SLICE_NS)
+		{
+			slice_ns = COSIM_MIN_SLICE_NS;
+		}
+		if(ns - cosim->now_ns < slice_ns)
+		{
+			slice_ns = ns - cosim->now_ns;
+		}
+		for(id = 0; id < COSIM_BOARDS_NUM; id++)
+		{
+			if(!COSIM_runBoard(cosim, id, cosim->now_ns + slice_ns))
+			{
+				cosim->stopped = TRUE;
+			}
+		}
+		cosim->now_ns += slice_ns;
+	}
+	return !cosim->stopped;
+}
+
+/*
+ * Description :
+ * Queue a frame started by a board on its line
+ */
+static void COSIM_frameStarted(void *context, uint8 data, uint64 endNs)
+{
+	COSIM_Type *cosim = ((COSIM_TransmitterType *)context)->cosim;
+	uint8 id = ((COSIM_TransmitterType *)context)->id;
+	COSIM_LineType *line = &cosim->lines[id];
+	COSIM_FrameType *frame;
+	if(line->count == COSIM_LINE_FRAMES)
+	{
+		fprintf(stderr, "cosim: %s line queue full\n", cosim->boards[id]->name);
+		exit(EXIT_FAILURE);
+	}
+	frame = &line->frames[(line->head + line->count) % COSIM_LINE_FRAMES];
+	frame->end_ns = endNs + cosim->delay_ns;
+	frame->data = data;
+	cosim->boards[id]->getUartFormat(&frame->format);
+	line->count++;
+	line->sent++;
+}
+
+/*
+ * Description :
+ * Run a board until the given time, delivering it the frames of the other board that end before
+ */
+static boolean COSIM_runBoard(COSIM_Type *cosim, uint8 id, uint64 ns)
+{
+	const BOARD_Type *board = cosim->boards[id];
+	COSIM_LineType *line = &cosim->lines[COSIM_BOARDS_NUM - 1 - id];
+	COSIM_FrameType *frame;
+	BOARD_UartFormatType format;
+	uint8 received;
+	uint8 status;
+	while(line->count != 0 && line->frames[line->head].end_ns <= ns)
+	{
+		frame = &line->frames[line->head];
+		if(frame->end_ns < board->getTimeNs())
+		{
+			cosim->late_frames++;
+		}
+		else if(!board->runUntilNs(frame->end_ns))
+		{
+			return FALSE;
+		}
+		board->getUartFormat(&format);
+		if(UartCable_transfer(&cosim->cable, &frame->format, &format, frame->data, &received, &status))
+		{
+			if(board->uartReceive(received, status))
+			{
+				line->received++;
+			}
+			else
+			{
+				line->overruns++;
+			}
+		}
+		line->head = (line->head + 1) % COSIM_LINE_FRAMES;
+		line->count--;
+	}
+	return board->runUntilNs(ns);
+}
@@ -0,0 +1,90 @@
+ /******************************************************************************
+ *
+ * Module: Co-Simulation
+ *
+ * File Name: cosim.h
+ *
+ * Description: Header file for the co-simulation of HMI ECU and Control ECU:
+ *              both host boards run on one virtual clock, connected by the
+ *              simulated UART cable
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef COSIM_H_
+#define COSIM_H_
+
+#include "board.h"
+#include "uart_cable.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define COSIM_HMI                        0
+#define COSIM_CONTROL                    1
+#define COSIM_BOARDS_NUM                 2
+
+/*
+ * The boards run one after the other in slices of the shortest frame time:
+ * a frame started in a slice ends after it, so it is always delivered to the
+ * other board at its exact end time. The slice is kept in these bounds
+ * (the USART is not configured yet at power on).
+ */
+#define COSIM_MIN_SLICE_NS               10000ULL
+#define COSIM_MAX_SLICE_NS               2000000ULL
+
+/* Frames on the line from one board, at most one is shifted out at a time but
+ * a delayed line (link-delay) holds all the frames sent during its delay */
+#define COSIM_LINE_FRAMES                2048
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	uint64 end_ns;
+	uint8 data;
+	BOARD_UartFormatType format;   /* Transmitter format */
+}COSIM_FrameType;
+
+typedef struct
+{
+	COSIM_FrameType frames[COSIM_LINE_FRAMES];
+	uint16 head;
+	uint16 count;
+	uint32 sent;               /* Frames started by the transmitter */
+	uint32 received;           /* Frames queued in the receiver */
+	uint32 overruns;           /* Frames lost in the receiver (FIFO full or receiver off) */
+}COSIM_LineType;
+
+typedef struct
+{
+	const BOARD_Type *boards[COSIM_BOARDS_NUM];
+	COSIM_LineType lines[COSIM_BOARDS_NUM];    /* Line driven by each board (its TXD) */
+	UartCable_Type cable;
+	uint64 now_ns;
+	uint64 delay_ns;           /* Time each frame takes to cross the cable after its end (radio bridge) */
+	uint32 late_frames;        /* Frames delivered after their end (format changed within a slice) */
+	boolean stopped;           /* A firmware main function returned */
+}COSIM_Type;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Connect the two boards with the cable and power them on.
+ */
+void COSIM_init(COSIM_Type *cosim, const BOARD_Type *hmi, const BOARD_Type *control, const UartCable_ConfigType *cable);
+
+/*
+ * Description :
+ * Run both boards until the given time.
+ * Returns FALSE if a firmware main function returned.
+ */
+boolean COSIM_runUntil(COSIM_Type *cosim, uint64 ns);
+
+#endif /* COSIM_H_ */
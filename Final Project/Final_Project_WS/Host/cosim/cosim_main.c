@@ -0,0 +1,96 @@
+ /******************************************************************************
+ *
+ * Module: Co-Simulation
+ *
+ * File Name: cosim_main.c
+ *
+ * Description: Runs a scenario on HMI ECU and Control ECU connected by the
+ *              simulated UART cable. Each ECU is a shared object with its own
+ *              host MCU (build/libhmi.so, build/libcontrol.so), loaded privately
+ *              so the two firmwares keep their own globals
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "cosim.h"
+#include "scenario.h"
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define COSIM_DEFAULT_HMI                "build/libhmi.so"
+#define COSIM_DEFAULT_CONTROL            "build/libcontrol.so"
+#define COSIM_DEFAULT_SEED               1
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Load the board of an ECU shared object
+ */
+static const BOARD_Type *cosimLoadBoard(const char *path)
+{
+	const BOARD_Type *(*get)(void);
+	void *handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+	if(handle == NULL)
+	{
+		fprintf(stderr, "%s\n", dlerror());
+		exit(EXIT_FAILURE);
+	}
+	*(void **)&get = dlsym(handle, BOARD_GET_SYMBOL);
+	if(get == NULL)
+	{
+		fprintf(stderr, "%s: no %s\n", path, BOARD_GET_SYMBOL);
+		exit(EXIT_FAILURE);
+	}
+	return get();
+}
+
+int main(int argc, char **argv)
+{
+	static COSIM_Type cosim;
+	UartCable_ConfigType cable = {0, COSIM_DEFAULT_SEED};
+	const char *hmi = COSIM_DEFAULT_HMI;
+	const char *control = COSIM_DEFAULT_CONTROL;
+	boolean verbose = FALSE;
+	int option;
+	while((option = getopt(argc, argv, "b:s:vH:C:")) != -1)
+	{
+		switch(option)
+		{
+		case 'b':
+			cable.bit_error_ppm = (uint32)strtoul(optarg, NULL, 10);
+			break;
+		case 's':
+			cable.seed = (uint32)strtoul(optarg, NULL, 10);
+			break;
+		case 'v':
+			verbose = TRUE;
+			break;
+		case 'H':
+			hmi = optarg;
+			break;
+		case 'C':
+			control = optarg;
+			break;
+		default:
+			optind = argc + 1;
+			break;
+		}
+	}
+	if(optind != argc - 1)
+	{
+		fprintf(stderr, "usage: %s [-v] [-b bit errors ppm] [-s seed] [-H hmi.so] [-C control.so] scenario\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	COSIM_init(&cosim, cosimLoadBoard(hmi), cosimLoadBoard(control), &cable);
+	return SCENARIO_run(argv[optind], &cosim, verbose) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,610 @@
+ /******************************************************************************
+ *
+ * Module: Scenario
+ *
+ * File Name: scenario.c
+ *
+ * Description: Source file for the scripted scenarios of the co-simulation
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "scenario.h"
+#include "communication_commands.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	char name[SCENARIO_MAX_NAME];
+	uint64 start_ns;
+	uint64 end_ns;
+	uint64 input_ns;           /* Last key, jam or command of the step */
+	uint64 met_ns;             /* Last expectation met */
+	uint32 sent[COSIM_BOARDS_NUM];
+	boolean passed;
+}SCENARIO_StepType;
+
+typedef struct
+{
+	COSIM_Type *cosim;
+	boolean verbose;
+	uint32 key_hold_ms;
+	uint32 key_gap_ms;
+	uint64 release_ns;         /* Release of the key held, 0 if none */
+	uint64 next_key_ns;        /* Earliest press of the next key */
+	SCENARIO_StepType steps[SCENARIO_MAX_STEPS];
+	uint8 steps_count;
+	const char *path;
+	uint32 line;
+}SCENARIO_Type;
+
+/* Condition of an expectation, checked every SCENARIO_POLL_NS */
+typedef boolean (*SCENARIO_Condition)(SCENARIO_Type *scenario, const void *argument);
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Instrumented ISRs, in the order of their ISRLAT_xxx numbers */
+static const char *const g_isrNames[ISRLAT_VECTORS_NUM] = { "TIMER1_OVF", "TIMER2_COMP", "USART_RXC" };
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Current time of the co-simulation in ms
+ */
+static double SCENARIO_nowMs(SCENARIO_Type *scenario)
+{
+	return scenario->cosim->now_ns / 1e6;
+}
+
+/*
+ * Description :
+ * Print an error of the scenario file or of the run, with its line
+ */
+static boolean SCENARIO_error(SCENARIO_Type *scenario, const char *message)
+{
+	const BOARD_Type *hmi = scenario->cosim->boards[COSIM_HMI];
+	const BOARD_Type *control = scenario->cosim->boards[COSIM_CONTROL];
+	printf("%s:%u: %s (at %.3f ms)\n", scenario->path, scenario->line, message, SCENARIO_nowMs(scenario));
+	printf("  lcd |%s|%s| door %u%%, motor %d, buzzer %s\n", hmi->getDisplayLine(0), hmi->getDisplayLine(1),
+			control->getDoorPercent(), control->getMotorDirection(), control->isBuzzerOn() ? "on" : "off");
+	return FALSE;
+}
+
+/*
+ * Description :
+ * Run the co-simulation for the given time, the key held is released on time
+ */
+static boolean SCENARIO_runFor(SCENARIO_Type *scenario, uint64 ns)
+{
+	uint64 end_ns = scenario->cosim->now_ns + ns;
+	if(scenario->release_ns != 0 && scenario->release_ns <= end_ns)
+	{
+		if(!COSIM_runUntil(scenario->cosim, scenario->release_ns))
+		{
+			return SCENARIO_error(scenario, "a firmware main function returned");
+		}
+		scenario->cosim->boards[COSIM_HMI]->releaseKey();
+		scenario->release_ns = 0;
+	}
+	if(!COSIM_runUntil(scenario->cosim, end_ns))
+	{
+		return SCENARIO_error(scenario, "a firmware main function returned");
+	}
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Step the commands are reported in
+ */
+static SCENARIO_StepType *SCENARIO_currentStep(SCENARIO_Type *scenario)
+{
+	return &scenario->steps[scenario->steps_count - 1];
+}
+
+/*
+ * Description :
+ * End the current step: its time and the frames sent during it
+ */
+static void SCENARIO_endStep(SCENARIO_Type *scenario, boolean passed)
+{
+	SCENARIO_StepType *step = SCENARIO_currentStep(scenario);
+	uint8 id;
+	step->end_ns = scenario->cosim->now_ns;
+	for(id = 0; id < COSIM_BOARDS_NUM; id++)
+	{
+		step->sent[id] = scenario->cosim->lines[id].sent - step->sent[id];
+	}
+	step->passed = passed;
+}
+
+/*
+ * Description :
+ * End the current step and start a new one
+ */
+static boolean SCENARIO_startStep(SCENARIO_Type *scenario, const char *name)
+{
+	SCENARIO_StepType *step;
+	uint8 id;
+	if(scenario->steps_count != 0)
+	{
+		SCENARIO_endStep(scenario, TRUE);
+	}
+	if(scenario->steps_count == SCENARIO_MAX_STEPS)
+	{
+		return SCENARIO_error(scenario, "too many steps");
+	}
+	step = &scenario->steps[scenario->steps_count++];
+	strncpy(step->name, name, SCENARIO_MAX_NAME - 1);
+	step->name[SCENARIO_MAX_NAME - 1] = '\0';
+	step->start_ns = scenario->cosim->now_ns;
+	step->end_ns = step->start_ns;
+	step->input_ns = step->start_ns;
+	step->met_ns = step->start_ns;
+	for(id = 0; id < COSIM_BOARDS_NUM; id++)
+	{
+		step->sent[id] = scenario->cosim->lines[id].sent;
+	}
+	step->passed = FALSE;
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Type keys on the HMI keypad: returns once the last one is pressed,
+ * it is released while the next commands run
+ */
+static boolean SCENARIO_keys(SCENARIO_Type *scenario, const char *keys)
+{
+	for(; *keys != '\0'; keys++)
+	{
+		if(scenario->release_ns != 0 && !SCENARIO_runFor(scenario, scenario->release_ns - scenario->cosim->now_ns))
+		{
+			return FALSE;
+		}
+		if(scenario->cosim->now_ns < scenario->next_key_ns
+				&& !SCENARIO_runFor(scenario, scenario->next_key_ns - scenario->cosim->now_ns))
+		{
+			return FALSE;
+		}
+		if(!scenario->cosim->boards[COSIM_HMI]->pressKey((*keys == 'c') ? '\r' : *keys))
+		{
+			return SCENARIO_error(scenario, "no such key on the keypad");
+		}
+		SCENARIO_currentStep(scenario)->input_ns = scenario->cosim->now_ns;
+		scenario->release_ns = scenario->cosim->now_ns + scenario->key_hold_ms * 1000000ULL;
+		scenario->next_key_ns = scenario->release_ns + scenario->key_gap_ms * 1000000ULL;
+	}
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Run until the condition is met or the timeout
+ */
+static boolean SCENARIO_expect(SCENARIO_Type *scenario, SCENARIO_Condition condition, const void *argument,
+		uint32 timeout_ms, const char *text)
+{
+	SCENARIO_StepType *step = SCENARIO_currentStep(scenario);
+	uint64 deadline = scenario->cosim->now_ns + timeout_ms * 1000000ULL;
+	char message[SCENARIO_MAX_LINE + 32];
+	while(!condition(scenario, argument))
+	{
+		if(scenario->cosim->now_ns >= deadline)
+		{
+			snprintf(message, sizeof(message), "timeout: %s", text);
+			return SCENARIO_error(scenario, message);
+		}
+		if(!SCENARIO_runFor(scenario, SCENARIO_POLL_NS))
+		{
+			return FALSE;
+		}
+	}
+	step->met_ns = scenario->cosim->now_ns;
+	if(scenario->verbose)
+	{
+		printf("%10.3f ms  %-40s +%.3f ms\n", SCENARIO_nowMs(scenario), text, (step->met_ns - step->input_ns) / 1e6);
+	}
+	return TRUE;
+}
+
+static boolean SCENARIO_lcdShows(SCENARIO_Type *scenario, const void *argument)
+{
+	const char *text = argument;
+	/* The row is the first character, then the text */
+	return strstr(scenario->cosim->boards[COSIM_HMI]->getDisplayLine((uint8)(text[0] - '0')), &text[1]) != NULL;
+}
+
+static boolean SCENARIO_motorIs(SCENARIO_Type *scenario, const void *argument)
+{
+	return scenario->cosim->boards[COSIM_CONTROL]->getMotorDirection() == *(const sint8 *)argument;
+}
+
+static boolean SCENARIO_doorAt(SCENARIO_Type *scenario, const void *argument)
+{
+	return scenario->cosim->boards[COSIM_CONTROL]->getDoorPercent() == *(const uint8 *)argument;
+}
+
+static boolean SCENARIO_buzzerIs(SCENARIO_Type *scenario, const void *argument)
+{
+	return scenario->cosim->boards[COSIM_CONTROL]->isBuzzerOn() == *(const boolean *)argument;
+}
+
+/*
+ * Description :
+ * Read the optional timeout after the arguments of an expectation
+ */
+static uint32 SCENARIO_timeout(const char *text)
+{
+	return (text != NULL && *text != '\0') ? (uint32)strtoul(text, NULL, 10) : SCENARIO_DEFAULT_TIMEOUT_MS;
+}
+
+/*
+ * Description :
+ * Read the numbers of the arguments (decimal, or hex with 0x).
+ * Returns their count, or 0 if there are more than the given count or one is not a number.
+ */
+static uint8 SCENARIO_numbers(const char *text, uint32 *values, uint8 count)
+{
+	uint8 read = 0;
+	char *end;
+	text += strspn(text, " \t");
+	while(*text != '\0')
+	{
+		if(read == count)
+		{
+			return 0;
+		}
+		values[read] = (uint32)strtoul(text, &end, 0);
+		if(end == text || (*end != '\0' && *end != ' ' && *end != '\t'))
+		{
+			return 0;
+		}
+		read++;
+		text = end + strspn(end, " \t");
+	}
+	return read;
+}
+
+/*
+ * Description :
+ * Send SET_CONFIG from the HMI with the given fields, in the order of the link layout
+ */
+static boolean SCENARIO_setConfig(SCENARIO_Type *scenario, const char *argument)
+{
+	uint32 fields[SCENARIO_CONFIG_FIELDS];
+	uint8 bytes[1 + CONFIG_SIZE];
+	uint8 *config = &bytes[1];
+	if(SCENARIO_numbers(argument, fields, SCENARIO_CONFIG_FIELDS) != SCENARIO_CONFIG_FIELDS)
+	{
+		return SCENARIO_error(scenario, "set-config <version> <motion ms> <ramp ms> <hold ms> <alarm ms> "
+				"<speed %> <free attempts> <lockout s>");
+	}
+	bytes[0] = SET_CONFIG;
+	config[CONFIG_VERSION_OFFSET] = (uint8)fields[0];
+	config[CONFIG_MOTION_TIME_OFFSET] = (uint8)(fields[1] >> 8);
+	config[CONFIG_MOTION_TIME_OFFSET + 1] = (uint8)fields[1];
+	config[CONFIG_RAMP_TIME_OFFSET] = (uint8)(fields[2] >> 8);
+	config[CONFIG_RAMP_TIME_OFFSET + 1] = (uint8)fields[2];
+	config[CONFIG_HOLD_TIME_OFFSET] = (uint8)(fields[3] >> 8);
+	config[CONFIG_HOLD_TIME_OFFSET + 1] = (uint8)fields[3];
+	config[CONFIG_ALARM_TIME_OFFSET] = (uint8)(fields[4] >> 8);
+	config[CONFIG_ALARM_TIME_OFFSET + 1] = (uint8)fields[4];
+	config[CONFIG_MOTOR_SPEED_OFFSET] = (uint8)fields[5];
+	config[CONFIG_FREE_ATTEMPTS_OFFSET] = (uint8)fields[6];
+	config[CONFIG_LOCKOUT_TIME_OFFSET] = (uint8)(fields[7] >> 8);
+	config[CONFIG_LOCKOUT_TIME_OFFSET + 1] = (uint8)fields[7];
+	if(!scenario->cosim->boards[COSIM_HMI]->sendCommand(bytes, sizeof(bytes)))
+	{
+		return SCENARIO_error(scenario, "the last command of the HMI board is not sent yet");
+	}
+	SCENARIO_currentStep(scenario)->input_ns = scenario->cosim->now_ns;
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Send SET_TIME from the HMI with the given Unix time
+ */
+static boolean SCENARIO_setTime(SCENARIO_Type *scenario, const char *argument)
+{
+	uint32 now;
+	uint8 bytes[5];
+	if(SCENARIO_numbers(argument, &now, 1) != 1)
+	{
+		return SCENARIO_error(scenario, "set-time <unix seconds>");
+	}
+	bytes[0] = SET_TIME;
+	bytes[1] = (uint8)(now >> 24);
+	bytes[2] = (uint8)(now >> 16);
+	bytes[3] = (uint8)(now >> 8);
+	bytes[4] = (uint8)now;
+	if(!scenario->cosim->boards[COSIM_HMI]->sendCommand(bytes, sizeof(bytes)))
+	{
+		return SCENARIO_error(scenario, "the last command of the HMI board is not sent yet");
+	}
+	SCENARIO_currentStep(scenario)->input_ns = scenario->cosim->now_ns;
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Write bytes in the Control ECU EEPROM, before the first run it is the power-on content
+ */
+static boolean SCENARIO_writeEeprom(SCENARIO_Type *scenario, const char *argument)
+{
+	uint32 values[1 + SCENARIO_MAX_EEPROM_BYTES];
+	uint8 bytes[SCENARIO_MAX_EEPROM_BYTES];
+	uint8 count = SCENARIO_numbers(argument, values, 1 + SCENARIO_MAX_EEPROM_BYTES);
+	uint8 i;
+	if(count < 2)
+	{
+		return SCENARIO_error(scenario, "eeprom <address> <byte>...");
+	}
+	for(i = 1; i < count; i++)
+	{
+		bytes[i - 1] = (uint8)values[i];
+	}
+	scenario->cosim->boards[COSIM_CONTROL]->writeEeprom((uint16)values[0], bytes, count - 1);
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Print the latency histogram of the instrumented ISRs of every board built with ISR_LATENCY
+ */
+static void SCENARIO_printLatency(SCENARIO_Type *scenario)
+{
+	const BOARD_Type *board;
+	const ISRLAT_StatsType *stats;
+	uint8 id;
+	uint8 vector;
+	uint8 bucket;
+	boolean printed = FALSE;
+
+	for(id = 0; id < COSIM_BOARDS_NUM; id++)
+	{
+		board = scenario->cosim->boards[id];
+		if(board->getIsrLatency == NULL)
+		{
+			continue;
+		}
+		printf("%10.3f ms  ISR latency of %s (us)\n", SCENARIO_nowMs(scenario), board->name);
+		printf("  %-12s %6s %7s %5s %5s |%6s%6s%6s%6s%6s%6s%6s%6s\n", "vector", "count", "resyncs", "min", "max",
+				"<4", "<8", "<16", "<32", "<64", "<128", "<256", ">=256");
+		for(vector = 0; vector < ISRLAT_VECTORS_NUM; vector++)
+		{
+			stats = board->getIsrLatency(vector);
+			printf("  %-12s %6u %7u %5u %5u |", g_isrNames[vector], stats->count, stats->resyncs,
+					(stats->count != 0) ? stats->min : 0, stats->max);
+			for(bucket = 0; bucket < ISRLAT_BUCKETS_NUM; bucket++)
+			{
+				printf("%6u", stats->buckets[bucket]);
+			}
+			printf("\n");
+		}
+		printed = TRUE;
+	}
+	if(!printed)
+	{
+		printf("%10.3f ms  print-latency: built without ISR_LATENCY (make clean all ISR_LATENCY=1)\n",
+				SCENARIO_nowMs(scenario));
+	}
+}
+
+/*
+ * Description :
+ * Run one command line of the scenario
+ */
+static boolean SCENARIO_command(SCENARIO_Type *scenario, char *line)
+{
+	char *command = strtok(line, " \t");
+	char *argument = strtok(NULL, "");
+	char *word;
+	char text[SCENARIO_MAX_LINE];
+	char message[SCENARIO_MAX_LINE + 16];
+	char *end;
+	sint8 direction;
+	uint8 percent;
+	boolean on;
+
+	if(command == NULL || command[0] == '#')
+	{
+		return TRUE;
+	}
+	if(argument == NULL)
+	{
+		argument = "";
+	}
+	argument += strspn(argument, " \t");
+	if(strcmp(command, "step") == 0)
+	{
+		if(scenario->verbose)
+		{
+			printf("%10.3f ms  -- %s\n", SCENARIO_nowMs(scenario), argument);
+		}
+		return SCENARIO_startStep(scenario, argument);
+	}
+	if(scenario->steps_count == 0 && !SCENARIO_startStep(scenario, "(start)"))
+	{
+		return FALSE;
+	}
+	if(strcmp(command, "keys") == 0)
+	{
+		if(scenario->verbose)
+		{
+			printf("%10.3f ms  keys %s\n", SCENARIO_nowMs(scenario), argument);
+		}
+		return SCENARIO_keys(scenario, argument);
+	}
+	if(strcmp(command, "key-time") == 0)
+	{
+		scenario->key_hold_ms = (uint32)strtoul(argument, &end, 10);
+		scenario->key_gap_ms = (uint32)strtoul(end, NULL, 10);
+		return TRUE;
+	}
+	if(strcmp(command, "run") == 0)
+	{
+		return SCENARIO_runFor(scenario, strtoul(argument, NULL, 10) * 1000000ULL);
+	}
+	if(strcmp(command, "expect-lcd") == 0)
+	{
+		/* Row, then the quoted text */
+		text[0] = argument[0];
+		word = strchr(argument, '"');
+		end = (word != NULL) ? strchr(word + 1, '"') : NULL;
+		if(text[0] < '0' || text[0] > '1' || end == NULL || (size_t)(end - word) >= sizeof(text) - 1)
+		{
+			return SCENARIO_error(scenario, "expect-lcd <row> \"<text>\" [ms]");
+		}
+		memcpy(&text[1], word + 1, end - word - 1);
+		text[end - word] = '\0';
+		snprintf(message, sizeof(message), "expect-lcd %c \"%s\"", text[0], &text[1]);
+		return SCENARIO_expect(scenario, SCENARIO_lcdShows, text, SCENARIO_timeout(end + 1), message);
+	}
+	if(strcmp(command, "print-latency") == 0)
+	{
+		SCENARIO_printLatency(scenario);
+		return TRUE;
+	}
+	if(strcmp(command, "print-lcd") == 0)
+	{
+		printf("%10.3f ms  lcd |%s|\n", SCENARIO_nowMs(scenario),
+				scenario->cosim->boards[COSIM_HMI]->getDisplayLine(0));
+		printf("%10.3f ms  lcd |%s|\n", SCENARIO_nowMs(scenario),
+				scenario->cosim->boards[COSIM_HMI]->getDisplayLine(1));
+		return TRUE;
+	}
+	if(strcmp(command, "set-config") == 0)
+	{
+		return SCENARIO_setConfig(scenario, argument);
+	}
+	if(strcmp(command, "set-time") == 0)
+	{
+		return SCENARIO_setTime(scenario, argument);
+	}
+	if(strcmp(command, "eeprom") == 0)
+	{
+		return SCENARIO_writeEeprom(scenario, argument);
+	}
+	word = strtok(argument, " \t");
+	if(word == NULL)
+	{
+		return SCENARIO_error(scenario, "missing argument");
+	}
+	argument = strtok(NULL, " \t");
+	snprintf(message, sizeof(message), "%s %s", command, word);
+	if(strcmp(command, "expect-motor") == 0)
+	{
+		direction = (strcmp(word, "opening") == 0) ? 1 : ((strcmp(word, "closing") == 0) ? -1 : 0);
+		return SCENARIO_expect(scenario, SCENARIO_motorIs, &direction, SCENARIO_timeout(argument), message);
+	}
+	if(strcmp(command, "expect-door") == 0)
+	{
+		percent = (strcmp(word, "open") == 0) ? 100 : 0;
+		return SCENARIO_expect(scenario, SCENARIO_doorAt, &percent, SCENARIO_timeout(argument), message);
+	}
+	if(strcmp(command, "expect-buzzer") == 0)
+	{
+		on = (strcmp(word, "on") == 0);
+		return SCENARIO_expect(scenario, SCENARIO_buzzerIs, &on, SCENARIO_timeout(argument), message);
+	}
+	if(strcmp(command, "jam") == 0)
+	{
+		scenario->cosim->boards[COSIM_CONTROL]->jamDoor(strcmp(word, "on") == 0);
+		SCENARIO_currentStep(scenario)->input_ns = scenario->cosim->now_ns;
+		return TRUE;
+	}
+	if(strcmp(command, "bit-errors") == 0)
+	{
+		UartCable_setBitErrorRate(&scenario->cosim->cable, (uint32)strtoul(word, NULL, 10));
+		return TRUE;
+	}
+	if(strcmp(command, "link-delay") == 0)
+	{
+		scenario->cosim->delay_ns = (uint64)strtoul(word, NULL, 10) * 1000000ULL;
+		return TRUE;
+	}
+	return SCENARIO_error(scenario, "unknown command");
+}
+
+/*
+ * Description :
+ * Print the report of the steps
+ */
+static void SCENARIO_report(SCENARIO_Type *scenario)
+{
+	COSIM_Type *cosim = scenario->cosim;
+	SCENARIO_StepType *step;
+	uint8 index;
+	printf("\n%-32s %10s %10s %10s %8s %8s  %s\n", "step", "start ms", "duration", "latency", "HMI->CU", "CU->HMI", "result");
+	for(index = 0; index < scenario->steps_count; index++)
+	{
+		step = &scenario->steps[index];
+		printf("%-32s %10.1f %10.1f ", step->name, step->start_ns / 1e6, (step->end_ns - step->start_ns) / 1e6);
+		if(step->passed)
+		{
+			printf("%10.1f", (step->met_ns - step->input_ns) / 1e6);
+		}
+		else
+		{
+			printf("%10s", "-");
+		}
+		printf(" %8u %8u  %s\n", step->sent[COSIM_HMI], step->sent[COSIM_CONTROL], step->passed ? "pass" : "FAIL");
+	}
+	printf("\ncable: %u frames, %u flipped bits, %u lost, %u frame errors, %u parity errors, %u corrupted | "
+			"overruns: HMI %u, CU %u | late frames: %u | model violations: HMI %u, CU %u\n",
+			cosim->cable.frames, cosim->cable.flipped_bits, cosim->cable.lost_frames, cosim->cable.frame_errors,
+			cosim->cable.parity_errors, cosim->cable.corrupted_frames,
+			cosim->lines[COSIM_CONTROL].overruns, cosim->lines[COSIM_HMI].overruns, cosim->late_frames,
+			cosim->boards[COSIM_HMI]->getModelViolations(), cosim->boards[COSIM_CONTROL]->getModelViolations());
+}
+
+/*
+ * Description :
+ * Run the scenario file on the co-simulation and print the report of its steps,
+ * verbose prints every command with its time.
+ * Returns TRUE if every expectation was met.
+ */
+boolean SCENARIO_run(const char *path, COSIM_Type *cosim, boolean verbose)
+{
+	SCENARIO_Type scenario;
+	char line[SCENARIO_MAX_LINE];
+	boolean passed = TRUE;
+	FILE *file = fopen(path, "r");
+	if(file == NULL)
+	{
+		perror(path);
+		return FALSE;
+	}
+	memset(&scenario, 0, sizeof(scenario));
+	scenario.cosim = cosim;
+	scenario.verbose = verbose;
+	scenario.key_hold_ms = SCENARIO_KEY_HOLD_MS;
+	scenario.key_gap_ms = SCENARIO_KEY_GAP_MS;
+	scenario.path = path;
+	while(passed && fgets(line, sizeof(line), file) != NULL)
+	{
+		scenario.line++;
+		line[strcspn(line, "\r\n")] = '\0';
+		passed = SCENARIO_command(&scenario, line);
+	}
+	fclose(file);
+	if(scenario.steps_count != 0)
+	{
+		SCENARIO_endStep(&scenario, passed);
+	}
+	SCENARIO_report(&scenario);
+	return passed;
+}
@@ -0,0 +1,74 @@
+ /******************************************************************************
+ *
+ * Module: Scenario
+ *
+ * File Name: scenario.h
+ *
+ * Description: Header file for the scripted scenarios of the co-simulation:
+ *              keypad input, fault injection and expectations on the display,
+ *              the door and the buzzer, with the latency of every step
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef SCENARIO_H_
+#define SCENARIO_H_
+
+#include "cosim.h"
+
+/*
+ * A scenario is a text file, one command per line ('#' starts a comment):
+ *
+ *   step <name>                        start a new step of the report
+ *   keys <keys>                        type keys on the keypad ('c' is ON/C)
+ *   key-time <hold ms> <gap ms>        how long each key is held, then released
+ *   run <ms>                           let the ECUs run
+ *   expect-lcd <row> "<text>" [ms]     wait until the LCD row shows the text
+ *   expect-motor opening|closing|stopped [ms]
+ *   expect-door open|closed [ms]       wait for the door limit position
+ *   expect-buzzer on|off [ms]
+ *   print-lcd                          print both LCD rows (values read by a scenario)
+ *   print-latency                      print the ISR latency histograms (ISR_LATENCY builds)
+ *   jam on|off                         block the door (obstacle) or free it
+ *   bit-errors <ppm>                   bit error rate of the cable
+ *   link-delay <ms>                    extra time each new frame takes to cross the cable
+ *   set-config <version> <motion ms> <ramp ms> <hold ms> <alarm ms> <speed %> <free attempts> <lockout s>
+ *                                      send SET_CONFIG from the HMI (the link layout fields)
+ *   set-time <unix seconds>            send SET_TIME from the HMI, as the provisioning tool
+ *                                      does: Control ECU checks the one-time codes with it
+ *   eeprom <address> <byte>...         write the Control ECU EEPROM, before the first run
+ *                                      it is the content found at power on
+ *
+ * An expectation fails after its timeout (SCENARIO_DEFAULT_TIMEOUT_MS if not given)
+ * and ends the scenario. The latency of a step is the time from its last input
+ * (key, jam or command) to its last expectation met, the duration is its whole time.
+ */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SCENARIO_DEFAULT_TIMEOUT_MS      5000
+#define SCENARIO_KEY_HOLD_MS             60
+#define SCENARIO_KEY_GAP_MS              60
+#define SCENARIO_POLL_NS                 1000000ULL    /* Expectations are checked every 1 ms */
+#define SCENARIO_MAX_STEPS               32
+#define SCENARIO_MAX_LINE                160
+#define SCENARIO_MAX_NAME                40
+#define SCENARIO_CONFIG_FIELDS           8
+#define SCENARIO_MAX_EEPROM_BYTES        32
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Run the scenario file on the co-simulation and print the report of its steps,
+ * verbose prints every command with its time.
+ * Returns TRUE if every expectation was met.
+ */
+boolean SCENARIO_run(const char *path, COSIM_Type *cosim, boolean verbose);
+
+#endif /* SCENARIO_H_ */
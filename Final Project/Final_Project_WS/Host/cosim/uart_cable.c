@@ -0,0 +1,185 @@
+ /******************************************************************************
+ *
+ * Module: UART Cable
+ *
+ * File Name: uart_cable.c
+ *
+ * Description: Source file for the simulated UART cable of the co-simulation
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "uart_cable.h"
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Function responsible for the next pseudo random number (xorshift32)
+ */
+static uint32 UartCable_random(UartCable_Type *cable);
+
+/*
+ * Function responsible for building the line bits of a frame, returns their number
+ */
+static uint8 UartCable_frameBits(const BOARD_UartFormatType *format, uint8 data, uint8 *bits);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Setup the cable with its bit error rate, counters cleared.
+ */
+void UartCable_init(UartCable_Type *cable, const UartCable_ConfigType *config)
+{
+	cable->config = *config;
+	cable->random = (config->seed != 0) ? config->seed : 1;
+	cable->frames = 0;
+	cable->flipped_bits = 0;
+	cable->lost_frames = 0;
+	cable->frame_errors = 0;
+	cable->parity_errors = 0;
+	cable->corrupted_frames = 0;
+}
+
+/*
+ * Description :
+ * Change the bit error rate, the random sequence goes on.
+ */
+void UartCable_setBitErrorRate(UartCable_Type *cable, uint32 bit_error_ppm)
+{
+	cable->config.bit_error_ppm = bit_error_ppm;
+}
+
+/*
+ * Description :
+ * Time of a whole frame on the line.
+ */
+uint64 UartCable_frameNs(const BOARD_UartFormatType *format)
+{
+	uint8 bits = 1 + format->data_bits + ((format->parity != BOARD_PARITY_NONE) ? 1 : 0) + format->stop_bits;
+	return (uint64)format->bit_ns * bits;
+}
+
+/*
+ * Description :
+ * Carry one frame from the transmitter to the receiver: the data and the FE/PE
+ * status as the receiver sees them. Returns FALSE if the frame is lost.
+ * The receiver synchronizes on the falling edge of the start bit and samples
+ * each of its bits in the middle, with its own bit time: a baud rate mismatch
+ * slides the samples over the transmitter bits, the line is idle (high) after the frame.
+ */
+boolean UartCable_transfer(UartCable_Type *cable, const BOARD_UartFormatType *tx, const BOARD_UartFormatType *rx,
+		uint8 data, uint8 *received, uint8 *status)
+{
+	uint8 line[UART_CABLE_MAX_FRAME_BITS];
+	uint8 count = UartCable_frameBits(tx, data, line);
+	uint8 index;
+	uint8 bit;
+	uint8 sampled[UART_CABLE_MAX_FRAME_BITS];
+	uint8 ones = 0;
+	uint8 value = 0;
+	uint64 sample_ns;
+
+	cable->frames++;
+	for(index = 0; index < count; index++)
+	{
+		if(cable->config.bit_error_ppm != 0 && (UartCable_random(cable) % 1000000UL) < cable->config.bit_error_ppm)
+		{
+			line[index] ^= 1;
+			cable->flipped_bits++;
+		}
+	}
+	if(line[0] != 0)
+	{
+		/* The receiver sees no start bit, it waits for the next falling edge */
+		cable->lost_frames++;
+		return FALSE;
+	}
+
+	/* Start bit, data bits, parity bit and the first stop bit (the only one checked) */
+	for(index = 0; index < 1 + rx->data_bits + ((rx->parity != BOARD_PARITY_NONE) ? 1 : 0) + 1; index++)
+	{
+		sample_ns = (uint64)rx->bit_ns * index + rx->bit_ns / 2;
+		bit = (uint8)(sample_ns / tx->bit_ns);
+		sampled[index] = (bit < count) ? line[bit] : 1;
+	}
+	for(index = 0; index < rx->data_bits && index < 8; index++)
+	{
+		value |= (uint8)(sampled[1 + index] << index);
+	}
+	for(index = 0; index < rx->data_bits; index++)
+	{
+		ones += sampled[1 + index];
+	}
+
+	*status = 0;
+	if(rx->parity != BOARD_PARITY_NONE)
+	{
+		/* Even parity: data and parity bits hold an even number of ones, odd parity the opposite */
+		ones += sampled[1 + rx->data_bits];
+		if((ones & 1) != ((rx->parity == BOARD_PARITY_ODD) ? 1 : 0))
+		{
+			*status |= BOARD_UART_PARITY_ERROR;
+			cable->parity_errors++;
+		}
+	}
+	if(sampled[1 + rx->data_bits + ((rx->parity != BOARD_PARITY_NONE) ? 1 : 0)] == 0)
+	{
+		*status |= BOARD_UART_FRAME_ERROR;
+		cable->frame_errors++;
+	}
+	if(*status == 0 && value != data)
+	{
+		cable->corrupted_frames++;
+	}
+	*received = value;
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Next pseudo random number (xorshift32)
+ */
+static uint32 UartCable_random(UartCable_Type *cable)
+{
+	uint32 x = cable->random;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	cable->random = x;
+	return x;
+}
+
+/*
+ * Description :
+ * Line bits of a frame, returns their number
+ */
+static uint8 UartCable_frameBits(const BOARD_UartFormatType *format, uint8 data, uint8 *bits)
+{
+	uint8 count = 0;
+	uint8 index;
+	uint8 ones = 0;
+	bits[count++] = 0;
+	/* Start bit */
+	for(index = 0; index < format->data_bits; index++)
+	{
+		bits[count] = (index < 8) ? ((data >> index) & 1) : 0;
+		ones += bits[count];
+		count++;
+	}
+	/* Data bits, LSB first */
+	if(format->parity != BOARD_PARITY_NONE)
+	{
+		bits[count++] = (ones & 1) ^ ((format->parity == BOARD_PARITY_ODD) ? 1 : 0);
+	}
+	for(index = 0; index < format->stop_bits; index++)
+	{
+		bits[count++] = 1;
+	}
+	return count;
+}
@@ -0,0 +1,79 @@
+ /******************************************************************************
+ *
+ * Module: UART Cable
+ *
+ * File Name: uart_cable.h
+ *
+ * Description: Header file for the simulated UART cable of the co-simulation:
+ *              a frame is rebuilt bit by bit on the line, bits are flipped at
+ *              the configured error rate, and it is sampled again with the
+ *              receiver baud rate and format
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef UART_CABLE_H_
+#define UART_CABLE_H_
+
+#include "board.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Longest frame: start bit, 9 data bits, parity and 2 stop bits (the 9th data bit is not carried) */
+#define UART_CABLE_MAX_FRAME_BITS        13
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	uint32 bit_error_ppm;      /* Probability of each line bit to be flipped, in parts per million */
+	uint32 seed;               /* Seed of the bit errors, the same seed gives the same errors */
+}UartCable_ConfigType;
+
+typedef struct
+{
+	UartCable_ConfigType config;
+	uint32 random;
+	uint32 frames;             /* Frames put on the line */
+	uint32 flipped_bits;
+	uint32 lost_frames;        /* No start bit seen by the receiver */
+	uint32 frame_errors;       /* Stop bit sampled low */
+	uint32 parity_errors;
+	uint32 corrupted_frames;   /* Received without any error flag but with other data */
+}UartCable_Type;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Setup the cable with its bit error rate, counters cleared.
+ */
+void UartCable_init(UartCable_Type *cable, const UartCable_ConfigType *config);
+
+/*
+ * Description :
+ * Change the bit error rate, the random sequence goes on.
+ */
+void UartCable_setBitErrorRate(UartCable_Type *cable, uint32 bit_error_ppm);
+
+/*
+ * Description :
+ * Time of a whole frame on the line.
+ */
+uint64 UartCable_frameNs(const BOARD_UartFormatType *format);
+
+/*
+ * Description :
+ * Carry one frame from the transmitter to the receiver: the data and the FE/PE
+ * status as the receiver sees them. Returns FALSE if the frame is lost.
+ */
+boolean UartCable_transfer(UartCable_Type *cable, const BOARD_UartFormatType *tx, const BOARD_UartFormatType *rx,
+		uint8 data, uint8 *received, uint8 *status);
+
+#endif /* UART_CABLE_H_ */
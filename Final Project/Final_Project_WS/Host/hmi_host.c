@@ -0,0 +1,118 @@
+ /******************************************************************************
+ *
+ * Module: HMI Host
+ *
+ * File Name: hmi_host.c
+ *
+ * Description: Runs the HMI ECU firmware on the host board, types the keys
+ *              given on the command line and prints every change of the display
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "board.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define HMI_HOST_DEFAULT_MS              3000
+#define HMI_HOST_STEP_MS                 10
+#define HMI_HOST_KEY_GAP_MS              250   /* Time before each key press */
+#define HMI_HOST_KEY_HOLD_MS             100
+
+#define HMI_HOST_ROWS                    2
+#define HMI_HOST_COLS                    16
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static const BOARD_Type *g_board;
+static char g_shownLines[HMI_HOST_ROWS][HMI_HOST_COLS + 1];
+static uint32 g_txBytes = 0;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * The link bytes to Control ECU, only counted: there is no Control ECU here
+ */
+static void hmiHostTx(void *context, uint8 data, uint64 endNs)
+{
+	(void)context;
+	(void)data;
+	(void)endNs;
+	g_txBytes++;
+}
+
+/*
+ * Description :
+ * Run the firmware for the given time, printing the display when it changes
+ */
+static void hmiHostRun(uint32 ms)
+{
+	uint8 row;
+	uint32 elapsed;
+	boolean changed;
+	for(elapsed = 0; elapsed < ms; elapsed += HMI_HOST_STEP_MS)
+	{
+		if(!g_board->runUntilNs(g_board->getTimeNs() + HMI_HOST_STEP_MS * 1000000ULL))
+		{
+			printf("firmware returned\n");
+			exit(EXIT_FAILURE);
+		}
+		changed = FALSE;
+		for(row = 0; row < HMI_HOST_ROWS; row++)
+		{
+			if(strcmp(g_shownLines[row], g_board->getDisplayLine(row)) != 0)
+			{
+				strcpy(g_shownLines[row], g_board->getDisplayLine(row));
+				changed = TRUE;
+			}
+		}
+		if(changed)
+		{
+			printf("%8.3f ms |%s|%s|\n", g_board->getTimeNs() / 1e6, g_shownLines[0], g_shownLines[1]);
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const char *keys = (argc > 1) ? argv[1] : "";
+	uint32 run_ms = (argc > 2) ? (uint32)strtoul(argv[2], NULL, 10) : HMI_HOST_DEFAULT_MS;
+	if(argc > 3 || (argc > 1 && strcmp(argv[1], "-h") == 0))
+	{
+		fprintf(stderr, "usage: %s [keys] [ms]\n"
+				"  types the keys (0-9 %%*-+=, 'c' for ON/C) then runs for ms (default %u)\n",
+				argv[0], HMI_HOST_DEFAULT_MS);
+		return EXIT_FAILURE;
+	}
+	g_board = BOARD_get();
+	g_board->setUartTx(hmiHostTx, NULL);
+	g_board->start();
+
+	for(; *keys != '\0'; keys++)
+	{
+		hmiHostRun(HMI_HOST_KEY_GAP_MS);
+		if(!g_board->pressKey((*keys == 'c') ? '\r' : *keys))
+		{
+			fprintf(stderr, "no key '%c' on the keypad\n", *keys);
+			return EXIT_FAILURE;
+		}
+		printf("%8.3f ms key '%c'\n", g_board->getTimeNs() / 1e6, *keys);
+		hmiHostRun(HMI_HOST_KEY_HOLD_MS);
+		g_board->releaseKey();
+	}
+	hmiHostRun(run_ms);
+
+	printf("model violations: %u | link: %u bytes sent\n", g_board->getModelViolations(), g_txBytes);
+	return EXIT_SUCCESS;
+}
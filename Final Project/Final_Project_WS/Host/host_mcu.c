@@ -0,0 +1,1818 @@
+ /******************************************************************************
+ *
+ * Module: Host MCU
+ *
+ * File Name: host_mcu.c
+ *
+ * Description: Source file for the host build MCU: a fake ATmega32 register layer
+ *              with its peripherals (ports, timers, USART, TWI, ADC, INT0/INT1)
+ *              run by a virtual clock, and the hooks of the device models
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "host_mcu.h"
+#include "common_macros.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/eeprom.h>
+#include <util/delay.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+
+#if ((F_CPU) % 1000000UL) != 0
+#error "The host MCU runs at a whole number of MHz"
+#endif
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define HOST_MHZ                   ((F_CPU) / 1000000UL)
+
+/* Data memory addresses of the registers with a behavior */
+#define ADDR_TWBR                  0x20
+#define ADDR_TWSR                  0x21
+#define ADDR_TWDR                  0x23
+#define ADDR_ADCL                  0x24
+#define ADDR_ADCH                  0x25
+#define ADDR_ADCSRA                0x26
+#define ADDR_ADMUX                 0x27
+#define ADDR_UBRRL                 0x29
+#define ADDR_UCSRB                 0x2A
+#define ADDR_UCSRA                 0x2B
+#define ADDR_UDR                   0x2C
+#define ADDR_PIND                  0x30
+#define ADDR_PINA                  0x39
+#define ADDR_UBRRH                 0x40
+#define ADDR_OCR2                  0x43
+#define ADDR_TCNT2                 0x44
+#define ADDR_TCCR2                 0x45
+#define ADDR_ICR1                  0x46
+#define ADDR_OCR1B                 0x48
+#define ADDR_OCR1A                 0x4A
+#define ADDR_TCNT1                 0x4C
+#define ADDR_TCCR1B                0x4E
+#define ADDR_TCCR1A                0x4F
+#define ADDR_SFIOR                 0x50
+#define ADDR_TCNT0                 0x52
+#define ADDR_TCCR0                 0x53
+#define ADDR_MCUCR                 0x55
+#define ADDR_TWCR                  0x56
+#define ADDR_TIFR                  0x58
+#define ADDR_TIMSK                 0x59
+#define ADDR_GIFR                  0x5A
+#define ADDR_GICR                  0x5B
+#define ADDR_OCR0                  0x5C
+#define ADDR_SREG                  0x5F
+#define ADDR_UCSRC                 HOST_UCSRC_ADDRESS
+#define ADDR_FIRST                 0x20
+#define REGISTERS_SIZE             (HOST_UCSRC_ADDRESS + 2)
+
+/* Port registers: PINx, DDRx = PINx + 1, PORTx = PINx + 2 */
+#define ADDR_PIN(port)             (ADDR_PINA - (3 * (port)))
+#define ADDR_DDR(port)             (ADDR_PIN(port) + 1)
+#define ADDR_PORT(port)            (ADDR_PIN(port) + 2)
+
+/* TWCR bit 1 is reserved (reads 0 on the chip): set in the value read, a full write clears it */
+#define TWCR_MARKER                0x02
+#define TWCR_STORED_BITS           ((1 << TWEA) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE))
+
+/* TWI status codes (TWSR & 0xF8) */
+#define TWI_STATUS_START           0x08
+#define TWI_STATUS_REP_START       0x10
+#define TWI_STATUS_SLA_W_ACK       0x18
+#define TWI_STATUS_SLA_W_NACK      0x20
+#define TWI_STATUS_DATA_W_ACK      0x28
+#define TWI_STATUS_DATA_W_NACK     0x30
+#define TWI_STATUS_SLA_R_ACK       0x40
+#define TWI_STATUS_SLA_R_NACK      0x48
+#define TWI_STATUS_DATA_R_ACK      0x50
+#define TWI_STATUS_DATA_R_NACK     0x58
+#define TWI_STATUS_IDLE            0xF8
+
+#define HOST_TIMERS_NUM            3
+#define FIRMWARE_STACK_SIZE        (8UL * 1024UL)   /* Under 10000 bytes: the stack reports fit their 4 digits */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* Counting setup of a timer, read from its registers */
+typedef struct
+{
+	uint32 prescale;       /* CPU cycles per count, 0 when stopped */
+	uint32 top;            /* Last count before going back to 0 */
+	uint32 max;            /* 0xFF or 0xFFFF */
+	uint32 compareA;
+	uint32 compareB;
+	boolean hasCompareB;
+	uint8 overflowFlag;    /* Flags in TIFR, same bits as their enables in TIMSK */
+	uint8 compareAFlag;
+	uint8 compareBFlag;
+	uint8 compareOutput;   /* COM bits of the compare A output */
+	boolean pwm;
+}HOST_TimerShapeType;
+
+typedef struct
+{
+	uint32 count;
+	uint64 lastCycle;      /* Cycle of the last sync */
+	uint8 outputLevel;     /* Compare A output pin in the non-PWM modes */
+}HOST_TimerType;
+
+typedef enum
+{
+	TWI_IDLE, TWI_ADDRESS, TWI_TRANSMIT, TWI_RECEIVE
+}HOST_TwiStateType;
+
+typedef enum
+{
+	TWI_OPERATION_NONE, TWI_OPERATION_START, TWI_OPERATION_BYTE
+}HOST_TwiOperationType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Register cells: the value to read, then the value written by the firmware */
+static union
+{
+	uint8 bytes[REGISTERS_SIZE];
+	uint16 words[REGISTERS_SIZE / 2];
+}g_registers;
+/* Value of every cell after the last commit, a difference is a write */
+static uint8 g_shadow[REGISTERS_SIZE];
+
+#define REG(address)               (g_registers.bytes[(address)])
+
+/* Virtual clock */
+static uint64 g_now = 0;
+static uint64 g_nextEvent = HOST_NEVER;
+static boolean g_checkInterrupts = FALSE;
+static uint32 g_interruptCounts[HOST_VECTORS_NUM];
+
+/* Firmware context */
+static ucontext_t g_hostContext;
+static ucontext_t g_firmwareContext;
+static uint8 *g_firmwareStack = NULL;
+static int (*g_firmwareEntry)(void) = NULL;
+static boolean g_firmwareStarted = FALSE;
+static boolean g_firmwareFinished = FALSE;
+static boolean g_inFirmware = FALSE;
+static uint64 g_runLimit = HOST_NEVER;
+
+/* Models */
+static HOST_ModelType *g_models = NULL;
+
+/* Timers */
+static HOST_TimerType g_timers[HOST_TIMERS_NUM];
+static uint8 g_timerFlags = 0; /* TIFR */
+
+/* External interrupts */
+static uint8 g_intFlags = 0; /* GIFR */
+static uint8 g_intLevels = 0; /* bit 0: INT0 (PD2), bit 1: INT1 (PD3) */
+
+/* USART */
+static struct
+{
+	uint8 control;         /* U2X and MPCM */
+	uint8 rxData[2];       /* UDR receive FIFO */
+	uint8 rxStatus[2];     /* FE and PE of each received frame */
+	uint8 rxCount;
+	boolean rxOverrun;
+	boolean udrAccessed;   /* UDR accessed since the last commit */
+	boolean txShiftBusy;
+	uint64 txEnd;          /* End of the stop bit of the frame in the shift register */
+	boolean txBufferFull;
+	uint8 txBuffer;
+	boolean txComplete;
+	HOST_UartTxCallBack txCallBack;
+	void *txContext;
+}g_uart;
+
+/* TWI */
+static struct
+{
+	uint8 control;         /* TWCR_STORED_BITS */
+	uint8 status;
+	boolean interrupt;     /* TWINT */
+	boolean busOwned;
+	HOST_TwiStateType state;
+	HOST_TwiOperationType operation;
+	uint64 operationEnd;
+	HOST_TwiDeviceType *devices;
+	HOST_TwiDeviceType *addressed;
+}g_twi;
+
+/* ADC */
+static struct
+{
+	boolean converting;
+	boolean firstConversion;
+	boolean flag;          /* ADIF */
+	uint64 conversionEnd;
+	uint16 inputMv[HOST_ADC_CHANNELS];
+	HOST_AnalogSource source[HOST_ADC_CHANNELS];
+	void *sourceContext[HOST_ADC_CHANNELS];
+}g_adc;
+
+/* Internal EEPROM */
+static uint8 g_eeprom[HOST_EEPROM_SIZE];
+static boolean g_eepromErased = FALSE;
+
+/* Interrupt vectors defined by the firmware */
+#define HOST_VECTOR(name)          extern void name(void) __attribute__((weak))
+HOST_VECTOR(INT0_vect);
+HOST_VECTOR(INT1_vect);
+HOST_VECTOR(INT2_vect);
+HOST_VECTOR(TIMER2_COMP_vect);
+HOST_VECTOR(TIMER2_OVF_vect);
+HOST_VECTOR(TIMER1_CAPT_vect);
+HOST_VECTOR(TIMER1_COMPA_vect);
+HOST_VECTOR(TIMER1_COMPB_vect);
+HOST_VECTOR(TIMER1_OVF_vect);
+HOST_VECTOR(TIMER0_COMP_vect);
+HOST_VECTOR(TIMER0_OVF_vect);
+HOST_VECTOR(SPI_STC_vect);
+HOST_VECTOR(USART_RXC_vect);
+HOST_VECTOR(USART_UDRE_vect);
+HOST_VECTOR(USART_TXC_vect);
+HOST_VECTOR(ADC_vect);
+HOST_VECTOR(EE_RDY_vect);
+HOST_VECTOR(ANA_COMP_vect);
+HOST_VECTOR(TWI_vect);
+HOST_VECTOR(SPM_RDY_vect);
+
+static void (*const g_vectors[HOST_VECTORS_NUM])(void) =
+{
+	INT0_vect, INT1_vect, INT2_vect, TIMER2_COMP_vect, TIMER2_OVF_vect, TIMER1_CAPT_vect,
+	TIMER1_COMPA_vect, TIMER1_COMPB_vect, TIMER1_OVF_vect, TIMER0_COMP_vect, TIMER0_OVF_vect,
+	SPI_STC_vect, USART_RXC_vect, USART_UDRE_vect, USART_TXC_vect, ADC_vect, EE_RDY_vect,
+	ANA_COMP_vect, TWI_vect, SPM_RDY_vect
+};
+
+static const char *const g_vectorNames[HOST_VECTORS_NUM] =
+{
+	"INT0", "INT1", "INT2", "TIMER2_COMP", "TIMER2_OVF", "TIMER1_CAPT", "TIMER1_COMPA",
+	"TIMER1_COMPB", "TIMER1_OVF", "TIMER0_COMP", "TIMER0_OVF", "SPI_STC", "USART_RXC",
+	"USART_UDRE", "USART_TXC", "ADC", "EE_RDY", "ANA_COMP", "TWI", "SPM_RDY"
+};
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void HOST_advance(uint64 cycles, boolean dispatch);
+static void HOST_commit(void);
+static void HOST_schedule(void);
+static void HOST_dispatchInterrupts(void);
+static void HOST_timerSync(uint8 id);
+static void HOST_uartStartFrame(uint8 data);
+static void HOST_adcStart(void);
+static uint8 HOST_resolvePort(uint8 port);
+
+/*******************************************************************************
+ *                      Functions Definitions (Private)                        *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Set a register from a peripheral, the firmware did not write it.
+ */
+static void HOST_setRegister(uint8 address, uint8 value)
+{
+	REG(address) = value;
+	g_shadow[address] = value;
+}
+
+/*
+ * Description :
+ * Counting setup of a timer from its registers
+ */
+static void HOST_timerShape(uint8 id, HOST_TimerShapeType *shape)
+{
+	static const uint16 prescales01[8] = {0, 1, 8, 64, 256, 1024, 0, 0}; /* 6, 7: external clock */
+	static const uint16 prescales2[8] = {0, 1, 8, 32, 64, 128, 256, 1024};
+	uint8 control;
+	uint8 mode;
+	shape->hasCompareB = FALSE;
+	shape->compareB = 0;
+	shape->compareBFlag = 0;
+	if(id == 1)
+	{
+		control = REG(ADDR_TCCR1B);
+		mode = ((control >> WGM12) & 0x03) << 2 | (REG(ADDR_TCCR1A) & 0x03);
+		shape->prescale = prescales01[control & 0x07];
+		shape->max = 0xFFFF;
+		shape->compareA = g_registers.words[ADDR_OCR1A / 2];
+		shape->compareB = g_registers.words[ADDR_OCR1B / 2];
+		shape->hasCompareB = TRUE;
+		shape->top = (mode == 4) ? shape->compareA : ((mode == 12) ? g_registers.words[ADDR_ICR1 / 2] : 0xFFFF);
+		shape->pwm = (mode != 0) && (mode != 4) && (mode != 12);
+		shape->overflowFlag = (1 << TOV1);
+		shape->compareAFlag = (1 << OCF1A);
+		shape->compareBFlag = (1 << OCF1B);
+		shape->compareOutput = (REG(ADDR_TCCR1A) >> COM1A0) & 0x03;
+		return;
+	}
+	control = REG((id == 0) ? ADDR_TCCR0 : ADDR_TCCR2);
+	mode = (((control >> WGM01) & 1) << 1) | ((control >> WGM00) & 1);
+	shape->prescale = (id == 0) ? prescales01[control & 0x07] : prescales2[control & 0x07];
+	shape->max = 0xFF;
+	shape->compareA = REG((id == 0) ? ADDR_OCR0 : ADDR_OCR2);
+	shape->top = (mode == 2) ? shape->compareA : 0xFF;
+	shape->pwm = (mode == 1) || (mode == 3);
+	shape->overflowFlag = (id == 0) ? (1 << TOV0) : (1 << TOV2);
+	shape->compareAFlag = (id == 0) ? (1 << OCF0) : (1 << OCF2);
+	shape->compareOutput = (control >> COM00) & 0x03; /* COM20 is the same bit */
+}
+
+/*
+ * Description :
+ * Number of times a counter at count becomes value in the next ticks
+ */
+static uint64 HOST_timerHits(uint32 count, uint32 value, uint32 period, uint64 ticks)
+{
+	uint64 distance = (value + period - count) % period;
+	if(distance == 0)
+	{
+		distance = period;
+	}
+	return (ticks >= distance) ? 1 + (ticks - distance) / period : 0;
+}
+
+/*
+ * Description :
+ * Bring a timer count and its flags up to the current cycle
+ */
+static void HOST_timerSync(uint8 id)
+{
+	HOST_TimerType *timer = &g_timers[id];
+	HOST_TimerShapeType shape;
+	uint64 ticks;
+	uint64 hits;
+	uint32 count;
+	uint32 period;
+	uint8 flags = g_timerFlags;
+	HOST_timerShape(id, &shape);
+	if(shape.prescale == 0)
+	{
+		timer->lastCycle = g_now;
+		return;
+	}
+	/* All the timers count on the edges of the shared prescaler */
+	ticks = g_now / shape.prescale - timer->lastCycle / shape.prescale;
+	timer->lastCycle = g_now;
+	if(ticks == 0)
+	{
+		return;
+	}
+	count = timer->count;
+	if(count > shape.top)
+	{
+		/* Above a lowered TOP: counts up to MAX and wraps first */
+		if(ticks < (uint64)(shape.max + 1 - count))
+		{
+			timer->count = count + (uint32)ticks;
+			return;
+		}
+		ticks -= shape.max + 1 - count;
+		count = 0;
+		g_timerFlags |= shape.overflowFlag;
+	}
+	period = shape.top + 1;
+	if(shape.compareA <= shape.top)
+	{
+		hits = HOST_timerHits(count, shape.compareA, period, ticks);
+		if(hits != 0)
+		{
+			g_timerFlags |= shape.compareAFlag;
+			if(!shape.pwm)
+			{
+				/* COM 1: toggle, 2: clear, 3: set the compare output on a match */
+				if(shape.compareOutput == 1)
+				{
+					timer->outputLevel ^= (uint8)(hits & 1);
+				}
+				else if(shape.compareOutput != 0)
+				{
+					timer->outputLevel = (shape.compareOutput == 3);
+				}
+			}
+		}
+	}
+	if(shape.hasCompareB && shape.compareB <= shape.top
+			&& HOST_timerHits(count, shape.compareB, period, ticks) != 0)
+	{
+		g_timerFlags |= shape.compareBFlag;
+	}
+	if(shape.top == shape.max && HOST_timerHits(count, 0, period, ticks) != 0)
+	{
+		g_timerFlags |= shape.overflowFlag;
+	}
+	timer->count = (uint32)((count + ticks) % period);
+	if(g_timerFlags != flags)
+	{
+		g_checkInterrupts = TRUE;
+	}
+}
+
+/*
+ * Description :
+ * Cycle of the next flag of a timer that has its interrupt enabled
+ */
+static uint64 HOST_timerNextEvent(uint8 id)
+{
+	HOST_TimerType *timer = &g_timers[id];
+	HOST_TimerShapeType shape;
+	uint8 waited;
+	uint32 period;
+	uint64 distance = HOST_NEVER;
+	uint64 candidate;
+	HOST_timerShape(id, &shape);
+	waited = REG(ADDR_TIMSK) & ~g_timerFlags & (shape.overflowFlag | shape.compareAFlag | shape.compareBFlag);
+	if(shape.prescale == 0 || waited == 0)
+	{
+		return HOST_NEVER;
+	}
+	HOST_timerSync(id);
+	if(timer->count > shape.top)
+	{
+		/* Wake up at the wrap, the matches are found from 0 */
+		distance = shape.max + 1 - timer->count;
+	}
+	else
+	{
+		period = shape.top + 1;
+		if((waited & shape.compareAFlag) && shape.compareA <= shape.top)
+		{
+			candidate = (shape.compareA + period - timer->count) % period;
+			distance = (candidate == 0) ? period : candidate;
+		}
+		if((waited & shape.compareBFlag) && shape.compareB <= shape.top)
+		{
+			candidate = (shape.compareB + period - timer->count) % period;
+			candidate = (candidate == 0) ? period : candidate;
+			distance = (candidate < distance) ? candidate : distance;
+		}
+		if((waited & shape.overflowFlag) && shape.top == shape.max)
+		{
+			candidate = period - timer->count;
+			distance = (candidate < distance) ? candidate : distance;
+		}
+	}
+	if(distance == HOST_NEVER)
+	{
+		return HOST_NEVER;
+	}
+	return (g_now / shape.prescale + distance) * shape.prescale;
+}
+
+/*
+ * Description :
+ * Value of the USART control and status register A
+ */
+static uint8 HOST_uartStatus(void)
+{
+	uint8 status = g_uart.control;
+	if(g_uart.rxCount != 0)
+	{
+		status |= (1 << RXC);
+		status |= g_uart.rxStatus[0];
+	}
+	if(g_uart.rxOverrun)
+	{
+		status |= (1 << DOR);
+	}
+	if(g_uart.txComplete)
+	{
+		status |= (1 << TXC);
+	}
+	if(!g_uart.txBufferFull)
+	{
+		status |= (1 << UDRE);
+	}
+	return status;
+}
+
+/*
+ * Description :
+ * The firmware wrote UDR: the byte goes to the shift register or waits in the buffer
+ */
+static void HOST_uartWrite(uint8 data)
+{
+	if(BIT_IS_CLEAR(REG(ADDR_UCSRB), TXEN))
+	{
+		return;
+	}
+	if(!g_uart.txShiftBusy)
+	{
+		HOST_uartStartFrame(data);
+	}
+	else
+	{
+		/* A write while UDRE is clear replaces the waiting byte */
+		g_uart.txBuffer = data;
+		g_uart.txBufferFull = TRUE;
+	}
+}
+
+/*
+ * Description :
+ * Start shifting a frame out on TXD
+ */
+static void HOST_uartStartFrame(uint8 data)
+{
+	g_uart.txShiftBusy = TRUE;
+	g_uart.txEnd = g_now + (uint64)HOST_getUartBitCycles() * HOST_getUartFrameBits();
+	if(g_uart.txCallBack != NULL)
+	{
+		g_uart.txCallBack(g_uart.txContext, data, g_uart.txEnd);
+	}
+}
+
+/*
+ * Description :
+ * The firmware read UDR: the oldest received byte leaves the FIFO
+ */
+static void HOST_uartRead(void)
+{
+	if(g_uart.rxCount == 0)
+	{
+		return;
+	}
+	g_uart.rxData[0] = g_uart.rxData[1];
+	g_uart.rxStatus[0] = g_uart.rxStatus[1];
+	g_uart.rxCount--;
+	g_uart.rxOverrun = FALSE;
+}
+
+/*
+ * Description :
+ * Time of one SCL period in CPU cycles
+ */
+static uint32 HOST_twiSclCycles(void)
+{
+	return 16 + 2UL * REG(ADDR_TWBR) * (1UL << (2 * (REG(ADDR_TWSR) & 0x03)));
+}
+
+/*
+ * Description :
+ * The firmware wrote TWCR
+ */
+static void HOST_twiControl(uint8 value)
+{
+	g_twi.control = value & TWCR_STORED_BITS;
+	if(BIT_IS_CLEAR(value, TWEN))
+	{
+		/* Disabling the TWI ends any transfer */
+		g_twi.interrupt = FALSE;
+		g_twi.busOwned = FALSE;
+		g_twi.state = TWI_IDLE;
+		g_twi.operation = TWI_OPERATION_NONE;
+		g_twi.operationEnd = HOST_NEVER;
+		g_twi.addressed = NULL;
+		g_twi.status = TWI_STATUS_IDLE;
+		return;
+	}
+	if(BIT_IS_CLEAR(value, TWINT))
+	{
+		return;
+	}
+	/* Writing one to TWINT clears it and starts the next bus operation */
+	g_twi.interrupt = FALSE;
+	if(value & (1 << TWSTO))
+	{
+		if(g_twi.addressed != NULL && g_twi.addressed->stop != NULL)
+		{
+			g_twi.addressed->stop(g_twi.addressed->context);
+		}
+		g_twi.addressed = NULL;
+		g_twi.busOwned = FALSE;
+		g_twi.state = TWI_IDLE;
+		g_twi.status = TWI_STATUS_IDLE;
+		g_twi.operation = TWI_OPERATION_NONE;
+		g_twi.operationEnd = HOST_NEVER;
+		/* TWSTO is cleared when the STOP is sent, TWINT is not set */
+	}
+	else if(value & (1 << TWSTA))
+	{
+		g_twi.operation = TWI_OPERATION_START;
+		g_twi.operationEnd = g_now + HOST_twiSclCycles();
+	}
+	else if(g_twi.state != TWI_IDLE)
+	{
+		/* 8 data bits and the acknowledge bit */
+		g_twi.operation = TWI_OPERATION_BYTE;
+		g_twi.operationEnd = g_now + 9UL * HOST_twiSclCycles();
+	}
+}
+
+/*
+ * Description :
+ * A TWI bus operation ended: update the status and set TWINT
+ */
+static void HOST_twiComplete(void)
+{
+	HOST_TwiDeviceType *device;
+	uint8 data = REG(ADDR_TWDR);
+	boolean ack = FALSE;
+	boolean read;
+	if(g_twi.operation == TWI_OPERATION_START)
+	{
+		g_twi.status = g_twi.busOwned ? TWI_STATUS_REP_START : TWI_STATUS_START;
+		g_twi.busOwned = TRUE;
+		g_twi.state = TWI_ADDRESS;
+	}
+	else if(g_twi.state == TWI_ADDRESS)
+	{
+		/* SLA+R/W: the first device that acknowledges is addressed */
+		read = (data & 1);
+		g_twi.addressed = NULL;
+		for(device = g_twi.devices; device != NULL && !ack; device = device->next)
+		{
+			if(device->select != NULL && device->select(device->context, data >> 1, read))
+			{
+				g_twi.addressed = device;
+				ack = TRUE;
+			}
+		}
+		if(read)
+		{
+			g_twi.status = ack ? TWI_STATUS_SLA_R_ACK : TWI_STATUS_SLA_R_NACK;
+			g_twi.state = TWI_RECEIVE;
+		}
+		else
+		{
+			g_twi.status = ack ? TWI_STATUS_SLA_W_ACK : TWI_STATUS_SLA_W_NACK;
+			g_twi.state = TWI_TRANSMIT;
+		}
+	}
+	else if(g_twi.state == TWI_TRANSMIT)
+	{
+		if(g_twi.addressed != NULL && g_twi.addressed->write != NULL)
+		{
+			ack = g_twi.addressed->write(g_twi.addressed->context, data);
+		}
+		g_twi.status = ack ? TWI_STATUS_DATA_W_ACK : TWI_STATUS_DATA_W_NACK;
+	}
+	else
+	{
+		/* The master acknowledges the byte when TWEA is set */
+		ack = (g_twi.control & (1 << TWEA)) != 0;
+		data = 0xFF; /* Nobody pulls SDA low */
+		if(g_twi.addressed != NULL && g_twi.addressed->read != NULL)
+		{
+			data = g_twi.addressed->read(g_twi.addressed->context, ack);
+		}
+		HOST_setRegister(ADDR_TWDR, data);
+		g_twi.status = ack ? TWI_STATUS_DATA_R_ACK : TWI_STATUS_DATA_R_NACK;
+	}
+	g_twi.operation = TWI_OPERATION_NONE;
+	g_twi.operationEnd = HOST_NEVER;
+	g_twi.interrupt = TRUE;
+	g_checkInterrupts = TRUE;
+}
+
+/*
+ * Description :
+ * ADC clock divider from ADCSRA
+ */
+static uint32 HOST_adcPrescale(void)
+{
+	uint8 select = REG(ADDR_ADCSRA) & 0x07;
+	return (select == 0) ? 2 : (1UL << select);
+}
+
+/*
+ * Description :
+ * The firmware wrote ADCSRA
+ */
+static void HOST_adcControl(uint8 value)
+{
+	if(value & (1 << ADIF))
+	{
+		g_adc.flag = FALSE;
+	}
+	REG(ADDR_ADCSRA) = value & ~((1 << ADIF) | (1 << ADSC));
+	if(BIT_IS_CLEAR(value, ADEN))
+	{
+		g_adc.converting = FALSE;
+		g_adc.firstConversion = TRUE;
+		g_adc.conversionEnd = HOST_NEVER;
+	}
+	else if((value & (1 << ADSC)) && !g_adc.converting)
+	{
+		HOST_adcStart();
+	}
+}
+
+/*
+ * Description :
+ * Start a conversion: 25 ADC clocks for the first one after enabling, 13 after
+ */
+static void HOST_adcStart(void)
+{
+	g_adc.converting = TRUE;
+	g_adc.conversionEnd = g_now + HOST_adcPrescale() * (g_adc.firstConversion ? 25UL : 13UL);
+	g_adc.firstConversion = FALSE;
+}
+
+/*
+ * Description :
+ * A conversion ended: sample the selected channel, set ADIF and restart in free running mode
+ */
+static void HOST_adcComplete(void)
+{
+	uint8 channel = REG(ADDR_ADMUX) & 0x07;
+	uint32 millivolts = g_adc.inputMv[channel];
+	uint32 result;
+	if(g_adc.source[channel] != NULL)
+	{
+		millivolts = g_adc.source[channel](g_adc.sourceContext[channel], channel);
+	}
+	result = (millivolts * 1024UL) / HOST_ADC_REF_MV;
+	if(result > 1023)
+	{
+		result = 1023;
+	}
+	if(REG(ADDR_ADMUX) & (1 << ADLAR))
+	{
+		result <<= 6;
+	}
+	HOST_setRegister(ADDR_ADCL, (uint8)result);
+	HOST_setRegister(ADDR_ADCH, (uint8)(result >> 8));
+	g_adc.flag = TRUE;
+	g_checkInterrupts = TRUE;
+	if((REG(ADDR_ADCSRA) & (1 << ADATE)) && (REG(ADDR_SFIOR) >> ADTS0) == 0)
+	{
+		HOST_adcStart();
+	}
+	else
+	{
+		g_adc.converting = FALSE;
+		g_adc.conversionEnd = HOST_NEVER;
+	}
+}
+
+/*
+ * Description :
+ * Level of every pin of a port: the outputs drive their PORT level, the inputs
+ * are pulled up by PORT (unless PUD) then driven by the models
+ */
+static uint8 HOST_resolvePort(uint8 port)
+{
+	HOST_ModelType *model;
+	uint8 direction = REG(ADDR_DDR(port));
+	uint8 output = REG(ADDR_PORT(port));
+	uint8 levels = output;
+	if(REG(ADDR_SFIOR) & (1 << PUD))
+	{
+		levels &= direction;
+	}
+	for(model = g_models; model != NULL; model = model->next)
+	{
+		if(model->resolvePins != NULL)
+		{
+			levels = model->resolvePins(model->context, port, levels);
+		}
+	}
+	return (uint8)((levels & ~direction) | (output & direction));
+}
+
+/*
+ * Description :
+ * The firmware wrote a port register: tell the models then update the pins
+ */
+static void HOST_portWritten(uint8 port)
+{
+	HOST_ModelType *model;
+	for(model = g_models; model != NULL; model = model->next)
+	{
+		if(model->portWritten != NULL)
+		{
+			model->portWritten(model->context, port);
+		}
+	}
+	HOST_pinsChanged();
+}
+
+/*
+ * Description :
+ * The firmware wrote a register: update the peripheral it belongs to
+ */
+static void HOST_writeRegister(uint8 address, uint8 value)
+{
+	uint8 port;
+	switch(address)
+	{
+	case ADDR_UDR:
+		g_uart.udrAccessed = FALSE;
+		HOST_uartWrite(value);
+		break;
+	case ADDR_UCSRA:
+		g_uart.control = value & ((1 << U2X) | (1 << MPCM));
+		if(value & (1 << TXC))
+		{
+			g_uart.txComplete = FALSE;
+		}
+		value = HOST_uartStatus();
+		break;
+	case ADDR_UBRRH:
+	case ADDR_UCSRC:
+		/* URSEL selects UCSRC or UBRRH, they share one address on the chip */
+		if(value & (1 << URSEL))
+		{
+			HOST_setRegister(ADDR_UCSRC, value);
+		}
+		else
+		{
+			HOST_setRegister(ADDR_UBRRH, value & 0x0F);
+		}
+		value = REG(address);
+		break;
+	case ADDR_TWCR:
+		HOST_twiControl(value & ~TWCR_MARKER);
+		value = REG(address);
+		break;
+	case ADDR_TWSR:
+		value &= 0x03;
+		break;
+	case ADDR_ADCSRA:
+		HOST_adcControl(value);
+		value = REG(address);
+		break;
+	case ADDR_TIFR:
+		g_timerFlags &= ~value;
+		value = 0;
+		break;
+	case ADDR_GIFR:
+		g_intFlags &= ~value;
+		value = 0;
+		break;
+	case ADDR_TCNT0:
+		g_timers[0].count = value;
+		break;
+	case ADDR_TCNT2:
+		g_timers[2].count = value;
+		break;
+	case ADDR_TCCR0:
+	case ADDR_TCCR2:
+		value &= ~(1 << FOC0); /* Strobe, reads as 0 */
+		break;
+	case ADDR_TCCR1A:
+		value &= ~((1 << FOC1A) | (1 << FOC1B));
+		break;
+	default:
+		break;
+	}
+	HOST_setRegister(address, value);
+	if(address >= ADDR_PIND && address <= ADDR_PINA + 2)
+	{
+		port = (uint8)((ADDR_PINA + 2 - address) / 3);
+		if(address == ADDR_PIN(port))
+		{
+			/* PINx is read only on the ATmega32 */
+			HOST_setRegister(address, g_shadow[address]);
+		}
+		else
+		{
+			HOST_portWritten(port);
+		}
+	}
+	if(address == ADDR_SFIOR)
+	{
+		HOST_pinsChanged();
+	}
+}
+
+/*
+ * Description :
+ * The firmware wrote a 16-bit register
+ */
+static void HOST_writeRegister16(uint8 address, uint16 value)
+{
+	if(address == ADDR_TCNT1)
+	{
+		g_timers[1].count = value;
+	}
+	else if(address == ADDR_ADCL)
+	{
+		value = g_registers.words[ADDR_ADCL / 2]; /* Read only */
+	}
+	HOST_setRegister(address, (uint8)value);
+	HOST_setRegister(address + 1, (uint8)(value >> 8));
+}
+
+/*
+ * Description :
+ * TRUE for the low byte of a 16-bit register, written as a whole
+ */
+static boolean HOST_isWordRegister(uint8 address)
+{
+	return (address == ADDR_ADCL) || (address == ADDR_ICR1) || (address == ADDR_OCR1B)
+			|| (address == ADDR_OCR1A) || (address == ADDR_TCNT1);
+}
+
+/*
+ * Description :
+ * Handle the writes of the firmware since the last commit: every cell that differs
+ * from its shadow was written, the timers count up to now with the old value first.
+ */
+static void HOST_commit(void)
+{
+	uint8 address;
+	uint8 size;
+	uint8 id;
+	uint8 written[2];
+	boolean changed = FALSE;
+	if(memcmp(&REG(ADDR_FIRST), &g_shadow[ADDR_FIRST], REGISTERS_SIZE - ADDR_FIRST) != 0)
+	{
+		changed = TRUE;
+		for(address = ADDR_FIRST; address < REGISTERS_SIZE; address += size)
+		{
+			size = HOST_isWordRegister(address) ? 2 : 1;
+			if(memcmp(&REG(address), &g_shadow[address], size) == 0)
+			{
+				continue;
+			}
+			memcpy(written, &REG(address), size);
+			memcpy(&REG(address), &g_shadow[address], size);
+			for(id = 0; id < HOST_TIMERS_NUM; id++)
+			{
+				HOST_timerSync(id);
+			}
+			if(size == 2)
+			{
+				HOST_writeRegister16(address, written[0] | (uint16)written[1] << 8);
+			}
+			else
+			{
+				HOST_writeRegister(address, written[0]);
+			}
+		}
+	}
+	if(g_uart.udrAccessed)
+	{
+		/* UDR accessed and unchanged: a read of a received byte, else the transmit of the same value */
+		g_uart.udrAccessed = FALSE;
+		changed = TRUE;
+		if(g_uart.rxCount != 0)
+		{
+			HOST_uartRead();
+		}
+		else
+		{
+			HOST_uartWrite(REG(ADDR_UDR));
+		}
+	}
+	if(changed)
+	{
+		g_checkInterrupts = TRUE;
+		HOST_schedule();
+	}
+}
+
+/*
+ * Description :
+ * Load the value to read in a register cell
+ */
+static void HOST_prepare(uint8 address)
+{
+	uint8 value;
+	switch(address)
+	{
+	case ADDR_UDR:
+		g_uart.udrAccessed = TRUE;
+		value = (g_uart.rxCount != 0) ? g_uart.rxData[0] : REG(address);
+		break;
+	case ADDR_UCSRA:
+		value = HOST_uartStatus();
+		break;
+	case ADDR_TWCR:
+		value = g_twi.control | (g_twi.interrupt ? (1 << TWINT) : 0) | TWCR_MARKER;
+		break;
+	case ADDR_TWSR:
+		value = g_twi.status | (REG(address) & 0x03);
+		break;
+	case ADDR_ADCSRA:
+		value = (REG(address) & ~(1 << ADSC)) | (g_adc.converting ? (1 << ADSC) : 0);
+		/* ADSC reads one until the end of the conversion, the cell keeps the value of the last read */
+		break;
+	case ADDR_TCNT0:
+		HOST_timerSync(0);
+		value = (uint8)g_timers[0].count;
+		break;
+	case ADDR_TCNT2:
+		HOST_timerSync(2);
+		value = (uint8)g_timers[2].count;
+		break;
+	case ADDR_TCNT1:
+		HOST_timerSync(1);
+		HOST_setRegister(ADDR_TCNT1 + 1, (uint8)(g_timers[1].count >> 8));
+		value = (uint8)g_timers[1].count;
+		break;
+	case ADDR_TCNT1 + 1:
+		HOST_timerSync(1);
+		value = (uint8)(g_timers[1].count >> 8);
+		break;
+	default:
+		if(address >= ADDR_PIND && address <= ADDR_PINA && ((ADDR_PINA - address) % 3) == 0)
+		{
+			value = HOST_resolvePort((uint8)((ADDR_PINA - address) / 3));
+		}
+		else
+		{
+			value = REG(address);
+		}
+		break;
+	}
+	HOST_setRegister(address, value);
+}
+
+/*
+ * Description :
+ * Cycle of the next event of the peripherals and models
+ */
+static void HOST_schedule(void)
+{
+	HOST_ModelType *model;
+	uint64 next = HOST_NEVER;
+	uint64 candidate;
+	uint8 id;
+	for(id = 0; id < HOST_TIMERS_NUM; id++)
+	{
+		candidate = HOST_timerNextEvent(id);
+		next = (candidate < next) ? candidate : next;
+	}
+	if(g_uart.txShiftBusy && g_uart.txEnd < next)
+	{
+		next = g_uart.txEnd;
+	}
+	if(g_twi.operationEnd < next)
+	{
+		next = g_twi.operationEnd;
+	}
+	if(g_adc.converting && g_adc.conversionEnd < next)
+	{
+		next = g_adc.conversionEnd;
+	}
+	for(model = g_models; model != NULL; model = model->next)
+	{
+		if(model->wakeCycle < next)
+		{
+			next = model->wakeCycle;
+		}
+	}
+	g_nextEvent = next;
+}
+
+/*
+ * Description :
+ * Run the events due at the current cycle
+ */
+static void HOST_processEvents(void)
+{
+	HOST_ModelType *model;
+	uint8 id;
+	for(id = 0; id < HOST_TIMERS_NUM; id++)
+	{
+		HOST_timerSync(id);
+	}
+	if(g_uart.txShiftBusy && g_uart.txEnd <= g_now)
+	{
+		g_uart.txShiftBusy = FALSE;
+		if(g_uart.txBufferFull)
+		{
+			g_uart.txBufferFull = FALSE;
+			HOST_uartStartFrame(g_uart.txBuffer);
+		}
+		else
+		{
+			g_uart.txComplete = TRUE;
+		}
+		g_checkInterrupts = TRUE;
+	}
+	if(g_twi.operationEnd <= g_now)
+	{
+		HOST_twiComplete();
+	}
+	if(g_adc.converting && g_adc.conversionEnd <= g_now)
+	{
+		HOST_adcComplete();
+	}
+	for(model = g_models; model != NULL; model = model->next)
+	{
+		if(model->wakeCycle <= g_now)
+		{
+			model->wakeCycle = (model->advance != NULL) ? model->advance(model->context, g_now) : HOST_NEVER;
+			if(model->wakeCycle <= g_now)
+			{
+				model->wakeCycle = g_now + 1;
+			}
+		}
+	}
+	HOST_schedule();
+}
+
+/*
+ * Description :
+ * Give the hand back to the host until the next HOST_runUntil()
+ */
+static void HOST_yield(void)
+{
+	if(g_inFirmware)
+	{
+		swapcontext(&g_firmwareContext, &g_hostContext);
+	}
+}
+
+/*
+ * Description :
+ * Run the virtual clock, processing the events on the way and taking the
+ * pending interrupts if dispatch is TRUE
+ */
+static void HOST_advance(uint64 cycles, boolean dispatch)
+{
+	uint64 target = g_now + cycles;
+	uint64 end;
+	do
+	{
+		end = target;
+		if(g_nextEvent < end)
+		{
+			end = (g_nextEvent > g_now) ? g_nextEvent : g_now;
+		}
+		if(g_runLimit < end && g_runLimit > g_now)
+		{
+			end = g_runLimit;
+		}
+		g_now = end;
+		if(g_nextEvent <= g_now)
+		{
+			HOST_processEvents();
+		}
+		if(dispatch && g_checkInterrupts)
+		{
+			HOST_dispatchInterrupts();
+		}
+		if(g_now >= g_runLimit)
+		{
+			HOST_yield();
+		}
+	} while(g_now < target);
+}
+
+/*
+ * Description :
+ * Highest priority interrupt that is flagged and enabled, -1 for none
+ */
+static sint8 HOST_pendingVector(void)
+{
+	uint8 gicr = REG(ADDR_GICR);
+	uint8 mcucr = REG(ADDR_MCUCR);
+	uint8 timers = g_timerFlags & REG(ADDR_TIMSK);
+	uint8 bit;
+	if((gicr & (1 << INT0)) && ((g_intFlags & (1 << INTF0))
+			|| ((mcucr & 0x03) == 0 && (g_intLevels & 0x01) == 0)))
+	{
+		return HOST_VECTOR_INT0;
+	}
+	if((gicr & (1 << INT1)) && ((g_intFlags & (1 << INTF1))
+			|| (((mcucr >> ISC10) & 0x03) == 0 && (g_intLevels & 0x02) == 0)))
+	{
+		return HOST_VECTOR_INT1;
+	}
+	if((gicr & (1 << INT2)) && (g_intFlags & (1 << INTF2)))
+	{
+		return HOST_VECTOR_INT2;
+	}
+	if(timers != 0)
+	{
+		/* TIFR bits 7 --> 0 are the timer vectors in priority order */
+		for(bit = 7; (timers & (1 << bit)) == 0; bit--)
+		{
+		}
+		return (sint8)(HOST_VECTOR_TIMER2_COMP + (7 - bit));
+	}
+	if(g_uart.rxCount != 0 && (REG(ADDR_UCSRB) & (1 << RXCIE)))
+	{
+		return HOST_VECTOR_USART_RXC;
+	}
+	if(!g_uart.txBufferFull && (REG(ADDR_UCSRB) & (1 << UDRIE)))
+	{
+		return HOST_VECTOR_USART_UDRE;
+	}
+	if(g_uart.txComplete && (REG(ADDR_UCSRB) & (1 << TXCIE)))
+	{
+		return HOST_VECTOR_USART_TXC;
+	}
+	if(g_adc.flag && (REG(ADDR_ADCSRA) & (1 << ADIE)))
+	{
+		return HOST_VECTOR_ADC;
+	}
+	if(g_twi.interrupt && (g_twi.control & (1 << TWIE)))
+	{
+		return HOST_VECTOR_TWI;
+	}
+	return -1;
+}
+
+/*
+ * Description :
+ * Take the pending interrupts while the I-bit is set: the flags cleared by the
+ * hardware are cleared, the I-bit is cleared during the ISR and set by its reti
+ */
+static void HOST_dispatchInterrupts(void)
+{
+	sint8 vector;
+	g_checkInterrupts = FALSE;
+	while((REG(ADDR_SREG) & (1 << SREG_I)) && (vector = HOST_pendingVector()) >= 0)
+	{
+		switch(vector)
+		{
+		case HOST_VECTOR_INT0:
+			g_intFlags &= ~(1 << INTF0);
+			break;
+		case HOST_VECTOR_INT1:
+			g_intFlags &= ~(1 << INTF1);
+			break;
+		case HOST_VECTOR_INT2:
+			g_intFlags &= ~(1 << INTF2);
+			break;
+		case HOST_VECTOR_USART_TXC:
+			g_uart.txComplete = FALSE;
+			break;
+		case HOST_VECTOR_ADC:
+			g_adc.flag = FALSE;
+			break;
+		default:
+			if(vector >= HOST_VECTOR_TIMER2_COMP && vector <= HOST_VECTOR_TIMER0_OVF)
+			{
+				g_timerFlags &= ~(1 << (7 - (vector - HOST_VECTOR_TIMER2_COMP)));
+			}
+			break;
+		}
+		/* The next flag of the source is due again now that this one is cleared */
+		HOST_schedule();
+		if(g_vectors[vector] == NULL)
+		{
+			/* The chip jumps to __bad_interrupt and restarts */
+			fprintf(stderr, "host mcu: %s interrupt without ISR\n", g_vectorNames[vector]);
+			HOST_fail("bad interrupt");
+		}
+		g_interruptCounts[vector]++;
+		HOST_setRegister(ADDR_SREG, REG(ADDR_SREG) & ~(1 << SREG_I));
+		HOST_advance(HOST_INTERRUPT_CYCLES / 2, FALSE);
+		g_vectors[vector]();
+		HOST_commit();
+		HOST_setRegister(ADDR_SREG, REG(ADDR_SREG) | (1 << SREG_I));
+		HOST_advance(HOST_INTERRUPT_CYCLES - HOST_INTERRUPT_CYCLES / 2, FALSE);
+	}
+}
+
+/*
+ * Description :
+ * First function of the firmware context
+ */
+static void HOST_firmwareRun(void)
+{
+	g_firmwareEntry();
+	HOST_commit();
+	g_firmwareFinished = TRUE;
+	/* Returning resumes the host context (uc_link) */
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Register access from the firmware (avr/io.h): run the clock by the access time,
+ * then load the value to read. A write through the cell is seen at the next access.
+ */
+volatile uint8_t *HOST_access8(uint8_t address)
+{
+	if(address < ADDR_FIRST || address >= REGISTERS_SIZE)
+	{
+		HOST_fail("register address out of the I/O space");
+	}
+	HOST_commit();
+	HOST_advance(HOST_ACCESS_CYCLES, TRUE);
+	HOST_prepare(address);
+	return &REG(address);
+}
+
+volatile uint16_t *HOST_access16(uint8_t address)
+{
+	if(address < ADDR_FIRST || address + 1 >= REGISTERS_SIZE || (address & 1) != 0)
+	{
+		HOST_fail("16-bit register address out of the I/O space");
+	}
+	HOST_commit();
+	HOST_advance(2 * HOST_ACCESS_CYCLES, TRUE);
+	HOST_prepare(address);
+	HOST_prepare(address + 1);
+	return (volatile uint16_t *)&g_registers.words[address / 2];
+}
+
+/*
+ * Description :
+ * sei()/cli() (avr/interrupt.h)
+ */
+void HOST_setInterrupts(uint8_t enable)
+{
+	HOST_commit();
+	if(enable)
+	{
+		HOST_setRegister(ADDR_SREG, REG(ADDR_SREG) | (1 << SREG_I));
+		g_checkInterrupts = TRUE;
+	}
+	else
+	{
+		HOST_setRegister(ADDR_SREG, REG(ADDR_SREG) & ~(1 << SREG_I));
+	}
+	HOST_advance(1, TRUE);
+}
+
+/*
+ * Description :
+ * _delay_ms()/_delay_us() (util/delay.h)
+ */
+void HOST_delayCycles(double cycles)
+{
+	uint64 whole = (uint64)cycles;
+	if((double)whole < cycles || whole == 0)
+	{
+		whole++;
+	}
+	HOST_commit();
+	HOST_advance(whole, TRUE);
+}
+
+/*
+ * Description :
+ * Called at the entry of every firmware function (-finstrument-functions).
+ * The calls of the host boards between two runs (peeks, mailboxes) take no firmware time.
+ */
+void __cyg_profile_func_enter(void *function, void *caller) __attribute__((no_instrument_function));
+void __cyg_profile_func_exit(void *function, void *caller) __attribute__((no_instrument_function));
+
+void __cyg_profile_func_enter(void *function, void *caller)
+{
+	(void)function;
+	(void)caller;
+	if(!g_inFirmware)
+	{
+		return;
+	}
+	HOST_commit();
+	HOST_advance(HOST_CALL_CYCLES, TRUE);
+}
+
+void __cyg_profile_func_exit(void *function, void *caller)
+{
+	(void)function;
+	(void)caller;
+}
+
+void HOST_init(void)
+{
+	HOST_ModelType *model;
+	HOST_TwiDeviceType *devices = g_twi.devices;
+	HOST_UartTxCallBack txCallBack = g_uart.txCallBack;
+	void *txContext = g_uart.txContext;
+	uint8 channel;
+	memset(&g_registers, 0, sizeof(g_registers));
+	g_now = 0;
+	g_checkInterrupts = FALSE;
+	memset(g_interruptCounts, 0, sizeof(g_interruptCounts));
+	memset(g_timers, 0, sizeof(g_timers));
+	g_timerFlags = 0;
+	g_intFlags = 0;
+	memset(&g_uart, 0, sizeof(g_uart));
+	g_uart.txCallBack = txCallBack;
+	g_uart.txContext = txContext;
+	memset(&g_twi, 0, sizeof(g_twi));
+	g_twi.devices = devices;
+	g_twi.status = TWI_STATUS_IDLE;
+	g_twi.operationEnd = HOST_NEVER;
+	g_adc.converting = FALSE;
+	g_adc.firstConversion = TRUE;
+	g_adc.flag = FALSE;
+	g_adc.conversionEnd = HOST_NEVER;
+	for(channel = 0; channel < HOST_ADC_CHANNELS; channel++)
+	{
+		if(g_adc.source[channel] == NULL)
+		{
+			g_adc.inputMv[channel] = 0;
+		}
+	}
+	/* Reset values */
+	REG(ADDR_UCSRC) = (1 << URSEL) | (1 << UCSZ1) | (1 << UCSZ0);
+	REG(ADDR_TWDR) = 0xFF;
+	REG(ADDR_TWSR) = TWI_STATUS_IDLE;
+	REG(ADDR_UCSRA) = HOST_uartStatus();
+	memcpy(g_shadow, g_registers.bytes, sizeof(g_shadow));
+	g_intLevels = (HOST_resolvePort(HOST_PORTD) >> PD2) & 0x03;
+	HOST_getEeprom();
+	for(model = g_models; model != NULL; model = model->next)
+	{
+		model->wakeCycle = 0;
+	}
+	g_firmwareStarted = FALSE;
+	g_firmwareFinished = FALSE;
+	g_runLimit = HOST_NEVER;
+	HOST_schedule();
+}
+
+void HOST_start(int (*entry)(void))
+{
+	if(g_firmwareStack == NULL)
+	{
+		g_firmwareStack = malloc(FIRMWARE_STACK_SIZE);
+		if(g_firmwareStack == NULL)
+		{
+			HOST_fail("no memory for the firmware stack");
+		}
+	}
+	getcontext(&g_firmwareContext);
+	g_firmwareContext.uc_stack.ss_sp = g_firmwareStack;
+	g_firmwareContext.uc_stack.ss_size = FIRMWARE_STACK_SIZE;
+	g_firmwareContext.uc_link = &g_hostContext;
+	makecontext(&g_firmwareContext, HOST_firmwareRun, 0);
+	g_firmwareEntry = entry;
+	g_firmwareStarted = TRUE;
+	g_firmwareFinished = FALSE;
+}
+
+boolean HOST_runUntil(uint64 cycle)
+{
+	if(!g_firmwareStarted || g_firmwareFinished)
+	{
+		return FALSE;
+	}
+	if(cycle > g_now)
+	{
+		g_runLimit = cycle;
+		g_inFirmware = TRUE;
+		swapcontext(&g_hostContext, &g_firmwareContext);
+		g_inFirmware = FALSE;
+		g_runLimit = HOST_NEVER;
+	}
+	return !g_firmwareFinished;
+}
+
+boolean HOST_runForMs(uint32 ms)
+{
+	return HOST_runUntil(g_now + HOST_msToCycles(ms));
+}
+
+uint64 HOST_getCycles(void)
+{
+	return g_now;
+}
+
+uint64 HOST_getTimeNs(void)
+{
+	return HOST_cyclesToNs(g_now);
+}
+
+uint64 HOST_msToCycles(uint32 ms)
+{
+	return (uint64)ms * ((F_CPU) / 1000UL);
+}
+
+uint64 HOST_nsToCycles(uint64 ns)
+{
+	return (ns * HOST_MHZ) / 1000ULL;
+}
+
+uint64 HOST_cyclesToNs(uint64 cycles)
+{
+	return (cycles * 1000ULL) / HOST_MHZ;
+}
+
+void HOST_cpuCycles(uint32 cycles)
+{
+	HOST_commit();
+	HOST_advance(cycles, TRUE);
+}
+
+uint8 HOST_peek(uint8 address)
+{
+	if(address < ADDR_FIRST || address >= REGISTERS_SIZE)
+	{
+		return 0;
+	}
+	return g_shadow[address];
+}
+
+uint32 HOST_getInterruptCount(HOST_VectorType vector)
+{
+	return (vector < HOST_VECTORS_NUM) ? g_interruptCounts[vector] : 0;
+}
+
+void HOST_addModel(HOST_ModelType *model)
+{
+	HOST_ModelType **last = &g_models;
+	while(*last != NULL)
+	{
+		last = &(*last)->next;
+	}
+	model->next = NULL;
+	model->wakeCycle = g_now;
+	*last = model;
+	HOST_schedule();
+}
+
+void HOST_wakeModel(HOST_ModelType *model, uint64 cycle)
+{
+	if(cycle < g_now)
+	{
+		cycle = g_now;
+	}
+	if(cycle < model->wakeCycle)
+	{
+		model->wakeCycle = cycle;
+		if(cycle < g_nextEvent)
+		{
+			g_nextEvent = cycle;
+		}
+	}
+}
+
+void HOST_pinsChanged(void)
+{
+	uint8 levels = (HOST_resolvePort(HOST_PORTD) >> PD2) & 0x03;
+	uint8 changed = levels ^ g_intLevels;
+	uint8 mcucr = REG(ADDR_MCUCR);
+	uint8 sense;
+	uint8 id;
+	for(id = 0; id < 2; id++)
+	{
+		if(changed & (1 << id))
+		{
+			/* ISC 1: any change, 2: falling edge, 3: rising edge (0: low level, not latched) */
+			sense = (mcucr >> (2 * id)) & 0x03;
+			if(sense == 1 || (sense == 2 && !(levels & (1 << id))) || (sense == 3 && (levels & (1 << id))))
+			{
+				g_intFlags |= (id == 0) ? (1 << INTF0) : (1 << INTF1);
+			}
+		}
+	}
+	g_intLevels = levels;
+	g_checkInterrupts = TRUE;
+}
+
+uint8 HOST_getPortDirection(uint8 port)
+{
+	return g_shadow[ADDR_DDR(port)];
+}
+
+uint8 HOST_getPortOutput(uint8 port)
+{
+	return g_shadow[ADDR_PORT(port)] & g_shadow[ADDR_DDR(port)];
+}
+
+uint8 HOST_getPinLevels(uint8 port)
+{
+	return HOST_resolvePort(port);
+}
+
+uint16 HOST_getOc0Duty(void)
+{
+	HOST_TimerShapeType shape;
+	uint8 control = g_shadow[ADDR_TCCR0];
+	uint16 compare = g_shadow[ADDR_OCR0];
+	uint8 mode = (((control >> WGM01) & 1) << 1) | ((control >> WGM00) & 1);
+	if(BIT_IS_CLEAR(g_shadow[ADDR_DDR(HOST_PORTB)], PB3))
+	{
+		return 0;
+	}
+	HOST_timerShape(0, &shape);
+	if(shape.compareOutput == 0)
+	{
+		return (g_shadow[ADDR_PORT(HOST_PORTB)] & (1 << PB3)) ? 256 : 0;
+	}
+	if(mode == 3)
+	{
+		/* Fast PWM: high from BOTTOM to the match (non-inverting) */
+		return (shape.compareOutput == 2) ? (compare + 1) : (255 - compare);
+	}
+	if(mode == 1)
+	{
+		/* Phase correct PWM */
+		return (shape.compareOutput == 2) ? (uint16)((compare * 256UL) / 255) : (uint16)(256 - (compare * 256UL) / 255);
+	}
+	if(shape.compareOutput == 1 && shape.prescale != 0)
+	{
+		return 128;
+	}
+	return g_timers[0].outputLevel ? 256 : 0;
+}
+
+void HOST_setAnalogInput(uint8 channel, uint16 millivolts)
+{
+	if(channel < HOST_ADC_CHANNELS)
+	{
+		g_adc.inputMv[channel] = millivolts;
+		g_adc.source[channel] = NULL;
+	}
+}
+
+void HOST_setAnalogSource(uint8 channel, HOST_AnalogSource source, void *context)
+{
+	if(channel < HOST_ADC_CHANNELS)
+	{
+		g_adc.source[channel] = source;
+		g_adc.sourceContext[channel] = context;
+	}
+}
+
+void HOST_setUartTx(HOST_UartTxCallBack callBack, void *context)
+{
+	g_uart.txCallBack = callBack;
+	g_uart.txContext = context;
+}
+
+boolean HOST_uartReceive(uint8 data, uint8 status)
+{
+	if(BIT_IS_CLEAR(REG(ADDR_UCSRB), RXEN))
+	{
+		return FALSE;
+	}
+	if(g_uart.rxCount == 2)
+	{
+		/* The FIFO and the shift register are full: the new frame is lost */
+		g_uart.rxOverrun = TRUE;
+		return FALSE;
+	}
+	g_uart.rxData[g_uart.rxCount] = data;
+	g_uart.rxStatus[g_uart.rxCount] = status & ((1 << FE) | (1 << PE));
+	g_uart.rxCount++;
+	g_checkInterrupts = TRUE;
+	return TRUE;
+}
+
+uint32 HOST_getUartBitCycles(void)
+{
+	uint32 ubrr = ((uint32)(g_shadow[ADDR_UBRRH] & 0x0F) << 8) | g_shadow[ADDR_UBRRL];
+	return ((g_uart.control & (1 << U2X)) ? 8UL : 16UL) * (ubrr + 1);
+}
+
+uint8 HOST_getUartFrameBits(void)
+{
+	uint8 data_bits;
+	uint8 parity;
+	uint8 stop_bits;
+	HOST_getUartFormat(&data_bits, &parity, &stop_bits);
+	/* Start bit, data bits, parity bit, stop bits */
+	return 1 + data_bits + ((parity != 0) ? 1 : 0) + stop_bits;
+}
+
+void HOST_getUartFormat(uint8 *dataBits, uint8 *parity, uint8 *stopBits)
+{
+	uint8 format = g_shadow[ADDR_UCSRC];
+	uint8 size = (((g_shadow[ADDR_UCSRB] >> UCSZ2) & 1) << 2) | ((format >> UCSZ0) & 0x03);
+	*dataBits = (size == 7) ? 9 : ((size > 3) ? 8 : (5 + size));
+	*parity = (format >> UPM0) & 0x03;
+	*stopBits = 1 + ((format >> USBS) & 1);
+}
+
+void HOST_addTwiDevice(HOST_TwiDeviceType *device)
+{
+	device->next = g_twi.devices;
+	g_twi.devices = device;
+}
+
+uint8 *HOST_getEeprom(void)
+{
+	if(!g_eepromErased)
+	{
+		memset(g_eeprom, 0xFF, sizeof(g_eeprom));
+		g_eepromErased = TRUE;
+	}
+	return g_eeprom;
+}
+
+/*
+ * Description :
+ * Bounds of the firmware stack (avr/io.h), for the stack monitor
+ */
+uint8_t *HOST_getStackBottom(void)
+{
+	return g_firmwareStack;
+}
+
+uint8_t *HOST_getStackTop(void)
+{
+	return g_firmwareStack + FIRMWARE_STACK_SIZE;
+}
+
+void HOST_fail(const char *message)
+{
+	fprintf(stderr, "host mcu: %s at cycle %llu\n", message, (unsigned long long)g_now);
+	exit(EXIT_FAILURE);
+}
+
+/*******************************************************************************
+ *                           Internal EEPROM                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Access to one EEPROM byte: a read costs 4 cycles, a write its 8.5ms
+ */
+static uint8 *HOST_eepromByte(const void *address, boolean write)
+{
+	HOST_commit();
+	HOST_advance(write ? (uint64)HOST_EEPROM_WRITE_US * HOST_MHZ : 4, TRUE);
+	return &HOST_getEeprom()[(uintptr_t)address % HOST_EEPROM_SIZE];
+}
+
+uint8_t eeprom_read_byte(const uint8_t *address)
+{
+	return *HOST_eepromByte(address, FALSE);
+}
+
+uint16_t eeprom_read_word(const uint16_t *address)
+{
+	const uint8 *bytes = (const uint8 *)address;
+	return eeprom_read_byte(bytes) | (uint16)eeprom_read_byte(bytes + 1) << 8;
+}
+
+uint32_t eeprom_read_dword(const uint32_t *address)
+{
+	const uint16 *words = (const uint16 *)address;
+	return eeprom_read_word(words) | (uint32)eeprom_read_word(words + 1) << 16;
+}
+
+void eeprom_read_block(void *destination, const void *source, size_t size)
+{
+	size_t i;
+	for(i = 0; i < size; i++)
+	{
+		((uint8 *)destination)[i] = eeprom_read_byte((const uint8 *)source + i);
+	}
+}
+
+void eeprom_write_byte(uint8_t *address, uint8_t value)
+{
+	*HOST_eepromByte(address, TRUE) = value;
+}
+
+void eeprom_write_word(uint16_t *address, uint16_t value)
+{
+	eeprom_write_byte((uint8 *)address, (uint8)value);
+	eeprom_write_byte((uint8 *)address + 1, (uint8)(value >> 8));
+}
+
+void eeprom_write_dword(uint32_t *address, uint32_t value)
+{
+	eeprom_write_word((uint16 *)address, (uint16)value);
+	eeprom_write_word((uint16 *)address + 1, (uint16)(value >> 16));
+}
+
+void eeprom_write_block(const void *source, void *destination, size_t size)
+{
+	size_t i;
+	for(i = 0; i < size; i++)
+	{
+		eeprom_write_byte((uint8 *)destination + i, ((const uint8 *)source)[i]);
+	}
+}
+
+void eeprom_update_byte(uint8_t *address, uint8_t value)
+{
+	if(eeprom_read_byte(address) != value)
+	{
+		eeprom_write_byte(address, value);
+	}
+}
+
+void eeprom_update_word(uint16_t *address, uint16_t value)
+{
+	eeprom_update_byte((uint8 *)address, (uint8)value);
+	eeprom_update_byte((uint8 *)address + 1, (uint8)(value >> 8));
+}
+
+void eeprom_update_dword(uint32_t *address, uint32_t value)
+{
+	eeprom_update_word((uint16 *)address, (uint16)value);
+	eeprom_update_word((uint16 *)address + 1, (uint16)(value >> 16));
+}
+
+void eeprom_update_block(const void *source, void *destination, size_t size)
+{
+	size_t i;
+	for(i = 0; i < size; i++)
+	{
+		eeprom_update_byte((uint8 *)destination + i, ((const uint8 *)source)[i]);
+	}
+}
@@ -0,0 +1,272 @@
+ /******************************************************************************
+ *
+ * Module: Host MCU
+ *
+ * File Name: host_mcu.h
+ *
+ * Description: Header file for the host build MCU: a fake ATmega32 register layer
+ *              with its peripherals (ports, timers, USART, TWI, ADC, INT0/INT1)
+ *              run by a virtual clock, and the hooks of the device models
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef HOST_MCU_H_
+#define HOST_MCU_H_
+
+#include "std_types.h"
+
+/*
+ * Virtual time only moves with what the firmware does:
+ * - a register access costs HOST_ACCESS_CYCLES and a function call HOST_CALL_CYCLES
+ *   (the firmware objects are built with -finstrument-functions),
+ * - _delay_ms()/_delay_us() and the internal EEPROM writes cost their whole time,
+ * - an interrupt entry and its reti cost HOST_INTERRUPT_CYCLES.
+ * The code between two of these costs nothing, so the clock is exact for every
+ * timing made of delays, waits on flags and peripheral events, and only an estimate
+ * for pure computations.
+ *
+ * Register writes are seen at the next register access (or call, delay, sei/cli):
+ * a write of the value already read back has no effect, except for UDR (any access
+ * without a received byte is a transmit) and TWCR (a marker bit makes every full
+ * write visible). The write-one-to-clear flags of TIFR, GIFR and ADCSRA (ADIF)
+ * read as 0: their interrupts are modeled, polling them is not.
+ */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define HOST_ACCESS_CYCLES         1
+#define HOST_CALL_CYCLES           8
+#define HOST_INTERRUPT_CYCLES      10
+
+#define HOST_NEVER                 0xFFFFFFFFFFFFFFFFULL
+
+/* Port indexes of the models hooks */
+#define HOST_PORTA                 0
+#define HOST_PORTB                 1
+#define HOST_PORTC                 2
+#define HOST_PORTD                 3
+#define HOST_PORTS_NUM             4
+
+#define HOST_ADC_CHANNELS          8
+#define HOST_ADC_REF_MV            5000 /* AVCC */
+
+#define HOST_EEPROM_SIZE           1024
+#define HOST_EEPROM_WRITE_US       8500
+
+/* Interrupt vectors, in priority order (vector number - 1) */
+typedef enum
+{
+	HOST_VECTOR_INT0, HOST_VECTOR_INT1, HOST_VECTOR_INT2, HOST_VECTOR_TIMER2_COMP,
+	HOST_VECTOR_TIMER2_OVF, HOST_VECTOR_TIMER1_CAPT, HOST_VECTOR_TIMER1_COMPA,
+	HOST_VECTOR_TIMER1_COMPB, HOST_VECTOR_TIMER1_OVF, HOST_VECTOR_TIMER0_COMP,
+	HOST_VECTOR_TIMER0_OVF, HOST_VECTOR_SPI_STC, HOST_VECTOR_USART_RXC,
+	HOST_VECTOR_USART_UDRE, HOST_VECTOR_USART_TXC, HOST_VECTOR_ADC, HOST_VECTOR_EE_RDY,
+	HOST_VECTOR_ANA_COMP, HOST_VECTOR_TWI, HOST_VECTOR_SPM_RDY, HOST_VECTORS_NUM
+}HOST_VectorType;
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/*
+ * A device model wired to the MCU pins, every hook can be NULL.
+ * The hooks are called from the virtual clock, in the firmware context.
+ */
+typedef struct HOST_Model
+{
+	void *context;
+	/* The MCU changed the output level or the direction of pins of the port */
+	void (*portWritten)(void *context, uint8 port);
+	/* Return the levels of the port input pins, the pins the model does not drive are returned unchanged */
+	uint8 (*resolvePins)(void *context, uint8 port, uint8 levels);
+	/* The virtual clock reached the cycle asked for, return the next one (HOST_NEVER for none) */
+	uint64 (*advance)(void *context, uint64 now);
+	/* Private to host_mcu.c */
+	uint64 wakeCycle;
+	struct HOST_Model *next;
+}HOST_ModelType;
+
+/*
+ * A TWI slave device, every hook can be NULL.
+ */
+typedef struct HOST_TwiDevice
+{
+	void *context;
+	/* SLA+R/W was sent: return TRUE to acknowledge it (the device is addressed) */
+	boolean (*select)(void *context, uint8 address, boolean read);
+	/* The master sent a data byte to the addressed device, return TRUE to acknowledge it */
+	boolean (*write)(void *context, uint8 data);
+	/* The master reads a data byte, ack tells if it acknowledges it (more bytes follow) */
+	uint8 (*read)(void *context, boolean ack);
+	/* A STOP condition ended the transfer */
+	void (*stop)(void *context);
+	/* Private to host_mcu.c */
+	struct HOST_TwiDevice *next;
+}HOST_TwiDeviceType;
+
+/* Called when a frame starts on TXD, endCycle is the end of its stop bit */
+typedef void (*HOST_UartTxCallBack)(void *context, uint8 data, uint64 endCycle);
+
+/* Analog input of an ADC channel in mV, read at every sample */
+typedef uint16 (*HOST_AnalogSource)(void *context, uint8 channel);
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Power-on reset of the MCU: registers, peripherals and the virtual clock.
+ * Models, TWI devices and the internal EEPROM are kept.
+ */
+void HOST_init(void);
+
+/*
+ * Description :
+ * Start the firmware main function in its own context (stack), it runs when
+ * HOST_runUntil() is called and stops again at the required cycle.
+ */
+void HOST_start(int (*entry)(void));
+
+/*
+ * Description :
+ * Run the firmware until the virtual clock reaches the given cycle.
+ * Returns FALSE if the firmware main function returned.
+ */
+boolean HOST_runUntil(uint64 cycle);
+
+/*
+ * Description :
+ * Run the firmware for the given time.
+ */
+boolean HOST_runForMs(uint32 ms);
+
+/*
+ * Description :
+ * Virtual clock in CPU cycles and in ns.
+ */
+uint64 HOST_getCycles(void);
+uint64 HOST_getTimeNs(void);
+
+/*
+ * Description :
+ * Convert a time in ms or ns to CPU cycles.
+ */
+uint64 HOST_msToCycles(uint32 ms);
+uint64 HOST_nsToCycles(uint64 ns);
+
+/*
+ * Description :
+ * Convert CPU cycles to a time in ns.
+ */
+uint64 HOST_cyclesToNs(uint64 cycles);
+
+/*
+ * Description :
+ * Run the virtual clock for the given cycles, from a test calling the drivers
+ * directly (no firmware context): events and interrupts are processed.
+ */
+void HOST_cpuCycles(uint32 cycles);
+
+/*
+ * Description :
+ * Read a register without any side effect (address as in avr/io.h).
+ */
+uint8 HOST_peek(uint8 address);
+
+/*
+ * Description :
+ * Number of times each interrupt vector was taken since HOST_init().
+ */
+uint32 HOST_getInterruptCount(HOST_VectorType vector);
+
+/*
+ * Description :
+ * Add a device model, its advance hook is first called at the current cycle.
+ */
+void HOST_addModel(HOST_ModelType *model);
+
+/*
+ * Description :
+ * Ask for the advance hook of the model at the given cycle (or earlier).
+ */
+void HOST_wakeModel(HOST_ModelType *model, uint64 cycle);
+
+/*
+ * Description :
+ * A model changed what it drives on the pins: the pin levels and the external
+ * interrupts are updated.
+ */
+void HOST_pinsChanged(void);
+
+/*
+ * Description :
+ * Pins state of a port: the output pins (DDR), their level (PORT) and the level read (PIN).
+ */
+uint8 HOST_getPortDirection(uint8 port);
+uint8 HOST_getPortOutput(uint8 port);
+uint8 HOST_getPinLevels(uint8 port);
+
+/*
+ * Description :
+ * Duty cycle of the OC0 pin (PB3) in 1/256, 256 when always high.
+ */
+uint16 HOST_getOc0Duty(void);
+
+/*
+ * Description :
+ * Set the analog input of an ADC channel to a fixed level or to a source read at every sample.
+ */
+void HOST_setAnalogInput(uint8 channel, uint16 millivolts);
+void HOST_setAnalogSource(uint8 channel, HOST_AnalogSource source, void *context);
+
+/*
+ * Description :
+ * Connect the USART transmitter (TXD) to a receiver.
+ */
+void HOST_setUartTx(HOST_UartTxCallBack callBack, void *context);
+
+/*
+ * Description :
+ * A frame ended on RXD: queue it in the receiver, status gives its FE and PE bits.
+ * Returns FALSE if the receiver is off or if the frame was lost (overrun).
+ */
+boolean HOST_uartReceive(uint8 data, uint8 status);
+
+/*
+ * Description :
+ * Time of one bit and number of bits of a frame, from the USART configuration.
+ */
+uint32 HOST_getUartBitCycles(void);
+uint8 HOST_getUartFrameBits(void);
+
+/*
+ * Description :
+ * Frame format from the USART configuration, parity as the UPM bits (0 none, 2 even, 3 odd).
+ */
+void HOST_getUartFormat(uint8 *dataBits, uint8 *parity, uint8 *stopBits);
+
+/*
+ * Description :
+ * Add a slave device on the TWI bus.
+ */
+void HOST_addTwiDevice(HOST_TwiDeviceType *device);
+
+/*
+ * Description :
+ * The internal EEPROM bytes, erased to 0xFF at start up.
+ */
+uint8 *HOST_getEeprom(void);
+
+/*
+ * Description :
+ * Print a message and stop the program: the firmware did something the host
+ * MCU cannot run (an interrupt without ISR resets the chip).
+ */
+void HOST_fail(const char *message);
+
+#endif /* HOST_MCU_H_ */
@@ -0,0 +1,49 @@
+ /******************************************************************************
+ *
+ * Module: Host - AVR EEPROM
+ *
+ * File Name: eeprom.h
+ *
+ * Description: Internal EEPROM functions for the host build, the 1KB EEPROM is
+ *              kept by host_mcu.c and a written byte takes 8.5ms of virtual time
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef HOST_AVR_EEPROM_H_
+#define HOST_AVR_EEPROM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define EEMEM
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+uint8_t eeprom_read_byte(const uint8_t *address);
+uint16_t eeprom_read_word(const uint16_t *address);
+uint32_t eeprom_read_dword(const uint32_t *address);
+void eeprom_read_block(void *destination, const void *source, size_t size);
+
+void eeprom_write_byte(uint8_t *address, uint8_t value);
+void eeprom_write_word(uint16_t *address, uint16_t value);
+void eeprom_write_dword(uint32_t *address, uint32_t value);
+void eeprom_write_block(const void *source, void *destination, size_t size);
+
+/* Only the bytes that differ are written, like avr-libc */
+void eeprom_update_byte(uint8_t *address, uint8_t value);
+void eeprom_update_word(uint16_t *address, uint16_t value);
+void eeprom_update_dword(uint32_t *address, uint32_t value);
+void eeprom_update_block(const void *source, void *destination, size_t size);
+
+#define eeprom_is_ready()        1
+#define eeprom_busy_wait()       do {} while (0)
+
+#endif /* HOST_AVR_EEPROM_H_ */
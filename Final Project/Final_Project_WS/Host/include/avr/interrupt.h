@@ -0,0 +1,37 @@
+ /******************************************************************************
+ *
+ * Module: Host - AVR Interrupts
+ *
+ * File Name: interrupt.h
+ *
+ * Description: ISR(), sei() and cli() for the host build, the interrupts are
+ *              raised and dispatched by the virtual clock of host_mcu.c
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef HOST_AVR_INTERRUPT_H_
+#define HOST_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * An ISR is a plain function named after its vector: the host core calls the
+ * ones the firmware defines (weak references) with the I-bit cleared, like the chip.
+ */
+#define ISR(vector, ...)         void vector(void); void vector(void)
+#define EMPTY_INTERRUPT(vector)  void vector(void); void vector(void) {}
+#define reti()                   return
+
+#define sei()                    HOST_setInterrupts(1)
+#define cli()                    HOST_setInterrupts(0)
+
+/* Set or clear the I-bit of SREG, a pending interrupt is taken right after sei() */
+void HOST_setInterrupts(uint8_t enable);
+
+#endif /* HOST_AVR_INTERRUPT_H_ */
@@ -0,0 +1,352 @@
+ /******************************************************************************
+ *
+ * Module: Host - AVR I/O
+ *
+ * File Name: io.h
+ *
+ * Description: ATmega32 register names for the host build, every register
+ *              access goes through the fake register layer of host_mcu.c
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef HOST_AVR_IO_H_
+#define HOST_AVR_IO_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+ *                          Fake Register Layer                                *
+ *******************************************************************************/
+
+/*
+ * Each register name is a call that returns the register cell: the call runs the
+ * virtual clock and the peripherals up to this access and loads the value to read,
+ * the store or read-modify-write through the cell is handled at the next access.
+ * Addresses are the ATmega32 data memory addresses (I/O address + 0x20).
+ */
+volatile uint8_t *HOST_access8(uint8_t address);
+volatile uint16_t *HOST_access16(uint8_t address);
+
+#define _SFR_MEM8(address)       (*HOST_access8(address))
+#define _SFR_MEM16(address)      (*HOST_access16(address))
+#define _SFR_IO8(address)        _SFR_MEM8((address) + 0x20)
+#define _SFR_IO16(address)       _SFR_MEM16((address) + 0x20)
+
+/* UCSRC shares its address with UBRRH on the chip (selected by URSEL), it has its own host address */
+#define HOST_UCSRC_ADDRESS       0x60
+
+/*******************************************************************************
+ *                               Registers                                     *
+ *******************************************************************************/
+
+/* TWI */
+#define TWBR    _SFR_IO8(0x00)
+#define TWSR    _SFR_IO8(0x01)
+#define TWAR    _SFR_IO8(0x02)
+#define TWDR    _SFR_IO8(0x03)
+#define TWCR    _SFR_IO8(0x36)
+
+/* ADC */
+#define ADC     _SFR_IO16(0x04)
+#define ADCW    _SFR_IO16(0x04)
+#define ADCL    _SFR_IO8(0x04)
+#define ADCH    _SFR_IO8(0x05)
+#define ADCSRA  _SFR_IO8(0x06)
+#define ADMUX   _SFR_IO8(0x07)
+
+/* Analog comparator */
+#define ACSR    _SFR_IO8(0x08)
+
+/* USART */
+#define UBRRL   _SFR_IO8(0x09)
+#define UCSRB   _SFR_IO8(0x0A)
+#define UCSRA   _SFR_IO8(0x0B)
+#define UDR     _SFR_IO8(0x0C)
+#define UBRRH   _SFR_IO8(0x20)
+#define UCSRC   _SFR_MEM8(HOST_UCSRC_ADDRESS)
+
+/* SPI */
+#define SPCR    _SFR_IO8(0x0D)
+#define SPSR    _SFR_IO8(0x0E)
+#define SPDR    _SFR_IO8(0x0F)
+
+/* Ports */
+#define PIND    _SFR_IO8(0x10)
+#define DDRD    _SFR_IO8(0x11)
+#define PORTD   _SFR_IO8(0x12)
+#define PINC    _SFR_IO8(0x13)
+#define DDRC    _SFR_IO8(0x14)
+#define PORTC   _SFR_IO8(0x15)
+#define PINB    _SFR_IO8(0x16)
+#define DDRB    _SFR_IO8(0x17)
+#define PORTB   _SFR_IO8(0x18)
+#define PINA    _SFR_IO8(0x19)
+#define DDRA    _SFR_IO8(0x1A)
+#define PORTA   _SFR_IO8(0x1B)
+
+/* Internal EEPROM (the host eeprom_* functions do not use them) */
+#define EECR    _SFR_IO8(0x1C)
+#define EEDR    _SFR_IO8(0x1D)
+#define EEAR    _SFR_IO16(0x1E)
+#define EEARL   _SFR_IO8(0x1E)
+#define EEARH   _SFR_IO8(0x1F)
+
+/* Timers */
+#define WDTCR   _SFR_IO8(0x21)
+#define ASSR    _SFR_IO8(0x22)
+#define OCR2    _SFR_IO8(0x23)
+#define TCNT2   _SFR_IO8(0x24)
+#define TCCR2   _SFR_IO8(0x25)
+#define ICR1    _SFR_IO16(0x26)
+#define OCR1B   _SFR_IO16(0x28)
+#define OCR1A   _SFR_IO16(0x2A)
+#define TCNT1   _SFR_IO16(0x2C)
+#define TCCR1B  _SFR_IO8(0x2E)
+#define TCCR1A  _SFR_IO8(0x2F)
+#define SFIOR   _SFR_IO8(0x30)
+#define OSCCAL  _SFR_IO8(0x31)
+#define TCNT0   _SFR_IO8(0x32)
+#define TCCR0   _SFR_IO8(0x33)
+#define MCUCSR  _SFR_IO8(0x34)
+#define MCUCR   _SFR_IO8(0x35)
+#define TIFR    _SFR_IO8(0x38)
+#define TIMSK   _SFR_IO8(0x39)
+#define GIFR    _SFR_IO8(0x3A)
+#define GICR    _SFR_IO8(0x3B)
+#define OCR0    _SFR_IO8(0x3C)
+
+/* CPU */
+#define SPL     _SFR_IO8(0x3D)
+#define SPH     _SFR_IO8(0x3E)
+#define SREG    _SFR_IO8(0x3F)
+
+/*******************************************************************************
+ *                                Register Bits                                *
+ *******************************************************************************/
+
+/* TWCR */
+#define TWINT   7
+#define TWEA    6
+#define TWSTA   5
+#define TWSTO   4
+#define TWWC    3
+#define TWEN    2
+#define TWIE    0
+
+/* TWSR */
+#define TWS7    7
+#define TWS6    6
+#define TWS5    5
+#define TWS4    4
+#define TWS3    3
+#define TWPS1   1
+#define TWPS0   0
+
+/* TWAR */
+#define TWGCE   0
+
+/* ADMUX */
+#define REFS1   7
+#define REFS0   6
+#define ADLAR   5
+#define MUX4    4
+#define MUX3    3
+#define MUX2    2
+#define MUX1    1
+#define MUX0    0
+
+/* ADCSRA */
+#define ADEN    7
+#define ADSC    6
+#define ADATE   5
+#define ADIF    4
+#define ADIE    3
+#define ADPS2   2
+#define ADPS1   1
+#define ADPS0   0
+
+/* UCSRA */
+#define RXC     7
+#define TXC     6
+#define UDRE    5
+#define FE      4
+#define DOR     3
+#define PE      2
+#define U2X     1
+#define MPCM    0
+
+/* UCSRB */
+#define RXCIE   7
+#define TXCIE   6
+#define UDRIE   5
+#define RXEN    4
+#define TXEN    3
+#define UCSZ2   2
+#define RXB8    1
+#define TXB8    0
+
+/* UCSRC */
+#define URSEL   7
+#define UMSEL   6
+#define UPM1    5
+#define UPM0    4
+#define USBS    3
+#define UCSZ1   2
+#define UCSZ0   1
+#define UCPOL   0
+
+/* Port pins */
+#define PA7     7
+#define PA6     6
+#define PA5     5
+#define PA4     4
+#define PA3     3
+#define PA2     2
+#define PA1     1
+#define PA0     0
+#define PB7     7
+#define PB6     6
+#define PB5     5
+#define PB4     4
+#define PB3     3
+#define PB2     2
+#define PB1     1
+#define PB0     0
+#define PC7     7
+#define PC6     6
+#define PC5     5
+#define PC4     4
+#define PC3     3
+#define PC2     2
+#define PC1     1
+#define PC0     0
+#define PD7     7
+#define PD6     6
+#define PD5     5
+#define PD4     4
+#define PD3     3
+#define PD2     2
+#define PD1     1
+#define PD0     0
+
+/* TCCR2 */
+#define FOC2    7
+#define WGM20   6
+#define COM21   5
+#define COM20   4
+#define WGM21   3
+#define CS22    2
+#define CS21    1
+#define CS20    0
+
+/* TCCR1A */
+#define COM1A1  7
+#define COM1A0  6
+#define COM1B1  5
+#define COM1B0  4
+#define FOC1A   3
+#define FOC1B   2
+#define WGM11   1
+#define WGM10   0
+
+/* TCCR1B */
+#define ICNC1   7
+#define ICES1   6
+#define WGM13   4
+#define WGM12   3
+#define CS12    2
+#define CS11    1
+#define CS10    0
+
+/* SFIOR */
+#define ADTS2   7
+#define ADTS1   6
+#define ADTS0   5
+#define ACME    3
+#define PUD     2
+#define PSR2    1
+#define PSR10   0
+
+/* TCCR0 */
+#define FOC0    7
+#define WGM00   6
+#define COM01   5
+#define COM00   4
+#define WGM01   3
+#define CS02    2
+#define CS01    1
+#define CS00    0
+
+/* MCUCSR */
+#define JTD     7
+#define ISC2    6
+#define JTRF    4
+#define WDRF    3
+#define BORF    2
+#define EXTRF   1
+#define PORF    0
+
+/* MCUCR */
+#define SE      7
+#define SM2     6
+#define SM1     5
+#define SM0     4
+#define ISC11   3
+#define ISC10   2
+#define ISC01   1
+#define ISC00   0
+
+/* TIFR */
+#define OCF2    7
+#define TOV2    6
+#define ICF1    5
+#define OCF1A   4
+#define OCF1B   3
+#define TOV1    2
+#define OCF0    1
+#define TOV0    0
+
+/* TIMSK */
+#define OCIE2   7
+#define TOIE2   6
+#define TICIE1  5
+#define OCIE1A  4
+#define OCIE1B  3
+#define TOIE1   2
+#define OCIE0   1
+#define TOIE0   0
+
+/* GIFR */
+#define INTF1   7
+#define INTF0   6
+#define INTF2   5
+
+/* GICR */
+#define INT1    7
+#define INT0    6
+#define INT2    5
+#define IVSEL   1
+#define IVCE    0
+
+/* SREG */
+#define SREG_I  7
+
+/*******************************************************************************
+ *                                 Memory                                      *
+ *******************************************************************************/
+
+#define RAMSTART     0x60
+#define RAMEND       0x85F
+#define E2END        0x3FF
+#define FLASHEND     0x7FFF
+
+/*
+ * The firmware runs on its own stack (host_mcu.c) and not in the RAM above:
+ * its first byte and the byte after its last one, it grows down from the top.
+ */
+uint8_t *HOST_getStackBottom(void);
+uint8_t *HOST_getStackTop(void);
+
+#endif /* HOST_AVR_IO_H_ */
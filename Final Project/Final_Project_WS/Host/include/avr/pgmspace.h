@@ -0,0 +1,37 @@
+ /******************************************************************************
+ *
+ * Module: Host - AVR Program Space
+ *
+ * File Name: pgmspace.h
+ *
+ * Description: Flash access macros for the host build, where constants are in RAM
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef HOST_AVR_PGMSPACE_H_
+#define HOST_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define PROGMEM
+#define PGM_P                    const char *
+#define PGM_VOID_P               const void *
+#define PSTR(s)                  (s)
+
+#define pgm_read_byte(address)   (*(const uint8_t *)(address))
+#define pgm_read_word(address)   (*(const uint16_t *)(address))
+#define pgm_read_dword(address)  (*(const uint32_t *)(address))
+#define pgm_read_ptr(address)    (*(void * const *)(address))
+
+#define memcpy_P                 memcpy
+#define strlen_P                 strlen
+#define strcmp_P                 strcmp
+
+#endif /* HOST_AVR_PGMSPACE_H_ */
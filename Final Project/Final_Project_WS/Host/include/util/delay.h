@@ -0,0 +1,34 @@
+ /******************************************************************************
+ *
+ * Module: Host - AVR Delays
+ *
+ * File Name: delay.h
+ *
+ * Description: Busy-wait delays for the host build, they run the virtual clock
+ *              of host_mcu.c instead of the wall clock
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef HOST_UTIL_DELAY_H_
+#define HOST_UTIL_DELAY_H_
+
+#ifndef F_CPU
+#error "F_CPU must be defined for util/delay.h"
+#endif
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Interrupts are still taken during the delay, like on the chip */
+#define _delay_ms(ms)            HOST_delayCycles((double)(ms) * ((F_CPU) / 1e3))
+#define _delay_us(us)            HOST_delayCycles((double)(us) * ((F_CPU) / 1e6))
+#define _delay_loop_1(count)     HOST_delayCycles((double)(count) * 3)
+#define _delay_loop_2(count)     HOST_delayCycles((double)(count) * 4)
+
+/* Run the virtual clock for the given CPU cycles (rounded up, at least 1) */
+void HOST_delayCycles(double cycles);
+
+#endif /* HOST_UTIL_DELAY_H_ */
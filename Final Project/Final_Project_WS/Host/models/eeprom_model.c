@@ -0,0 +1,129 @@
+ /******************************************************************************
+ *
+ * Module: EEPROM Model
+ *
+ * File Name: eeprom_model.c
+ *
+ * Description: Source file for the host model of the 24C16 I2C EEPROM
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "eeprom_model.h"
+#include <string.h>
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static boolean EepromModel_select(void *context, uint8 address, boolean read);
+static boolean EepromModel_write(void *context, uint8 data);
+static uint8 EepromModel_read(void *context, boolean ack);
+static void EepromModel_stop(void *context);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Put the EEPROM on the TWI bus, erased (0xFF).
+ */
+void EepromModel_init(EepromModel_Type *eeprom)
+{
+	memset(eeprom, 0, sizeof(*eeprom));
+	memset(eeprom->memory, 0xFF, sizeof(eeprom->memory));
+	eeprom->device.context = eeprom;
+	eeprom->device.select = EepromModel_select;
+	eeprom->device.write = EepromModel_write;
+	eeprom->device.read = EepromModel_read;
+	eeprom->device.stop = EepromModel_stop;
+	HOST_addTwiDevice(&eeprom->device);
+}
+
+/*
+ * Description :
+ * SLA+R/W: the block bits are the high bits of the address. No ACK during a write cycle.
+ */
+static boolean EepromModel_select(void *context, uint8 address, boolean read)
+{
+	EepromModel_Type *eeprom = context;
+	if((address & 0x78) != EEPROM_MODEL_ADDRESS)
+	{
+		return FALSE;
+	}
+	if(HOST_getCycles() < eeprom->busy_until)
+	{
+		eeprom->busy_naks++;
+		return FALSE;
+	}
+	if(!read)
+	{
+		eeprom->address = (uint16)((address & 0x07) << 8) | (eeprom->address & 0xFF);
+		eeprom->word_address_next = TRUE;
+		eeprom->page_mask = 0;
+	}
+	return TRUE;
+}
+
+/*
+ * Description :
+ * The first byte is the word address, the next ones are loaded in the page
+ * buffer (rolling over inside the page) and written at the STOP
+ */
+static boolean EepromModel_write(void *context, uint8 data)
+{
+	EepromModel_Type *eeprom = context;
+	uint8 offset;
+	if(eeprom->word_address_next)
+	{
+		eeprom->address = (eeprom->address & 0x0700) | data;
+		eeprom->word_address_next = FALSE;
+		return TRUE;
+	}
+	offset = eeprom->address % EEPROM_MODEL_PAGE_SIZE;
+	eeprom->page[offset] = data;
+	eeprom->page_mask |= (uint16)(1 << offset);
+	eeprom->address = (eeprom->address & ~(EEPROM_MODEL_PAGE_SIZE - 1))
+			| ((offset + 1) % EEPROM_MODEL_PAGE_SIZE);
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Sequential read from the address counter, rolling over the whole memory
+ */
+static uint8 EepromModel_read(void *context, boolean ack)
+{
+	EepromModel_Type *eeprom = context;
+	uint8 data = eeprom->memory[eeprom->address];
+	(void)ack;
+	eeprom->address = (eeprom->address + 1) % EEPROM_MODEL_SIZE;
+	return data;
+}
+
+/*
+ * Description :
+ * A STOP after loaded bytes starts the internal write cycle
+ */
+static void EepromModel_stop(void *context)
+{
+	EepromModel_Type *eeprom = context;
+	uint16 page_start = eeprom->address & ~(EEPROM_MODEL_PAGE_SIZE - 1);
+	uint8 offset;
+	if(eeprom->page_mask == 0)
+	{
+		return;
+	}
+	for(offset = 0; offset < EEPROM_MODEL_PAGE_SIZE; offset++)
+	{
+		if(eeprom->page_mask & (1 << offset))
+		{
+			eeprom->memory[page_start + offset] = eeprom->page[offset];
+		}
+	}
+	eeprom->page_mask = 0;
+	eeprom->write_cycles++;
+	eeprom->busy_until = HOST_getCycles() + HOST_nsToCycles(EEPROM_MODEL_WRITE_NS);
+}
@@ -0,0 +1,53 @@
+ /******************************************************************************
+ *
+ * Module: EEPROM Model
+ *
+ * File Name: eeprom_model.h
+ *
+ * Description: Header file for the host model of the 24C16 I2C EEPROM
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef EEPROM_MODEL_H_
+#define EEPROM_MODEL_H_
+
+#include "host_mcu.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define EEPROM_MODEL_SIZE                2048   /* 8 blocks of 256 bytes, selected by A10..A8 in the SLA */
+#define EEPROM_MODEL_PAGE_SIZE           16
+#define EEPROM_MODEL_ADDRESS             0x50   /* 7-bit device address, 1010 A10 A9 A8 */
+#define EEPROM_MODEL_WRITE_NS            5000000UL
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	HOST_TwiDeviceType device;
+	uint8 memory[EEPROM_MODEL_SIZE];
+	uint16 address;            /* Internal address counter */
+	boolean word_address_next; /* The next byte written is the word address */
+	uint8 page[EEPROM_MODEL_PAGE_SIZE];
+	uint16 page_mask;          /* Bytes of the page loaded since SLA+W */
+	uint64 busy_until;         /* End of the internal write cycle, no ACK before */
+	uint32 write_cycles;
+	uint32 busy_naks;
+}EepromModel_Type;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Put the EEPROM on the TWI bus, erased (0xFF).
+ */
+void EepromModel_init(EepromModel_Type *eeprom);
+
+#endif /* EEPROM_MODEL_H_ */
@@ -0,0 +1,195 @@
+ /******************************************************************************
+ *
+ * Module: H-Bridge Model
+ *
+ * File Name: hbridge_model.c
+ *
+ * Description: Source file for the host model of the door motor: the H-bridge
+ *              with its PWM enable, the motor current on the shunt, the door
+ *              travel and its two limit switches
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "hbridge_model.h"
+#include <string.h>
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void HBridgeModel_update(HBridgeModel_Type *motor);
+static void HBridgeModel_portWritten(void *context, uint8 port);
+static uint8 HBridgeModel_resolvePins(void *context, uint8 port, uint8 levels);
+static uint64 HBridgeModel_advance(void *context, uint64 now);
+static uint16 HBridgeModel_sense(void *context, uint8 channel);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Wire the motor to the MCU pins, the door starts at the given position.
+ */
+void HBridgeModel_init(HBridgeModel_Type *motor, const HBridgeModel_ConfigType *config, uint32 position)
+{
+	memset(motor, 0, sizeof(*motor));
+	motor->config = *config;
+	motor->position = (position > HBRIDGE_MODEL_FULL_TRAVEL) ? HBRIDGE_MODEL_FULL_TRAVEL : position;
+	motor->last_cycle = HOST_getCycles();
+	motor->model.context = motor;
+	motor->model.portWritten = HBridgeModel_portWritten;
+	motor->model.resolvePins = HBridgeModel_resolvePins;
+	motor->model.advance = HBridgeModel_advance;
+	HOST_addModel(&motor->model);
+	HOST_setAnalogSource(config->sense_channel, HBridgeModel_sense, motor);
+}
+
+/*
+ * Description :
+ * Block the door (an obstacle) or free it again.
+ */
+void HBridgeModel_jam(HBridgeModel_Type *motor, boolean jammed)
+{
+	HBridgeModel_update(motor);
+	motor->jammed = jammed;
+	HOST_wakeModel(&motor->model, HOST_getCycles());
+}
+
+/*
+ * Description :
+ * Door position in micro travels, updated to the current cycle.
+ */
+uint32 HBridgeModel_getPosition(HBridgeModel_Type *motor)
+{
+	HBridgeModel_update(motor);
+	return motor->position;
+}
+
+/*
+ * Description :
+ * Move the door with the drive it had since the last update, then read the
+ * drive again: the H-bridge inputs and the EN duty
+ */
+static void HBridgeModel_update(HBridgeModel_Type *motor)
+{
+	const HBridgeModel_ConfigType *config = &motor->config;
+	uint64 cycles_per_us = HOST_nsToCycles(1000);
+	uint64 elapsed_us = (HOST_getCycles() - motor->last_cycle) / cycles_per_us;
+	uint64 travel;
+	uint32 before = motor->position;
+	uint8 inputs;
+	sint8 direction;
+	boolean blocked;
+	/* Whole us only, the rest is counted in the next update */
+	motor->last_cycle += elapsed_us * cycles_per_us;
+	if(motor->direction != 0 && motor->duty != 0 && !motor->jammed)
+	{
+		/* Speed proportional to the duty: full travel in travel_ms at 100% */
+		travel = (elapsed_us * motor->duty * (HBRIDGE_MODEL_FULL_TRAVEL / 1000UL)) / (256ULL * config->travel_ms);
+		if(motor->direction > 0)
+		{
+			motor->position = (motor->position + travel > HBRIDGE_MODEL_FULL_TRAVEL)
+					? HBRIDGE_MODEL_FULL_TRAVEL : (uint32)(motor->position + travel);
+		}
+		else
+		{
+			motor->position = (travel > motor->position) ? 0 : (uint32)(motor->position - travel);
+		}
+		if((before == 0) != (motor->position == 0)
+				|| (before == HBRIDGE_MODEL_FULL_TRAVEL) != (motor->position == HBRIDGE_MODEL_FULL_TRAVEL))
+		{
+			HOST_pinsChanged();
+		}
+		/* A limit switch was pressed or released */
+	}
+	inputs = (HOST_getPortOutput(config->in_port) >> config->in_pin) & 0x03;
+	motor->duty = HOST_getOc0Duty();
+	direction = (inputs == 0x01) ? 1 : ((inputs == 0x02) ? -1 : 0);
+	if(inputs == 0x03 && motor->duty != 0)
+	{
+		motor->shoot_through++;
+	}
+	if(direction != 0 && motor->direction == -direction)
+	{
+		motor->reversals++;
+	}
+	motor->direction = direction;
+	/* Against an end stop or an obstacle the motor draws its stall current */
+	blocked = motor->jammed || (direction > 0 && motor->position == HBRIDGE_MODEL_FULL_TRAVEL)
+			|| (direction < 0 && motor->position == 0);
+	if(direction == 0)
+	{
+		motor->current_ma = 0;
+	}
+	else
+	{
+		motor->current_ma = (uint16)(((uint32)(blocked ? config->stall_ma : config->run_ma) * motor->duty) / 256);
+	}
+}
+
+/*
+ * Description :
+ * The H-bridge inputs changed: update from now on
+ */
+static void HBridgeModel_portWritten(void *context, uint8 port)
+{
+	HBridgeModel_Type *motor = context;
+	if(port == motor->config.in_port)
+	{
+		HBridgeModel_update(motor);
+		HOST_wakeModel(&motor->model, HOST_getCycles());
+	}
+}
+
+/*
+ * Description :
+ * The limit switches pull their pin low when pressed
+ */
+static uint8 HBridgeModel_resolvePins(void *context, uint8 port, uint8 levels)
+{
+	HBridgeModel_Type *motor = context;
+	const HBridgeModel_ConfigType *config = &motor->config;
+	if(port != config->switch_port)
+	{
+		return levels;
+	}
+	if(motor->position == HBRIDGE_MODEL_FULL_TRAVEL)
+	{
+		levels &= (uint8)~(1 << config->open_switch_pin);
+	}
+	if(motor->position == 0)
+	{
+		levels &= (uint8)~(1 << config->closed_switch_pin);
+	}
+	return levels;
+}
+
+/*
+ * Description :
+ * Move the door while the motor runs, the switches change on the way
+ */
+static uint64 HBridgeModel_advance(void *context, uint64 now)
+{
+	HBridgeModel_Type *motor = context;
+	HBridgeModel_update(motor);
+	if(motor->direction == 0)
+	{
+		return HOST_NEVER;
+	}
+	return now + HOST_nsToCycles(HBRIDGE_MODEL_STEP_NS);
+}
+
+/*
+ * Description :
+ * Voltage on the current shunt in mV
+ */
+static uint16 HBridgeModel_sense(void *context, uint8 channel)
+{
+	HBridgeModel_Type *motor = context;
+	(void)channel;
+	HBridgeModel_update(motor);
+	return (uint16)(((uint32)motor->current_ma * motor->config.shunt_milliohm) / 1000UL);
+}
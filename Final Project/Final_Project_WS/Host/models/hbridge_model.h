@@ -0,0 +1,83 @@
+ /******************************************************************************
+ *
+ * Module: H-Bridge Model
+ *
+ * File Name: hbridge_model.h
+ *
+ * Description: Header file for the host model of the door motor: the H-bridge
+ *              with its PWM enable, the motor current on the shunt, the door
+ *              travel and its two limit switches
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef HBRIDGE_MODEL_H_
+#define HBRIDGE_MODEL_H_
+
+#include "host_mcu.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Door position in micro travels: 0 is closed, HBRIDGE_MODEL_FULL_TRAVEL is open */
+#define HBRIDGE_MODEL_FULL_TRAVEL        1000000UL
+
+/* The position, the current and the switches are updated with this period while the motor runs */
+#define HBRIDGE_MODEL_STEP_NS            250000UL
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	uint8 in_port;             /* IN1 on in_pin, IN2 on in_pin + 1, EN on OC0 (PB3) */
+	uint8 in_pin;
+	uint8 switch_port;
+	uint8 open_switch_pin;     /* Pressed (pulled low) when the door is fully open */
+	uint8 closed_switch_pin;   /* Pressed (pulled low) when the door is fully closed */
+	uint8 sense_channel;       /* ADC channel of the current shunt */
+	uint16 shunt_milliohm;
+	uint16 travel_ms;          /* Full travel time at 100% duty */
+	uint16 run_ma;             /* Motor current while moving at 100% duty */
+	uint16 stall_ma;           /* Motor current at 100% duty when it cannot move */
+}HBridgeModel_ConfigType;
+
+typedef struct
+{
+	HOST_ModelType model;
+	HBridgeModel_ConfigType config;
+	uint32 position;
+	sint8 direction;           /* +1 opening (IN1), -1 closing (IN2), 0 stopped or braking */
+	uint16 duty;               /* EN duty in 1/256 */
+	uint16 current_ma;
+	boolean jammed;            /* Injected obstacle: the door cannot move */
+	uint64 last_cycle;
+	uint32 shoot_through;      /* Both inputs high while enabled */
+	uint32 reversals;          /* Direction changes without a stop in between */
+}HBridgeModel_Type;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Wire the motor to the MCU pins, the door starts at the given position.
+ */
+void HBridgeModel_init(HBridgeModel_Type *motor, const HBridgeModel_ConfigType *config, uint32 position);
+
+/*
+ * Description :
+ * Block the door (an obstacle) or free it again.
+ */
+void HBridgeModel_jam(HBridgeModel_Type *motor, boolean jammed);
+
+/*
+ * Description :
+ * Door position in micro travels, updated to the current cycle.
+ */
+uint32 HBridgeModel_getPosition(HBridgeModel_Type *motor);
+
+#endif /* HBRIDGE_MODEL_H_ */
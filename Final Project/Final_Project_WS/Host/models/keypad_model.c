@@ -0,0 +1,104 @@
+ /******************************************************************************
+ *
+ * Module: Keypad Model
+ *
+ * File Name: keypad_model.c
+ *
+ * Description: Source file for the host model of the 4x4 keypad matrix with its
+ *              external column pull-ups
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "keypad_model.h"
+#include <string.h>
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * The columns are pulled up, a pressed button connects its column to its row
+ */
+static uint8 KeypadModel_resolvePins(void *context, uint8 port, uint8 levels);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Wire the keypad to the MCU pins, no button is pressed.
+ */
+void KeypadModel_init(KeypadModel_Type *keypad, const KeypadModel_ConfigType *config)
+{
+	memset(keypad, 0, sizeof(*keypad));
+	keypad->config = *config;
+	keypad->pressed_row = -1;
+	keypad->pressed_col = -1;
+	keypad->model.context = keypad;
+	keypad->model.resolvePins = KeypadModel_resolvePins;
+	HOST_addModel(&keypad->model);
+}
+
+/*
+ * Description :
+ * Hold the button of the given key down until KeypadModel_release().
+ * Returns FALSE for a key that is not on the keypad.
+ */
+boolean KeypadModel_press(KeypadModel_Type *keypad, char key)
+{
+	const char *layout = KEYPAD_MODEL_LAYOUT;
+	const char *button = (key != '\0') ? strchr(layout, key) : NULL;
+	if(button == NULL)
+	{
+		return FALSE;
+	}
+	keypad->pressed_row = (sint8)((button - layout) / KEYPAD_MODEL_COLS);
+	keypad->pressed_col = (sint8)((button - layout) % KEYPAD_MODEL_COLS);
+	keypad->presses++;
+	HOST_pinsChanged();
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Release the pressed button.
+ */
+void KeypadModel_release(KeypadModel_Type *keypad)
+{
+	keypad->pressed_row = -1;
+	keypad->pressed_col = -1;
+	HOST_pinsChanged();
+}
+
+/*
+ * Description :
+ * The columns are pulled up, a pressed button connects its column to its row
+ */
+static uint8 KeypadModel_resolvePins(void *context, uint8 port, uint8 levels)
+{
+	KeypadModel_Type *keypad = context;
+	const KeypadModel_ConfigType *config = &keypad->config;
+	uint8 row_pin;
+	uint8 col_pin;
+	if(port != config->col_port)
+	{
+		return levels;
+	}
+	levels |= (uint8)(((1 << KEYPAD_MODEL_COLS) - 1) << config->first_col_pin);
+	if(keypad->pressed_row >= 0)
+	{
+		row_pin = config->first_row_pin + keypad->pressed_row;
+		col_pin = config->first_col_pin + keypad->pressed_col;
+		/* A row driven low wins over the pull-up */
+		if((HOST_getPortDirection(config->row_port) & (1 << row_pin))
+				&& !(HOST_getPortOutput(config->row_port) & (1 << row_pin)))
+		{
+			levels &= (uint8)~(1 << col_pin);
+		}
+	}
+	return levels;
+}
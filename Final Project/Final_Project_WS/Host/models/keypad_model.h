@@ -0,0 +1,78 @@
+ /******************************************************************************
+ *
+ * Module: Keypad Model
+ *
+ * File Name: keypad_model.h
+ *
+ * Description: Header file for the host model of the 4x4 keypad matrix with its
+ *              external column pull-ups
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef KEYPAD_MODEL_H_
+#define KEYPAD_MODEL_H_
+
+#include "host_mcu.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define KEYPAD_MODEL_ROWS                4
+#define KEYPAD_MODEL_COLS                4
+
+/*
+ * Keys by the character they stand for, row by row:
+ *     7 8 9 %
+ *     4 5 6 *
+ *     1 2 3 -
+ *    ON 0 = +     ON is '\r', the driver reports it as 13 (Enter)
+ */
+#define KEYPAD_MODEL_LAYOUT              "789%456*123-\r0=+"
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	uint8 row_port;        /* HOST_PORTA .. HOST_PORTD */
+	uint8 first_row_pin;
+	uint8 col_port;
+	uint8 first_col_pin;
+}KeypadModel_ConfigType;
+
+typedef struct
+{
+	HOST_ModelType model;
+	KeypadModel_ConfigType config;
+	sint8 pressed_row;     /* -1 when no button is pressed */
+	sint8 pressed_col;
+	uint32 presses;
+}KeypadModel_Type;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Wire the keypad to the MCU pins, no button is pressed.
+ */
+void KeypadModel_init(KeypadModel_Type *keypad, const KeypadModel_ConfigType *config);
+
+/*
+ * Description :
+ * Hold the button of the given key down until KeypadModel_release().
+ * Returns FALSE for a key that is not on the keypad.
+ */
+boolean KeypadModel_press(KeypadModel_Type *keypad, char key);
+
+/*
+ * Description :
+ * Release the pressed button.
+ */
+void KeypadModel_release(KeypadModel_Type *keypad);
+
+#endif /* KEYPAD_MODEL_H_ */
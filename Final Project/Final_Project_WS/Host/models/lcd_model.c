@@ -0,0 +1,218 @@
+ /******************************************************************************
+ *
+ * Module: LCD Model
+ *
+ * File Name: lcd_model.c
+ *
+ * Description: Source file for the host model of the HD44780 2x16 character LCD
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "lcd_model.h"
+#include <string.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define LCD_MODEL_LINE2_ADDRESS          0x40
+#define LCD_MODEL_LINE_LENGTH            0x28
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * The bus is latched on the falling edge of E
+ */
+static void LcdModel_portWritten(void *context, uint8 port);
+
+/*
+ * Description :
+ * Run an instruction (rs = 0) or write a character (rs = 1)
+ */
+static void LcdModel_execute(LcdModel_Type *lcd, boolean rs, uint8 value);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Wire the LCD to the MCU pins, the display is blank and in 8-bit interface mode.
+ */
+void LcdModel_init(LcdModel_Type *lcd, const LcdModel_ConfigType *config)
+{
+	memset(lcd, 0, sizeof(*lcd));
+	lcd->config = *config;
+	memset(lcd->ddram, ' ', sizeof(lcd->ddram));
+	lcd->increment = TRUE;
+	lcd->model.context = lcd;
+	lcd->model.portWritten = LcdModel_portWritten;
+	HOST_addModel(&lcd->model);
+}
+
+/*
+ * Description :
+ * Text of a display row, 16 characters.
+ */
+const char *LcdModel_getLine(LcdModel_Type *lcd, uint8 row)
+{
+	uint8 col;
+	uint8 character;
+	for(col = 0; col < LCD_MODEL_COLS; col++)
+	{
+		character = lcd->ddram[(row ? LCD_MODEL_LINE2_ADDRESS : 0) + col];
+		if(character < 8)
+		{
+			character = LCD_MODEL_GLYPH_CHAR;
+		}
+		else if(character < ' ' || character > '~')
+		{
+			character = '?';
+		}
+		lcd->line[col] = (char)character;
+	}
+	lcd->line[LCD_MODEL_COLS] = '\0';
+	return lcd->line;
+}
+
+/*
+ * Description :
+ * The bus is latched on the falling edge of E
+ */
+static void LcdModel_portWritten(void *context, uint8 port)
+{
+	LcdModel_Type *lcd = context;
+	const LcdModel_ConfigType *config = &lcd->config;
+	boolean e_level;
+	boolean rs;
+	uint8 bus;
+	if(port != config->e_port)
+	{
+		return;
+	}
+	e_level = (HOST_getPortOutput(config->e_port) >> config->e_pin) & 1;
+	if(!lcd->e_level || e_level)
+	{
+		lcd->e_level = e_level;
+		return;
+	}
+	lcd->e_level = FALSE;
+	rs = (HOST_getPortOutput(config->rs_port) >> config->rs_pin) & 1;
+	bus = HOST_getPortOutput(config->data_port);
+	if(config->data_bits == 8)
+	{
+		LcdModel_execute(lcd, rs, bus);
+		return;
+	}
+	/* 4 wires on DB7..DB4 */
+	bus = (uint8)(((bus >> config->first_data_pin) & 0x0F) << 4);
+	if(!lcd->four_bit_mode)
+	{
+		LcdModel_execute(lcd, rs, bus);
+	}
+	else if(!lcd->low_nibble_next)
+	{
+		lcd->high_nibble = bus;
+		lcd->low_nibble_next = TRUE;
+	}
+	else
+	{
+		lcd->low_nibble_next = FALSE;
+		LcdModel_execute(lcd, rs, lcd->high_nibble | (bus >> 4));
+	}
+}
+
+/*
+ * Description :
+ * Run an instruction (rs = 0) or write a character (rs = 1), a byte latched
+ * before the end of the previous one is counted as a busy violation
+ */
+static void LcdModel_execute(LcdModel_Type *lcd, boolean rs, uint8 value)
+{
+	uint64 now = HOST_getCycles();
+	uint32 busy_ns = LCD_MODEL_COMMAND_NS;
+	if(now < lcd->busy_until)
+	{
+		lcd->busy_violations++;
+	}
+	if(rs)
+	{
+		lcd->characters++;
+		busy_ns = LCD_MODEL_DATA_NS;
+		if(lcd->cgram_selected)
+		{
+			lcd->cgram[lcd->address % LCD_MODEL_CGRAM_SIZE] = value;
+			lcd->address = (uint8)((lcd->address + (lcd->increment ? 1 : -1)) % LCD_MODEL_CGRAM_SIZE);
+		}
+		else
+		{
+			lcd->ddram[lcd->address % LCD_MODEL_DDRAM_SIZE] = value;
+			lcd->address = (uint8)(lcd->address + (lcd->increment ? 1 : -1));
+			/* Each line is 40 characters long, the end of one goes to the start of the other */
+			if(lcd->address == LCD_MODEL_LINE_LENGTH)
+			{
+				lcd->address = LCD_MODEL_LINE2_ADDRESS;
+			}
+			else if(lcd->address == LCD_MODEL_LINE2_ADDRESS + LCD_MODEL_LINE_LENGTH)
+			{
+				lcd->address = 0;
+			}
+		}
+	}
+	else
+	{
+		lcd->commands++;
+		if(value & 0x80)
+		{
+			lcd->address = value & 0x7F;
+			lcd->cgram_selected = FALSE;
+		}
+		else if(value & 0x40)
+		{
+			lcd->address = value & 0x3F;
+			lcd->cgram_selected = TRUE;
+		}
+		else if(value & 0x20)
+		{
+			/* Function set: DL selects the 8 or 4-bit interface */
+			lcd->four_bit_mode = !(value & 0x10);
+			lcd->low_nibble_next = FALSE;
+		}
+		else if(value & 0x10)
+		{
+			/* Cursor shift (the display shift is not modeled) */
+			if(!(value & 0x08))
+			{
+				lcd->address = (uint8)(lcd->address + ((value & 0x04) ? 1 : -1));
+			}
+		}
+		else if(value & 0x08)
+		{
+			lcd->display_on = (value & 0x04) != 0;
+		}
+		else if(value & 0x04)
+		{
+			lcd->increment = (value & 0x02) != 0;
+		}
+		else if(value & 0x02)
+		{
+			lcd->address = 0;
+			lcd->cgram_selected = FALSE;
+			busy_ns = LCD_MODEL_HOME_NS;
+		}
+		else if(value & 0x01)
+		{
+			memset(lcd->ddram, ' ', sizeof(lcd->ddram));
+			lcd->address = 0;
+			lcd->cgram_selected = FALSE;
+			lcd->increment = TRUE;
+			busy_ns = LCD_MODEL_HOME_NS;
+		}
+	}
+	lcd->busy_until = now + HOST_nsToCycles(busy_ns);
+}
@@ -0,0 +1,86 @@
+ /******************************************************************************
+ *
+ * Module: LCD Model
+ *
+ * File Name: lcd_model.h
+ *
+ * Description: Header file for the host model of the HD44780 2x16 character LCD
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef LCD_MODEL_H_
+#define LCD_MODEL_H_
+
+#include "host_mcu.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define LCD_MODEL_ROWS                   2
+#define LCD_MODEL_COLS                   16
+#define LCD_MODEL_DDRAM_SIZE             0x80
+#define LCD_MODEL_CGRAM_SIZE             64
+
+/* Execution times of the controller (HD44780 datasheet, 270kHz) */
+#define LCD_MODEL_COMMAND_NS             37000UL
+#define LCD_MODEL_DATA_NS                43000UL
+#define LCD_MODEL_HOME_NS                1520000UL
+
+/* Characters 0..7 are the CGRAM glyphs, shown as this character in the lines */
+#define LCD_MODEL_GLYPH_CHAR             '#'
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef struct
+{
+	uint8 data_port;       /* HOST_PORTA .. HOST_PORTD */
+	uint8 first_data_pin;  /* DB0 in 8-bit wiring, DB4 in 4-bit wiring */
+	uint8 data_bits;       /* 8 or 4 wires */
+	uint8 rs_port;
+	uint8 rs_pin;
+	uint8 e_port;
+	uint8 e_pin;
+}LcdModel_ConfigType;
+
+typedef struct
+{
+	HOST_ModelType model;
+	LcdModel_ConfigType config;
+	boolean e_level;
+	boolean four_bit_mode;     /* Interface set by the last function set command */
+	boolean low_nibble_next;
+	uint8 high_nibble;
+	uint8 ddram[LCD_MODEL_DDRAM_SIZE];
+	uint8 cgram[LCD_MODEL_CGRAM_SIZE];
+	uint8 address;
+	boolean cgram_selected;
+	boolean increment;
+	boolean display_on;
+	uint64 busy_until;         /* Cycle the current instruction ends */
+	uint32 commands;
+	uint32 characters;
+	uint32 busy_violations;    /* Bytes latched while the controller was still busy */
+	char line[LCD_MODEL_COLS + 1];
+}LcdModel_Type;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Wire the LCD to the MCU pins, the display is blank and in 8-bit interface mode.
+ */
+void LcdModel_init(LcdModel_Type *lcd, const LcdModel_ConfigType *config);
+
+/*
+ * Description :
+ * Text of a display row, 16 characters.
+ */
+const char *LcdModel_getLine(LcdModel_Type *lcd, uint8 row);
+
+#endif /* LCD_MODEL_H_ */
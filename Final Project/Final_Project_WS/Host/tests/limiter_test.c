@@ -0,0 +1,199 @@
+ /******************************************************************************
+ *
+ * Module: Host Unit Tests
+ *
+ * File Name: limiter_test.c
+ *
+ * Description: Unit tests of the wrong attempts limiter of Control ECU: the free
+ *              attempts, the 30s to 3840s doubling lockouts, the decay, the
+ *              saturated count and the lockout restored after a reset
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "unit_test.h"
+#include "attempt_limiter.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Longest lockout: the base lockout doubled LIMITER_MAX_DOUBLINGS times */
+#define TEST_MAX_LOCKOUT_S               (LIMITER_BASE_LOCKOUT_S << LIMITER_MAX_DOUBLINGS)
+#define TEST_ERASED_COUNT                0xFF
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Start from a new count with the default configuration, as Control ECU does at boot
+ */
+static void startLimiter(uint8 failures, uint32 now)
+{
+	LIMITER_configure(LIMITER_FREE_ATTEMPTS, LIMITER_BASE_LOCKOUT_S);
+	LIMITER_init(failures, now);
+}
+
+/*
+ * One wrong attempt as Control ECU makes it: allowed, counted, then not forgotten.
+ * Returns the lockout it starts
+ */
+static uint16 wrongAttempt(uint32 now)
+{
+	LIMITER_attemptStarted(now);
+	return LIMITER_lockoutLeft(now);
+}
+
+static void testFreeAttempts(void)
+{
+	uint8 attempt;
+
+	UNIT_group("Free attempts");
+	startLimiter(TEST_ERASED_COUNT, 0);
+	TEST_CHECK_EQUAL(LIMITER_getFailures(0), 0);
+	TEST_CHECK_EQUAL(LIMITER_lockoutLeft(0), 0);
+	for(attempt = 1; attempt < LIMITER_FREE_ATTEMPTS; attempt++)
+	{
+		TEST_CHECK_EQUAL(wrongAttempt(attempt), 0);
+		TEST_CHECK_EQUAL(LIMITER_getFailures(attempt), attempt);
+	}
+	/* The next wrong attempt starts the base lockout */
+	TEST_CHECK_EQUAL(wrongAttempt(attempt), LIMITER_BASE_LOCKOUT_S);
+
+	/* A right password forgets every wrong attempt and ends the lockout */
+	LIMITER_attemptSucceeded();
+	TEST_CHECK_EQUAL(LIMITER_getFailures(attempt), 0);
+	TEST_CHECK_EQUAL(LIMITER_lockoutLeft(attempt), 0);
+	TEST_CHECK_EQUAL(wrongAttempt(attempt + 1), 0);
+}
+
+static void testBackoff(void)
+{
+	uint32 now = 100;
+	uint16 expected = LIMITER_BASE_LOCKOUT_S;
+	uint8 attempt;
+
+	UNIT_group("Backoff: 30s doubled up to 3840s");
+	startLimiter(0, now);
+	for(attempt = 1; attempt < LIMITER_FREE_ATTEMPTS; attempt++)
+	{
+		wrongAttempt(now);
+	}
+	/* Each wrong attempt is made as soon as the previous lockout ends */
+	for(attempt = 0; attempt <= LIMITER_MAX_DOUBLINGS + 2; attempt++)
+	{
+		TEST_CHECK_EQUAL(wrongAttempt(now), expected);
+		TEST_CHECK_EQUAL(LIMITER_lockoutLeft(now + expected - 1), 1);
+		now += expected;
+		TEST_CHECK_EQUAL(LIMITER_lockoutLeft(now), 0);
+		if(expected < TEST_MAX_LOCKOUT_S)
+		{
+			expected *= 2;
+		}
+	}
+	TEST_CHECK_EQUAL(TEST_MAX_LOCKOUT_S, 3840);
+	TEST_CHECK_EQUAL(LIMITER_getFailures(now), LIMITER_FREE_ATTEMPTS + LIMITER_MAX_DOUBLINGS + 2);
+}
+
+static void testDecay(void)
+{
+	uint32 lockout_end;
+	uint8 attempt;
+
+	UNIT_group("Decay: one wrong attempt forgotten every 10 min after the lockout");
+	startLimiter(0, 0);
+	for(attempt = 1; attempt <= LIMITER_FREE_ATTEMPTS; attempt++)
+	{
+		wrongAttempt(0);
+	}
+	lockout_end = LIMITER_BASE_LOCKOUT_S;
+	/* Nothing is forgotten during the lockout nor before LIMITER_DECAY_S after it */
+	TEST_CHECK_EQUAL(LIMITER_getFailures(lockout_end + LIMITER_DECAY_S - 1), LIMITER_FREE_ATTEMPTS);
+	TEST_CHECK_EQUAL(LIMITER_getFailures(lockout_end + LIMITER_DECAY_S), LIMITER_FREE_ATTEMPTS - 1);
+	/* One forgotten attempt makes the next wrong one start the base lockout again, not twice it */
+	TEST_CHECK_EQUAL(wrongAttempt(lockout_end + LIMITER_DECAY_S), LIMITER_BASE_LOCKOUT_S);
+
+	lockout_end += LIMITER_DECAY_S + LIMITER_BASE_LOCKOUT_S;
+	TEST_CHECK_EQUAL(LIMITER_getFailures(lockout_end + 3 * LIMITER_DECAY_S), 0);
+	TEST_CHECK_EQUAL(LIMITER_getFailures(lockout_end + 10 * LIMITER_DECAY_S), 0);
+	TEST_CHECK_EQUAL(wrongAttempt(lockout_end + 10 * LIMITER_DECAY_S), 0);
+}
+
+static void testSaturation(void)
+{
+	uint32 now = 0;
+	uint16 attempt;
+
+	UNIT_group("Saturated count");
+	startLimiter(0, now);
+	for(attempt = 0; attempt < 300; attempt++)
+	{
+		now += wrongAttempt(now);
+	}
+	TEST_CHECK_EQUAL(LIMITER_getFailures(now), LIMITER_MAX_FAILURES);
+	TEST_CHECK_EQUAL(wrongAttempt(now), TEST_MAX_LOCKOUT_S);
+}
+
+static void testRestore(void)
+{
+	uint8 saved;
+
+	UNIT_group("Restore after a reset");
+	startLimiter(0, 5000);
+	wrongAttempt(5000);
+	wrongAttempt(5000);
+	wrongAttempt(5000);
+	TEST_CHECK_EQUAL(wrongAttempt(5030), 2 * LIMITER_BASE_LOCKOUT_S);
+	saved = LIMITER_getFailures(5040);
+	/* The count saved in the EEPROM, then a reset 10s into the lockout: the uptime starts at 0 */
+	startLimiter(saved, 0);
+	TEST_CHECK_EQUAL(LIMITER_getFailures(0), LIMITER_FREE_ATTEMPTS + 1);
+	TEST_CHECK_EQUAL(LIMITER_lockoutLeft(0), 2 * LIMITER_BASE_LOCKOUT_S);
+	TEST_CHECK_EQUAL(LIMITER_lockoutLeft(2 * LIMITER_BASE_LOCKOUT_S - 1), 1);
+	TEST_CHECK_EQUAL(LIMITER_lockoutLeft(2 * LIMITER_BASE_LOCKOUT_S), 0);
+	/* The backoff goes on from the restored count */
+	TEST_CHECK_EQUAL(wrongAttempt(2 * LIMITER_BASE_LOCKOUT_S), 4 * LIMITER_BASE_LOCKOUT_S);
+
+	/* A reset during a check: the attempt was counted before the check */
+	startLimiter(LIMITER_FREE_ATTEMPTS - 1, 0);
+	LIMITER_attemptStarted(0);
+	saved = LIMITER_getFailures(0);
+	startLimiter(saved, 0);
+	TEST_CHECK_EQUAL(LIMITER_lockoutLeft(0), LIMITER_BASE_LOCKOUT_S);
+
+	/* Below the free attempts no lockout, an erased EEPROM is no wrong attempt */
+	startLimiter(LIMITER_FREE_ATTEMPTS - 1, 0);
+	TEST_CHECK_EQUAL(LIMITER_lockoutLeft(0), 0);
+	startLimiter(TEST_ERASED_COUNT, 0);
+	TEST_CHECK_EQUAL(LIMITER_getFailures(0), 0);
+	startLimiter(LIMITER_MAX_FAILURES, 0);
+	TEST_CHECK_EQUAL(LIMITER_lockoutLeft(0), TEST_MAX_LOCKOUT_S);
+}
+
+static void testConfigure(void)
+{
+	UNIT_group("Configured free attempts and base lockout");
+	LIMITER_init(0, 0);
+	LIMITER_configure(1, 10);
+	TEST_CHECK_EQUAL(wrongAttempt(0), 10);
+	TEST_CHECK_EQUAL(wrongAttempt(10), 20);
+	/* The base lockout is capped so the longest lockout fits 16 bits */
+	LIMITER_init(0, 0);
+	LIMITER_configure(1, 0xFFFF);
+	TEST_CHECK_EQUAL(wrongAttempt(0), LIMITER_MAX_BASE_LOCKOUT_S);
+	LIMITER_init(LIMITER_MAX_FAILURES, 0);
+	TEST_CHECK_EQUAL(LIMITER_lockoutLeft(0), (uint16)(LIMITER_MAX_BASE_LOCKOUT_S << LIMITER_MAX_DOUBLINGS));
+}
+
+int main(void)
+{
+	testFreeAttempts();
+	testBackoff();
+	testDecay();
+	testSaturation();
+	testRestore();
+	testConfigure();
+	return UNIT_report();
+}
@@ -0,0 +1,191 @@
+ /******************************************************************************
+ *
+ * Module: Host Unit Tests
+ *
+ * File Name: totp_test.c
+ *
+ * Description: Unit tests of the one-time codes of Control ECU: SHA-1 and
+ *              HMAC-SHA1 vectors, the RFC 4226 HOTP and RFC 6238 TOTP vectors,
+ *              the +-1 step window and the refusal of a code used twice
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#include "unit_test.h"
+#include "sha1.h"
+#include "totp.h"
+#include <string.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* RFC 4226 appendix D and RFC 6238 appendix B (SHA1) shared secret */
+#define TEST_SECRET                      "12345678901234567890"
+#define TEST_SECRET_LENGTH               20
+/* TOTP_verify() window of Control ECU: one step before and after the current one */
+#define TEST_WINDOW                      3
+#define TEST_DIGITS                      6
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Compare a digest with its hexadecimal form
+ */
+static int digestIs(const uint8 *digest, const char *hex)
+{
+	char text[2 * SHA1_DIGEST_SIZE + 1];
+	uint8 i;
+	for(i = 0; i < SHA1_DIGEST_SIZE; i++)
+	{
+		sprintf(&text[2 * i], "%02x", digest[i]);
+	}
+	return strcmp(text, hex) == 0;
+}
+
+static void testSha1(void)
+{
+	static const char long_message[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+	SHA1_ContextType context;
+	uint8 digest[SHA1_DIGEST_SIZE];
+	uint8 i;
+
+	UNIT_group("SHA-1 (FIPS 180 examples)");
+	SHA1_init(&context);
+	SHA1_final(&context, digest);
+	TEST_CHECK(digestIs(digest, "da39a3ee5e6b4b0d3255bfef95601890afd80709"));
+
+	SHA1_init(&context);
+	SHA1_update(&context, (const uint8 *)"abc", 3);
+	SHA1_final(&context, digest);
+	TEST_CHECK(digestIs(digest, "a9993e364706816aba3e25717850c26c9cd0d89d"));
+
+	SHA1_init(&context);
+	SHA1_update(&context, (const uint8 *)long_message, sizeof(long_message) - 1);
+	SHA1_final(&context, digest);
+	TEST_CHECK(digestIs(digest, "84983e441c3bd26ebaae4aa1f95129e5e54670f1"));
+
+	/* The same message in pieces that cross the block boundary */
+	SHA1_init(&context);
+	for(i = 0; i < sizeof(long_message) - 1; i += 5)
+	{
+		SHA1_update(&context, (const uint8 *)&long_message[i],
+				(sizeof(long_message) - 1 - i < 5) ? (sizeof(long_message) - 1 - i) : 5);
+	}
+	SHA1_final(&context, digest);
+	TEST_CHECK(digestIs(digest, "84983e441c3bd26ebaae4aa1f95129e5e54670f1"));
+}
+
+static void testHmacSha1(void)
+{
+	uint8 secret[20];
+	HMAC_SHA1_KeyType key;
+	uint8 mac[SHA1_DIGEST_SIZE];
+
+	UNIT_group("HMAC-SHA1 (RFC 2202 cases 1 and 2)");
+	memset(secret, 0x0B, sizeof(secret));
+	HMAC_SHA1_setKey(&key, secret, sizeof(secret));
+	HMAC_SHA1_compute(&key, (const uint8 *)"Hi There", 8, mac);
+	TEST_CHECK(digestIs(mac, "b617318655057264e28bc0b6fb378c8ef146be00"));
+
+	HMAC_SHA1_setKey(&key, (const uint8 *)"Jefe", 4);
+	HMAC_SHA1_compute(&key, (const uint8 *)"what do ya want for nothing?", 28, mac);
+	TEST_CHECK(digestIs(mac, "effcdf6ae5eb2fa2d27416d5f184df9c259a7c79"));
+}
+
+static void testHotp(void)
+{
+	/* RFC 4226 appendix D: the code of each counter value */
+	static const uint32 codes[] =
+	{
+		755224, 287082, 359152, 969429, 338314, 254676, 287922, 162583, 399871, 520489
+	};
+	uint32 counter;
+
+	UNIT_group("HOTP (RFC 4226 appendix D)");
+	TOTP_init((const uint8 *)TEST_SECRET, TEST_SECRET_LENGTH);
+	for(counter = 0; counter < sizeof(codes) / sizeof(codes[0]); counter++)
+	{
+		TEST_CHECK_EQUAL(TOTP_code(counter, 6), codes[counter]);
+	}
+}
+
+static void testTotp(void)
+{
+	/* RFC 6238 appendix B, SHA1 mode: Unix time and its 8 digits code */
+	static const struct
+	{
+		uint32 time;
+		uint32 code;
+	} vectors[] =
+	{
+		{59, 94287082},
+		{1111111109, 7081804},
+		{1111111111, 14050471},
+		{1234567890, 89005924},
+		{2000000000, 69279037}
+	};
+	uint8 i;
+
+	UNIT_group("TOTP (RFC 6238 appendix B)");
+	TOTP_init((const uint8 *)TEST_SECRET, TEST_SECRET_LENGTH);
+	for(i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++)
+	{
+		TEST_CHECK_EQUAL(TOTP_code(vectors[i].time / TOTP_STEP_SECONDS, 8), vectors[i].code);
+	}
+	/* 20000000000 does not fit the 32 bits Unix time of Control ECU, its step does */
+	TEST_CHECK_EQUAL(TOTP_code(666666666UL, 8), 65353130);
+}
+
+static void testWindow(void)
+{
+	uint32 step = 1234567890UL / TOTP_STEP_SECONDS;
+
+	UNIT_group("TOTP_verify: +-1 step window");
+	TOTP_init((const uint8 *)TEST_SECRET, TEST_SECRET_LENGTH);
+	TEST_CHECK(!TOTP_verify(TOTP_code(step - 2, TEST_DIGITS), step, TEST_DIGITS, TEST_WINDOW));
+	TEST_CHECK(!TOTP_verify(TOTP_code(step + 2, TEST_DIGITS), step, TEST_DIGITS, TEST_WINDOW));
+	TEST_CHECK(!TOTP_verify((TOTP_code(step, TEST_DIGITS) + 1) % 1000000, step, TEST_DIGITS, TEST_WINDOW));
+	TEST_CHECK(TOTP_verify(TOTP_code(step - 1, TEST_DIGITS), step, TEST_DIGITS, TEST_WINDOW));
+	TEST_CHECK(TOTP_verify(TOTP_code(step, TEST_DIGITS), step, TEST_DIGITS, TEST_WINDOW));
+	TEST_CHECK(TOTP_verify(TOTP_code(step + 1, TEST_DIGITS), step, TEST_DIGITS, TEST_WINDOW));
+
+	/* Window 1: the current step only */
+	TEST_CHECK(!TOTP_verify(TOTP_code(step + 1, TEST_DIGITS), step + 2, TEST_DIGITS, 1));
+	TEST_CHECK(TOTP_verify(TOTP_code(step + 2, TEST_DIGITS), step + 2, TEST_DIGITS, 1));
+}
+
+static void testReplay(void)
+{
+	uint32 step = 2000000000UL / TOTP_STEP_SECONDS;
+	uint32 code = TOTP_code(step, TEST_DIGITS);
+
+	UNIT_group("TOTP_verify: replay refusal");
+	TOTP_init((const uint8 *)TEST_SECRET, TEST_SECRET_LENGTH);
+	TEST_CHECK(TOTP_verify(code, step, TEST_DIGITS, TEST_WINDOW));
+	TEST_CHECK(!TOTP_verify(code, step, TEST_DIGITS, TEST_WINDOW));
+	/* Still refused in the next step, where it is the code of the step before */
+	TEST_CHECK(!TOTP_verify(code, step + 1, TEST_DIGITS, TEST_WINDOW));
+	/* The code of the step before the used one is refused too */
+	TEST_CHECK(!TOTP_verify(TOTP_code(step - 1, TEST_DIGITS), step, TEST_DIGITS, TEST_WINDOW));
+	/* The next code is accepted once */
+	TEST_CHECK(TOTP_verify(TOTP_code(step + 1, TEST_DIGITS), step + 1, TEST_DIGITS, TEST_WINDOW));
+	TEST_CHECK(!TOTP_verify(TOTP_code(step + 1, TEST_DIGITS), step + 1, TEST_DIGITS, TEST_WINDOW));
+	/* A new secret starts again */
+	TOTP_init((const uint8 *)TEST_SECRET, TEST_SECRET_LENGTH);
+	TEST_CHECK(TOTP_verify(code, step, TEST_DIGITS, TEST_WINDOW));
+}
+
+int main(void)
+{
+	testSha1();
+	testHmacSha1();
+	testHotp();
+	testTotp();
+	testWindow();
+	testReplay();
+	return UNIT_report();
+}
@@ -0,0 +1,79 @@
+ /******************************************************************************
+ *
+ * Module: Host Unit Tests
+ *
+ * File Name: unit_test.h
+ *
+ * Description: Checks of the host unit tests (make test): each failed check is
+ *              printed with its line, the test exits 1 if any check failed
+ *
+ * Author: Yousouf Soliman
+ *
+ *******************************************************************************/
+
+#ifndef UNIT_TEST_H_
+#define UNIT_TEST_H_
+
+#include <stdio.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Count a check, print it if it failed and go on with the next one */
+#define TEST_CHECK(condition) \
+	UNIT_check((condition) ? 1 : 0, #condition, __LINE__)
+
+/* Check an integer result, both values are printed if they differ */
+#define TEST_CHECK_EQUAL(actual, expected) \
+	UNIT_checkEqual((unsigned long)(actual), (unsigned long)(expected), #actual, __LINE__)
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static unsigned g_testChecks = 0;
+static unsigned g_testFailures = 0;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+static inline void UNIT_check(int passed, const char *condition, int line)
+{
+	g_testChecks++;
+	if(!passed)
+	{
+		g_testFailures++;
+		printf("  FAIL line %d: %s\n", line, condition);
+	}
+}
+
+static inline void UNIT_checkEqual(unsigned long actual, unsigned long expected, const char *name, int line)
+{
+	g_testChecks++;
+	if(actual != expected)
+	{
+		g_testFailures++;
+		printf("  FAIL line %d: %s is %lu, expected %lu\n", line, name, actual, expected);
+	}
+}
+
+/*
+ * Print the name of a test group, its failed checks follow
+ */
+static inline void UNIT_group(const char *name)
+{
+	printf("%s\n", name);
+}
+
+/*
+ * Print the totals, returns the exit code of the test
+ */
+static inline int UNIT_report(void)
+{
+	printf("%u checks, %u failed\n", g_testChecks, g_testFailures);
+	return (g_testFailures == 0) ? 0 : 1;
+}
+
+#endif /* UNIT_TEST_H_ */